@@ -0,0 +1,22 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Benchmarks link the same sources as the full tests, but replace the mocked
+# host driver and per-test keymaps with counting ones, so that only the
+# keycode processing pipeline itself is measured.
+
+$(TEST_OUTPUT)_SRC := \
+	$(QUANTUM_SRC) \
+	$(SRC) \
+	$(QUANTUM_PATH)/keymap_introspection.c \
+	tests/test_common/matrix.c \
+	tests/bench_common/bench_eeprom.c \
+	tests/bench_common/bench_fixture.cpp \
+	tests/bench_common/bench_trace.cpp \
+	$(patsubst $(ROOTDIR)/%,%,$(wildcard $(TEST_PATH)/*.cpp))
+
+$(TEST_OUTPUT)_DEFS := $(OPT_DEFS) "-DKEYMAP_C=\"keymap.c\"" "-DBENCH_PATH=\"$(TEST_PATH)\""
+
+$(TEST_OUTPUT)_CONFIG := $(TEST_PATH)/config.h
+
+VPATH += $(TOP_DIR)/tests/bench_common
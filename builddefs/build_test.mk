@@ -55,21 +55,34 @@ ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include tests/test_common/build.mk
 include $(TEST_PATH)/test.mk
 endif
+ifneq ($(wildcard $(TEST_PATH)/bench.mk),)
+include tests/bench_common/build.mk
+include $(TEST_PATH)/bench.mk
+endif
 
 include $(BUILDDEFS_PATH)/common_features.mk
 include $(BUILDDEFS_PATH)/generic_features.mk
 include $(PLATFORM_PATH)/common.mk
 include $(TMK_PATH)/protocol.mk
+include $(DRIVER_PATH)/flash/tests/rules.mk
 include $(QUANTUM_PATH)/debounce/tests/rules.mk
 include $(QUANTUM_PATH)/encoder/tests/rules.mk
+include $(QUANTUM_PATH)/matrix_port/tests/rules.mk
+include $(QUANTUM_PATH)/midi/tests/rules.mk
 include $(QUANTUM_PATH)/os_detection/tests/rules.mk
+include $(QUANTUM_PATH)/rgb_matrix/tests/rules.mk
 include $(QUANTUM_PATH)/sequencer/tests/rules.mk
+include $(QUANTUM_PATH)/split_common/tests/rules.mk
+include $(QUANTUM_PATH)/task_scheduler/tests/rules.mk
 include $(QUANTUM_PATH)/wear_leveling/tests/rules.mk
 include $(QUANTUM_PATH)/logging/print.mk
 include $(PLATFORM_PATH)/test/rules.mk
 ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include $(BUILDDEFS_PATH)/build_full_test.mk
 endif
+ifneq ($(wildcard $(TEST_PATH)/bench.mk),)
+include $(BUILDDEFS_PATH)/build_bench.mk
+endif
 
 $(TEST_OUTPUT)_SRC += \
 	tests/test_common/main.cpp \
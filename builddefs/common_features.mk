@@ -84,10 +84,10 @@ ifeq ($(strip $(MIDI_ENABLE)), yes)
     COMMON_VPATH += $(QUANTUM_PATH)/midi
     SRC += $(QUANTUM_DIR)/midi/midi.c
     SRC += $(QUANTUM_DIR)/midi/midi_device.c
+    SRC += $(QUANTUM_DIR)/midi/midi_packet_queue.c
     SRC += $(QUANTUM_DIR)/midi/qmk_midi.c
     SRC += $(QUANTUM_DIR)/midi/sysex_tools.c
     SRC += $(QUANTUM_DIR)/midi/bytequeue/bytequeue.c
-    SRC += $(QUANTUM_DIR)/midi/bytequeue/interrupt_setting.c
     SRC += $(QUANTUM_DIR)/process_keycode/process_midi.c
 endif
 
@@ -112,6 +112,11 @@ ifeq ($(strip $(STENO_ENABLE)), yes)
             OPT_DEFS += -DSTENO_ENABLE_BOLT
         endif
 
+        ifeq ($(strip $(STENO_DICTIONARY_ENABLE)), yes)
+            OPT_DEFS += -DSTENO_DICTIONARY_ENABLE
+            FLASH_DRIVER ?= spi
+        endif
+
         SRC += $(QUANTUM_DIR)/process_keycode/process_steno.c
     endif
 endif
@@ -282,14 +287,16 @@ ifneq ($(strip $(WEAR_LEVELING_DRIVER)),none)
   endif
 endif
 
-VALID_FLASH_DRIVER_TYPES := spi
+VALID_FLASH_DRIVER_TYPES := spi custom
 FLASH_DRIVER ?= none
 ifneq ($(strip $(FLASH_DRIVER)), none)
     ifeq ($(filter $(FLASH_DRIVER),$(VALID_FLASH_DRIVER_TYPES)),)
         $(call CATASTROPHIC_ERROR,Invalid FLASH_DRIVER,FLASH_DRIVER="$(FLASH_DRIVER)" is not a valid flash driver)
     else
         OPT_DEFS += -DFLASH_ENABLE
-        ifeq ($(strip $(FLASH_DRIVER)),spi)
+        ifeq ($(strip $(FLASH_DRIVER)),custom)
+            COMMON_VPATH += $(DRIVER_PATH)/flash
+        else ifeq ($(strip $(FLASH_DRIVER)),spi)
             SPI_DRIVER_REQUIRED = yes
             OPT_DEFS += -DFLASH_DRIVER -DFLASH_SPI
             COMMON_VPATH += $(DRIVER_PATH)/flash
@@ -647,6 +654,13 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
     ifneq ($(strip $(CUSTOM_MATRIX)), lite)
         # Include the standard or split matrix code if needed
         QUANTUM_SRC += $(QUANTUM_DIR)/matrix.c
+
+        # Read matrix input pins a whole GPIO port at a time
+        ifeq ($(strip $(MATRIX_PORT_READ)), yes)
+            OPT_DEFS += -DMATRIX_PORT_READ
+            COMMON_VPATH += $(QUANTUM_DIR)/matrix_port
+            QUANTUM_SRC += $(QUANTUM_DIR)/matrix_port/matrix_port.c
+        endif
     endif
 endif
 
@@ -47,8 +47,10 @@ GENERIC_FEATURES = \
     SEND_STRING \
     SEQUENCER \
     SPACE_CADET \
+    STATE_BUS \
     SWAP_HANDS \
     TAP_DANCE \
+    TASK_SCHEDULER \
     TRI_LAYER \
     VIA \
     VIRTSER \
@@ -44,6 +44,7 @@ OTHER_OPTION_NAMES = \
   LEADER_ENABLE \
   STENO_ENABLE \
   STENO_PROTOCOL \
+  STENO_DICTIONARY_ENABLE \
   TAP_DANCE_ENABLE \
   VIRTSER_ENABLE \
   OLED_ENABLE \
@@ -19,6 +19,10 @@
 
 #include "eeprom_driver.h"
 
+__attribute__((weak)) void eeprom_driver_flush(void) {}
+
+__attribute__((weak)) void eeprom_driver_task(void) {}
+
 uint8_t eeprom_read_byte(const uint8_t *addr) {
     uint8_t ret = 0;
     eeprom_read_block(&ret, addr, 1);
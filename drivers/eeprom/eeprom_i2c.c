@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #if defined(EXTERNAL_EEPROM_WP_PIN)
@@ -34,17 +35,48 @@
 */
 
 #include "wait.h"
+#include "timer.h"
+#include "util.h"
 #include "i2c_master.h"
 #include "eeprom.h"
+#include "eeprom_driver.h"
 #include "eeprom_i2c.h"
 
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif // DEBUG_EEPROM_OUTPUT
 
+#if EXTERNAL_EEPROM_CACHE_LINES > 0
+_Static_assert(EXTERNAL_EEPROM_PAGE_SIZE % EXTERNAL_EEPROM_CACHE_LINE_SIZE == 0, "EXTERNAL_EEPROM_CACHE_LINE_SIZE must divide EXTERNAL_EEPROM_PAGE_SIZE");
+
+/* Read cache -- always holds the latest data, as writes update any cached lines. */
+static struct {
+    bool      valid;
+    uintptr_t addr;
+    uint8_t   data[EXTERNAL_EEPROM_CACHE_LINE_SIZE];
+} eeprom_cache[EXTERNAL_EEPROM_CACHE_LINES];
+static uint8_t eeprom_cache_victim = 0;
+#endif // EXTERNAL_EEPROM_CACHE_LINES > 0
+
+#if EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+/* Writes not yet sent to the EEPROM, all within a single page. */
+static struct {
+    bool      active;
+    uintptr_t page_addr;
+    uint16_t  start;
+    uint16_t  end;
+    uint32_t  last_write;
+    uint8_t   data[EXTERNAL_EEPROM_PAGE_SIZE];
+} eeprom_pending;
+#endif // EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+
+/* Page write most recently sent to the EEPROM, which may still be in its write cycle. */
+static bool      eeprom_write_in_progress = false;
+static uint32_t  eeprom_write_start;
+static uintptr_t eeprom_write_addr;
+
 static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     uintptr_t p = (uintptr_t)addr;
     for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
@@ -53,6 +85,125 @@ static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     }
 }
 
+static void eeprom_i2c_wait_for_write(void) {
+    if (!eeprom_write_in_progress) {
+        return;
+    }
+
+    /* The EEPROM doesn't acknowledge its address until the write cycle completes, so poll instead of waiting for the worst case. */
+    while (timer_elapsed32(eeprom_write_start) <= EXTERNAL_EEPROM_WRITE_TIME) {
+        if (i2c_ping_address(EXTERNAL_EEPROM_I2C_ADDRESS(eeprom_write_addr), 1) == I2C_STATUS_SUCCESS) {
+            break;
+        }
+    }
+
+    eeprom_write_in_progress = false;
+}
+
+static bool eeprom_i2c_read_device(uintptr_t addr, uint8_t *buf, size_t len) {
+    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
+    fill_target_address(complete_packet, (const void *)addr);
+
+    eeprom_i2c_wait_for_write();
+
+    if (i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100) != I2C_STATUS_SUCCESS) {
+        return false;
+    }
+    return i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS(addr), buf, len, 100) == I2C_STATUS_SUCCESS;
+}
+
+/* Writes data to the EEPROM, which must not cross a page boundary. Returns without waiting for the write cycle. */
+static void eeprom_i2c_write_device(uintptr_t addr, const uint8_t *buf, size_t len) {
+    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
+
+    eeprom_i2c_wait_for_write();
+
+#if defined(EXTERNAL_EEPROM_WP_PIN)
+    gpio_set_pin_output(EXTERNAL_EEPROM_WP_PIN);
+    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 0);
+#endif
+
+    fill_target_address(complete_packet, (const void *)addr);
+    memcpy(&complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE], buf, len);
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("[EEPROM W] 0x%04X: ", ((int)addr));
+    for (size_t i = 0; i < len; i++) {
+        dprintf(" %02X", (int)(buf[i]));
+    }
+    dprintf("\n");
+#endif // DEBUG_EEPROM_OUTPUT
+
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + len, 100);
+
+#if EXTERNAL_EEPROM_WRITE_TIME > 0
+    eeprom_write_in_progress = true;
+    eeprom_write_start       = timer_read32();
+    eeprom_write_addr        = addr;
+#endif
+
+#if defined(EXTERNAL_EEPROM_WP_PIN)
+    /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
+    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 1);
+    gpio_set_pin_input_high(EXTERNAL_EEPROM_WP_PIN);
+#endif
+}
+
+#if EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+static void eeprom_i2c_flush_pending(void) {
+    if (eeprom_pending.active) {
+        eeprom_pending.active = false;
+        eeprom_i2c_write_device(eeprom_pending.page_addr + eeprom_pending.start, &eeprom_pending.data[eeprom_pending.start], eeprom_pending.end - eeprom_pending.start);
+    }
+}
+
+/* Applies any writes not yet sent to the EEPROM to data read back from it. */
+static void eeprom_i2c_apply_pending(uintptr_t addr, uint8_t *buf, size_t len) {
+    if (eeprom_pending.active) {
+        uintptr_t start = MAX(addr, eeprom_pending.page_addr + eeprom_pending.start);
+        uintptr_t end   = MIN(addr + len, eeprom_pending.page_addr + eeprom_pending.end);
+        if (start < end) {
+            memcpy(&buf[start - addr], &eeprom_pending.data[start - eeprom_pending.page_addr], end - start);
+        }
+    }
+}
+#else
+#    define eeprom_i2c_flush_pending()
+#    define eeprom_i2c_apply_pending(addr, buf, len)
+#endif // EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+
+#if EXTERNAL_EEPROM_CACHE_LINES > 0
+static uint8_t *eeprom_i2c_cache_line(uintptr_t line_addr) {
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_LINES; ++i) {
+        if (eeprom_cache[i].valid && eeprom_cache[i].addr == line_addr) {
+            return eeprom_cache[i].data;
+        }
+    }
+
+    /* Not cached, fetch the entire line in a single transaction. */
+    uint8_t i               = eeprom_cache_victim;
+    eeprom_cache_victim     = (eeprom_cache_victim + 1) % EXTERNAL_EEPROM_CACHE_LINES;
+    eeprom_cache[i].addr    = line_addr;
+    eeprom_cache[i].valid   = eeprom_i2c_read_device(line_addr, eeprom_cache[i].data, EXTERNAL_EEPROM_CACHE_LINE_SIZE);
+    eeprom_i2c_apply_pending(line_addr, eeprom_cache[i].data, EXTERNAL_EEPROM_CACHE_LINE_SIZE);
+    return eeprom_cache[i].data;
+}
+
+static void eeprom_i2c_cache_update(uintptr_t addr, const uint8_t *buf, size_t len) {
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_CACHE_LINES; ++i) {
+        if (eeprom_cache[i].valid) {
+            uintptr_t start = MAX(addr, eeprom_cache[i].addr);
+            uintptr_t end   = MIN(addr + len, eeprom_cache[i].addr + EXTERNAL_EEPROM_CACHE_LINE_SIZE);
+            if (start < end) {
+                memcpy(&eeprom_cache[i].data[start - eeprom_cache[i].addr], &buf[start - addr], end - start);
+            }
+        }
+    }
+}
+#else
+#    define eeprom_i2c_cache_update(addr, buf, len)
+#endif // EXTERNAL_EEPROM_CACHE_LINES > 0
+
 void eeprom_driver_init(void) {
     i2c_init();
 #if defined(EXTERNAL_EEPROM_WP_PIN)
@@ -60,6 +211,13 @@ void eeprom_driver_init(void) {
     gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 1);
     gpio_set_pin_input_high(EXTERNAL_EEPROM_WP_PIN);
 #endif
+#if EXTERNAL_EEPROM_CACHE_LINES > 0
+    memset(eeprom_cache, 0, sizeof(eeprom_cache));
+#endif
+#if EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+    eeprom_pending.active = false;
+#endif
+    eeprom_write_in_progress = false;
 }
 
 void eeprom_driver_erase(void) {
@@ -72,22 +230,54 @@ void eeprom_driver_erase(void) {
     for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
         eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
     }
+    eeprom_driver_flush();
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
 #endif
 }
 
+void eeprom_driver_flush(void) {
+    eeprom_i2c_flush_pending();
+    eeprom_i2c_wait_for_write();
+}
+
+void eeprom_driver_task(void) {
+#if EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+    if (eeprom_pending.active && timer_elapsed32(eeprom_pending.last_write) >= EXTERNAL_EEPROM_WRITE_COALESCE_TIME) {
+        eeprom_i2c_flush_pending();
+    }
+#endif
+}
+
 void eeprom_read_block(void *buf, const void *addr, size_t len) {
-    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
-    fill_target_address(complete_packet, addr);
+    uint8_t * read_buf    = (uint8_t *)buf;
+    uintptr_t target_addr = (uintptr_t)addr;
+
+#if EXTERNAL_EEPROM_CACHE_LINES > 0
+    if (len <= (EXTERNAL_EEPROM_CACHE_LINES) * (EXTERNAL_EEPROM_CACHE_LINE_SIZE)) {
+        while (len > 0) {
+            uintptr_t line_addr   = target_addr - (target_addr % EXTERNAL_EEPROM_CACHE_LINE_SIZE);
+            size_t    line_offset = target_addr - line_addr;
+            size_t    read_length = MIN(len, EXTERNAL_EEPROM_CACHE_LINE_SIZE - line_offset);
 
-    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE, 100);
-    i2c_receive(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), buf, len, 100);
+            memcpy(read_buf, eeprom_i2c_cache_line(line_addr) + line_offset, read_length);
+
+            read_buf += read_length;
+            target_addr += read_length;
+            len -= read_length;
+        }
+    } else
+#endif // EXTERNAL_EEPROM_CACHE_LINES > 0
+    {
+        /* Reads larger than the cache go directly to the EEPROM, rather than evicting everything. */
+        eeprom_i2c_read_device(target_addr, read_buf, len);
+        eeprom_i2c_apply_pending(target_addr, read_buf, len);
+    }
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
     dprintf("[EEPROM R] 0x%04X: ", ((int)addr));
-    for (size_t i = 0; i < len; ++i) {
+    for (size_t i = 0; i < ((uintptr_t)read_buf - (uintptr_t)buf); ++i) {
         dprintf(" %02X", (int)(((uint8_t *)buf)[i]));
     }
     dprintf("\n");
@@ -95,46 +285,46 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 }
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    uint8_t   complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
-    uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
+    const uint8_t *write_buf   = (const uint8_t *)buf;
+    uintptr_t      target_addr = (uintptr_t)addr;
 
-#if defined(EXTERNAL_EEPROM_WP_PIN)
-    gpio_set_pin_output(EXTERNAL_EEPROM_WP_PIN);
-    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 0);
-#endif
+    eeprom_i2c_cache_update(target_addr, write_buf, len);
 
     while (len > 0) {
-        uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
-        int       write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
-        if (write_length > len) {
-            write_length = len;
-        }
+        uintptr_t page_addr    = target_addr - (target_addr % EXTERNAL_EEPROM_PAGE_SIZE);
+        uint16_t  page_offset  = target_addr - page_addr;
+        uint16_t  write_length = MIN(len, EXTERNAL_EEPROM_PAGE_SIZE - page_offset);
 
-        fill_target_address(complete_packet, (const void *)target_addr);
-        for (uint8_t i = 0; i < write_length; i++) {
-            complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + i] = read_buf[i];
+#if EXTERNAL_EEPROM_WRITE_COALESCE_TIME == 0
+        eeprom_i2c_write_device(target_addr, write_buf, write_length);
+#else
+        if (eeprom_pending.active && eeprom_pending.page_addr != page_addr) {
+            eeprom_i2c_flush_pending();
         }
 
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-        dprintf("[EEPROM W] 0x%04X: ", ((int)target_addr));
-        for (uint8_t i = 0; i < write_length; i++) {
-            dprintf(" %02X", (int)(read_buf[i]));
+        if (!eeprom_pending.active) {
+            eeprom_pending.page_addr = page_addr;
+            eeprom_pending.start     = page_offset;
+            eeprom_pending.end       = page_offset + write_length;
+        } else {
+            /* Fill any gap between the pending writes and this one with the current contents, so a single page write covers both. */
+            if (page_offset > eeprom_pending.end) {
+                eeprom_read_block(&eeprom_pending.data[eeprom_pending.end], (const void *)(page_addr + eeprom_pending.end), page_offset - eeprom_pending.end);
+            }
+            if (page_offset + write_length < eeprom_pending.start) {
+                eeprom_read_block(&eeprom_pending.data[page_offset + write_length], (const void *)(page_addr + page_offset + write_length), eeprom_pending.start - (page_offset + write_length));
+            }
+            eeprom_pending.start = MIN(eeprom_pending.start, page_offset);
+            eeprom_pending.end   = MAX(eeprom_pending.end, page_offset + write_length);
         }
-        dprintf("\n");
-#endif // DEBUG_EEPROM_OUTPUT
 
-        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
-        wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+        memcpy(&eeprom_pending.data[page_offset], write_buf, write_length);
+        eeprom_pending.active     = true;
+        eeprom_pending.last_write = timer_read32();
+#endif // EXTERNAL_EEPROM_WRITE_COALESCE_TIME == 0
 
-        read_buf += write_length;
+        write_buf += write_length;
         target_addr += write_length;
         len -= write_length;
     }
-
-#if defined(EXTERNAL_EEPROM_WP_PIN)
-    /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
-    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 1);
-    gpio_set_pin_input_high(EXTERNAL_EEPROM_WP_PIN);
-#endif
 }
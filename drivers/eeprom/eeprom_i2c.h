@@ -123,3 +123,27 @@
 #ifndef EXTERNAL_EEPROM_WRITE_TIME
 #    define EXTERNAL_EEPROM_WRITE_TIME 5
 #endif
+
+/*
+    The number of bytes fetched from the EEPROM at a time when reading, which
+    must divide the page size. Reads are served from a RAM cache of
+    EXTERNAL_EEPROM_CACHE_LINES of these, which is kept up to date by writes.
+    The cache is disabled unless EXTERNAL_EEPROM_CACHE_LINES is set.
+*/
+#ifndef EXTERNAL_EEPROM_CACHE_LINE_SIZE
+#    define EXTERNAL_EEPROM_CACHE_LINE_SIZE 16
+#endif
+#ifndef EXTERNAL_EEPROM_CACHE_LINES
+#    define EXTERNAL_EEPROM_CACHE_LINES 0
+#endif
+
+/*
+    The number of milliseconds writes are held in RAM waiting for further
+    writes to the same page, so that they can be written to the EEPROM in a
+    single page write. Writes to a different page, or a call to
+    eeprom_driver_flush(), write them out immediately. The default of 0
+    writes out every write immediately, without a page buffer in RAM.
+*/
+#ifndef EXTERNAL_EEPROM_WRITE_COALESCE_TIME
+#    define EXTERNAL_EEPROM_WRITE_COALESCE_TIME 0
+#endif
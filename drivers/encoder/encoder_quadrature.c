@@ -87,6 +87,7 @@ __attribute__((weak)) void encoder_quadrature_post_init_kb(void) {
     extern void encoder_quadrature_handle_read(uint8_t index, uint8_t pin_a_state, uint8_t pin_b_state);
     // Unused normally, but can be used for things like setting up pin-change interrupts in keyboard code.
     // During the interrupt, read the pins then call `encoder_handle_read()` with the pin states and it'll queue up an encoder event if needed.
+    // Alternatively, set up a periodic timer and call `encoder_quadrature_sample()` from it, with ENCODER_QUADRATURE_EXTERNAL_SAMPLING defined.
 }
 
 void encoder_quadrature_post_init(void) {
@@ -206,8 +207,15 @@ void encoder_quadrature_handle_read(uint8_t index, uint8_t pin_a_state, uint8_t
     }
 }
 
-__attribute__((weak)) void encoder_driver_task(void) {
+void encoder_quadrature_sample(void) {
     for (uint8_t i = 0; i < thisCount; i++) {
         encoder_quadrature_handle_read(i, encoder_quadrature_read_pin(i, false), encoder_quadrature_read_pin(i, true));
     }
 }
+
+__attribute__((weak)) void encoder_driver_task(void) {
+#ifndef ENCODER_QUADRATURE_EXTERNAL_SAMPLING
+    // Sampling is done from keyboard code otherwise, decoded steps only need collecting by encoder_task()
+    encoder_quadrature_sample();
+#endif // ENCODER_QUADRATURE_EXTERNAL_SAMPLING
+}
@@ -65,28 +65,66 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 // #define DEBUG_FLASH_SPI_OUTPUT
 
+_Static_assert(EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE <= EXTERNAL_FLASH_PAGE_SIZE, "EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE must not exceed EXTERNAL_FLASH_PAGE_SIZE");
+_Static_assert(EXTERNAL_FLASH_QUEUE_LENGTH > 0 && EXTERNAL_FLASH_QUEUE_LENGTH <= 255, "EXTERNAL_FLASH_QUEUE_LENGTH must be between 1 and 255");
+
+typedef enum {
+    FLASH_OPERATION_WRITE,
+    FLASH_OPERATION_ERASE_SECTOR,
+    FLASH_OPERATION_ERASE_BLOCK,
+} flash_operation_t;
+
+/* A single queued erase or page program. */
+typedef struct {
+    uint8_t          operation;
+    bool             started;
+    bool             last;        // no request continues into the next queued operation
+    uint8_t          completions; // requests sharing the callback below which end with this operation
+    uint16_t         length;
+    uint32_t         addr;
+    uint32_t         deadline;
+    flash_callback_t callback;
+    void *           cb_arg;
+    uint8_t          data[EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE];
+} flash_queue_entry_t;
+
+static struct {
+    flash_queue_entry_t entries[EXTERNAL_FLASH_QUEUE_LENGTH];
+    uint8_t             head;
+    uint8_t             count;
+} flash_queue;
+
 static bool spi_flash_start(void) {
     return spi_start(EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN, EXTERNAL_FLASH_SPI_LSBFIRST, EXTERNAL_FLASH_SPI_MODE, EXTERNAL_FLASH_SPI_CLOCK_DIVISOR);
 }
 
+static flash_status_t spi_flash_read_status(uint8_t *status) {
+    bool res = spi_flash_start();
+    if (!res) {
+        dprint("Failed to start SPI! [spi flash read status]\n");
+        return FLASH_STATUS_ERROR;
+    }
+
+    spi_write(FLASH_CMD_RDSR);
+
+    *status = (uint8_t)spi_read();
+
+    spi_stop();
+
+    return FLASH_STATUS_SUCCESS;
+}
+
 static flash_status_t spi_flash_wait_while_busy(void) {
     uint32_t       deadline = timer_read32() + EXTERNAL_FLASH_SPI_TIMEOUT;
     flash_status_t response = FLASH_STATUS_SUCCESS;
     uint8_t        retval;
 
     do {
-        bool res = spi_flash_start();
-        if (!res) {
+        if (spi_flash_read_status(&retval) != FLASH_STATUS_SUCCESS) {
             dprint("Failed to start SPI! [spi flash wait while busy]\n");
             return FLASH_STATUS_ERROR;
         }
 
-        spi_write(FLASH_CMD_RDSR);
-
-        retval = (uint8_t)spi_read();
-
-        spi_stop();
-
         if (timer_read32() >= deadline) {
             response = FLASH_STATUS_TIMEOUT;
             break;
@@ -127,7 +165,9 @@ static flash_status_t spi_flash_write_disable(void) {
 /* This function is used for read transfer, write transfer and erase transfer. */
 static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t *data, size_t len) {
     flash_status_t response = FLASH_STATUS_SUCCESS;
-    uint8_t        buffer[EXTERNAL_FLASH_ADDRESS_SIZE + 1];
+    uint8_t        buffer[EXTERNAL_FLASH_ADDRESS_SIZE + 2];
+    uint16_t       header_length = EXTERNAL_FLASH_ADDRESS_SIZE + 1;
+    bool           res;
 
     buffer[0] = cmd;
     for (int i = 0; i < EXTERNAL_FLASH_ADDRESS_SIZE; ++i) {
@@ -135,17 +175,24 @@ static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t
         addr >>= 8;
     }
 
-    bool res = spi_flash_start();
+    if (cmd == FLASH_CMD_FASTREAD) {
+        /* Fast reads require a dummy byte before data is returned, but may be clocked faster. */
+        buffer[header_length++] = 0;
+        res                     = spi_start(EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN, EXTERNAL_FLASH_SPI_LSBFIRST, EXTERNAL_FLASH_SPI_MODE, EXTERNAL_FLASH_SPI_FAST_READ_CLOCK_DIVISOR);
+    } else {
+        res = spi_flash_start();
+    }
     if (!res) {
         dprint("Failed to start SPI! [spi flash transmit]\n");
         return FLASH_STATUS_ERROR;
     }
 
-    response = spi_transmit(buffer, sizeof(buffer));
+    response = spi_transmit(buffer, header_length);
 
     if ((!response) && (data != NULL)) {
         switch (cmd) {
             case FLASH_CMD_READ:
+            case FLASH_CMD_FASTREAD:
                 response = spi_receive(data, len);
                 break;
             case FLASH_CMD_PP:
@@ -162,6 +209,282 @@ static flash_status_t spi_flash_transaction(uint8_t cmd, uint32_t addr, uint8_t
     return response;
 }
 
+static flash_status_t spi_flash_check_erase_address(uint32_t addr, uint32_t size) {
+    /* Check that the address exceeds the limit. */
+    if ((addr + size) >= (EXTERNAL_FLASH_SIZE) || ((addr % size) != 0)) {
+        dprintf("Flash erase address over limit! [addr:0x%lx]\n", (uint32_t)addr);
+        return FLASH_STATUS_ERROR;
+    }
+    return FLASH_STATUS_SUCCESS;
+}
+
+static flash_queue_entry_t *spi_flash_queue_head(void) {
+    return flash_queue.count > 0 ? &flash_queue.entries[flash_queue.head] : NULL;
+}
+
+static flash_queue_entry_t *spi_flash_queue_tail(void) {
+    return flash_queue.count > 0 ? &flash_queue.entries[(flash_queue.head + flash_queue.count - 1) % EXTERNAL_FLASH_QUEUE_LENGTH] : NULL;
+}
+
+/* Sends the write-enable and the erase or program command for the queued operation, without waiting for completion. */
+static flash_status_t spi_flash_queue_start(flash_queue_entry_t *entry) {
+    flash_status_t response = spi_flash_write_enable();
+    if (response != FLASH_STATUS_SUCCESS) {
+        dprint("Failed to write-enable! [spi flash queue start]\n");
+        return response;
+    }
+
+    switch (entry->operation) {
+        case FLASH_OPERATION_WRITE:
+            response = spi_flash_transaction(FLASH_CMD_PP, entry->addr, entry->data, entry->length);
+            break;
+        case FLASH_OPERATION_ERASE_SECTOR:
+            response = spi_flash_transaction(FLASH_CMD_SE, entry->addr, NULL, 0);
+            break;
+        case FLASH_OPERATION_ERASE_BLOCK:
+            response = spi_flash_transaction(FLASH_CMD_BE, entry->addr, NULL, 0);
+            break;
+        default:
+            response = FLASH_STATUS_ERROR;
+            break;
+    }
+
+    entry->started  = true;
+    entry->deadline = timer_read32() + EXTERNAL_FLASH_SPI_TIMEOUT;
+    return response;
+}
+
+/*
+    Removes the oldest queued operation, notifying the requests which end with
+    it. A failure also removes the remaining operations of the request, so the
+    requester hears about it straight away and nothing after the failed
+    operation is programmed.
+*/
+static void spi_flash_queue_complete(flash_status_t response) {
+    bool abort;
+    do {
+        flash_queue_entry_t *entry       = spi_flash_queue_head();
+        flash_callback_t     callback    = entry->callback;
+        void *               cb_arg      = entry->cb_arg;
+        uint8_t              completions = entry->completions;
+
+        abort            = response != FLASH_STATUS_SUCCESS && !entry->last;
+        flash_queue.head = (flash_queue.head + 1) % EXTERNAL_FLASH_QUEUE_LENGTH;
+        flash_queue.count--;
+
+        while (callback && completions--) {
+            callback(response, cb_arg);
+        }
+    } while (abort && flash_queue.count > 0);
+}
+
+/*
+    Advances the queue by at most one status poll and one command. Returns the
+    result of any operation which completed.
+*/
+static flash_status_t spi_flash_queue_poll(bool start_next) {
+    flash_status_t       response = FLASH_STATUS_SUCCESS;
+    flash_queue_entry_t *entry    = spi_flash_queue_head();
+
+    if (entry != NULL && entry->started) {
+        uint8_t status;
+        response = spi_flash_read_status(&status);
+        if (response == FLASH_STATUS_SUCCESS && (status & FLASH_FLAG_WIP)) {
+            if (!timer_expired32(timer_read32(), entry->deadline)) {
+                return FLASH_STATUS_SUCCESS;
+            }
+            dprint("Timed out waiting for WIP flag! [spi flash queue poll]\n");
+            response = FLASH_STATUS_TIMEOUT;
+        }
+
+        spi_flash_queue_complete(response);
+        entry = spi_flash_queue_head();
+    }
+
+    if (start_next && response == FLASH_STATUS_SUCCESS && entry != NULL) {
+        response = spi_flash_queue_start(entry);
+        if (response != FLASH_STATUS_SUCCESS) {
+            spi_flash_queue_complete(response);
+        }
+    }
+
+    return response;
+}
+
+/* Waits for the operation currently being performed by the FLASH, if any, leaving the remainder queued. */
+static void spi_flash_queue_wait_for_active(void) {
+    flash_queue_entry_t *entry;
+    while ((entry = spi_flash_queue_head()) != NULL && entry->started) {
+        spi_flash_queue_poll(false);
+    }
+}
+
+/* Allocates a new queue entry, the caller has made sure there is room. */
+static flash_queue_entry_t *spi_flash_queue_push(uint8_t operation, uint32_t addr) {
+    flash_queue_entry_t *entry = &flash_queue.entries[(flash_queue.head + flash_queue.count) % EXTERNAL_FLASH_QUEUE_LENGTH];
+    flash_queue.count++;
+
+    entry->operation   = operation;
+    entry->started     = false;
+    entry->last        = true;
+    entry->completions = 0;
+    entry->length      = 0;
+    entry->addr        = addr;
+    entry->callback    = NULL;
+    entry->cb_arg      = NULL;
+    return entry;
+}
+
+/* Attaches the completion of a request to the operation it ends with. */
+static void spi_flash_queue_set_callback(flash_queue_entry_t *entry, flash_callback_t callback, void *cb_arg) {
+    if (callback) {
+        entry->callback = callback;
+        entry->cb_arg   = cb_arg;
+        entry->completions++;
+    }
+}
+
+/*
+    Whether a write to addr may be appended to the most recently queued write:
+    it has to be contiguous, within the same page, not yet sent, and any
+    request already ending with it has to share the callback.
+*/
+static bool spi_flash_queue_can_merge(const flash_queue_entry_t *entry, uint32_t addr, flash_callback_t callback, void *cb_arg) {
+    if (entry == NULL || entry->started || entry->operation != FLASH_OPERATION_WRITE || entry->addr + entry->length != addr || (addr % EXTERNAL_FLASH_PAGE_SIZE) == 0 || entry->length >= EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE) {
+        return false;
+    }
+    return entry->callback == NULL || callback == NULL || (entry->callback == callback && entry->cb_arg == cb_arg);
+}
+
+/* The number of queue entries a write needs on top of what it can merge into the most recent one. */
+static uint32_t spi_flash_queue_write_entries(uint32_t addr, size_t len, flash_callback_t callback, void *cb_arg) {
+    const flash_queue_entry_t *tail    = spi_flash_queue_tail();
+    uint32_t                   entries = 0;
+    uint32_t                   room    = spi_flash_queue_can_merge(tail, addr, callback, cb_arg) ? EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE - tail->length : 0;
+
+    while (len > 0) {
+        if (room == 0) {
+            entries++;
+            room = EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE;
+        }
+        size_t write_length = MIN(MIN(len, EXTERNAL_FLASH_PAGE_SIZE - (addr % EXTERNAL_FLASH_PAGE_SIZE)), room);
+        addr += write_length;
+        len -= write_length;
+        room = (addr % EXTERNAL_FLASH_PAGE_SIZE) == 0 ? 0 : room - write_length;
+    }
+    return entries;
+}
+
+/* Whether a request needing the given number of new entries can be queued now. */
+static flash_status_t spi_flash_queue_reserve(uint32_t entries) {
+    if (entries > EXTERNAL_FLASH_QUEUE_LENGTH) {
+        dprint("Request does not fit the queue! [spi flash queue reserve]\n");
+        return FLASH_STATUS_ERROR;
+    }
+    return entries > (uint32_t)(EXTERNAL_FLASH_QUEUE_LENGTH - flash_queue.count) ? FLASH_STATUS_BUSY : FLASH_STATUS_SUCCESS;
+}
+
+/* Applies the effect of any queued operations to data read back from the FLASH. */
+static void spi_flash_queue_overlay(uint32_t addr, uint8_t *buf, size_t len) {
+    for (uint8_t i = 0; i < flash_queue.count; ++i) {
+        flash_queue_entry_t *entry = &flash_queue.entries[(flash_queue.head + i) % EXTERNAL_FLASH_QUEUE_LENGTH];
+        uint32_t             size  = entry->operation == FLASH_OPERATION_WRITE ? entry->length : entry->operation == FLASH_OPERATION_ERASE_SECTOR ? (EXTERNAL_FLASH_SECTOR_SIZE) : (EXTERNAL_FLASH_BLOCK_SIZE);
+        uint32_t             start = MAX(addr, entry->addr);
+        uint32_t             end   = MIN(addr + len, entry->addr + size);
+
+        for (uint32_t a = start; a < end; ++a) {
+            if (entry->operation == FLASH_OPERATION_WRITE) {
+                /* Programming can only clear bits. */
+                buf[a - addr] &= entry->data[a - entry->addr];
+            } else {
+                buf[a - addr] = 0xFF;
+            }
+        }
+    }
+}
+
+static flash_status_t spi_flash_erase_async(uint8_t operation, uint32_t addr, uint32_t size, flash_callback_t callback, void *cb_arg) {
+    flash_status_t response = spi_flash_check_erase_address(addr, size);
+    if (response != FLASH_STATUS_SUCCESS) {
+        return response;
+    }
+
+    response = spi_flash_queue_reserve(1);
+    if (response != FLASH_STATUS_SUCCESS) {
+        return response;
+    }
+
+    spi_flash_queue_set_callback(spi_flash_queue_push(operation, addr), callback, cb_arg);
+
+    flash_task();
+    return FLASH_STATUS_SUCCESS;
+}
+
+flash_status_t flash_erase_sector_async(uint32_t addr, flash_callback_t callback, void *cb_arg) {
+    return spi_flash_erase_async(FLASH_OPERATION_ERASE_SECTOR, addr, EXTERNAL_FLASH_SECTOR_SIZE, callback, cb_arg);
+}
+
+flash_status_t flash_erase_block_async(uint32_t addr, flash_callback_t callback, void *cb_arg) {
+    return spi_flash_erase_async(FLASH_OPERATION_ERASE_BLOCK, addr, EXTERNAL_FLASH_BLOCK_SIZE, callback, cb_arg);
+}
+
+flash_status_t flash_write_block_async(uint32_t addr, const void *buf, size_t len, flash_callback_t callback, void *cb_arg) {
+    const uint8_t *write_buf = (const uint8_t *)buf;
+
+    /* Either the whole request is queued or nothing of it. */
+    flash_status_t response = spi_flash_queue_reserve(spi_flash_queue_write_entries(addr, len, callback, cb_arg));
+    if (response != FLASH_STATUS_SUCCESS) {
+        return response;
+    }
+
+    bool first = true;
+    while (len > 0) {
+        uint32_t             page_remaining = EXTERNAL_FLASH_PAGE_SIZE - (addr % EXTERNAL_FLASH_PAGE_SIZE);
+        flash_queue_entry_t *entry          = spi_flash_queue_tail();
+
+        /* Merge with the most recently queued write if possible, within the request it always is unless a page or the entry is full. */
+        if (first ? !spi_flash_queue_can_merge(entry, addr, callback, cb_arg) : (addr % EXTERNAL_FLASH_PAGE_SIZE) == 0 || entry->length >= EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE) {
+            entry = spi_flash_queue_push(FLASH_OPERATION_WRITE, addr);
+        }
+        first = false;
+
+        size_t write_length = MIN(MIN(len, page_remaining), EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE - entry->length);
+        memcpy(&entry->data[entry->length], write_buf, write_length);
+        entry->length += write_length;
+
+        write_buf += write_length;
+        addr += write_length;
+        len -= write_length;
+
+        entry->last = (len == 0);
+        if (entry->last) {
+            spi_flash_queue_set_callback(entry, callback, cb_arg);
+        }
+    }
+
+    flash_task();
+    return FLASH_STATUS_SUCCESS;
+}
+
+bool flash_is_busy(void) {
+    return flash_queue.count > 0;
+}
+
+flash_status_t flash_flush(void) {
+    flash_status_t response = FLASH_STATUS_SUCCESS;
+    while (flash_queue.count > 0) {
+        flash_status_t status = spi_flash_queue_poll(true);
+        if (response == FLASH_STATUS_SUCCESS) {
+            response = status;
+        }
+    }
+    return response;
+}
+
+void flash_task(void) {
+    spi_flash_queue_poll(true);
+}
+
 void flash_init(void) {
     spi_init();
 }
@@ -169,6 +492,9 @@ void flash_init(void) {
 flash_status_t flash_erase_chip(void) {
     flash_status_t response = FLASH_STATUS_SUCCESS;
 
+    /* Complete any queued operations first. */
+    flash_flush();
+
     /* Wait for the write-in-progress bit to be cleared. */
     response = spi_flash_wait_while_busy();
     if (response != FLASH_STATUS_SUCCESS) {
@@ -203,14 +529,14 @@ flash_status_t flash_erase_chip(void) {
 }
 
 flash_status_t flash_erase_sector(uint32_t addr) {
-    flash_status_t response = FLASH_STATUS_SUCCESS;
-
-    /* Check that the address exceeds the limit. */
-    if ((addr + (EXTERNAL_FLASH_SECTOR_SIZE)) >= (EXTERNAL_FLASH_SIZE) || ((addr % (EXTERNAL_FLASH_SECTOR_SIZE)) != 0)) {
-        dprintf("Flash erase sector address over limit! [addr:0x%lx]\n", (uint32_t)addr);
-        return FLASH_STATUS_ERROR;
+    flash_status_t response = spi_flash_check_erase_address(addr, EXTERNAL_FLASH_SECTOR_SIZE);
+    if (response != FLASH_STATUS_SUCCESS) {
+        return response;
     }
 
+    /* Complete any queued operations first. */
+    flash_flush();
+
     /* Wait for the write-in-progress bit to be cleared. */
     response = spi_flash_wait_while_busy();
     if (response != FLASH_STATUS_SUCCESS) {
@@ -243,14 +569,14 @@ flash_status_t flash_erase_sector(uint32_t addr) {
 }
 
 flash_status_t flash_erase_block(uint32_t addr) {
-    flash_status_t response = FLASH_STATUS_SUCCESS;
-
-    /* Check that the address exceeds the limit. */
-    if ((addr + (EXTERNAL_FLASH_BLOCK_SIZE)) >= (EXTERNAL_FLASH_SIZE) || ((addr % (EXTERNAL_FLASH_BLOCK_SIZE)) != 0)) {
-        dprintf("Flash erase block address over limit! [addr:0x%lx]\n", (uint32_t)addr);
-        return FLASH_STATUS_ERROR;
+    flash_status_t response = spi_flash_check_erase_address(addr, EXTERNAL_FLASH_BLOCK_SIZE);
+    if (response != FLASH_STATUS_SUCCESS) {
+        return response;
     }
 
+    /* Complete any queued operations first. */
+    flash_flush();
+
     /* Wait for the write-in-progress bit to be cleared. */
     response = spi_flash_wait_while_busy();
     if (response != FLASH_STATUS_SUCCESS) {
@@ -286,6 +612,9 @@ flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len) {
     flash_status_t response = FLASH_STATUS_SUCCESS;
     uint8_t *      read_buf = (uint8_t *)buf;
 
+    /* Only the operation already in progress needs to complete -- anything still queued is applied afterwards. */
+    spi_flash_queue_wait_for_active();
+
     /* Wait for the write-in-progress bit to be cleared. */
     response = spi_flash_wait_while_busy();
     if (response != FLASH_STATUS_SUCCESS) {
@@ -295,13 +624,20 @@ flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len) {
     }
 
     /* Perform read. */
+#ifdef EXTERNAL_FLASH_FAST_READ
+    response = spi_flash_transaction(FLASH_CMD_FASTREAD, addr, read_buf, len);
+#else
     response = spi_flash_transaction(FLASH_CMD_READ, addr, read_buf, len);
+#endif
     if (response != FLASH_STATUS_SUCCESS) {
         dprint("Failed to read block! [spi flash read block]\n");
         memset(read_buf, 0, len);
         return response;
     }
 
+    /* Reflect any writes or erases which have not yet been performed. */
+    spi_flash_queue_overlay(addr, read_buf, len);
+
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_FLASH_SPI_OUTPUT)
     dprintf("[SPI FLASH R] 0x%08lx: ", addr);
     for (size_t i = 0; i < len; ++i) {
@@ -317,6 +653,9 @@ flash_status_t flash_write_block(uint32_t addr, const void *buf, size_t len) {
     flash_status_t response  = FLASH_STATUS_SUCCESS;
     uint8_t *      write_buf = (uint8_t *)buf;
 
+    /* Complete any queued operations first. */
+    flash_flush();
+
     while (len > 0) {
         uint32_t page_offset  = addr % EXTERNAL_FLASH_PAGE_SIZE;
         size_t   write_length = EXTERNAL_FLASH_PAGE_SIZE - page_offset;
@@ -106,19 +106,59 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #define EXTERNAL_FLASH_PAGE_COUNT ((EXTERNAL_FLASH_SIZE) / (EXTERNAL_FLASH_PAGE_SIZE))
 
+/*
+    The number of operations which can be queued by the asynchronous API. A
+    request which doesn't fit the remaining room is refused with
+    FLASH_STATUS_BUSY.
+*/
+#ifndef EXTERNAL_FLASH_QUEUE_LENGTH
+#    define EXTERNAL_FLASH_QUEUE_LENGTH 4
+#endif
+
+/*
+    The largest number of bytes programmed by a single queued write, which is
+    also the amount of RAM reserved for each queued operation. Contiguous
+    queued writes within the same page are merged up to this size.
+*/
+#ifndef EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE
+#    define EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE 64
+#endif
+
+/*
+    Whether or not reads should use the FAST READ command, which permits a
+    higher SPI clock than the standard READ command on most FLASH chips.
+*/
+// #define EXTERNAL_FLASH_FAST_READ
+
+/*
+    The clock divisor for SPI used when issuing FAST READ commands.
+*/
+#ifndef EXTERNAL_FLASH_SPI_FAST_READ_CLOCK_DIVISOR
+#    define EXTERNAL_FLASH_SPI_FAST_READ_CLOCK_DIVISOR EXTERNAL_FLASH_SPI_CLOCK_DIVISOR
+#endif
+
 typedef int16_t flash_status_t;
 
 #define FLASH_STATUS_SUCCESS (0)
 #define FLASH_STATUS_ERROR (-1)
 #define FLASH_STATUS_TIMEOUT (-2)
 #define FLASH_STATUS_BAD_ADDRESS (-3)
+#define FLASH_STATUS_BUSY (-4)
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+/*
+    Invoked once a queued operation has completed, with the result of the
+    operation.
+*/
+typedef void (*flash_callback_t)(flash_status_t status, void *cb_arg);
+
 void flash_init(void);
 
 flash_status_t flash_erase_chip(void);
@@ -131,6 +171,31 @@ flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len);
 
 flash_status_t flash_write_block(uint32_t addr, const void *buf, size_t len);
 
+/*
+    Asynchronous API -- operations are queued and return immediately, and are
+    performed by flash_task() without waiting for the FLASH to complete each
+    erase or program. Data is copied on submission, so the supplied buffer may
+    be reused straight away. Reads issued through flash_read_block() include
+    the effect of any operations still in the queue. Synchronous operations
+    complete any queued operations beforehand, preserving ordering.
+
+    A request is queued as a whole or not at all: FLASH_STATUS_BUSY is returned
+    while the queue lacks room for it, FLASH_STATUS_ERROR if it can never fit.
+    If one of its operations fails, the rest of the request is dropped and the
+    callback is invoked with the failure straight away.
+*/
+flash_status_t flash_erase_block_async(uint32_t addr, flash_callback_t callback, void *cb_arg);
+
+flash_status_t flash_erase_sector_async(uint32_t addr, flash_callback_t callback, void *cb_arg);
+
+flash_status_t flash_write_block_async(uint32_t addr, const void *buf, size_t len, flash_callback_t callback, void *cb_arg);
+
+bool flash_is_busy(void);
+
+flash_status_t flash_flush(void);
+
+void flash_task(void);
+
 #ifdef __cplusplus
 }
 #endif
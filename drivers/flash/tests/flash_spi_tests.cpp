@@ -0,0 +1,298 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+#include "spi_flash_fake.hpp"
+
+#define TEST_SECTOR (4 * (EXTERNAL_FLASH_SECTOR_SIZE))
+
+class FlashSpi : public ::testing::Test {
+   protected:
+    struct completion {
+        int            count  = 0;
+        flash_status_t status = FLASH_STATUS_ERROR;
+    };
+
+    static void on_complete(flash_status_t status, void *cb_arg) {
+        auto c = static_cast<completion *>(cb_arg);
+        ++c->count;
+        c->status = status;
+    }
+
+    void SetUp() override {
+        SpiFlashFake::Instance().reset_instance();
+        flash_init();
+    }
+
+    void TearDown() override {
+        // Don't leave anything queued for the next test
+        run_until_idle();
+        EXPECT_EQ(SpiFlashFake::Instance().violation_count(), 0) << "Commands were issued which the FLASH would have ignored";
+    }
+
+    // Runs the flash task from the main loop until all queued operations have completed
+    static void run_until_idle() {
+        auto &fake = SpiFlashFake::Instance();
+        while (flash_is_busy()) {
+            fake.advance(100);
+            flash_task();
+        }
+    }
+
+    static std::vector<std::uint8_t> pattern(std::size_t length, std::uint8_t seed) {
+        std::vector<std::uint8_t> data(length);
+        for (std::size_t i = 0; i < length; ++i) {
+            data[i] = (std::uint8_t)(seed + i * 7);
+        }
+        return data;
+    }
+};
+
+/**
+ * This test verifies that a queued write returns without waiting for the page program to complete.
+ */
+TEST_F(FlashSpi, WriteAsync_DoesNotWaitForProgram) {
+    auto &     fake = SpiFlashFake::Instance();
+    completion done;
+    auto       data = pattern(32, 1);
+
+    std::uint64_t start = fake.elapsed_time();
+    EXPECT_EQ(flash_write_block_async(TEST_SECTOR, data.data(), data.size(), on_complete, &done), FLASH_STATUS_SUCCESS);
+    EXPECT_LT(fake.elapsed_time() - start, SpiFlashFake::PROGRAM_DURATION) << "Write should not wait for the program to complete";
+    EXPECT_TRUE(flash_is_busy());
+    EXPECT_EQ(done.count, 0) << "Callback should not be invoked before the program completes";
+
+    run_until_idle();
+    EXPECT_EQ(done.count, 1) << "Callback should be invoked exactly once";
+    EXPECT_EQ(done.status, FLASH_STATUS_SUCCESS);
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), fake.data() + TEST_SECTOR)) << "Data was not programmed";
+}
+
+/**
+ * This test verifies that queued erases return without waiting, and that queueing more operations than fit is refused rather than waited for.
+ */
+TEST_F(FlashSpi, EraseAsync_DoesNotWaitForErase) {
+    auto &     fake = SpiFlashFake::Instance();
+    completion done[EXTERNAL_FLASH_QUEUE_LENGTH + 1];
+    std::fill_n(fake.data(), (EXTERNAL_FLASH_QUEUE_LENGTH + 1) * (EXTERNAL_FLASH_SECTOR_SIZE), 0x00);
+
+    std::uint64_t start = fake.elapsed_time();
+    for (int i = 0; i < EXTERNAL_FLASH_QUEUE_LENGTH; ++i) {
+        EXPECT_EQ(flash_erase_sector_async(i * (EXTERNAL_FLASH_SECTOR_SIZE), on_complete, &done[i]), FLASH_STATUS_SUCCESS);
+    }
+    EXPECT_LT(fake.elapsed_time() - start, SpiFlashFake::SECTOR_ERASE_DURATION) << "Erases should not wait for completion";
+
+    // The queue is full, so this one is refused until the oldest erase has completed
+    start = fake.elapsed_time();
+    EXPECT_EQ(flash_erase_sector_async(EXTERNAL_FLASH_QUEUE_LENGTH * (EXTERNAL_FLASH_SECTOR_SIZE), on_complete, &done[EXTERNAL_FLASH_QUEUE_LENGTH]), FLASH_STATUS_BUSY);
+    EXPECT_LT(fake.elapsed_time() - start, SpiFlashFake::SECTOR_ERASE_DURATION) << "A full queue should not be waited for";
+    EXPECT_EQ(done[0].count, 0);
+
+    while (done[0].count == 0) {
+        fake.advance(100);
+        flash_task();
+    }
+    EXPECT_EQ(flash_erase_sector_async(EXTERNAL_FLASH_QUEUE_LENGTH * (EXTERNAL_FLASH_SECTOR_SIZE), on_complete, &done[EXTERNAL_FLASH_QUEUE_LENGTH]), FLASH_STATUS_SUCCESS);
+
+    run_until_idle();
+    for (auto &d : done) {
+        EXPECT_EQ(d.count, 1);
+        EXPECT_EQ(d.status, FLASH_STATUS_SUCCESS);
+    }
+    EXPECT_TRUE(std::all_of(fake.data(), fake.data() + (EXTERNAL_FLASH_QUEUE_LENGTH + 1) * (EXTERNAL_FLASH_SECTOR_SIZE), [](std::uint8_t v) { return v == 0xFF; })) << "Sectors were not erased";
+}
+
+/**
+ * This test verifies that reads reflect queued erases and writes before the FLASH has performed them.
+ */
+TEST_F(FlashSpi, ReadBlock_ReflectsQueuedOperations) {
+    auto &fake = SpiFlashFake::Instance();
+    auto  data = pattern(100, 2);
+    std::fill_n(fake.data() + TEST_SECTOR, EXTERNAL_FLASH_SECTOR_SIZE, 0x00);
+
+    EXPECT_EQ(flash_erase_sector_async(TEST_SECTOR, NULL, NULL), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(flash_write_block_async(TEST_SECTOR + 200, data.data(), data.size(), NULL, NULL), FLASH_STATUS_SUCCESS);
+
+    std::vector<std::uint8_t> actual(512);
+    EXPECT_EQ(flash_read_block(TEST_SECTOR, actual.data(), actual.size()), FLASH_STATUS_SUCCESS);
+    EXPECT_TRUE(flash_is_busy()) << "Queued writes should not have been waited for";
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+        std::uint8_t expected = (i >= 200 && i < 300) ? data[i - 200] : 0xFF;
+        ASSERT_EQ(actual[i], expected) << "Incorrect readback at offset " << i;
+    }
+
+    run_until_idle();
+    std::vector<std::uint8_t> after(512);
+    EXPECT_EQ(flash_read_block(TEST_SECTOR, after.data(), after.size()), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(after, actual) << "Readback changed once the queued operations were performed";
+}
+
+/**
+ * This test verifies that small contiguous writes are merged into as few page programs as possible.
+ */
+TEST_F(FlashSpi, SmallWrites_AreBatchedIntoPagePrograms) {
+    auto &fake = SpiFlashFake::Instance();
+    auto  data = pattern(EXTERNAL_FLASH_PAGE_SIZE, 3);
+
+    for (std::size_t i = 0; i < data.size(); i += 4) {
+        flash_status_t status;
+        while ((status = flash_write_block_async(TEST_SECTOR + i, &data[i], 4, NULL, NULL)) == FLASH_STATUS_BUSY) {
+            fake.advance(100);
+            flash_task();
+        }
+        EXPECT_EQ(status, FLASH_STATUS_SUCCESS);
+    }
+    run_until_idle();
+
+    // The first write is sent straight away as the FLASH is idle, the remainder queue up behind it
+    EXPECT_EQ(fake.command_count(SpiFlashFake::CMD_PP), 1 + (EXTERNAL_FLASH_PAGE_SIZE) / (EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE)) << "Writes were not batched";
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), fake.data() + TEST_SECTOR)) << "Data was not programmed";
+}
+
+/**
+ * This test verifies that writes spanning page boundaries are split, as page programs wrap around within a page.
+ */
+TEST_F(FlashSpi, WriteAcrossPages_IsSplitAtPageBoundaries) {
+    auto &     fake = SpiFlashFake::Instance();
+    auto       data = pattern(60, 4);
+    completion done;
+
+    // The last 20 bytes of one page and the first 40 of the next
+    EXPECT_EQ(flash_write_block_async(TEST_SECTOR + (EXTERNAL_FLASH_PAGE_SIZE)-20, data.data(), data.size(), on_complete, &done), FLASH_STATUS_SUCCESS);
+    run_until_idle();
+
+    EXPECT_EQ(fake.command_count(SpiFlashFake::CMD_PP), 2);
+    EXPECT_EQ(done.count, 1) << "Callback should only be invoked once the entire write has completed";
+    EXPECT_EQ(done.status, FLASH_STATUS_SUCCESS);
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), fake.data() + TEST_SECTOR + (EXTERNAL_FLASH_PAGE_SIZE)-20)) << "Data was not programmed";
+}
+
+/**
+ * This test verifies that a write which could never fit the queue is refused without queueing any of it.
+ */
+TEST_F(FlashSpi, OversizedWrite_IsRefused) {
+    auto &     fake = SpiFlashFake::Instance();
+    auto       data = pattern((EXTERNAL_FLASH_QUEUE_LENGTH) * (EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE) + 1, 8);
+    completion done;
+
+    EXPECT_EQ(flash_write_block_async(TEST_SECTOR, data.data(), data.size(), on_complete, &done), FLASH_STATUS_ERROR);
+    EXPECT_FALSE(flash_is_busy());
+    EXPECT_EQ(done.count, 0);
+    EXPECT_EQ(fake.command_count(SpiFlashFake::CMD_PP), 0);
+}
+
+/**
+ * This test verifies that writes sharing a completion callback are merged, and the callback is invoked once per request.
+ */
+TEST_F(FlashSpi, WritesWithSameCallback_AreMerged) {
+    auto &     fake = SpiFlashFake::Instance();
+    auto       data = pattern(32, 9);
+    completion done, other;
+
+    // Keep the FLASH busy so the writes queue up behind the erase
+    EXPECT_EQ(flash_erase_sector_async(TEST_SECTOR, NULL, NULL), FLASH_STATUS_SUCCESS);
+    for (std::size_t i = 0; i < 16; i += 4) {
+        EXPECT_EQ(flash_write_block_async(TEST_SECTOR + i, &data[i], 4, on_complete, &done), FLASH_STATUS_SUCCESS);
+    }
+    // A different argument cannot share the program
+    EXPECT_EQ(flash_write_block_async(TEST_SECTOR + 16, &data[16], 16, on_complete, &other), FLASH_STATUS_SUCCESS);
+    run_until_idle();
+
+    EXPECT_EQ(fake.command_count(SpiFlashFake::CMD_PP), 2) << "Writes with the same callback were not batched";
+    EXPECT_EQ(done.count, 4) << "Callback should be invoked once for each request";
+    EXPECT_EQ(done.status, FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(other.count, 1);
+    EXPECT_EQ(other.status, FLASH_STATUS_SUCCESS);
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), fake.data() + TEST_SECTOR)) << "Data was not programmed";
+}
+
+/**
+ * This test verifies that synchronous operations are performed after any queued operations.
+ */
+TEST_F(FlashSpi, SynchronousOperations_PreserveOrdering) {
+    auto &fake = SpiFlashFake::Instance();
+    auto  data = pattern(64, 5);
+
+    // A queued write followed by a synchronous erase leaves the sector erased
+    EXPECT_EQ(flash_write_block_async(TEST_SECTOR, data.data(), data.size(), NULL, NULL), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(flash_erase_sector(TEST_SECTOR), FLASH_STATUS_SUCCESS);
+    EXPECT_FALSE(flash_is_busy());
+    EXPECT_TRUE(std::all_of(fake.data() + TEST_SECTOR, fake.data() + TEST_SECTOR + data.size(), [](std::uint8_t v) { return v == 0xFF; })) << "Erase was performed before the queued write";
+
+    // A queued erase followed by a synchronous write leaves the data written
+    std::fill_n(fake.data() + TEST_SECTOR, EXTERNAL_FLASH_SECTOR_SIZE, 0x00);
+    EXPECT_EQ(flash_erase_sector_async(TEST_SECTOR, NULL, NULL), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(flash_write_block(TEST_SECTOR, data.data(), data.size()), FLASH_STATUS_SUCCESS);
+    EXPECT_FALSE(flash_is_busy());
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), fake.data() + TEST_SECTOR)) << "Write was performed before the queued erase";
+}
+
+/**
+ * This test verifies that an operation which never completes is reported through its callback.
+ */
+TEST_F(FlashSpi, StuckOperation_ReportsTimeout) {
+    auto &     fake = SpiFlashFake::Instance();
+    completion erase_done, write_done;
+    auto       data = pattern(16, 6);
+
+    EXPECT_EQ(flash_erase_sector_async(TEST_SECTOR, on_complete, &erase_done), FLASH_STATUS_SUCCESS);
+    fake.set_stuck(true);
+    EXPECT_EQ(flash_write_block_async(TEST_SECTOR, data.data(), data.size(), on_complete, &write_done), FLASH_STATUS_SUCCESS);
+
+    while (erase_done.count == 0) {
+        fake.advance(100000);
+        flash_task();
+    }
+    EXPECT_EQ(erase_done.status, FLASH_STATUS_TIMEOUT);
+    fake.set_stuck(false);
+    run_until_idle();
+    EXPECT_EQ(write_done.count, 1);
+    EXPECT_EQ(write_done.status, FLASH_STATUS_SUCCESS);
+}
+
+/**
+ * This test verifies that a failed program drops the rest of its request, reporting the failure straight away, while later requests still run.
+ */
+TEST_F(FlashSpi, FailedOperation_AbortsRestOfRequest) {
+    auto &     fake = SpiFlashFake::Instance();
+    completion write_done, erase_done;
+    auto       data = pattern(3 * (EXTERNAL_FLASH_QUEUE_PROGRAM_SIZE), 10);
+
+    EXPECT_EQ(flash_write_block_async(TEST_SECTOR, data.data(), data.size(), on_complete, &write_done), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(flash_erase_sector_async(TEST_SECTOR + (EXTERNAL_FLASH_SECTOR_SIZE), on_complete, &erase_done), FLASH_STATUS_SUCCESS);
+    fake.set_stuck(true);
+
+    while (write_done.count == 0) {
+        fake.advance(100000);
+        flash_task();
+    }
+    EXPECT_EQ(write_done.status, FLASH_STATUS_TIMEOUT);
+    EXPECT_EQ(fake.command_count(SpiFlashFake::CMD_PP), 1) << "Remainder of the failed write should not have been programmed";
+    EXPECT_EQ(erase_done.count, 0);
+
+    fake.set_stuck(false);
+    run_until_idle();
+    EXPECT_EQ(write_done.count, 1) << "Callback should be invoked exactly once";
+    EXPECT_EQ(fake.command_count(SpiFlashFake::CMD_PP), 1);
+    EXPECT_EQ(erase_done.count, 1);
+    EXPECT_EQ(erase_done.status, FLASH_STATUS_SUCCESS);
+}
+
+#ifdef EXTERNAL_FLASH_FAST_READ
+/**
+ * This test verifies that reads use the FAST READ command at the configured clock divisor.
+ */
+TEST_F(FlashSpi, FastRead_UsedForReads) {
+    auto &fake = SpiFlashFake::Instance();
+    auto  data = pattern(300, 7);
+    std::copy(data.begin(), data.end(), fake.data() + TEST_SECTOR);
+
+    std::vector<std::uint8_t> actual(data.size());
+    EXPECT_EQ(flash_read_block(TEST_SECTOR, actual.data(), actual.size()), FLASH_STATUS_SUCCESS);
+    EXPECT_EQ(actual, data);
+    EXPECT_EQ(fake.command_count(SpiFlashFake::CMD_FASTREAD), 1);
+    EXPECT_EQ(fake.command_count(SpiFlashFake::CMD_READ), 0);
+    EXPECT_EQ(fake.divisor(), EXTERNAL_FLASH_SPI_FAST_READ_CLOCK_DIVISOR);
+}
+#endif // EXTERNAL_FLASH_FAST_READ
@@ -0,0 +1,18 @@
+flash_spi_DEFS := \
+	-DEXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN=0 \
+	-DNO_PRINT \
+	-DNO_DEBUG
+flash_spi_INC := \
+	$(DRIVER_PATH)/flash/tests \
+	$(DRIVER_PATH)/flash
+flash_spi_SRC := \
+	$(DRIVER_PATH)/flash/flash_spi.c \
+	$(DRIVER_PATH)/flash/tests/spi_flash_fake.cpp \
+	$(DRIVER_PATH)/flash/tests/flash_spi_tests.cpp
+
+flash_spi_fast_read_DEFS := \
+	$(flash_spi_DEFS) \
+	-DEXTERNAL_FLASH_FAST_READ \
+	-DEXTERNAL_FLASH_SPI_FAST_READ_CLOCK_DIVISOR=2
+flash_spi_fast_read_INC := $(flash_spi_INC)
+flash_spi_fast_read_SRC := $(flash_spi_SRC)
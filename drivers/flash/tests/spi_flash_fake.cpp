@@ -0,0 +1,176 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "gtest/gtest.h"
+#include "spi_flash_fake.hpp"
+
+SpiFlashFake SpiFlashFake::instance;
+
+void SpiFlashFake::reset_instance() {
+    storage.assign(EXTERNAL_FLASH_SIZE, 0xFF);
+    command_counts.fill(0);
+    now           = 0;
+    busy_until    = 0;
+    write_enabled = false;
+    stuck         = false;
+    selected      = false;
+    violations    = 0;
+    last_divisor  = 0;
+}
+
+bool SpiFlashFake::start(std::uint16_t divisor) {
+    EXPECT_FALSE(selected) << "SPI transaction started while another was in progress";
+    selected      = true;
+    last_divisor  = divisor;
+    current_phase = phase::command;
+    address       = 0;
+    address_bytes = 0;
+    program_data.clear();
+    now += TRANSACTION_DURATION;
+    return true;
+}
+
+void SpiFlashFake::begin_data_phase() {
+    current_phase = (command == CMD_FASTREAD) ? phase::dummy : phase::data;
+}
+
+uint8_t SpiFlashFake::transfer(std::uint8_t value) {
+    EXPECT_TRUE(selected) << "SPI transfer without an active transaction";
+    switch (current_phase) {
+        case phase::command:
+            command = value;
+            ++command_counts[command];
+            if (command != CMD_RDSR && busy()) {
+                ++violations;
+            }
+            switch (command) {
+                case CMD_PP:
+                case CMD_READ:
+                case CMD_FASTREAD:
+                case CMD_SE:
+                case CMD_BE:
+                    current_phase = phase::address;
+                    break;
+                default:
+                    current_phase = phase::data;
+                    break;
+            }
+            return 0xFF;
+        case phase::address:
+            address = (address << 8) | value;
+            if (++address_bytes == EXTERNAL_FLASH_ADDRESS_SIZE) {
+                begin_data_phase();
+            }
+            return 0xFF;
+        case phase::dummy:
+            current_phase = phase::data;
+            return 0xFF;
+        case phase::data:
+            break;
+    }
+
+    switch (command) {
+        case CMD_RDSR:
+            return (busy() ? 0x01 : 0x00) | (write_enabled ? 0x02 : 0x00);
+        case CMD_READ:
+        case CMD_FASTREAD:
+            return storage[address++ % storage.size()];
+        case CMD_PP:
+            program_data.push_back(value);
+            return 0xFF;
+        default:
+            return 0xFF;
+    }
+}
+
+void SpiFlashFake::stop() {
+    EXPECT_TRUE(selected) << "SPI transaction stopped without being started";
+    selected = false;
+    if (current_phase == phase::command) {
+        return;
+    }
+
+    // Erases and programs only take effect once chip select is released
+    std::uint64_t duration = 0;
+    switch (command) {
+        case CMD_WREN:
+            write_enabled = true;
+            return;
+        case CMD_WRDI:
+            write_enabled = false;
+            return;
+        case CMD_PP: {
+            std::uint32_t page = address & ~(std::uint32_t)(EXTERNAL_FLASH_PAGE_SIZE - 1);
+            for (std::size_t i = 0; i < program_data.size(); ++i) {
+                // Programming past the end of a page wraps around to the start of the same page
+                std::uint32_t a = page | ((address + i) & (EXTERNAL_FLASH_PAGE_SIZE - 1));
+                storage[a % storage.size()] &= program_data[i];
+            }
+            duration = PROGRAM_DURATION;
+            break;
+        }
+        case CMD_SE:
+            std::fill_n(storage.begin() + (address & ~(std::uint32_t)(EXTERNAL_FLASH_SECTOR_SIZE - 1)), EXTERNAL_FLASH_SECTOR_SIZE, 0xFF);
+            duration = SECTOR_ERASE_DURATION;
+            break;
+        case CMD_BE:
+            std::fill_n(storage.begin() + (address & ~(std::uint32_t)(EXTERNAL_FLASH_BLOCK_SIZE - 1)), EXTERNAL_FLASH_BLOCK_SIZE, 0xFF);
+            duration = BLOCK_ERASE_DURATION;
+            break;
+        case CMD_CE:
+            std::fill(storage.begin(), storage.end(), 0xFF);
+            duration = BLOCK_ERASE_DURATION * EXTERNAL_FLASH_BLOCK_COUNT;
+            break;
+        default:
+            return;
+    }
+
+    if (!write_enabled) {
+        ++violations;
+        return;
+    }
+    write_enabled = false;
+    busy_until    = now + duration;
+}
+
+extern "C" {
+
+void spi_init(void) {}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    return SpiFlashFake::Instance().start(divisor);
+}
+
+spi_status_t spi_write(uint8_t data) {
+    return SpiFlashFake::Instance().transfer(data);
+}
+
+spi_status_t spi_read(void) {
+    return SpiFlashFake::Instance().transfer(0xFF);
+}
+
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; ++i) {
+        SpiFlashFake::Instance().transfer(data[i]);
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    for (uint16_t i = 0; i < length; ++i) {
+        data[i] = SpiFlashFake::Instance().transfer(0xFF);
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+void spi_stop(void) {
+    SpiFlashFake::Instance().stop();
+}
+
+uint32_t timer_read32(void) {
+    return (uint32_t)(SpiFlashFake::Instance().elapsed_time() / 1000);
+}
+
+uint16_t timer_read(void) {
+    return (uint16_t)timer_read32();
+}
+}
@@ -0,0 +1,110 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include "flash_spi.h"
+#include "spi_master.h"
+};
+
+/**
+ * Emulates a SPI NOR flash chip, including the write-enable latch, page program wrap-around, and the time taken by erases
+ * and programs. Time only advances through SPI transactions or explicit calls to advance(), and is exposed to the driver
+ * through timer_read32().
+ */
+class SpiFlashFake {
+   private:
+    static SpiFlashFake instance;
+
+    enum class phase { command, address, dummy, data };
+
+    std::vector<std::uint8_t>      storage;
+    std::array<std::uint8_t, 256>  command_counts;
+    std::uint64_t                  now;
+    std::uint64_t                  busy_until;
+    bool                           write_enabled;
+    bool                           stuck;
+    bool                           selected;
+    std::uint32_t                  violations;
+    std::uint16_t                  last_divisor;
+    phase                          current_phase;
+    std::uint8_t                   command;
+    std::uint32_t                  address;
+    std::uint8_t                   address_bytes;
+    std::vector<std::uint8_t>      program_data;
+
+    void begin_data_phase();
+
+   public:
+    // Commands understood by the emulated chip
+    enum : std::uint8_t {
+        CMD_WRSR     = 0x01,
+        CMD_PP       = 0x02,
+        CMD_READ     = 0x03,
+        CMD_WRDI     = 0x04,
+        CMD_RDSR     = 0x05,
+        CMD_WREN     = 0x06,
+        CMD_FASTREAD = 0x0B,
+        CMD_SE       = 0x20,
+        CMD_CE       = 0x60,
+        CMD_BE       = 0xD8,
+    };
+
+    // Simulated durations, in microseconds
+    enum : std::uint64_t {
+        TRANSACTION_DURATION  = 1,
+        PROGRAM_DURATION      = 700,
+        SECTOR_ERASE_DURATION = 45000,
+        BLOCK_ERASE_DURATION  = 500000,
+    };
+
+    static SpiFlashFake& Instance() {
+        return instance;
+    }
+
+    void reset_instance();
+
+    // Time since reset, in microseconds
+    std::uint64_t elapsed_time() const {
+        return now;
+    }
+    void advance(std::uint64_t duration) {
+        now += duration;
+    }
+
+    // Whether an erase or program is still in progress
+    bool busy() const {
+        return stuck || now < busy_until;
+    }
+    // Simulates a chip which never completes an erase or program
+    void set_stuck(bool s) {
+        stuck = s;
+    }
+
+    // Number of times the given command has been issued
+    std::uint32_t command_count(std::uint8_t cmd) const {
+        return command_counts[cmd];
+    }
+    // Number of commands issued which a real chip would have ignored or corrupted, such as a program while busy
+    std::uint32_t violation_count() const {
+        return violations;
+    }
+    // Clock divisor used by the most recent transaction
+    std::uint16_t divisor() const {
+        return last_divisor;
+    }
+
+    std::uint8_t* data() {
+        return storage.data();
+    }
+    std::size_t size() const {
+        return storage.size();
+    }
+
+    bool    start(std::uint16_t divisor);
+    uint8_t transfer(std::uint8_t value);
+    void    stop();
+};
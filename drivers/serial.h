@@ -28,6 +28,13 @@ void soft_serial_target_init(void);
 
 bool soft_serial_transaction(int sstd_index);
 
+#ifdef SERIAL_USART_STREAMING
+// target pushes the given transactions' data to the initiator as one batch
+void soft_serial_target_push(const int8_t *sstd_indices, uint8_t count);
+// initiator makes completed pushes visible in the shared memory
+void soft_serial_initiator_apply_pushes(void);
+#endif
+
 #ifdef SERIAL_DEBUG
 #    include <debug.h>
 #    include <print.h>
@@ -11,6 +11,21 @@
 #    define WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT 32
 #endif // WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT
 
+// Erases and writes are queued with the flash driver, so failures are reported on the next erase or write
+static bool queued_operation_failed = false;
+
+static void backing_store_queued_operation_complete(flash_status_t status, void *cb_arg) {
+    if (status != FLASH_STATUS_SUCCESS) {
+        queued_operation_failed = true;
+    }
+}
+
+static bool backing_store_check_queued_operations(void) {
+    bool ret                = !queued_operation_failed;
+    queued_operation_failed = false;
+    return ret;
+}
+
 bool backing_store_init(void) {
     bs_dprintf("Init\n");
     flash_init();
@@ -28,7 +43,7 @@ bool backing_store_erase(void) {
     uint32_t start = timer_read32();
 #endif
 
-    bool ret = true;
+    bool ret = backing_store_check_queued_operations();
     for (int i = 0; i < (WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_COUNT); ++i) {
         flash_status_t status = flash_erase_block(((WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_OFFSET) + i) * (EXTERNAL_FLASH_BLOCK_SIZE));
         if (status != FLASH_STATUS_SUCCESS) {
@@ -41,6 +56,19 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+bool backing_store_erase_sector(uint32_t address) {
+    uint32_t offset = (WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_OFFSET) * (EXTERNAL_FLASH_BLOCK_SIZE) + address;
+    if (!backing_store_check_queued_operations()) {
+        return false;
+    }
+    flash_status_t status = flash_erase_sector_async(offset, backing_store_queued_operation_complete, NULL);
+    if (status == FLASH_STATUS_BUSY) {
+        // Queue is full, erase in place rather than waiting for room
+        status = flash_erase_sector(offset);
+    }
+    return status == FLASH_STATUS_SUCCESS;
+}
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return backing_store_write_bulk(address, &value, 1);
 }
@@ -72,6 +100,9 @@ bool backing_store_write_bulk(uint32_t address, backing_store_int_t *values, siz
     uint32_t            offset = (WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_OFFSET) * (EXTERNAL_FLASH_BLOCK_SIZE) + address;
     size_t              index  = 0;
     backing_store_int_t temp[WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT];
+    if (!backing_store_check_queued_operations()) {
+        return false;
+    }
     do {
         // Copy out the block of data we want to transmit first
         size_t this_loop = MIN(item_count, WEAR_LEVELING_EXTERNAL_FLASH_BULK_COUNT);
@@ -87,8 +118,13 @@ bool backing_store_write_bulk(uint32_t address, backing_store_int_t *values, siz
             temp[i] = ~temp[i];
         }
 
-        // Write out the block
-        if (flash_write_block(offset, temp, sizeof(backing_store_int_t) * this_loop) != FLASH_STATUS_SUCCESS) {
+        // Queue the block -- the flash driver copies the data, and reads reflect it before it has been programmed
+        flash_status_t status = flash_write_block_async(offset, temp, sizeof(backing_store_int_t) * this_loop, backing_store_queued_operation_complete, NULL);
+        if (status != FLASH_STATUS_SUCCESS) {
+            // Queue is full or the block is too large for it, write in place instead
+            status = flash_write_block(offset, temp, sizeof(backing_store_int_t) * this_loop);
+        }
+        if (status != FLASH_STATUS_SUCCESS) {
             return false;
         }
 
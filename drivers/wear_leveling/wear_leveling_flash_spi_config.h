@@ -23,12 +23,21 @@
 #    define BACKING_STORE_WRITE_SIZE 8
 #endif
 
+// Smallest erasable unit, used by WEAR_LEVELING_DUAL_BANK
+#ifndef BACKING_STORE_SECTOR_SIZE
+#    define BACKING_STORE_SECTOR_SIZE (EXTERNAL_FLASH_SECTOR_SIZE)
+#endif
+
 // The space allocated by the block
 #ifndef WEAR_LEVELING_BACKING_SIZE
 #    define WEAR_LEVELING_BACKING_SIZE ((EXTERNAL_FLASH_BLOCK_SIZE) * (WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_COUNT))
 #endif // WEAR_LEVELING_BACKING_SIZE
 
-// Use half of the backing size for logical EEPROM
+// Use half of the backing size for logical EEPROM, or half of each bank for WEAR_LEVELING_DUAL_BANK
 #ifndef WEAR_LEVELING_LOGICAL_SIZE
-#    define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    ifdef WEAR_LEVELING_DUAL_BANK
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 4)
+#    else
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    endif
 #endif // WEAR_LEVELING_LOGICAL_SIZE
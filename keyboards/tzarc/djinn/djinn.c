@@ -121,6 +121,12 @@ RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
     hsv.v = (uint8_t)(hsv.v * scale);
     return hsv_to_rgb(hsv);
 }
+
+void rgb_matrix_hsv_to_rgb_span(const HSV *hsv, RGB *rgb, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        rgb[i] = rgb_matrix_hsv_to_rgb(hsv[i]);
+    }
+}
 #endif
 
 //----------------------------------------------------------
@@ -61,6 +61,7 @@ subcommands = [
     'qmk.cli.generate.make_dependencies',
     'qmk.cli.generate.rgb_breathe_table',
     'qmk.cli.generate.rules_mk',
+    'qmk.cli.generate.steno_dictionary',
     'qmk.cli.generate.version_h',
     'qmk.cli.git.submodule',
     'qmk.cli.hello',
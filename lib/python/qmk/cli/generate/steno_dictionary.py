@@ -0,0 +1,55 @@
+"""Converts a Plover JSON dictionary to the image read by `STENO_DICTIONARY_ENABLE`.
+"""
+import json
+
+from milc import cli
+
+from qmk.path import normpath
+from qmk.steno_dictionary import build_image, parse_stroke
+
+
+@cli.argument('-o', '--output', arg_only=True, type=normpath, required=True, help='Image file to write to')
+@cli.argument('-b', '--buckets', arg_only=True, type=int, help='Number of buckets, a power of two. Defaults to twice the number of entries.')
+@cli.argument('-q', '--quiet', arg_only=True, action='store_true', help="Quiet mode, only output error messages")
+@cli.argument('input', arg_only=True, type=normpath, help='Plover JSON dictionary')
+@cli.subcommand('Converts a Plover JSON dictionary to a steno dictionary image for external flash')
+def generate_steno_dictionary(cli):
+    """Converts a Plover JSON dictionary to a steno dictionary image.
+
+    Only single stroke entries that translate to plain ASCII text can be stored, all other entries are skipped.
+    """
+    try:
+        dictionary = json.loads(cli.args.input.read_text(encoding='utf-8'))
+    except (OSError, ValueError) as e:
+        cli.log.error('Could not read dictionary %s: %s', cli.args.input, e)
+        return False
+
+    entries = {}
+    skipped = 0
+    for steno, text in dictionary.items():
+        if '/' in steno or not text.isascii() or '{' in text or len(text) > 255:
+            skipped += 1
+            continue
+        try:
+            stroke = parse_stroke(steno)
+        except ValueError as e:
+            cli.log.warning('Skipping %s', e)
+            skipped += 1
+            continue
+        if stroke in entries:
+            cli.log.warning('Skipping duplicate stroke %s', steno)
+            skipped += 1
+            continue
+        entries[stroke] = text
+
+    try:
+        image = build_image(entries, cli.args.buckets)
+    except ValueError as e:
+        cli.log.error(e)
+        return False
+
+    cli.args.output.parent.mkdir(parents=True, exist_ok=True)
+    cli.args.output.write_bytes(image)
+
+    if not cli.args.quiet:
+        cli.log.info('Wrote %d entries (%d bytes) to %s, skipped %d entries', len(entries), len(image), cli.args.output, skipped)
@@ -0,0 +1,205 @@
+"""Functions to build the stroke dictionary read by `STENO_DICTIONARY_ENABLE`.
+
+The image is a hash table, all values little endian:
+
+    uint32_t magic            "STND"
+    uint16_t version          1
+    uint16_t bucket_count     a power of two
+    uint32_t bucket[]         offset of the entry from the start of the image, 0 if empty
+
+Each entry holds the stroke as 6 bytes, the length of the text in 1 byte and the text itself. Bit `n` of a stroke is
+set for the steno key `QK_STENO + n`. A stroke goes in the bucket given by `stroke_hash()`, or the next free one after
+it.
+"""
+import struct
+
+MAGIC = b'STND'
+VERSION = 1
+HEADER_SIZE = 8
+ENTRY_HEADER_SIZE = 7
+HASH_MULTIPLIER = 0x9E3779B1
+
+# Bit of each steno key, its keycode minus QK_STENO
+STENO_KEY_BITS = {
+    'FN': 0,
+    'N1': 1,
+    'N2': 2,
+    'N3': 3,
+    'N4': 4,
+    'N5': 5,
+    'N6': 6,
+    'S1': 7,
+    'S2': 8,
+    'TL': 9,
+    'KL': 10,
+    'PL': 11,
+    'WL': 12,
+    'HL': 13,
+    'RL': 14,
+    'A': 15,
+    'O': 16,
+    'ST1': 17,
+    'ST2': 18,
+    'RE1': 19,
+    'RE2': 20,
+    'PWR': 21,
+    'ST3': 22,
+    'ST4': 23,
+    'E': 24,
+    'U': 25,
+    'FR': 26,
+    'RR': 27,
+    'PR': 28,
+    'BR': 29,
+    'LR': 30,
+    'GR': 31,
+    'TR': 32,
+    'SR': 33,
+    'DR': 34,
+    'N7': 35,
+    'N8': 36,
+    'N9': 37,
+    'NA': 38,
+    'NB': 39,
+    'NC': 40,
+    'ZR': 41,
+}
+
+# Keys of the Plover steno order, and the digits that stand for them when combined with the number bar
+LEFT_KEYS = {'S': 'S1', 'T': 'TL', 'K': 'KL', 'P': 'PL', 'W': 'WL', 'H': 'HL', 'R': 'RL'}
+VOWEL_KEYS = {'A': 'A', 'O': 'O', '*': 'ST1', 'E': 'E', 'U': 'U'}
+RIGHT_KEYS = {'F': 'FR', 'R': 'RR', 'P': 'PR', 'B': 'BR', 'L': 'LR', 'G': 'GR', 'T': 'TR', 'S': 'SR', 'D': 'DR', 'Z': 'ZR'}
+LEFT_DIGITS = {'1': 'S1', '2': 'TL', '3': 'PL', '4': 'HL'}
+VOWEL_DIGITS = {'5': 'A', '0': 'O'}
+RIGHT_DIGITS = {'6': 'FR', '7': 'PR', '8': 'LR', '9': 'TR'}
+
+
+def stroke_hash(stroke):
+    """Returns the hash of a stroke, the same way as `steno_dictionary_hash()` in the firmware.
+    """
+    low = stroke & 0xFFFFFFFF
+    high = (stroke >> 32) & 0xFFFFFFFF
+    value = (low ^ (high * HASH_MULTIPLIER)) & 0xFFFFFFFF
+    value = (value * HASH_MULTIPLIER) & 0xFFFFFFFF
+    return value >> 16
+
+
+def parse_stroke(steno):
+    """Converts a single stroke in Plover notation, e.g. `STKPW-Z` or `#2`, to its bits.
+
+    Raises ValueError if the stroke is not valid.
+    """
+    stroke = 0
+    left = True
+    keys = list(LEFT_KEYS.items())
+    digits = False
+
+    def press(key):
+        nonlocal stroke
+        bit = 1 << STENO_KEY_BITS[key]
+        if stroke & bit:
+            raise ValueError(f'Key {key} appears twice in stroke {steno}')
+        stroke |= bit
+
+    for char in steno:
+        if char == '#':
+            digits = True
+            continue
+        if char == '-':
+            if not left:
+                raise ValueError(f'Misplaced "-" in stroke {steno}')
+            left = False
+            keys = list(RIGHT_KEYS.items())
+            continue
+        if char.isdigit():
+            digits = True
+            if char in VOWEL_DIGITS:
+                left = False
+                press(VOWEL_DIGITS[char])
+                keys = list(RIGHT_KEYS.items())
+            elif left and char in LEFT_DIGITS:
+                press(LEFT_DIGITS[char])
+            elif char in RIGHT_DIGITS:
+                left = False
+                keys = list(RIGHT_KEYS.items())
+                press(RIGHT_DIGITS[char])
+            else:
+                raise ValueError(f'Invalid digit {char} in stroke {steno}')
+            continue
+        if char in VOWEL_KEYS:
+            left = False
+            press(VOWEL_KEYS[char])
+            keys = list(RIGHT_KEYS.items())
+            continue
+
+        # Keys of a side must be in steno order
+        for index, (letter, key) in enumerate(keys):
+            if letter == char:
+                press(key)
+                keys = keys[index + 1:]
+                break
+        else:
+            raise ValueError(f'Invalid key {char} in stroke {steno}')
+
+    if digits:
+        press('N1')
+    if not stroke:
+        raise ValueError(f'Empty stroke {steno}')
+    return stroke
+
+
+def build_image(entries, bucket_count=None):
+    """Lays out a dictionary image from a dict of stroke bits to text.
+
+    The table gets at least twice as many buckets as there are entries, unless bucket_count is given.
+    """
+    if bucket_count is None:
+        bucket_count = 1
+        while bucket_count < 2 * len(entries):
+            bucket_count *= 2
+    if bucket_count & (bucket_count - 1) or not 0 < bucket_count <= 0xFFFF:
+        raise ValueError(f'Number of buckets must be a power of two below 65536, not {bucket_count}')
+    if len(entries) > bucket_count:
+        raise ValueError(f'{len(entries)} entries do not fit into {bucket_count} buckets')
+
+    buckets = [0] * bucket_count
+    data = bytearray()
+    offset = HEADER_SIZE + 4 * bucket_count
+
+    for stroke, text in entries.items():
+        if isinstance(text, str):
+            text = text.encode('ascii')
+        if len(text) > 255:
+            raise ValueError(f'Translation of stroke {stroke:#x} is longer than 255 characters')
+        if not 0 < stroke < (1 << 48):
+            raise ValueError(f'Invalid stroke {stroke:#x}')
+
+        bucket = stroke_hash(stroke) & (bucket_count - 1)
+        while buckets[bucket]:
+            bucket = (bucket + 1) & (bucket_count - 1)
+        buckets[bucket] = offset + len(data)
+
+        data += stroke.to_bytes(6, 'little') + bytes([len(text)]) + text
+
+    header = MAGIC + struct.pack('<HH', VERSION, bucket_count) + struct.pack(f'<{bucket_count}I', *buckets)
+    return bytes(header + data)
+
+
+def lookup(image, stroke):
+    """Looks a stroke up in a dictionary image the same way as the firmware does, returns its text or None.
+    """
+    magic, version, bucket_count = struct.unpack_from('<4sHH', image, 0)
+    if magic != MAGIC or version != VERSION or not bucket_count or bucket_count & (bucket_count - 1):
+        raise ValueError('Not a steno dictionary image')
+
+    bucket = stroke_hash(stroke) & (bucket_count - 1)
+    for _ in range(bucket_count):
+        offset, = struct.unpack_from('<I', image, HEADER_SIZE + 4 * bucket)
+        if offset == 0:
+            return None
+        entry_stroke = int.from_bytes(image[offset:offset + 6], 'little')
+        if entry_stroke == stroke:
+            length = image[offset + 6]
+            return image[offset + ENTRY_HEADER_SIZE:offset + ENTRY_HEADER_SIZE + length]
+        bucket = (bucket + 1) & (bucket_count - 1)
+    return None
@@ -0,0 +1,67 @@
+import json
+import re
+from pathlib import Path
+
+import pytest
+
+from qmk.steno_dictionary import build_image, lookup, parse_stroke, stroke_hash
+
+STENO_TESTS = Path(__file__).resolve().parents[4] / 'tests' / 'steno'
+
+
+def test_parse_stroke():
+    assert parse_stroke('TP') == (1 << 9) | (1 << 11)
+    assert parse_stroke('EZ') == (1 << 24) | (1 << 41)
+    assert parse_stroke('-T') == 1 << 32
+    assert parse_stroke('T') == 1 << 9
+    assert parse_stroke('#2') == (1 << 1) | (1 << 9)
+    assert parse_stroke('STKPWHRAO*EUFRPBLGTSDZ') == 0x207FF03FE80
+
+
+@pytest.mark.parametrize('steno', ['', 'PT', 'AA', 'X', 'T--P'])
+def test_parse_stroke_invalid(steno):
+    with pytest.raises(ValueError):
+        parse_stroke(steno)
+
+
+def test_stroke_hash():
+    # Same values as tests/steno/test_steno.cpp
+    assert stroke_hash(0xA00) == 0x2AC0
+    assert stroke_hash(0x20001000000) == 0x7E98
+    assert stroke_hash(0x207FF03FE80) == 0x56B5
+
+
+def test_round_trip():
+    entries = {parse_stroke(steno): f'text {i}' for i, steno in enumerate(['S', 'T', 'K', 'P', 'W', 'H', 'R', 'A', 'O', 'E', 'U', '-F', '-R', '-P', '-B', '-L', '-G', '-T', '-S', '-D', '-Z', '*'])}
+    image = build_image(entries)
+
+    assert image[:4] == b'STND'
+    for stroke, text in entries.items():
+        assert lookup(image, stroke) == text.encode()
+    assert lookup(image, parse_stroke('STKPW')) is None
+
+
+def test_full_table_round_trip():
+    entries = {1 << bit: chr(ord('a') + bit) for bit in range(8)}
+    image = build_image(entries, 8)
+
+    for stroke, text in entries.items():
+        assert lookup(image, stroke) == text.encode()
+
+
+def test_too_small_table():
+    with pytest.raises(ValueError):
+        build_image({1: 'a', 2: 'b', 4: 'c'}, 2)
+
+
+def test_firmware_test_image_is_current():
+    """The image the firmware tests load is the generator output for steno_dictionary.json.
+    """
+    dictionary = json.loads((STENO_TESTS / 'steno_dictionary.json').read_text())
+    entries = {parse_stroke(steno): text for steno, text in dictionary.items() if '/' not in steno}
+
+    header = (STENO_TESTS / 'steno_dictionary_image.h').read_text()
+    array = header[header.index('{'):header.index('}')]
+    firmware_image = bytes(int(value, 16) for value in re.findall(r'0x([0-9A-F]{2})', array))
+
+    assert firmware_image == build_image(entries, 8)
@@ -79,3 +79,11 @@ typedef uint8_t pin_t;
 #define gpio_read_pin(pin) ((PORT->Group[SAMD_PORT(pin)].IN.reg & SAMD_PIN_MASK(pin)) != 0)
 
 #define gpio_toggle_pin(pin) (PORT->Group[SAMD_PORT(pin)].OUTTGL.reg = SAMD_PIN_MASK(pin))
+
+/* Operation of GPIO by port. */
+
+typedef uint32_t port_data_t;
+
+#define gpio_get_pin_port(pin) ((pin)&0x20)
+#define gpio_get_pin_index(pin) SAMD_PIN(pin)
+#define gpio_read_port(port) (PORT->Group[SAMD_PORT(port)].IN.reg)
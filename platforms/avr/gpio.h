@@ -36,3 +36,11 @@ typedef uint8_t pin_t;
 #define gpio_read_pin(pin) ((bool)(PINx_ADDRESS(pin) & _BV((pin)&0xF)))
 
 #define gpio_toggle_pin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin)&0xF))
+
+/* Operation of GPIO by port. */
+
+typedef uint8_t port_data_t;
+
+#define gpio_get_pin_port(pin) ((pin) & ~0xF)
+#define gpio_get_pin_index(pin) ((pin)&0xF)
+#define gpio_read_port(port) (PINx_ADDRESS(port))
@@ -7,6 +7,8 @@
 #include "serial_protocol.h"
 #include "synchronization_util.h"
 
+#if !defined(SERIAL_USART_STREAMING)
+
 static inline bool initiate_transaction(uint8_t transaction_id);
 static inline bool react_to_transaction(void);
 
@@ -156,3 +158,520 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
 
     return true;
 }
+
+#else // SERIAL_USART_STREAMING
+
+#    if !defined(SERIAL_USART_FULL_DUPLEX)
+#        error "SERIAL_USART_STREAMING requires SERIAL_USART_FULL_DUPLEX, both halves need to be able to send at any time."
+#    endif
+
+#    include <string.h>
+#    include "crc.h"
+
+#    if !defined(SERIAL_USART_TIMEOUT)
+#        define SERIAL_USART_TIMEOUT 20
+#    endif
+
+#    if !defined(SERIAL_USART_STREAM_TIMEOUT)
+#        define SERIAL_USART_STREAM_TIMEOUT 100
+#    endif
+
+#    if !defined(SERIAL_USART_STREAM_PUSH_SIZE)
+#        define SERIAL_USART_STREAM_PUSH_SIZE 32
+#    endif
+
+#    if !defined(SERIAL_USART_STREAM_PUSH_SLOTS)
+#        define SERIAL_USART_STREAM_PUSH_SLOTS 4
+#    endif
+
+#    if !defined(SERIAL_USART_STATS_INTERVAL)
+#        define SERIAL_USART_STATS_INTERVAL 5000
+#    endif
+
+#    define STREAM_SYNC 0xA5
+#    define STREAM_KIND_REQUEST 0x01
+#    define STREAM_KIND_RESPONSE 0x02
+#    define STREAM_KIND_PUSH 0x03
+#    define STREAM_KIND_MASK 0x0F
+#    define STREAM_FLAG_MORE 0x80
+
+/* Every frame starts with a sync byte, followed by the header, the payload and
+ * the CRC8 of header and payload. Both halves send whenever they have something
+ * to say, the sequence number pairs requests with their responses. */
+typedef struct __attribute__((packed)) stream_frame_t {
+    uint8_t sync;
+    uint8_t kind;
+    uint8_t transaction_id;
+    uint8_t sequence;
+    uint8_t length;
+    uint8_t payload[UINT8_MAX + 1];
+} stream_frame_t;
+
+#    define STREAM_HEADER_SIZE (offsetof(stream_frame_t, payload) - offsetof(stream_frame_t, kind))
+
+typedef struct stream_push_slot_t {
+    bool    used;
+    bool    staged;
+    bool    ready;
+    uint8_t transaction_id;
+    uint8_t length;
+    uint8_t payload[SERIAL_USART_STREAM_PUSH_SIZE];
+} stream_push_slot_t;
+
+static stream_frame_t        rx_frame;
+static stream_frame_t        tx_frame;
+static stream_frame_t        main_frame;
+static uint8_t               response_payload[UINT8_MAX];
+static uint8_t               response_length;
+static volatile bool         awaiting_response = false;
+static volatile uint8_t      expected_sequence = 0;
+static uint8_t               main_sequence     = 0;
+static volatile systime_t    last_rx;
+static bool                  is_initiator = false;
+static stream_push_slot_t    push_slots[SERIAL_USART_STREAM_PUSH_SLOTS];
+static bool                  pushed[NUM_TOTAL_TRANSACTIONS];
+static uint8_t               push_sequence;
+static bool                  push_sequence_valid = false;
+static bool                  push_batch_broken   = true;
+static bool                  push_resync         = false;
+static serial_stream_stats_t stream_stats;
+
+static BSEMAPHORE_DECL(response_sem, true);
+static MUTEX_DECL(tx_mutex);
+static MUTEX_DECL(push_mutex);
+
+static inline uint32_t stream_elapsed_us(systime_t start) {
+    return TIME_I2US(chTimeDiffX(start, chVTGetSystemTimeX()));
+}
+
+static bool stream_send_frame(stream_frame_t* frame) {
+    frame->sync                   = STREAM_SYNC;
+    frame->payload[frame->length] = crc8(&frame->kind, STREAM_HEADER_SIZE + frame->length);
+
+    chMtxLock(&tx_mutex);
+    bool success = serial_transport_send(&frame->sync, 1 + STREAM_HEADER_SIZE + frame->length + 1);
+    chMtxUnlock(&tx_mutex);
+
+    if (likely(success)) {
+        stream_stats.frames_sent++;
+    }
+    return success;
+}
+
+static bool stream_receive_frame(stream_frame_t* frame) {
+    /* Hunt for the start of a frame, anything else on the line is noise or the
+     * remainder of a broken frame. */
+    do {
+        if (unlikely(!serial_transport_receive_blocking(&frame->sync, sizeof(frame->sync)))) {
+            return false;
+        }
+    } while (frame->sync != STREAM_SYNC);
+
+    systime_t start = chVTGetSystemTimeX();
+    if (unlikely(!serial_transport_receive(&frame->kind, STREAM_HEADER_SIZE))) {
+        return false;
+    }
+
+    if (unlikely(frame->transaction_id >= NUM_TOTAL_TRANSACTIONS)) {
+        stream_stats.crc_errors++;
+        frame->kind = 0;
+        return true;
+    }
+
+    if (unlikely(!serial_transport_receive(frame->payload, frame->length + 1))) {
+        return false;
+    }
+
+    if (unlikely(crc8(&frame->kind, STREAM_HEADER_SIZE + frame->length) != frame->payload[frame->length])) {
+        stream_stats.crc_errors++;
+        frame->kind = 0;
+        return true;
+    }
+
+    uint32_t frame_us     = stream_elapsed_us(start);
+    stream_stats.frame_us = frame_us;
+    if (frame_us > stream_stats.frame_max_us) {
+        stream_stats.frame_max_us = frame_us;
+    }
+    stream_stats.frames_received++;
+    last_rx = chVTGetSystemTimeX();
+
+    return true;
+}
+
+/**
+ * @brief Run a transaction requested by the master and send back the result.
+ */
+static void stream_handle_request(void) {
+    split_transaction_desc_t* transaction = &split_transaction_table[rx_frame.transaction_id];
+    if (unlikely(rx_frame.length != transaction->initiator2target_buffer_size)) {
+        return;
+    }
+
+    {
+        split_shared_memory_lock_autounlock();
+
+        if (transaction->initiator2target_buffer_size) {
+            memcpy(split_trans_initiator2target_buffer(transaction), rx_frame.payload, transaction->initiator2target_buffer_size);
+        }
+
+        if (transaction->slave_callback) {
+            transaction->slave_callback(transaction->initiator2target_buffer_size, split_trans_initiator2target_buffer(transaction), transaction->target2initiator_buffer_size, split_trans_target2initiator_buffer(transaction));
+        }
+
+        if (transaction->target2initiator_buffer_size) {
+            memcpy(tx_frame.payload, split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size);
+        }
+    }
+
+    tx_frame.kind           = STREAM_KIND_RESPONSE;
+    tx_frame.transaction_id = rx_frame.transaction_id;
+    tx_frame.sequence       = rx_frame.sequence;
+    tx_frame.length         = transaction->target2initiator_buffer_size;
+    stream_send_frame(&tx_frame);
+}
+
+/**
+ * @brief Hand a response over to the waiting master transaction, stale
+ * responses to transactions that already timed out are dropped.
+ */
+static void stream_handle_response(void) {
+    bool accepted = false;
+
+    chSysLock();
+    if (awaiting_response && rx_frame.sequence == expected_sequence) {
+        awaiting_response = false;
+        accepted          = true;
+    }
+    chSysUnlock();
+
+    if (accepted) {
+        memcpy(response_payload, rx_frame.payload, rx_frame.length);
+        response_length = rx_frame.length;
+        chBSemSignal(&response_sem);
+    }
+}
+
+/**
+ * @brief Throw away the batch currently being staged, as one of its frames got
+ * lost. Everything pushed so far is stale from now on, so the master polls
+ * until the next complete batch has arrived. Must be called with the push
+ * mutex locked.
+ */
+static void stream_drop_push_batch(void) {
+    for (uint8_t i = 0; i < SERIAL_USART_STREAM_PUSH_SLOTS; i++) {
+        if (push_slots[i].staged) {
+            push_slots[i].staged = false;
+            push_slots[i].ready  = false;
+        }
+    }
+    push_batch_broken = true;
+    push_resync       = true;
+    stream_stats.pushes_dropped++;
+}
+
+/**
+ * @brief Stage data pushed by the slave. A batch of pushes only becomes
+ * visible once its last frame arrived, so that related transactions like a
+ * checksum and the data it covers are always applied together. Batches with a
+ * gap in their sequence numbers are dropped as a whole, just like the batch the
+ * master joined halfway through after startup.
+ */
+static void stream_handle_push(void) {
+    if (unlikely(rx_frame.length != split_transaction_table[rx_frame.transaction_id].target2initiator_buffer_size || rx_frame.length > SERIAL_USART_STREAM_PUSH_SIZE)) {
+        return;
+    }
+
+    chMtxLock(&push_mutex);
+
+    if (unlikely(push_sequence_valid && rx_frame.sequence != push_sequence)) {
+        stream_drop_push_batch();
+    }
+    push_sequence       = rx_frame.sequence + 1;
+    push_sequence_valid = true;
+
+    if (!push_batch_broken) {
+        stream_push_slot_t* slot = NULL;
+        for (uint8_t i = 0; i < SERIAL_USART_STREAM_PUSH_SLOTS; i++) {
+            if (push_slots[i].used && push_slots[i].transaction_id == rx_frame.transaction_id) {
+                slot = &push_slots[i];
+                break;
+            }
+            if (!push_slots[i].used && slot == NULL) {
+                slot = &push_slots[i];
+            }
+        }
+
+        if (likely(slot)) {
+            slot->used           = true;
+            slot->staged         = true;
+            slot->transaction_id = rx_frame.transaction_id;
+            slot->length         = rx_frame.length;
+            memcpy(slot->payload, rx_frame.payload, rx_frame.length);
+            stream_stats.pushes_received++;
+        } else {
+            stream_drop_push_batch();
+        }
+    }
+
+    if (!(rx_frame.kind & STREAM_FLAG_MORE)) {
+        if (!push_batch_broken) {
+            for (uint8_t i = 0; i < SERIAL_USART_STREAM_PUSH_SLOTS; i++) {
+                if (push_slots[i].staged) {
+                    push_slots[i].staged = false;
+                    push_slots[i].ready  = true;
+                }
+            }
+        }
+        push_batch_broken = false;
+    }
+
+    chMtxUnlock(&push_mutex);
+}
+
+/**
+ * @brief A frame was lost on the master, it might have been a push. A batch in
+ * progress is dropped right away, otherwise the gap in the sequence numbers
+ * takes care of the batch the frame belonged to.
+ */
+static void stream_handle_lost_frame(void) {
+    if (!is_initiator) {
+        return;
+    }
+
+    chMtxLock(&push_mutex);
+    push_resync = true;
+    for (uint8_t i = 0; i < SERIAL_USART_STREAM_PUSH_SLOTS; i++) {
+        if (push_slots[i].staged) {
+            stream_drop_push_batch();
+            break;
+        }
+    }
+    chMtxUnlock(&push_mutex);
+}
+
+/**
+ * @brief This thread runs on both halves and receives every frame.
+ */
+static THD_WORKING_AREA(waStreamThread, 1024);
+static THD_FUNCTION(StreamThread, arg) {
+    (void)arg;
+    chRegSetThreadName("split_protocol_stream");
+
+    while (true) {
+        if (unlikely(!stream_receive_frame(&rx_frame))) {
+            /* A frame was cut short, clear the receive queue to start with a
+             * clean slate. */
+            serial_transport_driver_clear();
+            stream_handle_lost_frame();
+            continue;
+        }
+
+        switch (rx_frame.kind & STREAM_KIND_MASK) {
+            case STREAM_KIND_REQUEST:
+                if (!is_initiator) {
+                    stream_handle_request();
+                }
+                break;
+            case STREAM_KIND_RESPONSE:
+                if (is_initiator) {
+                    stream_handle_response();
+                }
+                break;
+            case STREAM_KIND_PUSH:
+                if (is_initiator) {
+                    stream_handle_push();
+                }
+                break;
+            default:
+                /* Corrupted frame. */
+                stream_handle_lost_frame();
+                break;
+        }
+    }
+}
+
+static void stream_print_stats(void) {
+#    if defined(SERIAL_DEBUG)
+    static systime_t last_print = 0;
+    if (chTimeDiffX(last_print, chVTGetSystemTimeX()) < TIME_MS2I(SERIAL_USART_STATS_INTERVAL)) {
+        return;
+    }
+    last_print = chVTGetSystemTimeX();
+
+    serial_dprintf("SPLIT: tx %lu rx %lu push %lu drop %lu crc %lu timeout %lu rtt %lu/%luus frame %lu/%luus\n", stream_stats.frames_sent, stream_stats.frames_received, stream_stats.pushes_received, stream_stats.pushes_dropped, stream_stats.crc_errors, stream_stats.timeouts, stream_stats.round_trip_us, stream_stats.round_trip_max_us, stream_stats.frame_us, stream_stats.frame_max_us);
+#    endif
+}
+
+void soft_serial_get_stream_stats(serial_stream_stats_t* stats) {
+    memcpy(stats, &stream_stats, sizeof(stream_stats));
+}
+
+/**
+ * @brief Slave specific initializations.
+ */
+void soft_serial_target_init(void) {
+    is_initiator = false;
+    serial_transport_driver_slave_init();
+
+    /* Start transport thread. */
+    chThdCreateStatic(waStreamThread, sizeof(waStreamThread), HIGHPRIO, StreamThread, NULL);
+}
+
+/**
+ * @brief Master specific initializations.
+ */
+void soft_serial_initiator_init(void) {
+    is_initiator = true;
+    serial_transport_driver_master_init();
+
+    /* Start transport thread. */
+    chThdCreateStatic(waStreamThread, sizeof(waStreamThread), HIGHPRIO, StreamThread, NULL);
+}
+
+/**
+ * @brief Push the current target2initiator buffers of the given transactions to
+ * the master as one batch. Must be called with the shared memory locked.
+ */
+void soft_serial_target_push(const int8_t* transaction_ids, uint8_t count) {
+    if (is_initiator || count == 0) {
+        return;
+    }
+
+    /* Oversized buffers are left for the master to poll, which it also has to
+     * do for the rest of the batch then. */
+    for (uint8_t i = 0; i < count; i++) {
+        if (split_transaction_table[transaction_ids[i]].target2initiator_buffer_size > SERIAL_USART_STREAM_PUSH_SIZE) {
+            return;
+        }
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        split_transaction_desc_t* transaction = &split_transaction_table[transaction_ids[i]];
+
+        main_frame.kind           = STREAM_KIND_PUSH | (i + 1 < count ? STREAM_FLAG_MORE : 0);
+        main_frame.transaction_id = transaction_ids[i];
+        main_frame.sequence       = main_sequence++;
+        main_frame.length         = transaction->target2initiator_buffer_size;
+        memcpy(main_frame.payload, split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size);
+        if (unlikely(!stream_send_frame(&main_frame))) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Copy completed push batches into the shared memory. This happens
+ * from the main loop before the transactions are run, so a single pass of
+ * transactions always sees a consistent state.
+ */
+void soft_serial_initiator_apply_pushes(void) {
+    chMtxLock(&push_mutex);
+    if (push_resync) {
+        memset(pushed, 0, sizeof(pushed));
+        push_resync = false;
+    }
+    for (uint8_t i = 0; i < SERIAL_USART_STREAM_PUSH_SLOTS; i++) {
+        stream_push_slot_t* slot = &push_slots[i];
+        if (!slot->ready) {
+            continue;
+        }
+
+        split_transaction_desc_t* transaction = &split_transaction_table[slot->transaction_id];
+        split_shared_memory_lock();
+        memcpy(split_trans_target2initiator_buffer(transaction), slot->payload, slot->length);
+        split_shared_memory_unlock();
+
+        pushed[slot->transaction_id] = true;
+        slot->ready                  = false;
+    }
+    chMtxUnlock(&push_mutex);
+}
+
+/**
+ * @brief Read-only transactions the slave keeps pushing are served from the
+ * shared memory, as long as the link is alive.
+ */
+static bool stream_is_pushed(uint8_t transaction_id) {
+    if (chTimeDiffX(last_rx, chVTGetSystemTimeX()) >= TIME_MS2I(SERIAL_USART_STREAM_TIMEOUT)) {
+        memset(pushed, 0, sizeof(pushed));
+        return false;
+    }
+
+    split_transaction_desc_t* transaction = &split_transaction_table[transaction_id];
+    return pushed[transaction_id] && !transaction->initiator2target_buffer_size && !transaction->slave_callback;
+}
+
+/**
+ * @brief Start transaction from the master half to the slave half.
+ *
+ * @param index Transaction Table index of the transaction to start.
+ * @return bool Indicates success of transaction.
+ */
+bool soft_serial_transaction(int index) {
+    uint8_t transaction_id = (uint8_t)index;
+
+    /* Sanity check that we are actually starting a valid transaction. */
+    if (unlikely(transaction_id >= NUM_TOTAL_TRANSACTIONS)) {
+        serial_dprintf("SPLIT: illegal transaction id\n");
+        return false;
+    }
+
+    stream_print_stats();
+
+    if (stream_is_pushed(transaction_id)) {
+        return true;
+    }
+
+    split_transaction_desc_t* transaction = &split_transaction_table[transaction_id];
+
+    if (transaction->initiator2target_buffer_size) {
+        split_shared_memory_lock_autounlock();
+        memcpy(main_frame.payload, split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size);
+    }
+
+    main_frame.kind           = STREAM_KIND_REQUEST;
+    main_frame.transaction_id = transaction_id;
+    main_frame.sequence       = main_sequence++;
+    main_frame.length         = transaction->initiator2target_buffer_size;
+
+    chSysLock();
+    chBSemResetI(&response_sem, true);
+    expected_sequence = main_frame.sequence;
+    awaiting_response = true;
+    chSysUnlock();
+
+    systime_t start = chVTGetSystemTimeX();
+    if (unlikely(!stream_send_frame(&main_frame))) {
+        awaiting_response = false;
+        serial_dprintf("SPLIT: sending request failed\n");
+        return false;
+    }
+
+    if (unlikely(chBSemWaitTimeout(&response_sem, TIME_MS2I(SERIAL_USART_TIMEOUT)) != MSG_OK)) {
+        awaiting_response = false;
+        stream_stats.timeouts++;
+        serial_dprintf("SPLIT: receiving response failed\n");
+        return false;
+    }
+
+    uint32_t round_trip_us     = stream_elapsed_us(start);
+    stream_stats.round_trip_us = round_trip_us;
+    if (round_trip_us > stream_stats.round_trip_max_us) {
+        stream_stats.round_trip_max_us = round_trip_us;
+    }
+
+    if (unlikely(response_length != transaction->target2initiator_buffer_size)) {
+        serial_dprintf("SPLIT: response size mismatch\n");
+        return false;
+    }
+
+    if (transaction->target2initiator_buffer_size) {
+        split_shared_memory_lock_autounlock();
+        memcpy(split_trans_target2initiator_buffer(transaction), response_payload, transaction->target2initiator_buffer_size);
+    }
+
+    return true;
+}
+
+#endif // SERIAL_USART_STREAMING
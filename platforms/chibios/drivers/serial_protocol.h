@@ -47,3 +47,27 @@ bool __attribute__((nonnull, hot)) serial_transport_receive_blocking(uint8_t* de
  * @return false Send failed, e.g. by timeout or bit errors.
  */
 bool __attribute__((nonnull, hot)) serial_transport_send(const uint8_t* source, const size_t size);
+
+#if defined(SERIAL_USART_STREAMING)
+
+typedef struct serial_stream_stats_t {
+    uint32_t frames_sent;
+    uint32_t frames_received;
+    uint32_t pushes_received;
+    uint32_t pushes_dropped;
+    uint32_t crc_errors;
+    uint32_t timeouts;
+    uint32_t round_trip_us;
+    uint32_t round_trip_max_us;
+    uint32_t frame_us;
+    uint32_t frame_max_us;
+} serial_stream_stats_t;
+
+/**
+ * @brief Retrieve the link statistics of the streaming protocol. Round trip
+ * times are measured from sending a request to receiving its response, frame
+ * times from the sync byte to the last byte of a received frame.
+ */
+void soft_serial_get_stream_stats(serial_stream_stats_t* stats);
+
+#endif
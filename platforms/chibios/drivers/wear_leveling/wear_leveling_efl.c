@@ -87,6 +87,15 @@ bool backing_store_init(void) {
 
 #endif // defined(WEAR_LEVELING_EFL_FIRST_SECTOR)
 
+#ifdef WEAR_LEVELING_DUAL_BANK
+    // Banks are erased one BACKING_STORE_SECTOR_SIZE at a time, so no sector may span the boundary between them
+    for (flash_sector_t i = 0; i < sector_count; ++i) {
+        if (flashGetSectorSize(flash, first_sector + i) > (BACKING_STORE_SECTOR_SIZE)) {
+            chSysHalt("Flash sector larger than BACKING_STORE_SECTOR_SIZE used with WEAR_LEVELING_DUAL_BANK");
+        }
+    }
+#endif // WEAR_LEVELING_DUAL_BANK
+
     return true;
 }
 
@@ -120,6 +129,32 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+bool backing_store_erase_sector(uint32_t address) {
+    // Erase every sector starting within the requested range -- sectors may vary in size, and the remainder of any larger sector was erased by an earlier request
+    uint32_t      offset = (base_offset + address);
+    bool          ret    = true;
+    flash_error_t status;
+    for (int i = 0; i < sector_count; ++i) {
+        flash_offset_t sector_offset = flashGetSectorOffset(flash, first_sector + i);
+        if (sector_offset < offset || sector_offset >= offset + (BACKING_STORE_SECTOR_SIZE)) {
+            continue;
+        }
+
+        // Kick off the sector erase
+        status = flashStartEraseSector(flash, first_sector + i);
+        if (status != FLASH_NO_ERROR && status != FLASH_BUSY_ERASING) {
+            ret = false;
+        }
+
+        // Wait for the erase to complete
+        status = flashWaitErase(flash);
+        if (status != FLASH_NO_ERROR && status != FLASH_BUSY_ERASING) {
+            ret = false;
+        }
+    }
+    return ret;
+}
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     uint32_t offset = (base_offset + address);
     bs_dprintf("Write ");
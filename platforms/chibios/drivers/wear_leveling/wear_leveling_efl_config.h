@@ -43,12 +43,29 @@
 #    endif
 #endif
 
-// 2kB backing space allocated
+// Smallest erasable unit, used by WEAR_LEVELING_DUAL_BANK -- only known for families with uniformly-sized sectors
+#ifndef BACKING_STORE_SECTOR_SIZE
+#    if defined(QMK_MCU_SERIES_GD32VF103)
+#        define BACKING_STORE_SECTOR_SIZE 1024 // from hal_efl_lld.c
+#    elif defined(QMK_MCU_FAMILY_STM32) && defined(STM32_FLASH_SECTOR_SIZE)
+#        define BACKING_STORE_SECTOR_SIZE (STM32_FLASH_SECTOR_SIZE) // from some family's stm32_registry.h file
+#    endif
+#endif
+
+// 2kB backing space allocated, doubled for WEAR_LEVELING_DUAL_BANK
 #ifndef WEAR_LEVELING_BACKING_SIZE
-#    define WEAR_LEVELING_BACKING_SIZE 2048
+#    ifdef WEAR_LEVELING_DUAL_BANK
+#        define WEAR_LEVELING_BACKING_SIZE 4096
+#    else
+#        define WEAR_LEVELING_BACKING_SIZE 2048
+#    endif
 #endif // WEAR_LEVELING_BACKING_SIZE
 
 // 1kB logical EEPROM
 #ifndef WEAR_LEVELING_LOGICAL_SIZE
-#    define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    ifdef WEAR_LEVELING_DUAL_BANK
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 4)
+#    else
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    endif
 #endif // WEAR_LEVELING_LOGICAL_SIZE
@@ -36,6 +36,10 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+bool backing_store_erase_sector(uint32_t address) {
+    return FLASH_ErasePage(WEAR_LEVELING_LEGACY_EMULATION_BASE_PAGE_ADDRESS + address) == FLASH_COMPLETE;
+}
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     uint32_t offset = ((WEAR_LEVELING_LEGACY_EMULATION_BASE_PAGE_ADDRESS) + address);
     bs_dprintf("Write ");
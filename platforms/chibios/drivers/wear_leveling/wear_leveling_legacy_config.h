@@ -23,13 +23,24 @@
 #    define WEAR_LEVELING_LEGACY_EMULATION_FLASH_BASE 0x08000000
 #endif
 
-// The number of pages to use
+// The number of pages to use, doubled for WEAR_LEVELING_DUAL_BANK
 #ifndef WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT
 #    if defined(QMK_MCU_STM32F042)
-#        define WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT 2
+#        ifdef WEAR_LEVELING_DUAL_BANK
+#            define WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT 4
+#        else
+#            define WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT 2
+#        endif
 #    elif defined(QMK_MCU_STM32F070) || defined(QMK_MCU_STM32F072)
-#        define WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT 1
+#        ifdef WEAR_LEVELING_DUAL_BANK
+#            define WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT 2
+#        else
+#            define WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT 1
+#        endif
 #    elif defined(QMK_MCU_STM32F401) || defined(QMK_MCU_STM32F411)
+#        ifdef WEAR_LEVELING_DUAL_BANK
+#            error WEAR_LEVELING_DUAL_BANK needs two 16kB sectors on STM32F401/STM32F411 -- set WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT to 2 and WEAR_LEVELING_BACKING_SIZE to 32768, after checking the extra sector does not overlap firmware
+#        endif
 #        define WEAR_LEVELING_LEGACY_EMULATION_PAGE_COUNT 1
 #    endif
 #endif
@@ -47,6 +58,11 @@
 #    endif
 #endif
 
+// Smallest erasable unit, used by WEAR_LEVELING_DUAL_BANK
+#ifndef BACKING_STORE_SECTOR_SIZE
+#    define BACKING_STORE_SECTOR_SIZE (WEAR_LEVELING_LEGACY_EMULATION_PAGE_SIZE)
+#endif
+
 // 2-byte writes
 #ifndef BACKING_STORE_WRITE_SIZE
 #    define BACKING_STORE_WRITE_SIZE 2
@@ -55,7 +71,11 @@
 // The amount of space to use for the entire set of emulation
 #ifndef WEAR_LEVELING_BACKING_SIZE
 #    if defined(QMK_MCU_STM32F042) || defined(QMK_MCU_STM32F070) || defined(QMK_MCU_STM32F072)
-#        define WEAR_LEVELING_BACKING_SIZE 2048
+#        ifdef WEAR_LEVELING_DUAL_BANK
+#            define WEAR_LEVELING_BACKING_SIZE 4096
+#        else
+#            define WEAR_LEVELING_BACKING_SIZE 2048
+#        endif
 #    elif defined(QMK_MCU_STM32F401) || defined(QMK_MCU_STM32F411)
 #        define WEAR_LEVELING_BACKING_SIZE 16384
 #    endif
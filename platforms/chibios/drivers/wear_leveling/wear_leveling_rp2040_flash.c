@@ -187,6 +187,13 @@ bool backing_store_erase(void) {
     return true;
 }
 
+bool backing_store_erase_sector(uint32_t address) {
+    interrupts = save_and_disable_interrupts();
+    flash_range_erase((WEAR_LEVELING_RP2040_FLASH_BASE) + address, (FLASH_SECTOR_SIZE));
+    restore_interrupts(interrupts);
+    return true;
+}
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return backing_store_write_bulk(address, &value, 1);
 }
@@ -11,16 +11,29 @@
 #    define BACKING_STORE_WRITE_SIZE 2
 #endif
 
-// 64kB backing space allocated
+// 64kB backing space allocated, doubled for WEAR_LEVELING_DUAL_BANK
 #ifndef WEAR_LEVELING_BACKING_SIZE
-#    define WEAR_LEVELING_BACKING_SIZE 8192
+#    ifdef WEAR_LEVELING_DUAL_BANK
+#        define WEAR_LEVELING_BACKING_SIZE 16384
+#    else
+#        define WEAR_LEVELING_BACKING_SIZE 8192
+#    endif
 #endif // WEAR_LEVELING_BACKING_SIZE
 
 // 32kB logical EEPROM
 #ifndef WEAR_LEVELING_LOGICAL_SIZE
-#    define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    ifdef WEAR_LEVELING_DUAL_BANK
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 4)
+#    else
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    endif
 #endif // WEAR_LEVELING_LOGICAL_SIZE
 
+// Smallest erasable unit, used by WEAR_LEVELING_DUAL_BANK
+#ifndef BACKING_STORE_SECTOR_SIZE
+#    define BACKING_STORE_SECTOR_SIZE (FLASH_SECTOR_SIZE)
+#endif
+
 // Define how much flash space we have (defaults to lib/pico-sdk/src/boards/include/boards/***)
 #ifndef WEAR_LEVELING_RP2040_FLASH_SIZE
 #    define WEAR_LEVELING_RP2040_FLASH_SIZE (PICO_FLASH_SIZE_BYTES)
@@ -43,3 +43,11 @@ typedef ioline_t pin_t;
 #define gpio_read_pin(pin) palReadLine(pin)
 
 #define gpio_toggle_pin(pin) palToggleLine(pin)
+
+/* Operation of GPIO by port. */
+
+typedef ioportmask_t port_data_t;
+
+#define gpio_get_pin_port(pin) PAL_LINE(PAL_PORT(pin), 0)
+#define gpio_get_pin_index(pin) PAL_PAD(pin)
+#define gpio_read_port(port) palReadPort(PAL_PORT(port))
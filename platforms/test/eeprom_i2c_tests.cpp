@@ -0,0 +1,186 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdlib>
+
+extern "C" {
+#include "eeprom_driver.h"
+#include "i2c_eeprom_mock.h"
+#include "timer.h"
+void advance_time(uint32_t ms);
+}
+
+// Location and size of a dynamic keymap, 4 layers of 6x16 keycodes
+#define KEYMAP_EEPROM_ADDR 37
+#define KEYMAP_SIZE (4 * 6 * 16 * 2)
+// Maximum number of bytes VIA transfers per HID report
+#define VIA_BUFFER_CHUNK 28
+
+class EepromI2c : public ::testing::Test {
+   protected:
+    std::array<uint8_t, EXTERNAL_EEPROM_BYTE_COUNT> expected{};
+
+    void SetUp() override {
+        timer_clear();
+        i2c_eeprom_mock_reset();
+        eeprom_driver_init();
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(i2c_eeprom_mock_wrap_count(), 0) << "Page writes should never wrap around within a page";
+    }
+
+    // Emulates the main loop between HID reports
+    static void idle(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; ++i) {
+            advance_time(1);
+            eeprom_driver_task();
+        }
+    }
+
+    void verify_device() {
+        eeprom_driver_flush();
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(i2c_eeprom_mock_data()[i], expected[i]) << "EEPROM contents differ at address " << i;
+        }
+    }
+
+    struct bus_usage {
+        uint32_t transactions;
+        uint32_t writes;
+        uint32_t time;
+    };
+
+    static bus_usage measure_start() {
+        return {i2c_eeprom_mock_transaction_count(), i2c_eeprom_mock_write_count(), timer_read32()};
+    }
+
+    static bus_usage measure_end(const bus_usage& start) {
+        return {i2c_eeprom_mock_transaction_count() - start.transactions, i2c_eeprom_mock_write_count() - start.writes, timer_read32() - start.time};
+    }
+};
+
+/**
+ * This test verifies that reads return the latest written data, and that all writes reach the EEPROM.
+ */
+TEST_F(EepromI2c, RandomAccess_MatchesWrittenData) {
+    srand(1);
+    for (int i = 0; i < 5000; ++i) {
+        uint8_t  buf[80];
+        size_t   len  = 1 + rand() % sizeof(buf);
+        uint32_t addr = rand() % (EXTERNAL_EEPROM_BYTE_COUNT - len);
+        if (rand() % 2) {
+            for (size_t j = 0; j < len; ++j) {
+                buf[j] = rand();
+            }
+            eeprom_write_block(buf, (void*)(uintptr_t)addr, len);
+            std::copy(buf, buf + len, expected.begin() + addr);
+        } else {
+            eeprom_read_block(buf, (const void*)(uintptr_t)addr, len);
+            for (size_t j = 0; j < len; ++j) {
+                ASSERT_EQ(buf[j], expected[addr + j]) << "Readback differs at address " << (addr + j);
+            }
+        }
+        if (rand() % 8 == 0) {
+            idle(rand() % 20);
+        }
+    }
+    verify_device();
+}
+
+/**
+ * This test verifies that an erase clears the entire EEPROM.
+ */
+TEST_F(EepromI2c, Erase_ClearsEverything) {
+    memset(i2c_eeprom_mock_data(), 0xA5, EXTERNAL_EEPROM_BYTE_COUNT);
+    uint8_t value = 0x5A;
+    eeprom_write_block(&value, (void*)(uintptr_t)100, 1);
+    eeprom_driver_erase();
+    verify_device();
+    EXPECT_EQ(eeprom_read_byte((const uint8_t*)(uintptr_t)100), 0);
+}
+
+#if EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+/**
+ * This test verifies that coalesced writes are written out once the main loop has been idle for long enough.
+ */
+TEST_F(EepromI2c, CoalescedWrites_WrittenOutByTask) {
+    eeprom_write_byte((uint8_t*)(uintptr_t)10, 0x12);
+    eeprom_write_byte((uint8_t*)(uintptr_t)11, 0x34);
+    EXPECT_EQ(i2c_eeprom_mock_write_count(), 0) << "Writes should have been held back";
+
+    idle(EXTERNAL_EEPROM_WRITE_COALESCE_TIME);
+    EXPECT_EQ(i2c_eeprom_mock_write_count(), 1) << "Writes should have been written out in a single page write";
+    EXPECT_EQ(i2c_eeprom_mock_data()[10], 0x12);
+    EXPECT_EQ(i2c_eeprom_mock_data()[11], 0x34);
+}
+#endif // EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+
+/**
+ * Reports bus usage for the access patterns used by VIA when configuring the dynamic keymap.
+ */
+TEST_F(EepromI2c, Benchmark_ViaKeymapAccess) {
+    const int pages = (KEYMAP_EEPROM_ADDR + KEYMAP_SIZE - 1) / EXTERNAL_EEPROM_PAGE_SIZE - KEYMAP_EEPROM_ADDR / EXTERNAL_EEPROM_PAGE_SIZE + 1;
+    srand(2);
+
+    // dynamic_keymap_set_buffer(), as used when loading a keymap -- one byte-wise update per HID report
+    auto start = measure_start();
+    for (int offset = 0; offset < KEYMAP_SIZE; offset += VIA_BUFFER_CHUNK) {
+        for (int i = offset; i < offset + VIA_BUFFER_CHUNK && i < KEYMAP_SIZE; ++i) {
+            uint8_t value = rand();
+            eeprom_update_byte((uint8_t*)(uintptr_t)(KEYMAP_EEPROM_ADDR + i), value);
+            expected[KEYMAP_EEPROM_ADDR + i] = value;
+        }
+        idle(1);
+    }
+    idle(EXTERNAL_EEPROM_WRITE_COALESCE_TIME + EXTERNAL_EEPROM_WRITE_TIME);
+    auto set_buffer = measure_end(start);
+
+    // dynamic_keymap_get_buffer(), as used when reading back the keymap
+    start = measure_start();
+    for (int offset = 0; offset < KEYMAP_SIZE; offset += VIA_BUFFER_CHUNK) {
+        for (int i = offset; i < offset + VIA_BUFFER_CHUNK && i < KEYMAP_SIZE; ++i) {
+            ASSERT_EQ(eeprom_read_byte((const uint8_t*)(uintptr_t)(KEYMAP_EEPROM_ADDR + i)), expected[KEYMAP_EEPROM_ADDR + i]);
+        }
+        idle(1);
+    }
+    auto get_buffer = measure_end(start);
+
+    // dynamic_keymap_set_keycode(), as used when reassigning individual keys
+    int straddling = 0;
+    start          = measure_start();
+    for (int k = 0; k < 50; ++k) {
+        uint32_t addr    = KEYMAP_EEPROM_ADDR + 2 * (rand() % (KEYMAP_SIZE / 2));
+        uint16_t keycode = rand();
+        if ((addr + 1) % EXTERNAL_EEPROM_PAGE_SIZE == 0) {
+            straddling++;
+        }
+        eeprom_update_byte((uint8_t*)(uintptr_t)addr, keycode >> 8);
+        eeprom_update_byte((uint8_t*)(uintptr_t)(addr + 1), keycode & 0xFF);
+        expected[addr]     = keycode >> 8;
+        expected[addr + 1] = keycode & 0xFF;
+        idle(50);
+    }
+    auto set_keycode = measure_end(start);
+
+    verify_device();
+
+    printf("BENCH cache %d x %d bytes, coalesce %dms, %d byte pages\n", (int)EXTERNAL_EEPROM_CACHE_LINES, (int)EXTERNAL_EEPROM_CACHE_LINE_SIZE, (int)EXTERNAL_EEPROM_WRITE_COALESCE_TIME, (int)EXTERNAL_EEPROM_PAGE_SIZE);
+    printf("BENCH  scenario    | transactions | page writes | elapsed\n");
+    printf("BENCH  set_buffer  | %12d | %11d | %5dms\n", (int)set_buffer.transactions, (int)set_buffer.writes, (int)set_buffer.time);
+    printf("BENCH  get_buffer  | %12d | %11d | %5dms\n", (int)get_buffer.transactions, (int)get_buffer.writes, (int)get_buffer.time);
+    printf("BENCH  set_keycode | %12d | %11d | %5dms\n", (int)set_keycode.transactions, (int)set_keycode.writes, (int)set_keycode.time);
+
+#if EXTERNAL_EEPROM_WRITE_COALESCE_TIME > 0
+    EXPECT_LE(set_buffer.writes, pages) << "Each page should only have been written once";
+    EXPECT_LE(set_keycode.writes, 50 + straddling) << "Each keycode should have been written in a single page write, unless it straddles a page boundary";
+#endif
+#if EXTERNAL_EEPROM_CACHE_LINES > 0
+    EXPECT_LE(get_buffer.transactions, 2 * (KEYMAP_SIZE / EXTERNAL_EEPROM_CACHE_LINE_SIZE + 1)) << "Reads should have fetched a cache line at a time";
+#endif
+    (void)pages;
+    (void)straddling;
+}
@@ -0,0 +1,38 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gpio_port_mock.h"
+
+static port_data_t mock_ports[MOCK_GPIO_PORT_COUNT];
+static uint32_t    mock_port_reads;
+
+port_data_t mock_gpio_read_port(pin_t port) {
+    mock_port_reads++;
+    return mock_ports[(port >> 8) % MOCK_GPIO_PORT_COUNT];
+}
+
+void mock_gpio_reset(void) {
+    for (uint8_t i = 0; i < MOCK_GPIO_PORT_COUNT; i++) {
+        mock_ports[i] = ~(port_data_t)0;
+    }
+    mock_port_reads = 0;
+}
+
+void mock_gpio_set_port(uint8_t port, port_data_t value) {
+    mock_ports[port % MOCK_GPIO_PORT_COUNT] = value;
+}
+
+void mock_gpio_set_pin(pin_t pin, bool level) {
+    port_data_t *port = &mock_ports[(pin >> 8) % MOCK_GPIO_PORT_COUNT];
+    port_data_t  mask = (port_data_t)1 << gpio_get_pin_index(pin);
+
+    if (level) {
+        *port |= mask;
+    } else {
+        *port &= ~mask;
+    }
+}
+
+uint32_t mock_gpio_port_read_count(void) {
+    return mock_port_reads;
+}
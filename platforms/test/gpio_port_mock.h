@@ -0,0 +1,45 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ *
+ * Stand-in for the platform GPIO port operations, for host-side unit tests.
+ *
+ * A pin is encoded as its port number in the high byte and its index within the port in the low byte.
+ * All inputs idle high, as if pulled up.
+ */
+
+typedef uint16_t pin_t;
+typedef uint32_t port_data_t;
+
+#define MOCK_GPIO_PORT_COUNT 8
+
+#define MOCK_PIN(port, index) ((pin_t)(((port) << 8) | (index)))
+
+#define gpio_get_pin_port(pin) ((pin)&0xFF00)
+#define gpio_get_pin_index(pin) ((pin)&0xFF)
+#define gpio_read_port(port) mock_gpio_read_port(port)
+
+port_data_t mock_gpio_read_port(pin_t port);
+
+void mock_gpio_reset(void);
+
+void mock_gpio_set_port(uint8_t port, port_data_t value);
+
+void mock_gpio_set_pin(pin_t pin, bool level);
+
+uint32_t mock_gpio_port_read_count(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,123 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "i2c_master.h"
+#include "timer.h"
+#include "i2c_eeprom_mock.h"
+
+void advance_time(uint32_t ms);
+
+static uint8_t  mock_data[EXTERNAL_EEPROM_BYTE_COUNT];
+static uint32_t mock_pointer;
+static bool     mock_busy;
+static uint32_t mock_busy_until;
+static uint32_t mock_transactions;
+static uint32_t mock_naks;
+static uint32_t mock_writes;
+static uint32_t mock_wraps;
+static uint32_t mock_bus_time;
+static uint32_t mock_bus_time_carry;
+
+void i2c_eeprom_mock_reset(void) {
+    memset(mock_data, 0, sizeof(mock_data));
+    mock_pointer        = 0;
+    mock_busy           = false;
+    mock_transactions   = 0;
+    mock_naks           = 0;
+    mock_writes         = 0;
+    mock_wraps          = 0;
+    mock_bus_time       = 0;
+    mock_bus_time_carry = 0;
+}
+
+uint8_t *i2c_eeprom_mock_data(void) {
+    return mock_data;
+}
+
+uint32_t i2c_eeprom_mock_transaction_count(void) {
+    return mock_transactions;
+}
+
+uint32_t i2c_eeprom_mock_nak_count(void) {
+    return mock_naks;
+}
+
+uint32_t i2c_eeprom_mock_write_count(void) {
+    return mock_writes;
+}
+
+uint32_t i2c_eeprom_mock_wrap_count(void) {
+    return mock_wraps;
+}
+
+uint32_t i2c_eeprom_mock_bus_time(void) {
+    return mock_bus_time;
+}
+
+// Accounts for a transaction on the bus, returning whether the device acknowledged it
+static bool i2c_eeprom_mock_transaction(uint16_t length) {
+    uint32_t duration = (length + 1) * I2C_EEPROM_MOCK_BYTE_DURATION_US;
+    mock_transactions++;
+    mock_bus_time += duration;
+    mock_bus_time_carry += duration;
+    if (mock_bus_time_carry >= 1000) {
+        advance_time(mock_bus_time_carry / 1000);
+        mock_bus_time_carry %= 1000;
+    }
+
+    if (mock_busy && !timer_expired32(timer_read32(), mock_busy_until)) {
+        mock_naks++;
+        return false;
+    }
+    mock_busy = false;
+    return true;
+}
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (!i2c_eeprom_mock_transaction(length)) {
+        return I2C_STATUS_ERROR;
+    }
+    if (length < EXTERNAL_EEPROM_ADDRESS_SIZE) {
+        return I2C_STATUS_SUCCESS;
+    }
+
+    mock_pointer = 0;
+    for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
+        mock_pointer = (mock_pointer << 8) | data[i];
+    }
+    mock_pointer %= EXTERNAL_EEPROM_BYTE_COUNT;
+
+    if (length > EXTERNAL_EEPROM_ADDRESS_SIZE) {
+        uint32_t page   = mock_pointer - (mock_pointer % EXTERNAL_EEPROM_PAGE_SIZE);
+        uint32_t offset = mock_pointer % EXTERNAL_EEPROM_PAGE_SIZE;
+        uint16_t count  = length - EXTERNAL_EEPROM_ADDRESS_SIZE;
+        if (offset + count > EXTERNAL_EEPROM_PAGE_SIZE) {
+            mock_wraps++;
+        }
+        for (uint16_t i = 0; i < count; ++i) {
+            mock_data[page + ((offset + i) % EXTERNAL_EEPROM_PAGE_SIZE)] = data[EXTERNAL_EEPROM_ADDRESS_SIZE + i];
+        }
+        mock_writes++;
+        mock_busy       = true;
+        mock_busy_until = timer_read32() + EXTERNAL_EEPROM_WRITE_TIME;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (!i2c_eeprom_mock_transaction(length)) {
+        return I2C_STATUS_ERROR;
+    }
+    for (uint16_t i = 0; i < length; ++i) {
+        data[i]      = mock_data[mock_pointer];
+        mock_pointer = (mock_pointer + 1) % EXTERNAL_EEPROM_BYTE_COUNT;
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_ping_address(uint8_t address, uint16_t timeout) {
+    return i2c_eeprom_mock_transaction(0) ? I2C_STATUS_SUCCESS : I2C_STATUS_ERROR;
+}
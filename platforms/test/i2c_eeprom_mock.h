@@ -0,0 +1,42 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "eeprom_i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ *
+ * Simulated I2C EEPROM behind the i2c_master API, for host-side unit tests.
+ *
+ * Page writes wrap around within the page as on real devices, and the device doesn't acknowledge its address for
+ * EXTERNAL_EEPROM_WRITE_TIME after each write. Time taken on the bus advances the test platform timer.
+ */
+
+// Time taken to transfer a single byte at 400kHz, including the acknowledge bit
+#define I2C_EEPROM_MOCK_BYTE_DURATION_US 23
+
+void     i2c_eeprom_mock_reset(void);
+uint8_t *i2c_eeprom_mock_data(void);
+
+// Total number of bus transactions, including those not acknowledged
+uint32_t i2c_eeprom_mock_transaction_count(void);
+// Number of transactions not acknowledged because the device was busy writing
+uint32_t i2c_eeprom_mock_nak_count(void);
+// Number of page writes performed
+uint32_t i2c_eeprom_mock_write_count(void);
+// Number of page writes which wrapped around within a page, which would corrupt data
+uint32_t i2c_eeprom_mock_wrap_count(void);
+// Total time spent on the bus, in microseconds
+uint32_t i2c_eeprom_mock_bus_time(void);
+
+#ifdef __cplusplus
+}
+#endif
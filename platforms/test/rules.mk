@@ -23,3 +23,21 @@ eeprom_legacy_emulated_flash_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_legacy_emulated_flash.c
 eeprom_legacy_emulated_flash_tiny_SRC := $(eeprom_legacy_emulated_flash_SRC)
 eeprom_legacy_emulated_flash_large_SRC := $(eeprom_legacy_emulated_flash_SRC)
+
+eeprom_i2c_DEFS := -DEEPROM_DRIVER -DEEPROM_I2C -DNO_PRINT
+eeprom_i2c_write_back_DEFS := $(eeprom_i2c_DEFS) \
+	-DEXTERNAL_EEPROM_CACHE_LINES=8 \
+	-DEXTERNAL_EEPROM_WRITE_COALESCE_TIME=10
+
+eeprom_i2c_INC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers \
+	$(TOP_DIR)/drivers/eeprom
+eeprom_i2c_write_back_INC := $(eeprom_i2c_INC)
+
+eeprom_i2c_SRC := \
+	$(TOP_DIR)/drivers/eeprom/eeprom_driver.c \
+	$(TOP_DIR)/drivers/eeprom/eeprom_i2c.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/i2c_eeprom_mock.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_i2c_tests.cpp
+eeprom_i2c_write_back_SRC := $(eeprom_i2c_SRC)
@@ -66,11 +66,68 @@ __attribute__((weak)) bool get_retro_tapping(uint16_t keycode, keyrecord_t *reco
 }
 #endif
 
+#define DELAYED_EVENTS_SIZE 8
+
+static keyevent_t delayed_events[DELAYED_EVENTS_SIZE] = {};
+static uint8_t    delayed_events_head                 = 0;
+static uint8_t    delayed_events_tail                 = 0;
+
+static void action_exec_event(keyevent_t event);
+
+/** \brief Hold back a key event until the keycode delayed by `unregister_code_delay()` has been released.
+ */
+static bool delayed_events_enq(keyevent_t event) {
+    uint8_t next = (delayed_events_head + 1) % DELAYED_EVENTS_SIZE;
+    if (next == delayed_events_tail) {
+        return false;
+    }
+    delayed_events[delayed_events_head] = event;
+    delayed_events_head                 = next;
+    return true;
+}
+
+/** \brief Execute the held back key events, as long as no keycode is waiting to be unregistered.
+ *
+ * \param flush Wait for the delayed keycodes to be unregistered instead.
+ */
+static void delayed_events_task(bool flush) {
+    while (delayed_events_tail != delayed_events_head) {
+        if (is_unregister_delayed()) {
+            if (!flush) {
+                return;
+            }
+            flush_delayed_unregister();
+        }
+        keyevent_t event    = delayed_events[delayed_events_tail];
+        delayed_events_tail = (delayed_events_tail + 1) % DELAYED_EVENTS_SIZE;
+        action_exec_event(event);
+    }
+    if (flush) {
+        flush_delayed_unregister();
+    }
+}
+
 /** \brief Called to execute an action.
  *
- * FIXME: Needs documentation.
+ * Key events arriving while a tap is still held for `TAP_CODE_DELAY` are held back until it has been
+ * released, before combos or `pre_process_record_user()` see them, to keep the order of the reports.
  */
 void action_exec(keyevent_t event) {
+    delayed_unregister_task();
+    delayed_events_task(false);
+
+    if (IS_EVENT(event) && is_unregister_delayed()) {
+        if (delayed_events_enq(event)) {
+            return;
+        }
+        // Out of space, wait for the release rather than losing the event
+        delayed_events_task(true);
+    }
+
+    action_exec_event(event);
+}
+
+static void action_exec_event(keyevent_t event) {
     if (IS_EVENT(event)) {
         ac_dprintf("\n---- action_exec: start -----\n");
         ac_dprintf("EVENT: ");
@@ -520,12 +577,7 @@ void process_action(keyrecord_t *record, action_t action) {
                     } else {
                         if (tap_count > 0) {
                             ac_dprintf("MODS_TAP: Tap: unregister_code\n");
-                            if (action.layer_tap.code == KC_CAPS_LOCK) {
-                                wait_ms(TAP_HOLD_CAPS_DELAY);
-                            } else {
-                                wait_ms(TAP_CODE_DELAY);
-                            }
-                            unregister_code(action.key.code);
+                            unregister_code_delay(action.key.code, action.layer_tap.code == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
                         } else {
                             ac_dprintf("MODS_TAP: No tap: add_mods\n");
 #    if defined(RETRO_TAPPING) && defined(DUMMY_MOD_NEUTRALIZER_KEYCODE)
@@ -700,12 +752,7 @@ void process_action(keyrecord_t *record, action_t action) {
                     } else {
                         if (tap_count > 0) {
                             ac_dprintf("KEYMAP_TAP_KEY: Tap: unregister_code\n");
-                            if (action.layer_tap.code == KC_CAPS_LOCK) {
-                                wait_ms(TAP_HOLD_CAPS_DELAY);
-                            } else {
-                                wait_ms(TAP_CODE_DELAY);
-                            }
-                            unregister_code(action.layer_tap.code);
+                            unregister_code_delay(action.layer_tap.code, action.layer_tap.code == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
                         } else {
                             ac_dprintf("KEYMAP_TAP_KEY: No tap: Off on release\n");
                             layer_off(action.layer_tap.val);
@@ -717,12 +764,7 @@ void process_action(keyrecord_t *record, action_t action) {
                         register_code(action.layer_tap.code);
                     } else {
                         ac_dprintf("KEYMAP_TAP_KEY: Tap: unregister_code\n");
-                        if (action.layer_tap.code == KC_CAPS) {
-                            wait_ms(TAP_HOLD_CAPS_DELAY);
-                        } else {
-                            wait_ms(TAP_CODE_DELAY);
-                        }
-                        unregister_code(action.layer_tap.code);
+                        unregister_code_delay(action.layer_tap.code, action.layer_tap.code == KC_CAPS ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
                     }
 #    endif
                     break;
@@ -790,8 +832,7 @@ void process_action(keyrecord_t *record, action_t action) {
                         if (event.pressed) {
                             register_code(action.swap.code);
                         } else {
-                            wait_ms(TAP_CODE_DELAY);
-                            unregister_code(action.swap.code);
+                            unregister_code_delay(action.swap.code, TAP_CODE_DELAY);
                             *record = (keyrecord_t){}; // hack: reset tap mode
                         }
                     } else {
@@ -880,6 +921,8 @@ void process_action(keyrecord_t *record, action_t action) {
  * FIXME: Needs documentation.
  */
 __attribute__((weak)) void register_code(uint8_t code) {
+    flush_delayed_unregister();
+
     if (code == KC_NO) {
         return;
 
@@ -891,9 +934,7 @@ __attribute__((weak)) void register_code(uint8_t code) {
 #    endif
         add_key(KC_CAPS_LOCK);
         send_keyboard_report();
-        wait_ms(TAP_HOLD_CAPS_DELAY);
-        del_key(KC_CAPS_LOCK);
-        send_keyboard_report();
+        unregister_code_delay(KC_CAPS_LOCK, TAP_HOLD_CAPS_DELAY);
 
     } else if (KC_LOCKING_NUM_LOCK == code) {
 #    ifdef LOCKING_RESYNC_ENABLE
@@ -901,9 +942,7 @@ __attribute__((weak)) void register_code(uint8_t code) {
 #    endif
         add_key(KC_NUM_LOCK);
         send_keyboard_report();
-        wait_ms(100);
-        del_key(KC_NUM_LOCK);
-        send_keyboard_report();
+        unregister_code_delay(KC_NUM_LOCK, 100);
 
     } else if (KC_LOCKING_SCROLL_LOCK == code) {
 #    ifdef LOCKING_RESYNC_ENABLE
@@ -911,9 +950,7 @@ __attribute__((weak)) void register_code(uint8_t code) {
 #    endif
         add_key(KC_SCROLL_LOCK);
         send_keyboard_report();
-        wait_ms(100);
-        del_key(KC_SCROLL_LOCK);
-        send_keyboard_report();
+        unregister_code_delay(KC_SCROLL_LOCK, 100);
 #endif
 
     } else if (IS_BASIC_KEYCODE(code)) {
@@ -950,6 +987,8 @@ __attribute__((weak)) void register_code(uint8_t code) {
  * FIXME: Needs documentation.
  */
 __attribute__((weak)) void unregister_code(uint8_t code) {
+    flush_delayed_unregister();
+
     if (code == KC_NO) {
         return;
 
@@ -1002,6 +1041,65 @@ __attribute__((weak)) void unregister_code(uint8_t code) {
     }
 }
 
+static struct {
+    uint8_t  code;
+    uint16_t time;
+    bool     pending;
+} delayed_unregister = {0};
+
+/** \brief Unregister a keycode after a delay, without blocking.
+ *
+ * The keycode is unregistered by `delayed_unregister_task()` once the delay has passed. Anything that
+ * registers or unregisters keycodes or mods in the meantime waits for the rest of the delay first, and
+ * keyboard events are held back until then, so the host sees the same reports in the same order as if
+ * the delay had blocked.
+ *
+ * \param code The basic keycode to unregister.
+ * \param delay The amount of time in milliseconds to leave the keycode registered.
+ */
+void unregister_code_delay(uint8_t code, uint16_t delay) {
+    flush_delayed_unregister();
+
+    if (delay == 0) {
+        unregister_code(code);
+        return;
+    }
+
+    delayed_unregister.code    = code;
+    delayed_unregister.time    = timer_read() + delay;
+    delayed_unregister.pending = true;
+}
+
+/** \brief Whether a keycode is waiting to be unregistered by `unregister_code_delay()`.
+ */
+bool is_unregister_delayed(void) {
+    return delayed_unregister.pending;
+}
+
+/** \brief Unregister the delayed keycode if its delay has passed.
+ */
+void delayed_unregister_task(void) {
+    if (delayed_unregister.pending && timer_expired(timer_read(), delayed_unregister.time)) {
+        delayed_unregister.pending = false;
+        unregister_code(delayed_unregister.code);
+    }
+}
+
+/** \brief Wait for the rest of the delay and unregister the delayed keycode right away.
+ */
+void flush_delayed_unregister(void) {
+    if (!delayed_unregister.pending) {
+        return;
+    }
+
+    uint16_t now = timer_read();
+    if (!timer_expired(now, delayed_unregister.time)) {
+        wait_ms(TIMER_DIFF_16(delayed_unregister.time, now));
+    }
+    delayed_unregister.pending = false;
+    unregister_code(delayed_unregister.code);
+}
+
 /** \brief Tap a keycode with a delay.
  *
  * \param code The basic keycode to tap.
@@ -1009,8 +1107,7 @@ __attribute__((weak)) void unregister_code(uint8_t code) {
  */
 __attribute__((weak)) void tap_code_delay(uint8_t code, uint16_t delay) {
     register_code(code);
-    wait_ms(delay);
-    unregister_code(code);
+    unregister_code_delay(code, delay);
 }
 
 /** \brief Tap a keycode with the default delay.
@@ -1027,6 +1124,7 @@ __attribute__((weak)) void tap_code(uint8_t code) {
  */
 __attribute__((weak)) void register_mods(uint8_t mods) {
     if (mods) {
+        flush_delayed_unregister();
         add_mods(mods);
         send_keyboard_report();
     }
@@ -1038,6 +1136,7 @@ __attribute__((weak)) void register_mods(uint8_t mods) {
  */
 __attribute__((weak)) void unregister_mods(uint8_t mods) {
     if (mods) {
+        flush_delayed_unregister();
         del_mods(mods);
         send_keyboard_report();
     }
@@ -1049,6 +1148,7 @@ __attribute__((weak)) void unregister_mods(uint8_t mods) {
  */
 __attribute__((weak)) void register_weak_mods(uint8_t mods) {
     if (mods) {
+        flush_delayed_unregister();
         add_weak_mods(mods);
         send_keyboard_report();
     }
@@ -1060,6 +1160,7 @@ __attribute__((weak)) void register_weak_mods(uint8_t mods) {
  */
 __attribute__((weak)) void unregister_weak_mods(uint8_t mods) {
     if (mods) {
+        flush_delayed_unregister();
         del_weak_mods(mods);
         send_keyboard_report();
     }
@@ -1070,6 +1171,7 @@ __attribute__((weak)) void unregister_weak_mods(uint8_t mods) {
  * FIXME: Needs documentation.
  */
 void clear_keyboard(void) {
+    delayed_unregister.pending = false;
     clear_mods();
     clear_keyboard_but_mods();
 }
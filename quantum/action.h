@@ -116,6 +116,10 @@ void register_code(uint8_t code);
 void unregister_code(uint8_t code);
 void tap_code(uint8_t code);
 void tap_code_delay(uint8_t code, uint16_t delay);
+void unregister_code_delay(uint8_t code, uint16_t delay);
+bool is_unregister_delayed(void);
+void delayed_unregister_task(void);
+void flush_delayed_unregister(void);
 void register_mods(uint8_t mods);
 void unregister_mods(uint8_t mods);
 void register_weak_mods(uint8_t mods);
@@ -63,6 +63,7 @@ static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
 static uint8_t     waiting_buffer_tail                 = 0;
+static bool        waiting_buffer_delayed              = false; // events wait for a delayed unregister, see unregister_code_delay()
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
@@ -78,7 +79,19 @@ static void debug_waiting_buffer(void);
  * FIXME: Needs doc
  */
 void action_tapping_process(keyrecord_t record) {
-    if (process_tapping(&record)) {
+    if (waiting_buffer_delayed || (IS_EVENT(record.event) && is_unregister_delayed())) {
+        // A tap is still held for TAP_CODE_DELAY, events are processed after its release to keep their order
+        if (IS_EVENT(record.event) && !waiting_buffer_enq(record)) {
+            ac_dprintf("OVERFLOW: CLEAR ALL STATES\n");
+            clear_keyboard();
+            waiting_buffer_clear();
+            tapping_key = (keyrecord_t){0};
+        }
+        waiting_buffer_delayed = is_unregister_delayed();
+        if (waiting_buffer_delayed) {
+            return;
+        }
+    } else if (process_tapping(&record)) {
         if (IS_EVENT(record.event)) {
             ac_dprintf("processed: ");
             debug_record(record);
@@ -99,6 +112,10 @@ void action_tapping_process(keyrecord_t record) {
         ac_dprintf("---- action_exec: process waiting_buffer -----\n");
     }
     for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+        if (is_unregister_delayed()) {
+            waiting_buffer_delayed = true;
+            break;
+        }
         if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
             ac_dprintf("processed: waiting_buffer[%u] =", waiting_buffer_tail);
             debug_record(waiting_buffer[waiting_buffer_tail]);
@@ -109,6 +109,56 @@ RGB hsv_to_rgb_nocie(HSV hsv) {
     return hsv_to_rgb_impl(hsv, false);
 }
 
+// Order of the channels in each hue region, as indices into {v, p, q, t}: red in bits 0-1, green in bits 2-3, blue in bits 4-5
+#define HSV_REGION_CHANNELS(r, g, b) ((r) | ((g) << 2) | ((b) << 4))
+
+static const uint8_t PROGMEM hsv_region_channels[] = {
+    HSV_REGION_CHANNELS(0, 3, 1), // v, t, p
+    HSV_REGION_CHANNELS(2, 0, 1), // q, v, p
+    HSV_REGION_CHANNELS(1, 0, 3), // p, v, t
+    HSV_REGION_CHANNELS(1, 2, 0), // p, q, v
+    HSV_REGION_CHANNELS(3, 1, 0), // t, p, v
+    HSV_REGION_CHANNELS(0, 1, 2), // v, p, q
+    HSV_REGION_CHANNELS(0, 3, 1), // v, t, p
+};
+
+void hsv_to_rgb_span_impl(const HSV *hsv, RGB *rgb, uint8_t count, bool use_cie) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t h = hsv[i].h;
+        uint16_t s = hsv[i].s;
+        uint16_t v = hsv[i].v;
+#ifdef USE_CIE1931_CURVE
+        if (use_cie) {
+            v = pgm_read_byte(&CIE1931_CURVE[v]);
+        }
+#endif
+
+        // Same as h * 6 / 255 for all hues, without the division
+        uint8_t region    = ((uint32_t)h * 1542 + 257) >> 16;
+        uint8_t remainder = (h * 2 - region * 85) * 3;
+
+        uint8_t channel[4];
+        channel[0] = v;
+        channel[1] = (v * (255 - s)) >> 8;
+        channel[2] = (v * (255 - ((s * remainder) >> 8))) >> 8;
+        channel[3] = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+        // Without saturation every channel is exactly v
+        uint8_t order = s ? pgm_read_byte(&hsv_region_channels[region]) : HSV_REGION_CHANNELS(0, 0, 0);
+        rgb[i].r      = channel[order & 3];
+        rgb[i].g      = channel[(order >> 2) & 3];
+        rgb[i].b      = channel[order >> 4];
+    }
+}
+
+void hsv_to_rgb_span(const HSV *hsv, RGB *rgb, uint8_t count) {
+#ifdef USE_CIE1931_CURVE
+    hsv_to_rgb_span_impl(hsv, rgb, count, true);
+#else
+    hsv_to_rgb_span_impl(hsv, rgb, count, false);
+#endif
+}
+
 #ifdef WS2812_RGBW
 void convert_rgb_to_rgbw(rgb_led_t *led) {
     // Determine lowest value in all three colors, put that into
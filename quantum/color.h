@@ -111,6 +111,10 @@ typedef struct PACKED HSV {
 
 RGB hsv_to_rgb(HSV hsv);
 RGB hsv_to_rgb_nocie(HSV hsv);
+RGB hsv_to_rgb_impl(HSV hsv, bool use_cie);
+/* Converts count colors at once, with the same results as hsv_to_rgb() */
+void hsv_to_rgb_span(const HSV *hsv, RGB *rgb, uint8_t count);
+void hsv_to_rgb_span_impl(const HSV *hsv, RGB *rgb, uint8_t count, bool use_cie);
 #ifdef WS2812_RGBW
 void convert_rgb_to_rgbw(rgb_led_t *led);
 #endif
@@ -84,6 +84,11 @@ void eeconfig_init_quantum(void) {
 #endif
 
     eeconfig_init_kb();
+
+#if defined(EEPROM_DRIVER)
+    // Don't leave the freshly initialised config buffered by the driver
+    eeprom_driver_flush();
+#endif
 }
 
 /** \brief eeconfig initialization
@@ -111,6 +116,9 @@ void eeconfig_disable(void) {
     eeprom_driver_erase();
 #endif
     eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
+#if defined(EEPROM_DRIVER)
+    eeprom_driver_flush();
+#endif
 }
 
 /** \brief eeconfig is enabled
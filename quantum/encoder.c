@@ -4,6 +4,7 @@
 #include <string.h>
 #include "action.h"
 #include "encoder.h"
+#include "timer.h"
 #include "wait.h"
 
 #ifndef ENCODER_MAP_KEY_DELAY
@@ -15,10 +16,36 @@ __attribute__((weak)) bool should_process_encoder(void) {
 }
 
 static encoder_events_t encoder_events;
-static bool             signal_queue_drain = false;
+static volatile bool    signal_queue_drain    = false;
+static volatile bool    signal_queue_drain_to = false;
+static volatile uint8_t queue_drain_target    = 0;
+
+// Per-encoder step accumulators. The counters are only ever incremented by the producer
+// (encoder_queue_event(), which may run from an interrupt) and only read by encoder_task(),
+// which tracks how many steps it has already taken, so no locking is needed.
+static volatile uint8_t encoder_steps_cw[NUM_ENCODERS];
+static volatile uint8_t encoder_steps_ccw[NUM_ENCODERS];
+static volatile uint8_t encoder_steps_dropped;
+static uint8_t          encoder_taken_cw[NUM_ENCODERS];
+static uint8_t          encoder_taken_ccw[NUM_ENCODERS];
+#if ENCODER_COALESCE_TIME > 0
+static uint16_t encoder_last_flush[NUM_ENCODERS];
+#endif // ENCODER_COALESCE_TIME > 0
 
 void encoder_init(void) {
     memset(&encoder_events, 0, sizeof(encoder_events));
+    signal_queue_drain    = false;
+    signal_queue_drain_to = false;
+    for (uint8_t i = 0; i < NUM_ENCODERS; i++) {
+        encoder_steps_cw[i]  = 0;
+        encoder_steps_ccw[i] = 0;
+        encoder_taken_cw[i]  = 0;
+        encoder_taken_ccw[i] = 0;
+#if ENCODER_COALESCE_TIME > 0
+        encoder_last_flush[i] = timer_read() - ENCODER_COALESCE_TIME;
+#endif // ENCODER_COALESCE_TIME > 0
+    }
+    encoder_steps_dropped = 0;
     encoder_driver_init();
 }
 
@@ -27,31 +54,76 @@ static void encoder_queue_drain(void) {
     encoder_events.dequeued = encoder_events.enqueued;
 }
 
+static void encoder_queue_drain_to(uint8_t dequeued) {
+    while (encoder_events.dequeued != dequeued && encoder_events.tail != encoder_events.head) {
+        encoder_events.tail = (encoder_events.tail + 1) % MAX_QUEUED_ENCODER_EVENTS;
+        encoder_events.dequeued++;
+    }
+}
+
+// Moves accumulated steps into the event queue, one event per encoder carrying the net movement.
+// With ENCODER_COALESCE_TIME set, a step arriving after a quiet period is flushed immediately,
+// while a fast spin is merged into at most one event per encoder per window.
+static void encoder_flush_steps(void) {
+    for (uint8_t i = 0; i < NUM_ENCODERS; i++) {
+        uint8_t cw  = encoder_steps_cw[i] - encoder_taken_cw[i];
+        uint8_t ccw = encoder_steps_ccw[i] - encoder_taken_ccw[i];
+        if (cw == 0 && ccw == 0) {
+            continue;
+        }
+
+#if ENCODER_COALESCE_TIME > 0
+        if (timer_elapsed(encoder_last_flush[i]) < ENCODER_COALESCE_TIME) {
+            continue;
+        }
+#endif // ENCODER_COALESCE_TIME > 0
+
+        bool    clockwise = cw > ccw;
+        uint8_t count     = clockwise ? cw - ccw : ccw - cw;
+        if (count > 0 && !encoder_queue_steps(i, clockwise, count)) {
+            // Queue is full, keep the steps accumulated and retry next time around
+            continue;
+        }
+
+        encoder_taken_cw[i] += cw;
+        encoder_taken_ccw[i] += ccw;
+#if ENCODER_COALESCE_TIME > 0
+        encoder_last_flush[i] = timer_read();
+#endif // ENCODER_COALESCE_TIME > 0
+    }
+}
+
 static bool encoder_handle_queue(void) {
     bool    changed = false;
     uint8_t index;
     bool    clockwise;
-    while (encoder_dequeue_event(&index, &clockwise)) {
+    uint8_t count;
+    while (encoder_dequeue_steps_advanced(&encoder_events, &index, &clockwise, &count)) {
+        changed = true;
+        if (!encoder_update_batch_kb(index, clockwise, count)) {
+            continue;
+        }
+
+        for (uint8_t i = 0; i < count; i++) {
 #ifdef ENCODER_MAP_ENABLE
 
-        // The delays below cater for Windows and its wonderful requirements.
-        action_exec(clockwise ? MAKE_ENCODER_CW_EVENT(index, true) : MAKE_ENCODER_CCW_EVENT(index, true));
+            // The delays below cater for Windows and its wonderful requirements.
+            action_exec(clockwise ? MAKE_ENCODER_CW_EVENT(index, true) : MAKE_ENCODER_CCW_EVENT(index, true));
 #    if ENCODER_MAP_KEY_DELAY > 0
-        wait_ms(ENCODER_MAP_KEY_DELAY);
+            wait_ms(ENCODER_MAP_KEY_DELAY);
 #    endif // ENCODER_MAP_KEY_DELAY > 0
 
-        action_exec(clockwise ? MAKE_ENCODER_CW_EVENT(index, false) : MAKE_ENCODER_CCW_EVENT(index, false));
+            action_exec(clockwise ? MAKE_ENCODER_CW_EVENT(index, false) : MAKE_ENCODER_CCW_EVENT(index, false));
 #    if ENCODER_MAP_KEY_DELAY > 0
-        wait_ms(ENCODER_MAP_KEY_DELAY);
+            wait_ms(ENCODER_MAP_KEY_DELAY);
 #    endif // ENCODER_MAP_KEY_DELAY > 0
 
 #else // ENCODER_MAP_ENABLE
 
-        encoder_update_kb(index, clockwise);
+            encoder_update_kb(index, clockwise);
 
 #endif // ENCODER_MAP_ENABLE
-
-        changed = true;
+        }
     }
     return changed;
 }
@@ -70,9 +142,14 @@ bool encoder_task(void) {
         signal_queue_drain = false;
         encoder_queue_drain();
     }
+    if (signal_queue_drain_to) {
+        signal_queue_drain_to = false;
+        encoder_queue_drain_to(queue_drain_target);
+    }
 
     // Let the encoder driver produce events
     encoder_driver_task();
+    encoder_flush_steps();
 
     // Process any events that were enqueued
     if (should_process_encoder()) {
@@ -98,14 +175,19 @@ bool encoder_queue_empty(void) {
     return encoder_queue_empty_advanced(&encoder_events);
 }
 
-bool encoder_queue_event_advanced(encoder_events_t *events, uint8_t index, bool clockwise) {
+bool encoder_queue_steps_advanced(encoder_events_t *events, uint8_t index, bool clockwise, uint8_t count) {
+    if (count == 0) {
+        return true;
+    }
+
     // Drop out if we're full
     if (encoder_queue_full_advanced(events)) {
+        events->overflowed++;
         return false;
     }
 
     // Append the event
-    encoder_event_t new_event   = {.index = index, .clockwise = clockwise ? 1 : 0};
+    encoder_event_t new_event   = {.index = index, .clockwise = clockwise ? 1 : 0, .count = count};
     events->queue[events->head] = new_event;
 
     // Increment the head index
@@ -115,7 +197,11 @@ bool encoder_queue_event_advanced(encoder_events_t *events, uint8_t index, bool
     return true;
 }
 
-bool encoder_dequeue_event_advanced(encoder_events_t *events, uint8_t *index, bool *clockwise) {
+bool encoder_queue_event_advanced(encoder_events_t *events, uint8_t index, bool clockwise) {
+    return encoder_queue_steps_advanced(events, index, clockwise, 1);
+}
+
+bool encoder_dequeue_steps_advanced(encoder_events_t *events, uint8_t *index, bool *clockwise, uint8_t *count) {
     if (encoder_queue_empty_advanced(events)) {
         return false;
     }
@@ -124,6 +210,28 @@ bool encoder_dequeue_event_advanced(encoder_events_t *events, uint8_t *index, bo
     encoder_event_t event = events->queue[events->tail];
     *index                = event.index;
     *clockwise            = event.clockwise;
+    *count                = event.count;
+
+    // Increment the tail index
+    events->tail = (events->tail + 1) % MAX_QUEUED_ENCODER_EVENTS;
+    events->dequeued++;
+
+    return true;
+}
+
+bool encoder_dequeue_event_advanced(encoder_events_t *events, uint8_t *index, bool *clockwise) {
+    if (encoder_queue_empty_advanced(events)) {
+        return false;
+    }
+
+    // Retrieve a single step of the event, only consuming the event once all its steps are taken
+    encoder_event_t *event = &events->queue[events->tail];
+    *index                 = event->index;
+    *clockwise             = event->clockwise;
+    if (event->count > 1) {
+        event->count--;
+        return true;
+    }
 
     // Increment the tail index
     events->tail = (events->tail + 1) % MAX_QUEUED_ENCODER_EVENTS;
@@ -133,7 +241,25 @@ bool encoder_dequeue_event_advanced(encoder_events_t *events, uint8_t *index, bo
 }
 
 bool encoder_queue_event(uint8_t index, bool clockwise) {
-    return encoder_queue_event_advanced(&encoder_events, index, clockwise);
+    if (index >= NUM_ENCODERS) {
+        return false;
+    }
+
+    volatile uint8_t *steps = clockwise ? &encoder_steps_cw[index] : &encoder_steps_ccw[index];
+    uint8_t           taken = clockwise ? encoder_taken_cw[index] : encoder_taken_ccw[index];
+
+    // Refuse to wrap around onto steps that encoder_task() hasn't collected yet
+    if ((uint8_t)(*steps - taken) == UINT8_MAX) {
+        encoder_steps_dropped++;
+        return false;
+    }
+
+    (*steps)++;
+    return true;
+}
+
+bool encoder_queue_steps(uint8_t index, bool clockwise, uint8_t count) {
+    return encoder_queue_steps_advanced(&encoder_events, index, clockwise, count);
 }
 
 bool encoder_dequeue_event(uint8_t *index, bool *clockwise) {
@@ -148,6 +274,23 @@ void encoder_signal_queue_drain(void) {
     signal_queue_drain = true;
 }
 
+void encoder_signal_queue_drain_to(uint8_t dequeued) {
+    queue_drain_target    = dequeued;
+    signal_queue_drain_to = true;
+}
+
+uint8_t encoder_overflow_count(void) {
+    return encoder_events.overflowed + encoder_steps_dropped;
+}
+
+__attribute__((weak)) bool encoder_update_batch_user(uint8_t index, bool clockwise, uint8_t count) {
+    return true;
+}
+
+__attribute__((weak)) bool encoder_update_batch_kb(uint8_t index, bool clockwise, uint8_t count) {
+    return encoder_update_batch_user(index, clockwise, count);
+}
+
 __attribute__((weak)) bool encoder_update_user(uint8_t index, bool clockwise) {
     return true;
 }
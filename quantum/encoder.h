@@ -34,6 +34,13 @@ bool encoder_dequeue_event(uint8_t *index, bool *clockwise);
 bool encoder_update_kb(uint8_t index, bool clockwise);
 bool encoder_update_user(uint8_t index, bool clockwise);
 
+// Invoked once per coalesced batch of steps; return true to continue with per-step handling
+bool encoder_update_batch_kb(uint8_t index, bool clockwise, uint8_t count);
+bool encoder_update_batch_user(uint8_t index, bool clockwise, uint8_t count);
+
+// Number of encoder steps dropped since init because they could not be accumulated or queued
+uint8_t encoder_overflow_count(void);
+
 #    ifdef SPLIT_KEYBOARD
 
 #        if defined(ENCODERS_PAD_A_RIGHT)
@@ -77,9 +84,14 @@ bool encoder_update_user(uint8_t index, bool clockwise);
 #        define MAX_QUEUED_ENCODER_EVENTS MAX(4, ((NUM_ENCODERS_MAX_PER_SIDE) + 1))
 #    endif // MAX_QUEUED_ENCODER_EVENTS
 
+#    ifndef ENCODER_COALESCE_TIME
+#        define ENCODER_COALESCE_TIME 0
+#    endif // ENCODER_COALESCE_TIME
+
 typedef struct encoder_event_t {
     uint8_t index : 7;
     uint8_t clockwise : 1;
+    uint8_t count;
 } encoder_event_t;
 
 typedef struct encoder_events_t {
@@ -87,6 +99,7 @@ typedef struct encoder_events_t {
     uint8_t         dequeued;
     uint8_t         head;
     uint8_t         tail;
+    uint8_t         overflowed;
     encoder_event_t queue[MAX_QUEUED_ENCODER_EVENTS];
 } encoder_events_t;
 
@@ -96,9 +109,16 @@ void encoder_retrieve_events(encoder_events_t *events);
 // Encoder event queue management
 bool encoder_queue_event_advanced(encoder_events_t *events, uint8_t index, bool clockwise);
 bool encoder_dequeue_event_advanced(encoder_events_t *events, uint8_t *index, bool *clockwise);
+bool encoder_queue_steps_advanced(encoder_events_t *events, uint8_t index, bool clockwise, uint8_t count);
+bool encoder_dequeue_steps_advanced(encoder_events_t *events, uint8_t *index, bool *clockwise, uint8_t *count);
+bool encoder_queue_steps(uint8_t index, bool clockwise, uint8_t count);
+bool encoder_queue_empty_advanced(encoder_events_t *events);
+bool encoder_queue_full(void);
 
 // Reset the queue to be empty
 void encoder_signal_queue_drain(void);
+// Discard queued events until `dequeued` events have been consumed in total
+void encoder_signal_queue_drain_to(uint8_t dequeued);
 
 #    ifdef ENCODER_MAP_ENABLE
 #        define NUM_DIRECTIONS 2
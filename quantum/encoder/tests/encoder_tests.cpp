@@ -23,6 +23,8 @@
 extern "C" {
 #include "encoder.h"
 #include "encoder/tests/mock.h"
+
+void encoder_quadrature_sample(void);
 }
 
 struct update {
@@ -39,11 +41,26 @@ bool encoder_update_kb(uint8_t index, bool clockwise) {
     return true;
 }
 
+uint8_t batches_array_idx = 0;
+uint8_t batch_counts[32];
+
+bool encoder_update_batch_user(uint8_t index, bool clockwise, uint8_t count) {
+    batch_counts[batches_array_idx % 32] = count;
+    batches_array_idx++;
+    return true;
+}
+
 bool setAndRead(pin_t pin, bool val) {
     setPin(pin, val);
     return encoder_task();
 }
 
+// Emulates an interrupt sampling the pins faster than encoder_task() runs
+void setAndSample(pin_t pin, bool val) {
+    setPin(pin, val);
+    encoder_quadrature_sample();
+}
+
 class EncoderTest : public ::testing::Test {};
 
 TEST_F(EncoderTest, TestInit) {
@@ -142,3 +159,76 @@ TEST_F(EncoderTest, TestHalfway) {
     EXPECT_EQ(updates[0].index, 0);
     EXPECT_EQ(updates[0].clockwise, true);
 }
+
+TEST_F(EncoderTest, TestHighRateSpinIsBatched) {
+    updates_array_idx = 0;
+    batches_array_idx = 0;
+    encoder_init();
+    // 20 clockwise detents decoded before the task gets to run
+    for (int i = 0; i < 20; i++) {
+        setAndSample(0, false);
+        setAndSample(1, false);
+        setAndSample(0, true);
+        setAndSample(1, true);
+    }
+    EXPECT_EQ(updates_array_idx, 0);
+
+    EXPECT_TRUE(encoder_task());
+    EXPECT_EQ(batches_array_idx, 1);
+    EXPECT_EQ(batch_counts[0], 20);
+    EXPECT_EQ(updates_array_idx, 20);
+    for (int i = 0; i < 20; i++) {
+        EXPECT_EQ(updates[i].index, 0);
+        EXPECT_EQ(updates[i].clockwise, true);
+    }
+    EXPECT_EQ(encoder_overflow_count(), 0);
+}
+
+TEST_F(EncoderTest, TestHighRateSpinReversalIsNetted) {
+    updates_array_idx = 0;
+    batches_array_idx = 0;
+    encoder_init();
+    for (int i = 0; i < 5; i++) {
+        setAndSample(0, false);
+        setAndSample(1, false);
+        setAndSample(0, true);
+        setAndSample(1, true);
+    }
+    for (int i = 0; i < 2; i++) {
+        setAndSample(1, false);
+        setAndSample(0, false);
+        setAndSample(1, true);
+        setAndSample(0, true);
+    }
+
+    encoder_task();
+    EXPECT_EQ(batches_array_idx, 1);
+    EXPECT_EQ(batch_counts[0], 3);
+    EXPECT_EQ(updates_array_idx, 3);
+    EXPECT_EQ(updates[2].clockwise, true);
+}
+
+TEST_F(EncoderTest, TestHighRateSpinOverflowIsCounted) {
+    updates_array_idx = 0;
+    batches_array_idx = 0;
+    encoder_init();
+    // More steps than a single accumulator can hold between two tasks
+    for (int i = 0; i < 300; i++) {
+        setAndSample(0, false);
+        setAndSample(1, false);
+        setAndSample(0, true);
+        setAndSample(1, true);
+    }
+
+    encoder_task();
+    EXPECT_EQ(updates_array_idx, 255);
+    EXPECT_EQ(encoder_overflow_count(), 45);
+
+    // The decoder keeps going once the accumulator has been drained
+    updates_array_idx = 0;
+    setAndRead(0, false);
+    setAndRead(1, false);
+    setAndRead(0, true);
+    setAndRead(1, true);
+    EXPECT_EQ(updates_array_idx, 1);
+}
@@ -77,6 +77,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef STENO_ENABLE
 #    include "process_steno.h"
 #endif
+#ifdef DYNAMIC_MACRO_ENABLE
+#    include "process_dynamic_macro.h"
+#endif
 #ifdef KEY_OVERRIDE_ENABLE
 #    include "process_key_override.h"
 #endif
@@ -110,6 +113,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef EEPROM_DRIVER
 #    include "eeprom_driver.h"
 #endif
+#if defined(WEAR_LEVELING_ENABLE) && defined(WEAR_LEVELING_DUAL_BANK)
+#    include "wear_leveling.h"
+#endif
+#ifdef FLASH_SPI
+#    include "flash_spi.h"
+#endif
 #if defined(CRC_ENABLE)
 #    include "crc.h"
 #endif
@@ -140,6 +149,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef OS_DETECTION_ENABLE
 #    include "os_detection.h"
 #endif
+#ifdef TASK_SCHEDULER_ENABLE
+#    include "task_scheduler.h"
+#endif
+#ifdef STATE_BUS_ENABLE
+#    include "state_bus.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -401,6 +416,171 @@ void quantum_init(void) {
     layer_state_set_kb((layer_state_t)layer_state);
 }
 
+#ifdef TASK_SCHEDULER_ENABLE
+#    define SCHEDULED_TASK(fn)              \
+        static bool fn##_scheduled(void) { \
+            fn();                          \
+            return false;                  \
+        }
+
+#    if defined(SPLIT_WATCHDOG_ENABLE)
+SCHEDULED_TASK(split_watchdog_task)
+#    endif
+#    ifdef STATE_BUS_ENABLE
+SCHEDULED_TASK(state_bus_task)
+#    endif
+
+// Input device activity of the current keyboard_task() call, which wakes up the displays
+static bool keyboard_input_activity = false;
+
+#    ifdef ENCODER_ENABLE
+static bool encoder_task_scheduled(void) {
+    if (encoder_task()) {
+        last_encoder_activity_trigger();
+        keyboard_input_activity = true;
+    }
+    return false;
+}
+#    endif
+#    ifdef POINTING_DEVICE_ENABLE
+static bool pointing_device_task_scheduled(void) {
+    if (pointing_device_task()) {
+        last_pointing_device_activity_trigger();
+        keyboard_input_activity = true;
+    }
+    return false;
+}
+#    endif
+#    if defined(RGBLIGHT_ENABLE)
+SCHEDULED_TASK(rgblight_task)
+#    endif
+#    ifdef LED_MATRIX_ENABLE
+SCHEDULED_TASK(led_matrix_task)
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
+SCHEDULED_TASK(rgb_matrix_task)
+#    endif
+#    if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+SCHEDULED_TASK(backlight_task)
+#    endif
+#    ifdef OLED_ENABLE
+SCHEDULED_TASK(oled_task)
+#    endif
+#    ifdef ST7565_ENABLE
+SCHEDULED_TASK(st7565_task)
+#    endif
+#    ifdef MOUSEKEY_ENABLE
+SCHEDULED_TASK(mousekey_task)
+#    endif
+#    ifdef PS2_MOUSE_ENABLE
+SCHEDULED_TASK(ps2_mouse_task)
+#    endif
+#    ifdef MIDI_ENABLE
+SCHEDULED_TASK(midi_task)
+#    endif
+#    ifdef JOYSTICK_ENABLE
+SCHEDULED_TASK(joystick_task)
+#    endif
+#    ifdef BLUETOOTH_ENABLE
+SCHEDULED_TASK(bluetooth_task)
+#    endif
+#    ifdef HAPTIC_ENABLE
+SCHEDULED_TASK(haptic_task)
+#    endif
+SCHEDULED_TASK(led_task)
+#    if defined(WEAR_LEVELING_ENABLE) && defined(WEAR_LEVELING_DUAL_BANK)
+SCHEDULED_TASK(wear_leveling_task)
+#    endif
+#    ifdef EEPROM_DRIVER
+SCHEDULED_TASK(eeprom_driver_task)
+#    endif
+#    ifdef FLASH_SPI
+SCHEDULED_TASK(flash_task)
+#    endif
+#    ifdef OS_DETECTION_ENABLE
+SCHEDULED_TASK(os_detection_task)
+#    endif
+
+// Everything keyboard_task() runs after the matrix and keycode processing, in the order it runs without the scheduler.
+// All core tasks share a priority, so that order is kept; periods are what the subsystems need to keep up, budgets
+// are typical worst case run times. Input devices and the state bus are never deferred.
+static const task_scheduler_task_t keyboard_scheduled_tasks[] = {
+#    if defined(SPLIT_WATCHDOG_ENABLE)
+    {"split_watchdog", split_watchdog_task_scheduled, 10, 20, TASK_PRIORITY_NORMAL},
+#    endif
+#    if defined(RGBLIGHT_ENABLE)
+    {"rgblight", rgblight_task_scheduled, 1, 300, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef LED_MATRIX_ENABLE
+    {"led_matrix", led_matrix_task_scheduled, 1, 300, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
+    {"rgb_matrix", rgb_matrix_task_scheduled, 1, 500, TASK_PRIORITY_NORMAL},
+#    endif
+#    if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+    // Software PWM needs to run on every loop
+    {"backlight", backlight_task_scheduled, 0, 20, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef ENCODER_ENABLE
+    {"encoder", encoder_task_scheduled, 0, 100, TASK_PRIORITY_NORMAL, TASK_FLAG_NEVER_DEFER},
+#    endif
+#    ifdef POINTING_DEVICE_ENABLE
+    {"pointing_device", pointing_device_task_scheduled, 0, 300, TASK_PRIORITY_NORMAL, TASK_FLAG_NEVER_DEFER},
+#    endif
+#    ifdef STATE_BUS_ENABLE
+    {"state_bus", state_bus_task_scheduled, 0, 100, TASK_PRIORITY_NORMAL, TASK_FLAG_NEVER_DEFER},
+#    endif
+#    ifdef OLED_ENABLE
+    {"oled", oled_task_scheduled, 10, 500, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef ST7565_ENABLE
+    {"st7565", st7565_task_scheduled, 10, 500, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef MOUSEKEY_ENABLE
+    {"mousekey", mousekey_task_scheduled, 1, 50, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef PS2_MOUSE_ENABLE
+    {"ps2_mouse", ps2_mouse_task_scheduled, 1, 300, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef MIDI_ENABLE
+    {"midi", midi_task_scheduled, 1, 200, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef JOYSTICK_ENABLE
+    {"joystick", joystick_task_scheduled, 1, 200, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef BLUETOOTH_ENABLE
+    {"bluetooth", bluetooth_task_scheduled, 1, 200, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef HAPTIC_ENABLE
+    {"haptic", haptic_task_scheduled, 1, 100, TASK_PRIORITY_NORMAL},
+#    endif
+    {"led", led_task_scheduled, 1, 50, TASK_PRIORITY_NORMAL},
+#    if defined(WEAR_LEVELING_ENABLE) && defined(WEAR_LEVELING_DUAL_BANK)
+    {"wear_leveling", wear_leveling_task_scheduled, 10, 500, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef EEPROM_DRIVER
+    {"eeprom_driver", eeprom_driver_task_scheduled, 1, 500, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef FLASH_SPI
+    {"flash", flash_task_scheduled, 1, 100, TASK_PRIORITY_NORMAL},
+#    endif
+#    ifdef OS_DETECTION_ENABLE
+    {"os_detection", os_detection_task_scheduled, 10, 20, TASK_PRIORITY_NORMAL},
+#    endif
+};
+
+_Static_assert(ARRAY_SIZE(keyboard_scheduled_tasks) <= TASK_SCHEDULER_MAX_TASKS, "TASK_SCHEDULER_MAX_TASKS is too small for the enabled features");
+
+static void keyboard_scheduler_init(void) {
+    task_scheduler_init();
+    for (uint8_t i = 0; i < ARRAY_SIZE(keyboard_scheduled_tasks); ++i) {
+        if (task_scheduler_register(&keyboard_scheduled_tasks[i]) == INVALID_TASK_ID) {
+            dprintf("task scheduler: failed to register %s\n", keyboard_scheduled_tasks[i].name);
+        }
+    }
+}
+#endif
+
 /** \brief keyboard_init
  *
  * FIXME: needs doc
@@ -453,9 +633,12 @@ void keyboard_init(void) {
 #ifdef RGBLIGHT_ENABLE
     rgblight_init();
 #endif
-#ifdef STENO_ENABLE_ALL
+#if defined(STENO_ENABLE_ALL) || defined(STENO_DICTIONARY_ENABLE)
     steno_init();
 #endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_init();
+#endif
 #if defined(NKRO_ENABLE) && defined(FORCE_NKRO)
     keymap_config.nkro = 1;
     eeconfig_update_keymap(keymap_config.raw);
@@ -486,6 +669,10 @@ void keyboard_init(void) {
     haptic_init();
 #endif
 
+#ifdef TASK_SCHEDULER_ENABLE
+    keyboard_scheduler_init();
+#endif
+
 #if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
     debug_enable = true;
 #endif
@@ -636,6 +823,14 @@ void quantum_task(void) {
     leader_task();
 #endif
 
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_task();
+#endif
+
+#ifdef STENO_ENABLE
+    steno_task();
+#endif
+
 #ifdef WPM_ENABLE
     decay_wpm();
 #endif
@@ -655,6 +850,10 @@ void quantum_task(void) {
 #ifdef SECURE_ENABLE
     secure_task();
 #endif
+
+#if defined(UNICODE_COMMON_ENABLE) && defined(UNICODE_ASYNC_OUTPUT)
+    unicode_task();
+#endif
 }
 
 /** \brief Main task that is repeatedly called as fast as possible. */
@@ -667,85 +866,117 @@ void keyboard_task(void) {
 
     quantum_task();
 
-#if defined(SPLIT_WATCHDOG_ENABLE)
+#ifdef TASK_SCHEDULER_ENABLE
+    keyboard_input_activity = false;
+    task_scheduler_task();
+    if (keyboard_input_activity) {
+        activity_has_occurred = true;
+    }
+
+    // Wake up displays if user is using those fabulous keys or spinning those encoders!
+#    if defined(OLED_ENABLE) && OLED_TIMEOUT > 0
+    if (activity_has_occurred) oled_on();
+#    endif
+#    if defined(ST7565_ENABLE) && ST7565_TIMEOUT > 0
+    if (activity_has_occurred) st7565_on();
+#    endif
+#else
+#    if defined(SPLIT_WATCHDOG_ENABLE)
     split_watchdog_task();
-#endif
+#    endif
 
-#if defined(RGBLIGHT_ENABLE)
+#    if defined(RGBLIGHT_ENABLE)
     rgblight_task();
-#endif
+#    endif
 
-#ifdef LED_MATRIX_ENABLE
+#    ifdef LED_MATRIX_ENABLE
     led_matrix_task();
-#endif
-#ifdef RGB_MATRIX_ENABLE
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
     rgb_matrix_task();
-#endif
+#    endif
 
-#if defined(BACKLIGHT_ENABLE)
-#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+#    if defined(BACKLIGHT_ENABLE)
+#        if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
     backlight_task();
+#        endif
 #    endif
-#endif
 
-#ifdef ENCODER_ENABLE
+#    ifdef ENCODER_ENABLE
     if (encoder_task()) {
         last_encoder_activity_trigger();
         activity_has_occurred = true;
     }
-#endif
+#    endif
 
-#ifdef POINTING_DEVICE_ENABLE
+#    ifdef POINTING_DEVICE_ENABLE
     if (pointing_device_task()) {
         last_pointing_device_activity_trigger();
         activity_has_occurred = true;
     }
-#endif
+#    endif
 
-#ifdef OLED_ENABLE
+#    ifdef STATE_BUS_ENABLE
+    state_bus_task();
+#    endif
+
+#    ifdef OLED_ENABLE
     oled_task();
-#    if OLED_TIMEOUT > 0
+#        if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) oled_on();
+#        endif
 #    endif
-#endif
 
-#ifdef ST7565_ENABLE
+#    ifdef ST7565_ENABLE
     st7565_task();
-#    if ST7565_TIMEOUT > 0
+#        if ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) st7565_on();
+#        endif
 #    endif
-#endif
 
-#ifdef MOUSEKEY_ENABLE
+#    ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
     mousekey_task();
-#endif
+#    endif
 
-#ifdef PS2_MOUSE_ENABLE
+#    ifdef PS2_MOUSE_ENABLE
     ps2_mouse_task();
-#endif
+#    endif
 
-#ifdef MIDI_ENABLE
+#    ifdef MIDI_ENABLE
     midi_task();
-#endif
+#    endif
 
-#ifdef JOYSTICK_ENABLE
+#    ifdef JOYSTICK_ENABLE
     joystick_task();
-#endif
+#    endif
 
-#ifdef BLUETOOTH_ENABLE
+#    ifdef BLUETOOTH_ENABLE
     bluetooth_task();
-#endif
+#    endif
 
-#ifdef HAPTIC_ENABLE
+#    ifdef HAPTIC_ENABLE
     haptic_task();
-#endif
+#    endif
 
     led_task();
 
-#ifdef OS_DETECTION_ENABLE
+#    if defined(WEAR_LEVELING_ENABLE) && defined(WEAR_LEVELING_DUAL_BANK)
+    wear_leveling_task();
+#    endif
+
+#    ifdef EEPROM_DRIVER
+    eeprom_driver_task();
+#    endif
+
+#    ifdef FLASH_SPI
+    flash_task();
+#    endif
+
+#    ifdef OS_DETECTION_ENABLE
     os_detection_task();
+#    endif
 #endif
 }
@@ -22,6 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "debounce.h"
 #include "atomic_util.h"
 
+#ifdef MATRIX_PORT_READ
+#    include "matrix_port.h"
+#endif
+
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -60,6 +64,10 @@ static SPLIT_MUTABLE_ROW pin_t row_pins[ROWS_PER_HAND] = MATRIX_ROW_PINS;
 #    ifdef MATRIX_COL_PINS
 static SPLIT_MUTABLE_COL pin_t col_pins[MATRIX_COLS]   = MATRIX_COL_PINS;
 #    endif // MATRIX_COL_PINS
+#    if defined(MATRIX_PORT_READ) && defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)
+// Port groupings of the input pins, built once the pinout for this half is known
+static matrix_port_map_t input_port_map;
+#    endif
 #endif
 
 /* matrix state(1:on, 0:off) */
@@ -181,6 +189,10 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
+#            ifdef MATRIX_PORT_READ
+    // Read all cols at once, a whole port at a time
+    current_row_value = (matrix_row_t)matrix_port_map_read(&input_port_map);
+#            else
     // For each col...
     matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
     for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
@@ -189,6 +201,7 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
         // Populate the matrix row with the state of the col pin
         current_row_value |= pin_state ? 0 : row_shifter;
     }
+#            endif
 
     // Unselect row
     unselect_row(current_row);
@@ -244,10 +257,19 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
+#            ifdef MATRIX_PORT_READ
+    // Read all rows at once, a whole port at a time
+    uint32_t row_states = matrix_port_map_read(&input_port_map);
+#            endif
+
     // For each row...
     for (uint8_t row_index = 0; row_index < ROWS_PER_HAND; row_index++) {
         // Check row pin state
+#            ifdef MATRIX_PORT_READ
+        if (row_states & ((uint32_t)1 << row_index)) {
+#            else
         if (readMatrixPin(row_pins[row_index]) == 0) {
+#            endif
             // Pin LO, set col bit
             current_matrix[row_index] |= row_shifter;
             key_pressed = true;
@@ -303,6 +325,14 @@ void matrix_init(void) {
     // initialize key pins
     matrix_init_pins();
 
+#if defined(MATRIX_PORT_READ) && defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)
+#    if (DIODE_DIRECTION == COL2ROW)
+    matrix_port_map_init(&input_port_map, col_pins, MATRIX_COLS);
+#    elif (DIODE_DIRECTION == ROW2COL)
+    matrix_port_map_init(&input_port_map, row_pins, ROWS_PER_HAND);
+#    endif
+#endif
+
     // initialize matrix state: all keys off
     memset(matrix, 0, sizeof(matrix));
     memset(raw_matrix, 0, sizeof(raw_matrix));
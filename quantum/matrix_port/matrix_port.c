@@ -0,0 +1,83 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "matrix_port.h"
+
+#if !defined(gpio_read_port) || !defined(gpio_get_pin_port) || !defined(gpio_get_pin_index)
+#    error "MATRIX_PORT_READ is not supported on this platform"
+#endif
+
+_Static_assert(MATRIX_PORT_MAX_PINS <= 32, "Port reads support at most 32 input pins");
+
+#ifndef MATRIX_INPUT_PRESSED_STATE
+#    define MATRIX_INPUT_PRESSED_STATE 0
+#endif
+
+static uint8_t matrix_port_group(matrix_port_map_t *map, pin_t port) {
+    for (uint8_t i = 0; i < map->port_count; i++) {
+        if (map->ports[i] == port) {
+            return i;
+        }
+    }
+
+    map->ports[map->port_count] = port;
+    return map->port_count++;
+}
+
+void matrix_port_map_init(matrix_port_map_t *map, const pin_t *pins, uint8_t count) {
+    memset(map, 0, sizeof(matrix_port_map_t));
+
+    if (count > MATRIX_PORT_MAX_PINS) {
+        count = MATRIX_PORT_MAX_PINS;
+    }
+
+    matrix_port_run_t *run        = NULL;
+    uint8_t            run_length = 0;
+    for (uint8_t bit = 0; bit < count; bit++) {
+        pin_t pin = pins[bit];
+        if (pin == NO_PIN) {
+            run = NULL;
+            continue;
+        }
+
+        uint8_t group = matrix_port_group(map, gpio_get_pin_port(pin));
+        uint8_t index = gpio_get_pin_index(pin);
+
+        // Extend the current run if this pin follows on from it in both the port and the output
+        if (run && run->group == group && run->pin_shift + run_length == index) {
+            run->mask |= (uint32_t)1 << run_length++;
+            continue;
+        }
+
+        run        = &map->runs[map->run_count++];
+        run_length = 1;
+        *run       = (matrix_port_run_t){
+            .group     = group,
+            .pin_shift = index,
+            .bit_shift = bit,
+            .mask      = 1,
+        };
+    }
+}
+
+uint32_t matrix_port_map_read(const matrix_port_map_t *map) {
+    port_data_t values[MATRIX_PORT_MAX_PINS];
+
+    // Sample every port before remapping, so that all pins are read as close together as possible
+    for (uint8_t i = 0; i < map->port_count; i++) {
+#if MATRIX_INPUT_PRESSED_STATE == 0
+        values[i] = ~gpio_read_port(map->ports[i]);
+#else
+        values[i] = gpio_read_port(map->ports[i]);
+#endif
+    }
+
+    uint32_t bits = 0;
+    for (uint8_t i = 0; i < map->run_count; i++) {
+        const matrix_port_run_t *run = &map->runs[i];
+        bits |= ((uint32_t)(values[run->group] >> run->pin_shift) & run->mask) << run->bit_shift;
+    }
+
+    return bits;
+}
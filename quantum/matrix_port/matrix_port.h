@@ -0,0 +1,62 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "gpio.h"
+#include "matrix.h"
+
+/**
+ * \file
+ *
+ * Reads a set of matrix input pins with one access per GPIO port, rather than one per pin.
+ *
+ * Pins are grouped by port, and consecutive pins which land on consecutive bits of the same port are
+ * merged into a single run, so that each run is moved into place with one shift and mask.
+ */
+
+// Only the input pins are read through a map -- the columns for COL2ROW, or this half's rows for ROW2COL
+#ifndef MATRIX_PORT_MAX_PINS
+#    if defined(DIODE_DIRECTION) && (DIODE_DIRECTION == ROW2COL)
+#        ifdef SPLIT_KEYBOARD
+#            define MATRIX_PORT_MAX_PINS (MATRIX_ROWS / 2)
+#        else
+#            define MATRIX_PORT_MAX_PINS (MATRIX_ROWS)
+#        endif
+#    else
+#        define MATRIX_PORT_MAX_PINS (MATRIX_COLS)
+#    endif
+#endif
+
+typedef struct {
+    uint8_t  group;     // index into matrix_port_map_t.ports
+    uint8_t  pin_shift; // index of the first pin of the run within its port
+    uint8_t  bit_shift; // index of the first output bit of the run
+    uint32_t mask;      // one bit for each pin in the run
+} matrix_port_run_t;
+
+typedef struct {
+    uint8_t           port_count;
+    uint8_t           run_count;
+    pin_t             ports[MATRIX_PORT_MAX_PINS];
+    matrix_port_run_t runs[MATRIX_PORT_MAX_PINS];
+} matrix_port_map_t;
+
+/**
+ * \brief Build the port groupings and shift/mask table for a list of input pins.
+ *
+ * \param map The map to initialise.
+ * \param pins The input pins, in output bit order. `NO_PIN` entries always read as released.
+ * \param count The number of pins, at most `MATRIX_PORT_MAX_PINS`.
+ */
+void matrix_port_map_init(matrix_port_map_t *map, const pin_t *pins, uint8_t count);
+
+/**
+ * \brief Read all input pins described by a map.
+ *
+ * \param map The map to read.
+ *
+ * \return A bitmask with bit `n` set if the `n`th pin is in the pressed state.
+ */
+uint32_t matrix_port_map_read(const matrix_port_map_t *map);
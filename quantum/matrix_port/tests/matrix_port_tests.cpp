@@ -0,0 +1,118 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <vector>
+
+extern "C" {
+#include "matrix_port.h"
+}
+
+class MatrixPort : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        mock_gpio_reset();
+    }
+
+    // What the per-pin matrix code would read: pressed pins are pulled low
+    uint32_t read_pins_individually(const std::vector<pin_t>& pins) {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < pins.size(); i++) {
+            if (pins[i] == NO_PIN) {
+                continue;
+            }
+            bool level = (mock_gpio_read_port(gpio_get_pin_port(pins[i])) >> gpio_get_pin_index(pins[i])) & 1;
+            if (!level) {
+                bits |= (uint32_t)1 << i;
+            }
+        }
+        return bits;
+    }
+
+    matrix_port_map_t map;
+};
+
+TEST_F(MatrixPort, ContiguousPinsFormOneRun) {
+    std::vector<pin_t> pins = {MOCK_PIN(0, 4), MOCK_PIN(0, 5), MOCK_PIN(0, 6), MOCK_PIN(0, 7)};
+    matrix_port_map_init(&map, pins.data(), pins.size());
+
+    EXPECT_EQ(map.port_count, 1);
+    EXPECT_EQ(map.run_count, 1);
+    EXPECT_EQ(map.runs[0].pin_shift, 4);
+    EXPECT_EQ(map.runs[0].bit_shift, 0);
+    EXPECT_EQ(map.runs[0].mask, 0xFu);
+
+    EXPECT_EQ(matrix_port_map_read(&map), 0u);
+
+    mock_gpio_set_pin(MOCK_PIN(0, 5), false);
+    mock_gpio_set_pin(MOCK_PIN(0, 7), false);
+    // Unrelated pins on the same port are ignored
+    mock_gpio_set_pin(MOCK_PIN(0, 0), false);
+    EXPECT_EQ(matrix_port_map_read(&map), 0b1010u);
+}
+
+TEST_F(MatrixPort, OneReadPerPort) {
+    std::vector<pin_t> pins = {MOCK_PIN(1, 0), MOCK_PIN(2, 3), MOCK_PIN(1, 1), MOCK_PIN(2, 4), MOCK_PIN(1, 2)};
+    matrix_port_map_init(&map, pins.data(), pins.size());
+
+    EXPECT_EQ(map.port_count, 2);
+    EXPECT_EQ(map.run_count, 5);
+
+    mock_gpio_reset();
+    matrix_port_map_read(&map);
+    EXPECT_EQ(mock_gpio_port_read_count(), 2u);
+}
+
+TEST_F(MatrixPort, NoPinReadsAsReleased) {
+    std::vector<pin_t> pins = {MOCK_PIN(0, 0), NO_PIN, MOCK_PIN(0, 1), MOCK_PIN(0, 2)};
+    matrix_port_map_init(&map, pins.data(), pins.size());
+
+    // NO_PIN breaks the run, as the output bits are no longer consecutive
+    EXPECT_EQ(map.run_count, 2);
+
+    mock_gpio_set_port(0, 0);
+    EXPECT_EQ(matrix_port_map_read(&map), 0b1101u);
+}
+
+TEST_F(MatrixPort, ReversedPinsMatchPerPinReads) {
+    std::vector<pin_t> pins;
+    for (int i = 15; i >= 0; i--) {
+        pins.push_back(MOCK_PIN(3, i));
+    }
+    matrix_port_map_init(&map, pins.data(), pins.size());
+
+    EXPECT_EQ(map.run_count, 16);
+
+    for (port_data_t value : {0x0000u, 0xFFFFu, 0xA5A5u, 0x1234u, 0x8001u}) {
+        mock_gpio_set_port(3, value);
+        EXPECT_EQ(matrix_port_map_read(&map), read_pins_individually(pins)) << "port value " << value;
+    }
+}
+
+TEST_F(MatrixPort, RandomLayoutsMatchPerPinReads) {
+    srand(1234);
+    for (int layout = 0; layout < 100; layout++) {
+        std::vector<pin_t> pins;
+        for (int i = 0; i < MATRIX_COLS; i++) {
+            if (rand() % 10 == 0) {
+                pins.push_back(NO_PIN);
+            } else if (!pins.empty() && pins.back() != NO_PIN && (pins.back() & 0xFF) < 31 && rand() % 2) {
+                // Bias towards runs of consecutive pins, as on real boards
+                pins.push_back(pins.back() + 1);
+            } else {
+                pins.push_back(MOCK_PIN(rand() % 4, rand() % 32));
+            }
+        }
+        matrix_port_map_init(&map, pins.data(), pins.size());
+        EXPECT_LE(map.run_count, MATRIX_COLS);
+
+        for (int sample = 0; sample < 20; sample++) {
+            for (uint8_t port = 0; port < 4; port++) {
+                mock_gpio_set_port(port, ((port_data_t)rand() << 16) ^ (port_data_t)rand());
+            }
+            EXPECT_EQ(matrix_port_map_read(&map), read_pins_individually(pins)) << "layout " << layout << " sample " << sample;
+        }
+    }
+}
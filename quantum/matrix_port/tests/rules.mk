@@ -0,0 +1,8 @@
+matrix_port_DEFS := -DMATRIX_ROWS=40 -DMATRIX_COLS=20
+matrix_port_INC := $(QUANTUM_PATH)/matrix_port
+matrix_port_CONFIG := $(PLATFORM_PATH)/test/gpio_port_mock.h
+
+matrix_port_SRC := \
+	$(PLATFORM_PATH)/test/gpio_port_mock.c \
+	$(QUANTUM_PATH)/matrix_port/matrix_port.c \
+	$(QUANTUM_PATH)/matrix_port/tests/matrix_port_tests.cpp
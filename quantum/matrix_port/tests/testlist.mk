@@ -0,0 +1,2 @@
+TEST_LIST += \
+	matrix_port
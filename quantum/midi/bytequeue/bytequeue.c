@@ -1,4 +1,4 @@
-// this is a single reader [maybe multiple writer?] byte queue
+// this is a lock-free single reader single writer byte queue
 // Copyright 2008 Alex Norman
 // writen by Alex Norman
 //
@@ -18,7 +18,10 @@
 // along with avr-bytequeue.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "bytequeue.h"
-#include "interrupt_setting.h"
+
+// Only orders the compiler, the queue is meant for single core MCUs where an
+// interrupt either sees a store completely or not at all.
+#define bytequeue_barrier() __asm__ volatile("" ::: "memory")
 
 void bytequeue_init(byteQueue_t* queue, uint8_t* dataArray, byteQueueIndex_t arrayLen) {
     queue->length = arrayLen;
@@ -26,29 +29,28 @@ void bytequeue_init(byteQueue_t* queue, uint8_t* dataArray, byteQueueIndex_t arr
     queue->start = queue->end = 0;
 }
 
+// only the writer updates end, so no locking is required
 bool bytequeue_enqueue(byteQueue_t* queue, uint8_t item) {
-    interrupt_setting_t setting = store_and_clear_interrupt();
+    byteQueueIndex_t end  = queue->end;
+    byteQueueIndex_t next = (end + 1) % queue->length;
     // full
-    if (((queue->end + 1) % queue->length) == queue->start) {
-        restore_interrupt_setting(setting);
+    if (next == queue->start) {
         return false;
-    } else {
-        queue->data[queue->end] = item;
-        queue->end              = (queue->end + 1) % queue->length;
-        restore_interrupt_setting(setting);
-        return true;
     }
+    queue->data[end] = item;
+    // the byte has to be in place before the reader can see it
+    bytequeue_barrier();
+    queue->end = next;
+    return true;
 }
 
 byteQueueIndex_t bytequeue_length(byteQueue_t* queue) {
-    byteQueueIndex_t    len;
-    interrupt_setting_t setting = store_and_clear_interrupt();
-    if (queue->end >= queue->start)
-        len = queue->end - queue->start;
+    byteQueueIndex_t start = queue->start;
+    byteQueueIndex_t end   = queue->end;
+    if (end >= start)
+        return end - start;
     else
-        len = (queue->length - queue->start) + queue->end;
-    restore_interrupt_setting(setting);
-    return len;
+        return (queue->length - start) + end;
 }
 
 // we don't need to avoid interrupts if there is only one reader
@@ -56,9 +58,9 @@ uint8_t bytequeue_get(byteQueue_t* queue, byteQueueIndex_t index) {
     return queue->data[(queue->start + index) % queue->length];
 }
 
-// we just update the start index to remove elements
+// we just update the start index to remove elements, only the reader does that
 void bytequeue_remove(byteQueue_t* queue, byteQueueIndex_t numToRemove) {
-    interrupt_setting_t setting = store_and_clear_interrupt();
-    queue->start                = (queue->start + numToRemove) % queue->length;
-    restore_interrupt_setting(setting);
+    // the bytes have to be read before the writer may reuse their slots
+    bytequeue_barrier();
+    queue->start = (queue->start + numToRemove) % queue->length;
 }
@@ -1,4 +1,4 @@
-// this is a single reader [maybe multiple writer?] byte queue
+// this is a lock-free single reader single writer byte queue
 // Copyright 2008 Alex Norman
 // writen by Alex Norman
 //
@@ -28,11 +28,13 @@ extern "C" {
 
 typedef uint8_t byteQueueIndex_t;
 
+// the reader only moves start and the writer only moves end, so one of them
+// may run from an interrupt without either having to disable interrupts
 typedef struct {
-    byteQueueIndex_t start;
-    byteQueueIndex_t end;
-    byteQueueIndex_t length;
-    uint8_t*         data;
+    volatile byteQueueIndex_t start;
+    volatile byteQueueIndex_t end;
+    byteQueueIndex_t          length;
+    uint8_t*                  data;
 } byteQueue_t;
 
 // you must have a queue, an array of data which the queue will use, and the length of that array
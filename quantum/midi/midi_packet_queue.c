@@ -0,0 +1,99 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "midi_packet_queue.h"
+
+_Static_assert(MIDI_PACKET_QUEUE_LENGTH <= 255, "MIDI_PACKET_QUEUE_LENGTH must fit the 8 bit queue indices");
+
+#define midi_packet_queue_barrier() __asm__ volatile("" ::: "memory")
+
+// code index number of a control change, in the low nibble of the event byte
+#define MIDI_PACKET_CIN_CC 0x0B
+
+static inline uint8_t next_index(uint8_t index) {
+    return (index + 1) % MIDI_PACKET_QUEUE_LENGTH;
+}
+
+// Only continuous controllers may lose intermediate values. Switches such as sustain (64-69) and the channel mode
+// messages (120-127) act on every message, so dropping one changes what the receiver does.
+static inline bool is_continuous_controller(uint8_t controller) {
+    return !(controller >= 64 && controller <= 69) && controller < 120;
+}
+
+static bool midi_packet_queue_coalesce(midi_packet_queue_t *queue, const midi_packet_t *packet) {
+    if ((packet->event & 0x0F) != MIDI_PACKET_CIN_CC || !is_continuous_controller(packet->data2)) {
+        return false;
+    }
+
+    // newest first, the matching packet is most likely near the end
+    uint8_t tail  = queue->tail;
+    uint8_t index = queue->head;
+    while (index != tail) {
+        index                = (index + MIDI_PACKET_QUEUE_LENGTH - 1) % MIDI_PACKET_QUEUE_LENGTH;
+        midi_packet_t *entry = &queue->packets[index];
+        // same cable, channel and controller
+        if (entry->event == packet->event && entry->data1 == packet->data1 && entry->data2 == packet->data2) {
+            entry->data3 = packet->data3;
+            queue->stats.coalesced++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void midi_packet_queue_init(midi_packet_queue_t *queue) {
+    queue->head            = 0;
+    queue->tail            = 0;
+    queue->stats.queued    = 0;
+    queue->stats.coalesced = 0;
+    queue->stats.max_depth = 0;
+}
+
+bool midi_packet_queue_push(midi_packet_queue_t *queue, const midi_packet_t *packet) {
+    uint8_t length = midi_packet_queue_length(queue);
+    if (length >= MIDI_PACKET_QUEUE_COALESCE_DEPTH && midi_packet_queue_coalesce(queue, packet)) {
+        return true;
+    }
+
+    uint8_t head = queue->head;
+    uint8_t next = next_index(head);
+    // full
+    if (next == queue->tail) {
+        return false;
+    }
+
+    queue->packets[head] = *packet;
+    // the packet has to be in place before the reader can see it
+    midi_packet_queue_barrier();
+    queue->head = next;
+
+    queue->stats.queued++;
+    if (length + 1 > queue->stats.max_depth) {
+        queue->stats.max_depth = length + 1;
+    }
+    return true;
+}
+
+uint8_t midi_packet_queue_pop(midi_packet_queue_t *queue, midi_packet_t *packets, uint8_t count) {
+    uint8_t head   = queue->head;
+    uint8_t tail   = queue->tail;
+    uint8_t popped = 0;
+
+    // the head has to be read before the packets it covers
+    midi_packet_queue_barrier();
+    while (popped < count && tail != head) {
+        packets[popped++] = queue->packets[tail];
+        tail              = next_index(tail);
+    }
+
+    // the packets have to be read before the writer may reuse their slots
+    midi_packet_queue_barrier();
+    queue->tail = tail;
+    return popped;
+}
+
+uint8_t midi_packet_queue_length(midi_packet_queue_t *queue) {
+    uint8_t head = queue->head;
+    uint8_t tail = queue->tail;
+    return (head + MIDI_PACKET_QUEUE_LENGTH - tail) % MIDI_PACKET_QUEUE_LENGTH;
+}
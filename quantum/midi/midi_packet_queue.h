@@ -0,0 +1,69 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/**
+ * @file
+ * @brief Queue of outgoing USB-MIDI event packets
+ *
+ * Outgoing messages are queued as 4 byte USB-MIDI event packets, so that they
+ * can be written to the endpoint a full transfer at a time. One writer and one
+ * reader may use the queue without locking. When the queue backs up, a control
+ * change of a continuous controller replaces the value of a still queued
+ * control change for the same controller instead of taking another slot, this
+ * rewrites a queued packet so the coalescing writer must not run concurrently
+ * with the reader. Switch controllers (64-69) and channel mode messages
+ * (120-127) are never coalesced.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef MIDI_PACKET_QUEUE_LENGTH
+#    define MIDI_PACKET_QUEUE_LENGTH 64
+#endif
+
+// number of queued packets from which on control changes are coalesced
+#ifndef MIDI_PACKET_QUEUE_COALESCE_DEPTH
+#    define MIDI_PACKET_QUEUE_COALESCE_DEPTH 16
+#endif
+
+// same layout as MIDI_EventPacket_t
+typedef struct {
+    uint8_t event;
+    uint8_t data1;
+    uint8_t data2;
+    uint8_t data3;
+} midi_packet_t;
+
+typedef struct {
+    uint32_t queued;
+    uint32_t coalesced;
+    uint8_t  max_depth;
+} midi_packet_queue_stats_t;
+
+typedef struct {
+    volatile uint8_t          head;
+    volatile uint8_t          tail;
+    midi_packet_queue_stats_t stats;
+    midi_packet_t             packets[MIDI_PACKET_QUEUE_LENGTH];
+} midi_packet_queue_t;
+
+void midi_packet_queue_init(midi_packet_queue_t *queue);
+
+// returns false if the queue is full and the packet could not be coalesced
+bool midi_packet_queue_push(midi_packet_queue_t *queue, const midi_packet_t *packet);
+
+// copies up to count of the oldest packets into packets and removes them, returns the number copied
+uint8_t midi_packet_queue_pop(midi_packet_queue_t *queue, midi_packet_t *packets, uint8_t count);
+
+uint8_t midi_packet_queue_length(midi_packet_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
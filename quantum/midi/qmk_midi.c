@@ -2,6 +2,7 @@
 #include "qmk_midi.h"
 #include "sysex_tools.h"
 #include "midi.h"
+#include "midi_packet_queue.h"
 #include "usb_descriptor.h"
 #include "process_midi.h"
 
@@ -9,6 +10,9 @@
 #    include "audio.h"
 #    include <math.h>
 #endif
+#ifdef SEQUENCER_ENABLE
+#    include "sequencer.h"
+#endif
 
 /*******************************************************************************
  * MIDI
@@ -16,6 +20,13 @@
 
 MidiDevice midi_device;
 
+// one full endpoint transfer worth of event packets
+#define MIDI_PACKETS_PER_TRANSFER (MIDI_STREAM_EPSIZE / sizeof(MIDI_EventPacket_t))
+
+_Static_assert(sizeof(midi_packet_t) == sizeof(MIDI_EventPacket_t), "midi_packet_t must match the USB-MIDI event packet layout");
+
+static midi_packet_queue_t midi_out_queue;
+
 #define SYSEX_START_OR_CONT 0x40
 #define SYSEX_ENDS_IN_1 0x50
 #define SYSEX_ENDS_IN_2 0x60
@@ -74,10 +85,31 @@ static void usb_send_func(MidiDevice* device, uint16_t cnt, uint8_t byte0, uint8
         }
     }
 
-    send_midi_packet(&event);
+    if (!midi_packet_queue_push(&midi_out_queue, (midi_packet_t*)&event)) {
+        // the host is not keeping up, hand everything to the endpoint and wait for it like an unqueued send would
+        midi_packet_t packet;
+        while (midi_packet_queue_pop(&midi_out_queue, &packet, 1)) {
+            send_midi_packet((MIDI_EventPacket_t*)&packet);
+        }
+        send_midi_packet(&event);
+        flush_midi_packets();
+    }
+}
+
+static void usb_send_queued_midi(void) {
+    midi_packet_t packets[MIDI_PACKETS_PER_TRANSFER];
+    uint8_t       count = midi_packet_queue_pop(&midi_out_queue, packets, MIDI_PACKETS_PER_TRANSFER);
+    if (count == 0) return;
+
+    for (uint8_t i = 0; i < count; i++) {
+        send_midi_packet((MIDI_EventPacket_t*)&packets[i]);
+    }
+    flush_midi_packets();
 }
 
 static void usb_get_midi(MidiDevice* device) {
+    usb_send_queued_midi();
+
     MIDI_EventPacket_t event;
     while (recv_midi_packet(&event)) {
         midi_packet_length_t length = midi_packet_length(event.Data1);
@@ -115,12 +147,33 @@ static void fallthrough_callback(MidiDevice* device, uint16_t cnt, uint8_t byte0
                 break;
         }
     }
-    if (byte0 == MIDI_STOP) {
-        stop_all_notes();
-    }
 #endif
 }
 
+static void realtime_callback(MidiDevice* device, uint8_t byte) {
+    switch (byte) {
+#ifdef SEQUENCER_ENABLE
+        case MIDI_CLOCK:
+            sequencer_midi_clock();
+            break;
+        case MIDI_START:
+            sequencer_midi_start();
+            break;
+        case MIDI_CONTINUE:
+            sequencer_midi_continue();
+            break;
+#endif
+        case MIDI_STOP:
+#ifdef AUDIO_ENABLE
+            stop_all_notes();
+#endif
+#ifdef SEQUENCER_ENABLE
+            sequencer_midi_stop();
+#endif
+            break;
+    }
+}
+
 static void cc_callback(MidiDevice* device, uint8_t chan, uint8_t num, uint8_t val) {
     // sending it back on the next channel
     // midi_send_cc(device, (chan + 1) % 16, num, val);
@@ -132,9 +185,11 @@ void setup_midi(void) {
 #ifdef MIDI_ADVANCED
     midi_init();
 #endif
+    midi_packet_queue_init(&midi_out_queue);
     midi_device_init(&midi_device);
     midi_device_set_send_func(&midi_device, usb_send_func);
     midi_device_set_pre_input_process_func(&midi_device, usb_get_midi);
     midi_register_fallthrough_callback(&midi_device, fallthrough_callback);
+    midi_register_realtime_callback(&midi_device, realtime_callback);
     midi_register_cc_callback(&midi_device, cc_callback);
 }
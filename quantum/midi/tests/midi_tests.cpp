@@ -0,0 +1,227 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+extern "C" {
+#include "midi.h"
+#include "midi_packet_queue.h"
+#include "bytequeue/bytequeue.h"
+}
+
+// Small deterministic generator for burst sizes
+static uint32_t burst_state = 1;
+static uint8_t  next_burst(uint8_t max) {
+    burst_state = burst_state * 1103515245 + 12345;
+    return 1 + (burst_state >> 16) % max;
+}
+
+TEST(ByteQueue, SustainedStreamKeepsOrder) {
+    uint8_t     data[MIDI_INPUT_QUEUE_LENGTH];
+    byteQueue_t queue;
+    bytequeue_init(&queue, data, sizeof(data));
+
+    const uint32_t total    = 1000000;
+    uint32_t       written  = 0;
+    uint32_t       read     = 0;
+    uint32_t       rejected = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (read < total) {
+        for (uint8_t burst = next_burst(64); burst && written < total; burst--) {
+            if (!bytequeue_enqueue(&queue, (uint8_t)written)) {
+                rejected++;
+                break;
+            }
+            written++;
+        }
+        EXPECT_EQ(bytequeue_length(&queue), written - read);
+        for (uint8_t burst = next_burst(64); burst && bytequeue_length(&queue); burst--) {
+            ASSERT_EQ(bytequeue_get(&queue, 0), (uint8_t)read);
+            bytequeue_remove(&queue, 1);
+            read++;
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(bytequeue_length(&queue), 0);
+    EXPECT_GT(rejected, 0);
+    printf("[ MIDI     ] bytequeue: %u bytes in %lld us\n", (unsigned)total, (long long)elapsed);
+}
+
+TEST(ByteQueue, FullQueueRejectsBytes) {
+    uint8_t     data[4];
+    byteQueue_t queue;
+    bytequeue_init(&queue, data, sizeof(data));
+
+    // one slot always stays free
+    EXPECT_TRUE(bytequeue_enqueue(&queue, 1));
+    EXPECT_TRUE(bytequeue_enqueue(&queue, 2));
+    EXPECT_TRUE(bytequeue_enqueue(&queue, 3));
+    EXPECT_FALSE(bytequeue_enqueue(&queue, 4));
+    EXPECT_EQ(bytequeue_length(&queue), 3);
+
+    bytequeue_remove(&queue, 2);
+    EXPECT_EQ(bytequeue_get(&queue, 0), 3);
+    EXPECT_TRUE(bytequeue_enqueue(&queue, 5));
+    EXPECT_TRUE(bytequeue_enqueue(&queue, 6));
+    EXPECT_EQ(bytequeue_length(&queue), 3);
+    EXPECT_EQ(bytequeue_get(&queue, 2), 6);
+}
+
+static std::vector<uint8_t> received_notes;
+
+static void noteon_callback(MidiDevice *device, uint8_t chan, uint8_t note, uint8_t velocity) {
+    received_notes.push_back(note);
+}
+
+TEST(MidiDevice, InputStreamIsProcessedInOrder) {
+    MidiDevice device;
+    midi_device_init(&device);
+    midi_register_noteon_callback(&device, noteon_callback);
+    received_notes.clear();
+
+    uint32_t sent = 0;
+    for (uint32_t scan = 0; scan < 1000; scan++) {
+        // as many messages as a USB frame could carry
+        for (uint8_t i = 0; i < 16; i++) {
+            uint8_t message[3] = {MIDI_NOTEON, (uint8_t)(sent % 128), 100};
+            midi_device_input(&device, sizeof(message), message);
+            sent++;
+        }
+        midi_device_process(&device);
+    }
+
+    ASSERT_EQ(received_notes.size(), sent);
+    for (uint32_t i = 0; i < sent; i++) {
+        ASSERT_EQ(received_notes[i], i % 128);
+    }
+}
+
+static midi_packet_t cc_packet(uint8_t controller, uint8_t value) {
+    return {0x0B, MIDI_CC, controller, value};
+}
+
+static midi_packet_t note_packet(uint8_t note) {
+    return {0x09, MIDI_NOTEON, note, 100};
+}
+
+TEST(MidiPacketQueue, ControlChangesAreNotCoalescedUntilBackedUp) {
+    midi_packet_queue_t queue;
+    midi_packet_queue_init(&queue);
+
+    for (uint8_t value = 0; value < MIDI_PACKET_QUEUE_COALESCE_DEPTH; value++) {
+        midi_packet_t packet = cc_packet(1, value);
+        EXPECT_TRUE(midi_packet_queue_push(&queue, &packet));
+    }
+    EXPECT_EQ(midi_packet_queue_length(&queue), MIDI_PACKET_QUEUE_COALESCE_DEPTH);
+    EXPECT_EQ(queue.stats.coalesced, 0);
+
+    // from here on the newest queued value is replaced
+    midi_packet_t packet = cc_packet(1, 100);
+    EXPECT_TRUE(midi_packet_queue_push(&queue, &packet));
+    EXPECT_EQ(midi_packet_queue_length(&queue), MIDI_PACKET_QUEUE_COALESCE_DEPTH);
+    EXPECT_EQ(queue.stats.coalesced, 1);
+
+    midi_packet_t packets[MIDI_PACKET_QUEUE_LENGTH];
+    uint8_t       count = midi_packet_queue_pop(&queue, packets, MIDI_PACKET_QUEUE_LENGTH);
+    ASSERT_EQ(count, MIDI_PACKET_QUEUE_COALESCE_DEPTH);
+    EXPECT_EQ(packets[count - 1].data3, 100);
+    EXPECT_EQ(midi_packet_queue_length(&queue), 0);
+}
+
+TEST(MidiPacketQueue, SwitchesAreNeverCoalesced) {
+    midi_packet_queue_t queue;
+    midi_packet_queue_init(&queue);
+
+    for (uint8_t value = 0; value < MIDI_PACKET_QUEUE_COALESCE_DEPTH; value++) {
+        midi_packet_t packet = cc_packet(1, value);
+        ASSERT_TRUE(midi_packet_queue_push(&queue, &packet));
+    }
+
+    // sustain released and pressed again while backed up, both edges have to reach the host
+    midi_packet_t sustain_off = cc_packet(64, 0);
+    midi_packet_t sustain_on  = cc_packet(64, 127);
+    midi_packet_t all_off     = cc_packet(123, 0);
+    EXPECT_TRUE(midi_packet_queue_push(&queue, &sustain_off));
+    EXPECT_TRUE(midi_packet_queue_push(&queue, &sustain_on));
+    EXPECT_TRUE(midi_packet_queue_push(&queue, &all_off));
+    EXPECT_TRUE(midi_packet_queue_push(&queue, &all_off));
+    EXPECT_EQ(queue.stats.coalesced, 0);
+
+    midi_packet_t packets[MIDI_PACKET_QUEUE_LENGTH];
+    uint8_t       count = midi_packet_queue_pop(&queue, packets, MIDI_PACKET_QUEUE_LENGTH);
+    ASSERT_EQ(count, MIDI_PACKET_QUEUE_COALESCE_DEPTH + 4);
+    EXPECT_EQ(packets[count - 4].data2, 64);
+    EXPECT_EQ(packets[count - 4].data3, 0);
+    EXPECT_EQ(packets[count - 3].data2, 64);
+    EXPECT_EQ(packets[count - 3].data3, 127);
+    EXPECT_EQ(packets[count - 2].data2, 123);
+    EXPECT_EQ(packets[count - 1].data2, 123);
+}
+
+TEST(MidiPacketQueue, FullQueueRejectsNotes) {
+    midi_packet_queue_t queue;
+    midi_packet_queue_init(&queue);
+
+    for (uint8_t i = 0; i < MIDI_PACKET_QUEUE_LENGTH - 1; i++) {
+        midi_packet_t packet = note_packet(i);
+        EXPECT_TRUE(midi_packet_queue_push(&queue, &packet));
+    }
+    midi_packet_t packet = note_packet(0);
+    EXPECT_FALSE(midi_packet_queue_push(&queue, &packet));
+    EXPECT_EQ(queue.stats.max_depth, MIDI_PACKET_QUEUE_LENGTH - 1);
+}
+
+TEST(MidiPacketQueue, SustainedSweepIsBatchedAndOrdered) {
+    midi_packet_queue_t queue;
+    midi_packet_queue_init(&queue);
+
+    const uint8_t  per_transfer  = 16; // 64 byte endpoint
+    const uint8_t  controllers   = 4;
+    uint8_t        last_cc[128]  = {0};
+    uint8_t        pushed_cc[4]  = {0};
+    uint32_t       notes_pushed  = 0;
+    uint32_t       notes_seen    = 0;
+    uint32_t       cc_pushed     = 0;
+    uint32_t       transfers     = 0;
+    uint32_t       packets_total = 0;
+    midi_packet_t  packets[per_transfer];
+
+    for (uint32_t frame = 0; frame < 2000; frame++) {
+        // an encoder sweep producing far more than one transfer per frame
+        for (uint8_t i = 0; i < 40 && frame < 1900; i++) {
+            uint8_t       controller = i % controllers;
+            midi_packet_t cc         = cc_packet(controller, ++pushed_cc[controller] & 0x7F);
+            ASSERT_TRUE(midi_packet_queue_push(&queue, &cc));
+            cc_pushed++;
+            if (i % 10 == 0) {
+                midi_packet_t note = note_packet(notes_pushed++ % 128);
+                ASSERT_TRUE(midi_packet_queue_push(&queue, &note));
+            }
+        }
+
+        uint8_t count = midi_packet_queue_pop(&queue, packets, per_transfer);
+        if (count) transfers++;
+        packets_total += count;
+        for (uint8_t i = 0; i < count; i++) {
+            if (packets[i].data1 == MIDI_NOTEON) {
+                ASSERT_EQ(packets[i].data2, notes_seen++ % 128);
+            } else {
+                last_cc[packets[i].data2] = packets[i].data3;
+            }
+        }
+    }
+
+    EXPECT_EQ(midi_packet_queue_length(&queue), 0);
+    EXPECT_EQ(notes_seen, notes_pushed);
+    for (uint8_t controller = 0; controller < controllers; controller++) {
+        EXPECT_EQ(last_cc[controller], pushed_cc[controller] & 0x7F);
+    }
+    EXPECT_GT(queue.stats.coalesced, 0);
+    EXPECT_LE(queue.stats.max_depth, MIDI_PACKET_QUEUE_LENGTH - 1);
+    printf("[ MIDI     ] %u messages sent as %u packets in %u transfers, %u coalesced\n", (unsigned)(cc_pushed + notes_pushed), (unsigned)packets_total, (unsigned)transfers, (unsigned)queue.stats.coalesced);
+}
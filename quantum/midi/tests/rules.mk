@@ -0,0 +1,9 @@
+midi_DEFS := -DNO_DEBUG -DNO_PRINT
+midi_INC := $(QUANTUM_PATH)/midi
+
+midi_SRC := \
+	$(QUANTUM_PATH)/midi/tests/midi_tests.cpp \
+	$(QUANTUM_PATH)/midi/midi.c \
+	$(QUANTUM_PATH)/midi/midi_device.c \
+	$(QUANTUM_PATH)/midi/midi_packet_queue.c \
+	$(QUANTUM_PATH)/midi/bytequeue/bytequeue.c
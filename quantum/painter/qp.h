@@ -56,6 +56,30 @@
 #    define QUANTUM_PAINTER_LOAD_FONTS_TO_RAM FALSE
 #endif
 
+#ifndef QUANTUM_PAINTER_GLYPH_CACHE_SIZE
+/**
+ * @def This controls the number of recently-drawn glyphs whose metrics are kept in RAM, so that repeated text redraws
+ *      do not need to walk the font's glyph tables again. Set to 0 to disable the glyph cache.
+ */
+#    define QUANTUM_PAINTER_GLYPH_CACHE_SIZE 0
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_SIZE
+
+#ifndef QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE
+/**
+ * @def This controls the number of bytes of decompressed glyph data held by each glyph cache entry. Glyphs which fit
+ *      are redrawn without touching the font's storage at all. Set to 0 to cache metrics only.
+ */
+#    define QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE 32
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE
+
+#ifndef QUANTUM_PAINTER_FLASH_STREAM_BUFFER_SIZE
+/**
+ * @def This controls the size of the read buffer used when loading images and fonts from external flash. Each loaded
+ *      image or font holds its own buffer, so increasing this number increases the amount of RAM required.
+ */
+#    define QUANTUM_PAINTER_FLASH_STREAM_BUFFER_SIZE 32
+#endif // QUANTUM_PAINTER_FLASH_STREAM_BUFFER_SIZE
+
 #ifndef QUANTUM_PAINTER_CONCURRENT_ANIMATIONS
 /**
  * @def This controls the maximum number of animations that Quantum Painter can play simultaneously. Increasing this
@@ -353,6 +377,20 @@ bool qp_pixdata(painter_device_t device, const void *pixel_data, uint32_t native
  */
 painter_image_handle_t qp_load_image_mem(const void *buffer);
 
+#ifdef QP_STREAM_HAS_FLASH_IO
+/**
+ * Loads an image from external flash.
+ *
+ * @note Images can be unloaded by calling \ref qp_close_image.
+ *
+ * @param address[in] the flash address of the image data to load
+ * @return an image handle usable with \ref qp_drawimage, \ref qp_drawimage_recolor, \ref qp_animate, and
+ *         \ref qp_animate_recolor.
+ * @return NULL if loading the image failed
+ */
+painter_image_handle_t qp_load_image_flash(uint32_t address);
+#endif // QP_STREAM_HAS_FLASH_IO
+
 /**
  * Closes an image handle when no longer in use.
  *
@@ -440,6 +478,19 @@ void qp_stop_animation(deferred_token anim_token);
  */
 painter_font_handle_t qp_load_font_mem(const void *buffer);
 
+#ifdef QP_STREAM_HAS_FLASH_IO
+/**
+ * Loads a font from external flash.
+ *
+ * @note Fonts can be unloaded by calling \ref qp_close_font.
+ *
+ * @param address[in] the flash address of the font data to load
+ * @return an image handle usable with \ref qp_textwidth, \ref qp_drawtext, and \ref qp_drawtext_recolor.
+ * @return NULL if loading the font failed
+ */
+painter_font_handle_t qp_load_font_flash(uint32_t address);
+#endif // QP_STREAM_HAS_FLASH_IO
+
 /**
  * Closes a font handle when no longer in use.
  *
@@ -165,7 +165,110 @@ bool qp_internal_byte_appender(uint8_t byteval, void* cb_arg) {
     return true;
 }
 
-// Helper shared between image and font rendering -- uses either (qp_internal_decode_palette + qp_internal_pixel_appender) or (qp_internal_send_bytes) to send data data to the display based on the asset's native-ness
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Block-based palette decoding
+
+// Number of packed bytes decoded per block -- the unpacked palette indices need up to 8x this on the stack
+#define QP_DECODE_BLOCK_BYTES 16
+
+// Unpacks whole bytes of palette indices at a time, least-significant bits first as per qp_internal_decode_palette()
+static inline void qp_internal_unpack_palette_indices(uint8_t bits_per_pixel, const uint8_t* packed, uint8_t* indices, uint16_t byte_count) {
+    switch (bits_per_pixel) {
+        case 1:
+            for (uint16_t i = 0; i < byte_count; ++i, indices += 8) {
+                uint8_t b  = packed[i];
+                indices[0] = b & 0x01;
+                indices[1] = (b >> 1) & 0x01;
+                indices[2] = (b >> 2) & 0x01;
+                indices[3] = (b >> 3) & 0x01;
+                indices[4] = (b >> 4) & 0x01;
+                indices[5] = (b >> 5) & 0x01;
+                indices[6] = (b >> 6) & 0x01;
+                indices[7] = b >> 7;
+            }
+            break;
+        case 2:
+            for (uint16_t i = 0; i < byte_count; ++i, indices += 4) {
+                uint8_t b  = packed[i];
+                indices[0] = b & 0x03;
+                indices[1] = (b >> 2) & 0x03;
+                indices[2] = (b >> 4) & 0x03;
+                indices[3] = b >> 6;
+            }
+            break;
+        case 4:
+            for (uint16_t i = 0; i < byte_count; ++i, indices += 2) {
+                uint8_t b  = packed[i];
+                indices[0] = b & 0x0F;
+                indices[1] = b >> 4;
+            }
+            break;
+        case 8:
+            memcpy(indices, packed, byte_count);
+            break;
+    }
+}
+
+// Equivalent to qp_internal_decode_palette + qp_internal_pixel_appender, but hands the driver whole blocks of pixels
+// at a time. Uncompressed data is read straight from the stream, skipping the per-byte input callback.
+static bool qp_internal_append_palette_blocks(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, qp_internal_byte_input_callback input_callback, void* input_arg, qp_internal_pixel_output_state_t* output_state) {
+    painter_driver_t* driver          = (painter_driver_t*)device;
+    const uint8_t     pixels_per_byte = 8 / bits_per_pixel;
+    const uint32_t    max_block       = QP_DECODE_BLOCK_BYTES * pixels_per_byte;
+    const bool        bulk_read       = input_callback == qp_drawimage_byte_uncompressed_decoder;
+    uint8_t           packed[QP_DECODE_BLOCK_BYTES];
+    uint8_t           indices[QP_DECODE_BLOCK_BYTES * 8];
+
+    uint32_t remaining_pixels = pixel_count;
+    while (remaining_pixels > 0) {
+        // Pull in the next block of packed indices, leaving any unused bits of the final byte unread
+        uint32_t block_pixels = remaining_pixels < max_block ? remaining_pixels : max_block;
+        uint16_t byte_count   = (block_pixels + pixels_per_byte - 1) / pixels_per_byte;
+        if (bulk_read) {
+            qp_internal_byte_input_state_t* state = (qp_internal_byte_input_state_t*)input_arg;
+            if (qp_stream_read(packed, 1, byte_count, state->src_stream) != byte_count) {
+                return false;
+            }
+        } else {
+            for (uint16_t i = 0; i < byte_count; ++i) {
+                int16_t byteval = input_callback(input_arg);
+                if (byteval < 0) {
+                    return false;
+                }
+                packed[i] = (uint8_t)byteval;
+            }
+        }
+        qp_internal_unpack_palette_indices(bits_per_pixel, packed, indices, byte_count);
+
+        // Hand the block to the driver, splitting it wherever the pixdata buffer fills up
+        uint8_t* next = indices;
+        uint32_t left = block_pixels;
+        while (left > 0) {
+            uint32_t room  = output_state->max_pixels - output_state->pixel_write_pos;
+            uint32_t count = left < room ? left : room;
+            if (!driver->driver_vtable->append_pixels(device, qp_internal_global_pixdata_buffer, qp_internal_global_pixel_lookup_table, output_state->pixel_write_pos, count, next)) {
+                return false;
+            }
+            output_state->pixel_write_pos += count;
+            next += count;
+            left -= count;
+
+            // If we've hit the transmit limit, send out the entire buffer and reset the write position
+            if (output_state->pixel_write_pos == output_state->max_pixels) {
+                if (!driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, output_state->pixel_write_pos)) {
+                    return false;
+                }
+                output_state->pixel_write_pos = 0;
+            }
+        }
+
+        remaining_pixels -= block_pixels;
+    }
+
+    return true;
+}
+
+// Helper shared between image and font rendering -- uses either (qp_internal_append_palette_blocks) or (qp_internal_send_bytes) to send data data to the display based on the asset's native-ness
 bool qp_internal_appender(painter_device_t device, uint8_t bpp, uint32_t pixel_count, qp_internal_byte_input_callback input_callback, void* input_state) {
     painter_driver_t* driver = (painter_driver_t*)device;
 
@@ -177,7 +280,7 @@ bool qp_internal_appender(painter_device_t device, uint8_t bpp, uint32_t pixel_c
         qp_internal_pixel_output_state_t output_state = {.device = device, .pixel_write_pos = 0, .max_pixels = qp_internal_num_pixels_in_buffer(device)};
 
         // Decode the pixel data and stream to the display
-        ret = qp_internal_decode_palette(device, pixel_count, bpp, input_callback, input_state, qp_internal_global_pixel_lookup_table, qp_internal_pixel_appender, &output_state);
+        ret = qp_internal_append_palette_blocks(device, pixel_count, bpp, input_callback, input_state, &output_state);
         // Any leftovers need transmission as well.
         if (ret && output_state.pixel_write_pos > 0) {
             ret &= driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, output_state.pixel_write_pos);
@@ -192,9 +295,25 @@ bool qp_internal_appender(painter_device_t device, uint8_t bpp, uint32_t pixel_c
         // Set up the output state
         qp_internal_byte_output_state_t output_state = {.device = device, .byte_write_pos = 0, .max_bytes = qp_internal_num_pixels_in_buffer(device) * driver->native_bits_per_pixel / 8};
 
-        // Stream the raw pixel data to the display
+        // Stream the raw pixel data to the display -- uncompressed data is already in native format, so read it straight
+        // into the pixdata buffer
         uint32_t byte_count = pixel_count * bpp / 8;
-        ret                 = qp_internal_send_bytes(device, byte_count, input_callback, input_state, qp_internal_byte_appender, &output_state);
+        if (input_callback == qp_drawimage_byte_uncompressed_decoder) {
+            qp_internal_byte_input_state_t* state = (qp_internal_byte_input_state_t*)input_state;
+            ret                                   = true;
+            while (ret && byte_count > 0) {
+                uint32_t count = byte_count < output_state.max_bytes ? byte_count : output_state.max_bytes;
+                ret            = qp_stream_read(qp_internal_global_pixdata_buffer, 1, count, state->src_stream) == count;
+                byte_count -= count;
+                if (ret && byte_count > 0) {
+                    ret = driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, count * 8 / driver->native_bits_per_pixel);
+                } else {
+                    output_state.byte_write_pos = count; // final block goes out with the leftovers below
+                }
+            }
+        } else {
+            ret = qp_internal_send_bytes(device, byte_count, input_callback, input_state, qp_internal_byte_appender, &output_state);
+        }
         // Any leftovers need transmission as well.
         if (ret && output_state.byte_write_pos > 0) {
             ret &= driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, output_state.byte_write_pos * 8 / driver->native_bits_per_pixel);
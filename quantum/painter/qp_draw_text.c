@@ -27,6 +27,9 @@ typedef struct qff_font_handle_t {
 #ifdef QP_STREAM_HAS_FILE_IO
         qp_file_stream_t file_stream;
 #endif // QP_STREAM_HAS_FILE_IO
+#ifdef QP_STREAM_HAS_FLASH_IO
+        qp_flash_stream_t flash_stream;
+#endif // QP_STREAM_HAS_FLASH_IO
     };
 #if QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
     bool  owns_buffer;
@@ -36,6 +39,67 @@ typedef struct qff_font_handle_t {
 
 static qff_font_handle_t font_descriptors[QUANTUM_PAINTER_NUM_FONTS] = {0};
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QFF glyph cache
+
+// Location and width of a single glyph, along with its decompressed data if it has been captured by the glyph cache
+typedef struct qff_glyph_t {
+    uint32_t data_offset;
+    uint8_t  width;
+#if (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0 && (QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE) > 0
+    uint16_t bitmap_length; // 0 until the glyph has been drawn once
+    uint8_t  bitmap[QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE];
+#endif
+} qff_glyph_t;
+
+#if (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0
+
+typedef struct qff_glyph_cache_entry_t {
+    qff_font_handle_t *font; // NULL if this entry is unused
+    uint32_t           code_point;
+    uint32_t           last_used;
+    qff_glyph_t        glyph;
+} qff_glyph_cache_entry_t;
+
+static qff_glyph_cache_entry_t glyph_cache[QUANTUM_PAINTER_GLYPH_CACHE_SIZE] = {0};
+static uint32_t                glyph_cache_counter                           = 0;
+
+static qff_glyph_t *qff_glyph_cache_lookup(qff_font_handle_t *qff_font, uint32_t code_point) {
+    for (int i = 0; i < QUANTUM_PAINTER_GLYPH_CACHE_SIZE; ++i) {
+        if (glyph_cache[i].font == qff_font && glyph_cache[i].code_point == code_point) {
+            glyph_cache[i].last_used = ++glyph_cache_counter;
+            return &glyph_cache[i].glyph;
+        }
+    }
+    return NULL;
+}
+
+static qff_glyph_t *qff_glyph_cache_insert(qff_font_handle_t *qff_font, uint32_t code_point, const qff_glyph_t *glyph) {
+    // Prefer an unused entry, otherwise evict the least recently used one
+    qff_glyph_cache_entry_t *entry = &glyph_cache[0];
+    for (int i = 0; i < QUANTUM_PAINTER_GLYPH_CACHE_SIZE && entry->font != NULL; ++i) {
+        if (glyph_cache[i].font == NULL || glyph_cache[i].last_used < entry->last_used) {
+            entry = &glyph_cache[i];
+        }
+    }
+
+    entry->font       = qff_font;
+    entry->code_point = code_point;
+    entry->last_used  = ++glyph_cache_counter;
+    entry->glyph      = *glyph;
+    return &entry->glyph;
+}
+
+static void qff_glyph_cache_purge(qff_font_handle_t *qff_font) {
+    for (int i = 0; i < QUANTUM_PAINTER_GLYPH_CACHE_SIZE; ++i) {
+        if (glyph_cache[i].font == qff_font) {
+            glyph_cache[i].font = NULL;
+        }
+    }
+}
+
+#endif // (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helper: load font from stream
 
@@ -73,21 +137,24 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
     font->owns_buffer = false;
     font->buffer      = NULL;
 
-    void *ram_buffer = malloc(font->mem_stream.length);
+    // The source may be any kind of stream, so ask the font how large it is
+    uint32_t length     = qff_get_total_size(&font->stream);
+    void *   ram_buffer = malloc(length);
     if (ram_buffer == NULL) {
         qp_dprintf("qp_load_font: could not allocate enough RAM for font, falling back to original\n");
     } else {
         do {
             // Copy the data into RAM
-            if (qp_stream_read(ram_buffer, 1, font->mem_stream.length, &font->mem_stream) != font->mem_stream.length) {
+            if (qp_stream_read(ram_buffer, 1, length, &font->stream) != length) {
                 qp_dprintf("qp_load_font: could not copy from flash to RAM, falling back to original\n");
                 break;
             }
 
             // Create the new stream with the new buffer
+            qp_stream_close(&font->stream);
             font->buffer      = ram_buffer;
             font->owns_buffer = true;
-            font->mem_stream  = qp_make_memory_stream(font->buffer, font->mem_stream.length);
+            font->mem_stream  = qp_make_memory_stream(font->buffer, length);
         } while (0);
     }
 
@@ -132,6 +199,30 @@ painter_font_handle_t qp_load_font_mem(const void *buffer) {
     return qp_load_font_internal(font_mem_stream_factory, (void *)buffer);
 }
 
+#ifdef QP_STREAM_HAS_FLASH_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_load_font_flash
+
+static inline bool font_flash_stream_factory(qff_font_handle_t *font, void *arg) {
+    uint32_t address = *(uint32_t *)arg;
+
+    // Assume we can read the font descriptor
+    font->flash_stream = qp_make_flash_stream(address, sizeof(qff_font_descriptor_v1_t));
+
+    // Update the length of the stream to match, and rewind to the start
+    font->flash_stream.length   = qff_get_total_size(&font->stream);
+    font->flash_stream.position = 0;
+
+    return true;
+}
+
+painter_font_handle_t qp_load_font_flash(uint32_t address) {
+    return qp_load_font_internal(font_flash_stream_factory, &address);
+}
+
+#endif // QP_STREAM_HAS_FLASH_IO
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_close_font
 
@@ -151,6 +242,11 @@ bool qp_close_font(painter_font_handle_t font) {
     }
 #endif // QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
 
+#if (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0
+    // Drop any cached glyphs, the slot may be reused by a different font
+    qff_glyph_cache_purge(qff_font);
+#endif // (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0
+
     // Free up this font for use elsewhere.
     qp_stream_close(&qff_font->stream);
     qff_font->validate_ok = false;
@@ -161,7 +257,7 @@ bool qp_close_font(painter_font_handle_t font) {
 // Helpers
 
 // Callback to be invoked for each codepoint detected in the UTF8 input string
-typedef bool (*code_point_handler)(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t width, uint8_t height, void *cb_arg);
+typedef bool (*code_point_handler)(qff_font_handle_t *qff_font, uint32_t code_point, qff_glyph_t *glyph, uint8_t height, void *cb_arg);
 
 // Helper that sets up the palette (if required) and returns the offset in the stream that the data starts
 static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device, qff_font_handle_t *qff_font, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, uint32_t *data_offset) {
@@ -214,7 +310,7 @@ static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device,
     return true;
 }
 
-static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t *width) {
+static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_font, uint32_t code_point, qff_glyph_t *glyph) {
     if (code_point >= 0x20 && code_point < 0x7F && qff_font->has_ascii_table) {
         // Do ascii table
         qff_ascii_glyph_v1_t glyph_info;
@@ -240,12 +336,8 @@ static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_f
                                + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
                                + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
 
-        if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
-            qp_dprintf("Failed to set stream position while preparing ascii glyph data\n");
-            return false;
-        }
-
-        *width = glyph_width;
+        glyph->data_offset = data_offset;
+        glyph->width       = glyph_width;
         return true;
     } else {
         // Do unicode table, which may include singular ascii glyphs if full ascii table isn't specified
@@ -275,12 +367,8 @@ static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_f
                                        + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
                                        + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
 
-                if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
-                    qp_dprintf("Failed to set stream position while preparing unicode glyph data\n");
-                    return false;
-                }
-
-                *width = glyph_width;
+                glyph->data_offset = data_offset;
+                glyph->width       = glyph_width;
                 return true;
             }
         }
@@ -302,13 +390,26 @@ static inline bool qp_iterate_code_points(qff_font_handle_t *qff_font, const cha
             return false;
         }
 
-        uint8_t width;
-        if (!qp_drawtext_prepare_glyph_for_render(qff_font, code_point, &width)) {
+#if (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0
+        qff_glyph_t *glyph = qff_glyph_cache_lookup(qff_font, code_point);
+        if (!glyph) {
+            qff_glyph_t info = {0};
+            if (!qp_drawtext_prepare_glyph_for_render(qff_font, code_point, &info)) {
+                qp_dprintf("Failed to prepare glyph for rendering.\n");
+                return false;
+            }
+            glyph = qff_glyph_cache_insert(qff_font, code_point, &info);
+        }
+#else
+        qff_glyph_t  info  = {0};
+        qff_glyph_t *glyph = &info;
+        if (!qp_drawtext_prepare_glyph_for_render(qff_font, code_point, glyph)) {
             qp_dprintf("Failed to prepare glyph for rendering.\n");
             return false;
         }
+#endif // (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0
 
-        if (!handler(qff_font, code_point, width, qff_font->base.line_height, cb_arg)) {
+        if (!handler(qff_font, code_point, glyph, qff_font->base.line_height, cb_arg)) {
             qp_dprintf("Failed to execute glyph handler.\n");
             return false;
         }
@@ -325,11 +426,11 @@ typedef struct code_point_iter_calcwidth_state_t {
 } code_point_iter_calcwidth_state_t;
 
 // Codepoint handler callback: width calc
-static inline bool qp_font_code_point_handler_calcwidth(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t width, uint8_t height, void *cb_arg) {
+static inline bool qp_font_code_point_handler_calcwidth(qff_font_handle_t *qff_font, uint32_t code_point, qff_glyph_t *glyph, uint8_t height, void *cb_arg) {
     code_point_iter_calcwidth_state_t *state = (code_point_iter_calcwidth_state_t *)cb_arg;
 
     // Increment the overall width by this glyph's width
-    state->width += width;
+    state->width += glyph->width;
 
     return true;
 }
@@ -347,25 +448,83 @@ typedef struct code_point_iter_drawglyph_state_t {
     qp_internal_pixel_output_state_t *output_state;
 } code_point_iter_drawglyph_state_t;
 
+#if (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0 && (QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE) > 0
+
+// Glyph bitmap state, used both to capture decompressed glyph data into the cache and to replay it
+typedef struct qff_glyph_bitmap_state_t {
+    qp_internal_byte_input_callback source_callback;
+    void *                          source_state;
+    uint8_t *                       bitmap;
+    uint16_t                        length;
+    uint16_t                        position;
+} qff_glyph_bitmap_state_t;
+
+static int16_t qff_glyph_bitmap_capture(void *cb_arg) {
+    qff_glyph_bitmap_state_t *state = (qff_glyph_bitmap_state_t *)cb_arg;
+    int16_t                   c     = state->source_callback(state->source_state);
+    if (c >= 0 && state->position < state->length) {
+        state->bitmap[state->position++] = (uint8_t)c;
+    }
+    return c;
+}
+
+static int16_t qff_glyph_bitmap_replay(void *cb_arg) {
+    qff_glyph_bitmap_state_t *state = (qff_glyph_bitmap_state_t *)cb_arg;
+    if (state->position >= state->length) {
+        return STREAM_EOF;
+    }
+    return state->bitmap[state->position++];
+}
+
+#endif // (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0 && (QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE) > 0
+
 // Codepoint handler callback: drawing
-static inline bool qp_font_code_point_handler_drawglyph(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t width, uint8_t height, void *cb_arg) {
+static inline bool qp_font_code_point_handler_drawglyph(qff_font_handle_t *qff_font, uint32_t code_point, qff_glyph_t *glyph, uint8_t height, void *cb_arg) {
     code_point_iter_drawglyph_state_t *state  = (code_point_iter_drawglyph_state_t *)cb_arg;
     painter_driver_t *                 driver = (painter_driver_t *)state->device;
 
-    // Reset the input state's RLE mode -- the stream should already be correctly positioned by qp_iterate_code_points()
-    state->input_state->rle.mode = MARKER_BYTE; // ignored if not using RLE
-
     // Reset the output state
     state->output_state->pixel_write_pos = 0;
 
     // Configure where we're going to be rendering to
-    driver->driver_vtable->viewport(state->device, state->xpos, state->ypos, state->xpos + width - 1, state->ypos + height - 1);
+    driver->driver_vtable->viewport(state->device, state->xpos, state->ypos, state->xpos + glyph->width - 1, state->ypos + height - 1);
 
     // Move the x-position for the next glyph
-    state->xpos += width;
+    state->xpos += glyph->width;
+
+    uint32_t pixel_count = ((uint32_t)glyph->width) * height;
+
+#if (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0 && (QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE) > 0
+    // Glyphs which have already been decompressed into the cache don't need the font's stream at all
+    if (glyph->bitmap_length > 0) {
+        qff_glyph_bitmap_state_t replay_state = {.bitmap = glyph->bitmap, .length = glyph->bitmap_length, .position = 0};
+        return qp_internal_appender(state->device, qff_font->bpp, pixel_count, qff_glyph_bitmap_replay, &replay_state);
+    }
+#endif // (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0 && (QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE) > 0
+
+    // Move to the glyph's data, and reset the input state's RLE mode
+    if (qp_stream_setpos(&qff_font->stream, glyph->data_offset) < 0) {
+        qp_dprintf("Failed to set stream position while preparing glyph data\n");
+        return false;
+    }
+    state->input_state->rle.mode = MARKER_BYTE; // ignored if not using RLE
+
+#if (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0 && (QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE) > 0
+    // Palette-based glyphs small enough to fit are captured as they're decoded, ready for the next redraw
+    uint32_t byte_count = (pixel_count * qff_font->bpp + 7) / 8;
+    if (qff_font->bpp <= 8 && byte_count <= (QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE)) {
+        qff_glyph_bitmap_state_t capture_state = {.source_callback = state->input_callback, .source_state = state->input_state, .bitmap = glyph->bitmap, .length = byte_count, .position = 0};
+        if (!qp_internal_appender(state->device, qff_font->bpp, pixel_count, qff_glyph_bitmap_capture, &capture_state)) {
+            return false;
+        }
+        if (capture_state.position == byte_count) {
+            glyph->bitmap_length = byte_count;
+        }
+        return true;
+    }
+#endif // (QUANTUM_PAINTER_GLYPH_CACHE_SIZE) > 0 && (QUANTUM_PAINTER_GLYPH_CACHE_BITMAP_SIZE) > 0
 
     // Decode the pixel data for the glyph, and stream it
-    uint32_t pixel_count = ((uint32_t)width) * height;
     return qp_internal_appender(state->device, qff_font->bpp, pixel_count, state->input_callback, state->input_state);
 }
 
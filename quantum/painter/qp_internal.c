@@ -20,7 +20,8 @@ enum {
                      + (SH1106_NUM_DEVICES)  // SH1106
 };
 
-static painter_device_t qp_devices[QP_NUM_DEVICES] = {NULL};
+// Surface-only builds have no registered devices, so keep at least one slot to avoid a zero-length array
+static painter_device_t qp_devices[(QP_NUM_DEVICES) > 0 ? (QP_NUM_DEVICES) : 1] = {NULL};
 
 bool qp_internal_register_device(painter_device_t driver) {
     for (uint8_t i = 0; i < QP_NUM_DEVICES; i++) {
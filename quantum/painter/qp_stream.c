@@ -1,12 +1,22 @@
 // Copyright 2021 Nick Brassel (@tzarc)
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <string.h>
 #include "qp_stream.h"
 
+#ifdef QP_STREAM_HAS_FLASH_IO
+#    include "flash_spi.h"
+#endif // QP_STREAM_HAS_FLASH_IO
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Stream API
 
 uint32_t qp_stream_read_impl(void *output_buf, uint32_t member_size, uint32_t num_members, qp_stream_t *stream) {
+    // Use the stream's bulk read if it has one
+    if (stream->read) {
+        return stream->read(stream, output_buf, num_members * member_size) / member_size;
+    }
+
     uint8_t *output_ptr = (uint8_t *)output_buf;
 
     uint32_t i;
@@ -47,6 +57,21 @@ static inline int16_t mem_get(qp_stream_t *stream) {
     return s->buffer[s->position++];
 }
 
+static inline uint32_t mem_read(qp_stream_t *stream, void *output_buf, uint32_t length) {
+    qp_memory_stream_t *s     = (qp_memory_stream_t *)stream;
+    int32_t             avail = s->length - s->position;
+    if (avail < 0) {
+        avail = 0;
+    }
+    if (length > (uint32_t)avail) {
+        length    = avail;
+        s->is_eof = true;
+    }
+    memcpy(output_buf, &s->buffer[s->position], length);
+    s->position += length;
+    return length;
+}
+
 static inline bool mem_put(qp_stream_t *stream, uint8_t c) {
     qp_memory_stream_t *s = (qp_memory_stream_t *)stream;
     if (s->position >= s->length) {
@@ -111,7 +136,7 @@ static inline void mem_close(qp_stream_t *stream) {
 
 qp_memory_stream_t qp_make_memory_stream(void *buffer, int32_t length) {
     qp_memory_stream_t stream = {
-        .base     = {.get = mem_get, .put = mem_put, .seek = mem_seek, .tell = mem_tell, .is_eof = mem_is_eof, .close = mem_close},
+        .base     = {.get = mem_get, .put = mem_put, .read = mem_read, .seek = mem_seek, .tell = mem_tell, .is_eof = mem_is_eof, .close = mem_close},
         .buffer   = (uint8_t *)buffer,
         .length   = length,
         .position = 0,
@@ -164,3 +189,98 @@ qp_file_stream_t qp_make_file_stream(FILE *f) {
     return stream;
 }
 #endif // QP_STREAM_HAS_FILE_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Flash streams
+
+#ifdef QP_STREAM_HAS_FLASH_IO
+
+static inline int16_t flash_get(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    if (s->position >= s->length) {
+        s->is_eof = true;
+        return STREAM_EOF;
+    }
+
+    // Refill the read buffer if the current position falls outside of it
+    if (s->position < s->buffer_start || s->position >= s->buffer_start + s->buffer_length) {
+        int32_t len = s->length - s->position;
+        if (len > QUANTUM_PAINTER_FLASH_STREAM_BUFFER_SIZE) {
+            len = QUANTUM_PAINTER_FLASH_STREAM_BUFFER_SIZE;
+        }
+        if (flash_read_block(s->address + s->position, s->buffer, len) != FLASH_STATUS_SUCCESS) {
+            s->buffer_length = 0;
+            s->is_eof        = true;
+            return STREAM_EOF;
+        }
+        s->buffer_start  = s->position;
+        s->buffer_length = len;
+    }
+
+    return s->buffer[(s->position++) - s->buffer_start];
+}
+
+static inline bool flash_put(qp_stream_t *stream, uint8_t c) {
+    // Read-only.
+    return false;
+}
+
+static inline int flash_seek(qp_stream_t *stream, int32_t offset, int origin) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+
+    // Handle as per fseek
+    int32_t position = s->position;
+    switch (origin) {
+        case SEEK_SET:
+            position = offset;
+            break;
+        case SEEK_CUR:
+            position += offset;
+            break;
+        case SEEK_END:
+            position = s->length + offset;
+            break;
+        default:
+            return -1;
+    }
+
+    // Same bounds handling as memory streams; the read buffer is left intact so that seeks within it are free
+    if (position < 0 || position > s->length) {
+        return -1;
+    }
+
+    s->position = position;
+    s->is_eof   = false;
+    return 0;
+}
+
+static inline int32_t flash_tell(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    return s->position;
+}
+
+static inline bool flash_is_eof(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    return s->is_eof;
+}
+
+static inline void flash_close(qp_stream_t *stream) {
+    qp_flash_stream_t *s = (qp_flash_stream_t *)stream;
+    s->buffer_length     = 0;
+}
+
+qp_flash_stream_t qp_make_flash_stream(uint32_t address, int32_t length) {
+    // Nothing else initialises the flash driver, and doing it again is harmless
+    flash_init();
+
+    qp_flash_stream_t stream = {
+        .base          = {.get = flash_get, .put = flash_put, .seek = flash_seek, .tell = flash_tell, .is_eof = flash_is_eof, .close = flash_close},
+        .address       = address,
+        .length        = length,
+        .position      = 0,
+        .buffer_start  = 0,
+        .buffer_length = 0,
+    };
+    return stream;
+}
+#endif // QP_STREAM_HAS_FLASH_IO
@@ -51,6 +51,7 @@ uint32_t qp_stream_write_impl(const void *input_buf, uint32_t member_size, uint3
 typedef struct qp_stream_t {
     int16_t (*get)(qp_stream_t *stream);
     bool (*put)(qp_stream_t *stream, uint8_t c);
+    uint32_t (*read)(qp_stream_t *stream, void *output_buf, uint32_t length); // optional, falls back to get()
     int (*seek)(qp_stream_t *stream, int32_t offset, int origin);
     int32_t (*tell)(qp_stream_t *stream);
     bool (*is_eof)(qp_stream_t *stream);
@@ -83,3 +84,23 @@ typedef struct qp_file_stream_t {
 qp_file_stream_t qp_make_file_stream(FILE *f);
 
 #endif // QP_STREAM_HAS_FILE_IO
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Flash streams
+
+#ifdef QP_STREAM_HAS_FLASH_IO
+
+typedef struct qp_flash_stream_t {
+    qp_stream_t base;
+    uint32_t    address;
+    int32_t     length;
+    int32_t     position;
+    bool        is_eof;
+    int32_t     buffer_start;
+    int32_t     buffer_length;
+    uint8_t     buffer[QUANTUM_PAINTER_FLASH_STREAM_BUFFER_SIZE];
+} qp_flash_stream_t;
+
+qp_flash_stream_t qp_make_flash_stream(uint32_t address, int32_t length);
+
+#endif // QP_STREAM_HAS_FLASH_IO
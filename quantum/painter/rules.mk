@@ -4,6 +4,8 @@ QUANTUM_PAINTER_ANIMATIONS_ENABLE ?= yes
 
 QUANTUM_PAINTER_LVGL_INTEGRATION ?= no
 
+QUANTUM_PAINTER_FLASH_STREAM_ENABLE ?= no
+
 # The list of permissible drivers that can be listed in QUANTUM_PAINTER_DRIVERS
 VALID_QUANTUM_PAINTER_DRIVERS := \
     surface \
@@ -38,6 +40,12 @@ SRC += \
     $(QUANTUM_DIR)/painter/qp_draw_image.c \
     $(QUANTUM_DIR)/painter/qp_draw_text.c
 
+# Check if people want to load images and fonts from external flash
+ifeq ($(strip $(QUANTUM_PAINTER_FLASH_STREAM_ENABLE)), yes)
+    FLASH_DRIVER ?= spi
+    OPT_DEFS += -DQP_STREAM_HAS_FLASH_IO
+endif
+
 # Check if people want animations... enable the defered exec if so.
 ifeq ($(strip $(QUANTUM_PAINTER_ANIMATIONS_ENABLE)), yes)
     DEFERRED_EXEC_ENABLE := yes
@@ -18,21 +18,89 @@
 /* Author: Wojciech Siewierski < wojciech dot siewierski at onet dot pl > */
 #include "process_dynamic_macro.h"
 #include <stddef.h>
+#include <string.h>
 #include "action_layer.h"
 #include "keycodes.h"
 #include "debug.h"
-#include "wait.h"
+#include "timer.h"
+#include "util.h"
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
 
+#ifdef DYNAMIC_MACRO_PERSIST
+#    include "eeconfig.h"
+#    include "eeprom.h"
+#endif
+
+/* Bytes used by both macros together. Defaults to the RAM the older
+ * format used for DYNAMIC_MACRO_SIZE events, which the compact format
+ * below fills with several times as many events.
+ */
+#ifndef DYNAMIC_MACRO_BUFFER_SIZE
+#    define DYNAMIC_MACRO_BUFFER_SIZE (DYNAMIC_MACRO_SIZE * sizeof(keyrecord_t))
+#endif
+
+/* Minimum time between two played back events, in ms. One event per
+ * host poll keeps every press and release visible to the host.
+ */
+#ifndef DYNAMIC_MACRO_PLAYBACK_INTERVAL
+#    if defined(DYNAMIC_MACRO_DELAY)
+#        define DYNAMIC_MACRO_PLAYBACK_INTERVAL DYNAMIC_MACRO_DELAY
+#    elif defined(USB_POLLING_INTERVAL_MS)
+#        define DYNAMIC_MACRO_PLAYBACK_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define DYNAMIC_MACRO_PLAYBACK_INTERVAL 1
+#    endif
+#endif
+
+// How many macros can be played back inside each other
+#ifndef DYNAMIC_MACRO_NESTING_DEPTH
+#    define DYNAMIC_MACRO_NESTING_DEPTH 2
+#endif
+
+/* Number of keys a macro can leave pressed, that are released once its
+ * playback ends.
+ */
+#ifndef DYNAMIC_MACRO_MAX_HELD_KEYS
+#    define DYNAMIC_MACRO_MAX_HELD_KEYS 8
+#endif
+
+#ifndef DYNAMIC_MACRO_BLINK_DURATION
+#    define DYNAMIC_MACRO_BLINK_DURATION 100
+#endif
+
+#ifdef DYNAMIC_MACRO_PERSIST
+#    ifndef DYNAMIC_MACRO_EEPROM_ADDR
+#        ifdef DYNAMIC_KEYMAP_ENABLE
+#            error "DYNAMIC_MACRO_EEPROM_ADDR must be defined when DYNAMIC_MACRO_PERSIST is used with dynamic keymaps"
+#        endif
+#        define DYNAMIC_MACRO_EEPROM_ADDR (EECONFIG_SIZE)
+#    endif
+#    define DYNAMIC_MACRO_EEPROM_MAGIC (uint16_t)0xD14C
+// Bytes written to EEPROM per call of dynamic_macro_task()
+#    ifndef DYNAMIC_MACRO_EEPROM_CHUNK_SIZE
+#        define DYNAMIC_MACRO_EEPROM_CHUNK_SIZE 16
+#    endif
+#endif
+
+_Static_assert(DYNAMIC_MACRO_BUFFER_SIZE <= UINT16_MAX, "DYNAMIC_MACRO_BUFFER_SIZE must fit in 16 bits");
+
+#ifdef BACKLIGHT_ENABLE
+static uint16_t blink_timer   = 0;
+static bool     blink_pending = false;
+#endif
+
 // default feedback method
 void dynamic_macro_led_blink(void) {
 #ifdef BACKLIGHT_ENABLE
-    backlight_toggle();
-    wait_ms(100);
-    backlight_toggle();
+    if (!blink_pending) {
+        backlight_toggle();
+        blink_pending = true;
+    }
+    // The backlight is toggled back by dynamic_macro_task(), so recording never stalls the keyboard
+    blink_timer = timer_read();
 #endif
 }
 
@@ -58,166 +126,534 @@ __attribute__((weak)) bool dynamic_macro_valid_key_user(uint16_t keycode, keyrec
     return true;
 }
 
-/* Convenience macros used for retrieving the debug info. All of them
- * need a `direction` variable accessible at the call site.
+/* Each event is stored as a header byte, an optional continuation of
+ * the time delta, and the key:
+ *
+ *   header        bit 7    pressed
+ *                 bits 6-5 encoding of the key, see dynamic_macro_event_kind_t
+ *                 bit 4    the time delta continues in a varint after the header
+ *                 bits 3-0 low bits of the time delta
+ *   time delta    7 bits per byte, least significant first, bit 7 set when another byte follows
+ *   key           1 to 3 bytes, depending on the encoding
+ *
+ * The time delta is the time since the previous event, in ms, and is
+ * only recorded with DYNAMIC_MACRO_RECORD_TIMING. Without it a key
+ * press or release takes two bytes on most keyboards.
  */
-#define DYNAMIC_MACRO_CURRENT_SLOT() (direction > 0 ? 1 : 2)
-#define DYNAMIC_MACRO_CURRENT_LENGTH(BEGIN, POINTER) ((int)(direction * ((POINTER) - (BEGIN))))
-#define DYNAMIC_MACRO_CURRENT_CAPACITY(BEGIN, END2) ((int)(direction * ((END2) - (BEGIN)) + 1))
+typedef enum {
+    DYNAMIC_MACRO_EVENT_KEY_PACKED = 0, // Key event, row and col packed into one byte as nibbles
+    DYNAMIC_MACRO_EVENT_KEY,            // Key event, row and col in one byte each
+    DYNAMIC_MACRO_EVENT_KEYCODE,        // Combo event, keycode in two bytes
+    DYNAMIC_MACRO_EVENT_OTHER,          // Any other event: type, row and col in one byte each
+} dynamic_macro_event_kind_t;
+
+#define DYNAMIC_MACRO_HEADER_PRESSED 0x80
+#define DYNAMIC_MACRO_HEADER_KIND_SHIFT 5
+#define DYNAMIC_MACRO_HEADER_DELTA_CONTINUES 0x10
+#define DYNAMIC_MACRO_HEADER_DELTA_MASK 0x0F
+#define DYNAMIC_MACRO_EVENT_MAX_SIZE 6
+
+/* Both macros use the same buffer but read/write on different
+ * ends of it.
+ *
+ * Macro1 is written left-to-right starting from the beginning of
+ * the buffer.
+ *
+ * Macro2 is written right-to-left starting from the end of the
+ * buffer, so its Nth byte is at macro_buffer[size - 1 - N].
+ *
+ * &macro_buffer
+ *  v
+ * +------------------------------------------------------------+
+ * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
+ * +------------------------------------------------------------+
+ *  <-- macro_length[0] -->    <---------- macro_length[1] ----->
+ *
+ * During the recording when one macro encounters the end of the
+ * other macro, the recording is stopped. Apart from this, there
+ * are no arbitrary limits for the macros' length in relation to
+ * each other: for example one can either have two medium sized
+ * macros or one long macro and one short macro. Or even one empty
+ * and one using the whole buffer.
+ */
+static uint8_t  macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE];
+static uint16_t macro_length[2] = {0, 0};
+
+static struct {
+    uint8_t  macro_id;    // 0 - no macro is being recorded right now, 1,2 - either macro 1 or 2 is being recorded
+    uint16_t length;      // Bytes recorded so far
+    uint16_t release_end; // Length up to the last recorded key release
+    uint16_t last_time;   // Time of the previously recorded event
+} recording = {0};
+
+typedef struct {
+    uint8_t       slot;
+    uint16_t      offset;
+    uint16_t      timer;
+    layer_state_t layer_state; // Layers of the macro, only active while its own events are processed
+} dynamic_macro_player_t;
+
+static dynamic_macro_player_t players[DYNAMIC_MACRO_NESTING_DEPTH];
+static uint8_t                player_count = 0;
+
+#define DYNAMIC_MACRO_SLOT_DIRECTION(slot) ((slot) == 0 ? +1 : -1)
+
+static inline uint8_t *dynamic_macro_byte(uint8_t slot, uint16_t offset) {
+    return slot == 0 ? &macro_buffer[offset] : &macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE - 1 - offset];
+}
 
 /**
- * Start recording of the dynamic macro.
+ * Encode an event into the compact format.
  *
- * @param[out] macro_pointer The new macro buffer iterator.
- * @param[in]  macro_buffer  The macro buffer used to initialize macro_pointer.
+ * @return The number of bytes used.
  */
-void dynamic_macro_record_start(keyrecord_t **macro_pointer, keyrecord_t *macro_buffer, int8_t direction) {
-    dprintln("dynamic macro recording: started");
+static uint8_t dynamic_macro_encode(const keyrecord_t *record, uint16_t delta, uint8_t *data) {
+    uint8_t size = 1;
+    uint8_t kind;
+
+    data[0] = (record->event.pressed ? DYNAMIC_MACRO_HEADER_PRESSED : 0) | (delta & DYNAMIC_MACRO_HEADER_DELTA_MASK);
+    delta >>= 4;
+    if (delta) {
+        data[0] |= DYNAMIC_MACRO_HEADER_DELTA_CONTINUES;
+        while (delta) {
+            data[size++] = (delta & 0x7F) | (delta > 0x7F ? 0x80 : 0);
+            delta >>= 7;
+        }
+    }
 
-    dynamic_macro_record_start_user(direction);
+    keypos_t key = record->event.key;
+    if (record->event.type == KEY_EVENT && key.row < 16 && key.col < 16) {
+        kind         = DYNAMIC_MACRO_EVENT_KEY_PACKED;
+        data[size++] = (key.row << 4) | key.col;
+    } else if (record->event.type == KEY_EVENT) {
+        kind         = DYNAMIC_MACRO_EVENT_KEY;
+        data[size++] = key.row;
+        data[size++] = key.col;
+#if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
+    } else if (record->event.type == COMBO_EVENT) {
+        kind         = DYNAMIC_MACRO_EVENT_KEYCODE;
+        data[size++] = record->keycode & 0xFF;
+        data[size++] = record->keycode >> 8;
+#endif
+    } else {
+        kind         = DYNAMIC_MACRO_EVENT_OTHER;
+        data[size++] = record->event.type;
+        data[size++] = key.row;
+        data[size++] = key.col;
+    }
+    data[0] |= kind << DYNAMIC_MACRO_HEADER_KIND_SHIFT;
 
-    clear_keyboard();
-    layer_clear();
-    *macro_pointer = macro_buffer;
+    return size;
 }
 
 /**
- * Play the dynamic macro.
+ * Decode the event at the given offset of a macro.
  *
- * @param macro_buffer[in] The beginning of the macro buffer being played.
- * @param macro_end[in]    The element after the last macro buffer element.
- * @param direction[in]    Either +1 or -1, which way to iterate the buffer.
+ * @return The number of bytes used by the event.
+ */
+static uint8_t dynamic_macro_decode(uint8_t slot, uint16_t offset, keyrecord_t *record, uint16_t *delta) {
+    uint8_t size   = 0;
+    uint8_t header = *dynamic_macro_byte(slot, offset + size++);
+
+    *delta = header & DYNAMIC_MACRO_HEADER_DELTA_MASK;
+    if (header & DYNAMIC_MACRO_HEADER_DELTA_CONTINUES) {
+        uint8_t shift = 4;
+        uint8_t byte;
+        do {
+            byte = *dynamic_macro_byte(slot, offset + size++);
+            *delta |= (uint16_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+    }
+
+    memset(record, 0, sizeof(keyrecord_t));
+    record->event.pressed = header & DYNAMIC_MACRO_HEADER_PRESSED;
+    record->event.time    = timer_read();
+    record->event.type    = KEY_EVENT;
+
+    switch ((header >> DYNAMIC_MACRO_HEADER_KIND_SHIFT) & 0x03) {
+        case DYNAMIC_MACRO_EVENT_KEY_PACKED: {
+            uint8_t packed       = *dynamic_macro_byte(slot, offset + size++);
+            record->event.key.row = packed >> 4;
+            record->event.key.col = packed & 0x0F;
+            break;
+        }
+        case DYNAMIC_MACRO_EVENT_KEY:
+            record->event.key.row = *dynamic_macro_byte(slot, offset + size++);
+            record->event.key.col = *dynamic_macro_byte(slot, offset + size++);
+            break;
+        case DYNAMIC_MACRO_EVENT_KEYCODE:
+            record->event.type = COMBO_EVENT;
+#if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
+            record->keycode = *dynamic_macro_byte(slot, offset + size);
+            record->keycode |= (uint16_t)*dynamic_macro_byte(slot, offset + size + 1) << 8;
+#endif
+            size += 2;
+            break;
+        case DYNAMIC_MACRO_EVENT_OTHER:
+            record->event.type    = *dynamic_macro_byte(slot, offset + size++);
+            record->event.key.row = *dynamic_macro_byte(slot, offset + size++);
+            record->event.key.col = *dynamic_macro_byte(slot, offset + size++);
+            break;
+    }
+
+    return size;
+}
+
+#ifdef DYNAMIC_MACRO_PERSIST
+typedef struct PACKED {
+    uint16_t magic;
+    uint16_t size;
+    uint16_t length[2];
+} dynamic_macro_eeprom_header_t;
+
+#    define DYNAMIC_MACRO_EEPROM_HEADER ((void *)(DYNAMIC_MACRO_EEPROM_ADDR))
+#    define DYNAMIC_MACRO_EEPROM_BUFFER ((uint8_t *)(DYNAMIC_MACRO_EEPROM_ADDR) + sizeof(dynamic_macro_eeprom_header_t))
+
+_Static_assert((DYNAMIC_MACRO_EEPROM_ADDR) + sizeof(dynamic_macro_eeprom_header_t) + (DYNAMIC_MACRO_BUFFER_SIZE) <= (TOTAL_EEPROM_BYTE_COUNT), "Dynamic macros are configured to use more EEPROM than is available.");
+
+#    define DYNAMIC_MACRO_NOT_SAVING 0xFF
+
+/* Macros are written to EEPROM by dynamic_macro_task(), a chunk at a
+ * time, so that stopping a recording doesn't stall the keyboard.
+ */
+static struct {
+    uint8_t  pending;   // Bit per slot waiting to be saved
+    uint8_t  slot;      // Slot being saved, or DYNAMIC_MACRO_NOT_SAVING
+    uint16_t offset;    // Bytes of it written so far
+    uint16_t length[2]; // Lengths of the macros that are valid in EEPROM
+} saving = {.slot = DYNAMIC_MACRO_NOT_SAVING};
+
+static void dynamic_macro_save_header(void) {
+    dynamic_macro_eeprom_header_t header = {
+        .magic  = DYNAMIC_MACRO_EEPROM_MAGIC,
+        .size   = DYNAMIC_MACRO_BUFFER_SIZE,
+        .length = {saving.length[0], saving.length[1]},
+    };
+    eeprom_update_block(&header, DYNAMIC_MACRO_EEPROM_HEADER, sizeof(header));
+}
+
+static void dynamic_macro_save(uint8_t slot) {
+    saving.pending |= 1 << slot;
+}
+
+static void dynamic_macro_cancel_save(uint8_t slot) {
+    saving.pending &= ~(1 << slot);
+    if (saving.slot == slot) {
+        saving.slot = DYNAMIC_MACRO_NOT_SAVING;
+    }
+}
+
+/**
+ * Write the next chunk of a macro to EEPROM. The buffer is mirrored as
+ * is, the saved copy of the macro is invalidated first and only made
+ * valid again by the header written after its last byte, so a power
+ * loss never leaves a partially written macro behind.
  */
-void dynamic_macro_play(keyrecord_t *macro_buffer, keyrecord_t *macro_end, int8_t direction) {
-    dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
+static void dynamic_macro_save_task(void) {
+    if (saving.slot == DYNAMIC_MACRO_NOT_SAVING) {
+        if (!saving.pending) {
+            return;
+        }
+        uint8_t slot = (saving.pending & 1) ? 0 : 1;
+        saving.pending &= ~(1 << slot);
+        saving.slot   = slot;
+        saving.offset = 0;
+
+        saving.length[slot] = 0;
+        // The new macro may extend into the space of an outdated copy of the other one
+        if (saving.length[slot ^ 1] > DYNAMIC_MACRO_BUFFER_SIZE - macro_length[slot]) {
+            saving.length[slot ^ 1] = 0;
+        }
+        dynamic_macro_save_header();
+        return;
+    }
 
-    layer_state_t saved_layer_state = layer_state;
+    uint8_t  slot   = saving.slot;
+    uint16_t length = macro_length[slot];
+    if (saving.offset < length) {
+        uint16_t chunk = MIN(length - saving.offset, DYNAMIC_MACRO_EEPROM_CHUNK_SIZE);
+        uint16_t start = slot == 0 ? saving.offset : DYNAMIC_MACRO_BUFFER_SIZE - saving.offset - chunk;
+        eeprom_update_block(&macro_buffer[start], DYNAMIC_MACRO_EEPROM_BUFFER + start, chunk);
+        saving.offset += chunk;
+        return;
+    }
+
+    saving.length[slot] = length;
+    saving.slot         = DYNAMIC_MACRO_NOT_SAVING;
+    dynamic_macro_save_header();
+    dprintf("dynamic macro: slot %d written to EEPROM\n", slot + 1);
+}
+
+static void dynamic_macro_load(void) {
+    dynamic_macro_eeprom_header_t header;
+
+    eeprom_read_block(&header, DYNAMIC_MACRO_EEPROM_HEADER, sizeof(header));
+    if (header.magic != DYNAMIC_MACRO_EEPROM_MAGIC || header.size != DYNAMIC_MACRO_BUFFER_SIZE || (uint32_t)header.length[0] + header.length[1] > DYNAMIC_MACRO_BUFFER_SIZE) {
+        dprintln("dynamic macro: no saved macros");
+        return;
+    }
+
+    macro_length[0]  = header.length[0];
+    macro_length[1]  = header.length[1];
+    saving.length[0] = header.length[0];
+    saving.length[1] = header.length[1];
+    eeprom_read_block(macro_buffer, DYNAMIC_MACRO_EEPROM_BUFFER, macro_length[0]);
+    eeprom_read_block(&macro_buffer[DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1]], DYNAMIC_MACRO_EEPROM_BUFFER + DYNAMIC_MACRO_BUFFER_SIZE - macro_length[1], macro_length[1]);
+
+    dprintf("dynamic macro: loaded, lengths: %u/%u\n", macro_length[0], macro_length[1]);
+}
+#endif
+
+/**
+ * Reset the macros, and load the saved ones from EEPROM if enabled.
+ */
+void dynamic_macro_init(void) {
+    memset(macro_buffer, 0, sizeof(macro_buffer));
+    macro_length[0]    = 0;
+    macro_length[1]    = 0;
+    recording.macro_id = 0;
+    player_count       = 0;
+#ifdef DYNAMIC_MACRO_PERSIST
+    memset(&saving, 0, sizeof(saving));
+    saving.slot = DYNAMIC_MACRO_NOT_SAVING;
+    dynamic_macro_load();
+#endif
+}
+
+/**
+ * Start recording of the dynamic macro.
+ */
+static void dynamic_macro_record_start(uint8_t slot) {
+    dprintln("dynamic macro recording: started");
+
+    dynamic_macro_record_start_user(DYNAMIC_MACRO_SLOT_DIRECTION(slot));
+
+    // The macro is about to be overwritten, so it can't keep playing or be saved
+    player_count = 0;
+#ifdef DYNAMIC_MACRO_PERSIST
+    dynamic_macro_cancel_save(slot);
+#endif
 
     clear_keyboard();
     layer_clear();
 
-    while (macro_buffer != macro_end) {
-        process_record(macro_buffer);
-        macro_buffer += direction;
-#ifdef DYNAMIC_MACRO_DELAY
-        wait_ms(DYNAMIC_MACRO_DELAY);
+    macro_length[slot]    = 0;
+    recording.macro_id    = slot + 1;
+    recording.length      = 0;
+    recording.release_end = 0;
+}
+
+/**
+ * Start playing back the dynamic macro. The events are sent by
+ * dynamic_macro_task().
+ */
+static void dynamic_macro_play(uint8_t slot) {
+    dprintf("dynamic macro: slot %d playback\n", slot + 1);
+
+    if (player_count == DYNAMIC_MACRO_NESTING_DEPTH) {
+        dprintln("dynamic macro: too deeply nested, ignoring");
+        return;
+    }
+
+    // Keys still held by the user are left alone, the macro starts without layers as it was recorded
+    dynamic_macro_player_t *player = &players[player_count++];
+    player->slot                   = slot;
+    player->offset                 = 0;
+    player->timer                  = timer_read();
+    player->layer_state            = 0;
+}
+
+/**
+ * Process an event of the macro played back by the given player. The
+ * layers of the macro are swapped in for the event only, so the layer
+ * keys the user presses or releases meanwhile keep working, and the
+ * layers the macro changed are dropped once it ends.
+ */
+static void dynamic_macro_process(uint8_t index, keyrecord_t *record) {
+#ifndef NO_ACTION_LAYER
+    layer_state_t live  = layer_state;
+    layer_state_t macro = players[index].layer_state;
+    layer_state         = macro;
 #endif
+
+    // May start a nested macro, which then plays before this one continues
+    process_record(record);
+
+#ifndef NO_ACTION_LAYER
+    players[index].layer_state = layer_state;
+    if (layer_state != macro) {
+        // The layer callbacks saw the layers of the macro, let them know about the live ones again
+        layer_state_set(live);
+    } else {
+        layer_state = live;
     }
+#endif
+}
 
-    clear_keyboard();
+static bool dynamic_macro_same_key(const keyrecord_t *a, const keyrecord_t *b) {
+    return a->event.type == b->event.type && KEYEQ(a->event.key, b->event.key)
+#if defined(COMBO_ENABLE) || defined(REPEAT_KEY_ENABLE)
+           && a->keycode == b->keycode
+#endif
+        ;
+}
 
-    layer_state_set(saved_layer_state);
+/**
+ * Release the keys the macro pressed, but did not release. This is the
+ * case for the keys being held when the recording was stopped.
+ */
+static void dynamic_macro_release_held(uint8_t index) {
+    uint8_t  slot = players[index].slot;
+    uint16_t held[DYNAMIC_MACRO_MAX_HELD_KEYS]; // Offsets of the press events
+    uint8_t  held_count = 0;
+
+    for (uint16_t offset = 0; offset < macro_length[slot];) {
+        keyrecord_t record, pressed;
+        uint16_t    delta;
+        uint8_t     size = dynamic_macro_decode(slot, offset, &record, &delta);
+
+        uint8_t i = 0;
+        for (; i < held_count; i++) {
+            dynamic_macro_decode(slot, held[i], &pressed, &delta);
+            if (dynamic_macro_same_key(&pressed, &record)) {
+                break;
+            }
+        }
+        if (record.event.pressed && i == held_count && held_count < DYNAMIC_MACRO_MAX_HELD_KEYS) {
+            held[held_count++] = offset;
+        } else if (!record.event.pressed && i < held_count) {
+            held[i] = held[--held_count];
+        }
+        offset += size;
+    }
 
-    dynamic_macro_play_user(direction);
+    for (uint8_t i = 0; i < held_count; i++) {
+        keyrecord_t record;
+        uint16_t    delta;
+        dynamic_macro_decode(slot, held[i], &record, &delta);
+        record.event.pressed = false;
+        dynamic_macro_process(index, &record);
+    }
 }
 
 /**
  * Record a single key in a dynamic macro.
- *
- * @param macro_buffer[in] The start of the used macro buffer.
- * @param macro_pointer[in,out] The current buffer position.
- * @param macro2_end[in] The end of the other macro.
- * @param direction[in]  Either +1 or -1, which way to iterate the buffer.
- * @param record[in]     The current keypress.
  */
-void dynamic_macro_record_key(keyrecord_t *macro_buffer, keyrecord_t **macro_pointer, keyrecord_t *macro2_end, int8_t direction, keyrecord_t *record) {
+static void dynamic_macro_record_key(keyrecord_t *record) {
+    uint8_t slot = recording.macro_id - 1;
+
     /* If we've just started recording, ignore all the key releases. */
-    if (!record->event.pressed && *macro_pointer == macro_buffer) {
+    if (!record->event.pressed && recording.length == 0) {
         dprintln("dynamic macro: ignoring a leading key-up event");
         return;
     }
 
-    /* The other end of the other macro is the last buffer element it
-     * is safe to use before overwriting the other macro.
+    uint16_t delta = 0;
+#ifdef DYNAMIC_MACRO_RECORD_TIMING
+    if (recording.length != 0) {
+        delta = TIMER_DIFF_16(record->event.time, recording.last_time);
+    }
+    recording.last_time = record->event.time;
+#endif
+
+    uint8_t data[DYNAMIC_MACRO_EVENT_MAX_SIZE];
+    uint8_t size = dynamic_macro_encode(record, delta, data);
+
+    /* The end of the other macro is the last buffer element it is
+     * safe to use before overwriting the other macro.
      */
-    if (*macro_pointer - direction != macro2_end) {
-        **macro_pointer = *record;
-        *macro_pointer += direction;
+    if (recording.length + size <= DYNAMIC_MACRO_BUFFER_SIZE - macro_length[slot ^ 1]) {
+        for (uint8_t i = 0; i < size; i++) {
+            *dynamic_macro_byte(slot, recording.length++) = data[i];
+        }
+        if (!record->event.pressed) {
+            recording.release_end = recording.length;
+        }
     }
-    dynamic_macro_record_key_user(direction, record);
+    dynamic_macro_record_key_user(DYNAMIC_MACRO_SLOT_DIRECTION(slot), record);
 
-    dprintf("dynamic macro: slot %d length: %d/%d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, *macro_pointer), DYNAMIC_MACRO_CURRENT_CAPACITY(macro_buffer, macro2_end));
+    dprintf("dynamic macro: slot %d length: %d/%d\n", slot + 1, recording.length, DYNAMIC_MACRO_BUFFER_SIZE - macro_length[slot ^ 1]);
 }
 
 /**
- * End recording of the dynamic macro. Essentially just update the
- * pointer to the end of the macro.
+ * If a dynamic macro is currently being recorded, stop recording.
  */
-void dynamic_macro_record_end(keyrecord_t *macro_buffer, keyrecord_t *macro_pointer, int8_t direction, keyrecord_t **macro_end) {
-    dynamic_macro_record_end_user(direction);
+void dynamic_macro_stop_recording(void) {
+    if (recording.macro_id == 0) {
+        return;
+    }
+
+    uint8_t slot = recording.macro_id - 1;
+    dynamic_macro_record_end_user(DYNAMIC_MACRO_SLOT_DIRECTION(slot));
 
     /* Do not save the keys being held when stopping the recording,
      * i.e. the keys used to access the layer DM_RSTP is on.
      */
-    while (macro_pointer != macro_buffer && (macro_pointer - direction)->event.pressed) {
-        dprintln("dynamic macro: trimming a trailing key-down event");
-        macro_pointer -= direction;
+    if (recording.release_end != recording.length) {
+        dprintln("dynamic macro: trimming trailing key-down events");
     }
+    macro_length[slot] = recording.release_end;
+
+    dprintf("dynamic macro: slot %d saved, length: %d\n", slot + 1, macro_length[slot]);
 
-    dprintf("dynamic macro: slot %d saved, length: %d\n", DYNAMIC_MACRO_CURRENT_SLOT(), DYNAMIC_MACRO_CURRENT_LENGTH(macro_buffer, macro_pointer));
+#ifdef DYNAMIC_MACRO_PERSIST
+    dynamic_macro_save(slot);
+#endif
 
-    *macro_end = macro_pointer;
+    recording.macro_id = 0;
 }
 
-/* Both macros use the same buffer but read/write on different
- * ends of it.
- *
- * Macro1 is written left-to-right starting from the beginning of
- * the buffer.
- *
- * Macro2 is written right-to-left starting from the end of the
- * buffer.
- *
- * &macro_buffer   macro_end
- *  v                   v
- * +------------------------------------------------------------+
- * |>>>>>> MACRO1 >>>>>>      <<<<<<<<<<<<< MACRO2 <<<<<<<<<<<<<|
- * +------------------------------------------------------------+
- *                           ^                                 ^
- *                         r_macro_end                  r_macro_buffer
- *
- * During the recording when one macro encounters the end of the
- * other macro, the recording is stopped. Apart from this, there
- * are no arbitrary limits for the macros' length in relation to
- * each other: for example one can either have two medium sized
- * macros or one long macro and one short macro. Or even one empty
- * and one using the whole buffer.
+bool dynamic_macro_is_playing(void) {
+    return player_count > 0;
+}
+
+/**
+ * Send the next event of the macro being played back, once it is due.
  */
-static keyrecord_t macro_buffer[DYNAMIC_MACRO_SIZE];
+void dynamic_macro_task(void) {
+#ifdef BACKLIGHT_ENABLE
+    if (blink_pending && timer_elapsed(blink_timer) >= DYNAMIC_MACRO_BLINK_DURATION) {
+        backlight_toggle();
+        blink_pending = false;
+    }
+#endif
 
-/* Pointer to the first buffer element after the first macro.
- * Initially points to the very beginning of the buffer since the
- * macro is empty. */
-static keyrecord_t *macro_end = macro_buffer;
+#ifdef DYNAMIC_MACRO_PERSIST
+    dynamic_macro_save_task();
+#endif
+
+    if (player_count == 0) {
+        return;
+    }
 
-/* The other end of the macro buffer. Serves as the beginning of
- * the second macro. */
-static keyrecord_t *const r_macro_buffer = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
+    dynamic_macro_player_t *player = &players[player_count - 1];
+    uint8_t                 slot   = player->slot;
 
-/* Like macro_end but for the second macro. */
-static keyrecord_t *r_macro_end = macro_buffer + DYNAMIC_MACRO_SIZE - 1;
+    if (player->offset >= macro_length[slot]) {
+        uint8_t index = player_count - 1;
+        dynamic_macro_release_held(index);
+        // Releasing a held play key may have started another macro on top of this one
+        if (player_count > index) {
+            memmove(&players[index], &players[index + 1], (player_count - index - 1) * sizeof(dynamic_macro_player_t));
+            player_count--;
+        }
 
-/* A persistent pointer to the current macro position (iterator)
- * used during the recording. */
-static keyrecord_t *macro_pointer = NULL;
+        dynamic_macro_play_user(DYNAMIC_MACRO_SLOT_DIRECTION(slot));
+        return;
+    }
 
-/* 0   - no macro is being recorded right now
- * 1,2 - either macro 1 or 2 is being recorded */
-static uint8_t macro_id = 0;
+    keyrecord_t record;
+    uint16_t    delta;
+    uint8_t     size = dynamic_macro_decode(slot, player->offset, &record, &delta);
 
-/**
- * If a dynamic macro is currently being recorded, stop recording.
- */
-void dynamic_macro_stop_recording(void) {
-    switch (macro_id) {
-        case 1:
-            dynamic_macro_record_end(macro_buffer, macro_pointer, +1, &macro_end);
-            break;
-        case 2:
-            dynamic_macro_record_end(r_macro_buffer, macro_pointer, -1, &r_macro_end);
-            break;
+    if (timer_elapsed(player->timer) < MAX(delta, DYNAMIC_MACRO_PLAYBACK_INTERVAL)) {
+        return;
     }
-    macro_id = 0;
+
+    player->offset += size;
+    player->timer = timer_read();
+    dynamic_macro_process(player_count - 1, &record);
 }
 
 /* Handle the key events related to the dynamic macros. Should be
@@ -231,23 +667,21 @@ void dynamic_macro_stop_recording(void) {
  *   }
  */
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
-    if (macro_id == 0) {
+    if (recording.macro_id == 0) {
         /* No macro recording in progress. */
         if (!record->event.pressed) {
             switch (keycode) {
                 case QK_DYNAMIC_MACRO_RECORD_START_1:
-                    dynamic_macro_record_start(&macro_pointer, macro_buffer, +1);
-                    macro_id = 1;
+                    dynamic_macro_record_start(0);
                     return false;
                 case QK_DYNAMIC_MACRO_RECORD_START_2:
-                    dynamic_macro_record_start(&macro_pointer, r_macro_buffer, -1);
-                    macro_id = 2;
+                    dynamic_macro_record_start(1);
                     return false;
                 case QK_DYNAMIC_MACRO_PLAY_1:
-                    dynamic_macro_play(macro_buffer, macro_end, +1);
+                    dynamic_macro_play(0);
                     return false;
                 case QK_DYNAMIC_MACRO_PLAY_2:
-                    dynamic_macro_play(r_macro_buffer, r_macro_end, -1);
+                    dynamic_macro_play(1);
                     return false;
             }
         }
@@ -273,14 +707,7 @@ bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record) {
             default:
                 if (dynamic_macro_valid_key_user(keycode, record)) {
                     /* Store the key in the macro buffer and process it normally. */
-                    switch (macro_id) {
-                        case 1:
-                            dynamic_macro_record_key(macro_buffer, &macro_pointer, r_macro_end, +1, record);
-                            break;
-                        case 2:
-                            dynamic_macro_record_key(r_macro_buffer, &macro_pointer, macro_end, -1, record);
-                            break;
-                    }
+                    dynamic_macro_record_key(record);
                 }
                 return true;
                 break;
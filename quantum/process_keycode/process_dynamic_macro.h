@@ -22,10 +22,10 @@
 #include <stdbool.h>
 #include "action.h"
 
-/* May be overridden with a custom value. Be aware that the effective
- * macro length is half of this value: each keypress is recorded twice
- * because of the down-event and up-event. This is not a bug, it's the
- * intended behavior.
+/* May be overridden with a custom value. The macro buffer takes as
+ * much RAM as this many keyrecord_t, and as events are stored in a
+ * compact format it holds several times as many key presses and
+ * releases. Set DYNAMIC_MACRO_BUFFER_SIZE to size it in bytes instead.
  *
  * Usually it should be fine to set the macro size to at least 256 but
  * there have been reports of it being too much in some users' cases,
@@ -35,6 +35,9 @@
 #    define DYNAMIC_MACRO_SIZE 128
 #endif
 
+void dynamic_macro_init(void);
+void dynamic_macro_task(void);
+bool dynamic_macro_is_playing(void);
 void dynamic_macro_led_blink(void);
 bool process_dynamic_macro(uint16_t keycode, keyrecord_t *record);
 void dynamic_macro_record_start_user(int8_t direction);
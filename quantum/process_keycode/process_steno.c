@@ -16,6 +16,7 @@
 #include "process_steno.h"
 #include "quantum_keycodes.h"
 #include "eeconfig.h"
+#include "util.h"
 #include <string.h>
 #ifdef VIRTSER_ENABLE
 #    include "virtser.h"
@@ -23,6 +24,27 @@
 #ifdef STENO_ENABLE_ALL
 #    include "eeprom.h"
 #endif
+#ifdef STENO_DICTIONARY_ENABLE
+#    include "flash_spi.h"
+#    include "send_string.h"
+#endif
+
+// Bytes of protocol packets that can be waiting to be sent to the host
+#ifndef STENO_PACKET_QUEUE_SIZE
+#    define STENO_PACKET_QUEUE_SIZE 32
+#endif
+
+#ifdef STENO_DICTIONARY_ENABLE
+// Characters of translations that can be waiting to be typed
+#    ifndef STENO_OUTPUT_QUEUE_SIZE
+#        define STENO_OUTPUT_QUEUE_SIZE 64
+#    endif
+#    ifndef STENO_DICTIONARY_ADDR
+#        define STENO_DICTIONARY_ADDR 0
+#    endif
+#    define STENO_DICTIONARY_MAGIC 0x444E5453UL // "STND"
+#    define STENO_DICTIONARY_VERSION 1
+#endif
 
 // All steno keys that have been pressed to form this chord,
 // stored in MAX_STROKE_SIZE groups of 8-bit arrays.
@@ -43,9 +65,44 @@ static const steno_mode_t mode = STENO_MODE_GEMINI;
 static const steno_mode_t mode = STENO_MODE_BOLT;
 #endif
 
+#ifdef STENO_DICTIONARY_ENABLE
+// All steno keys of this chord in a protocol independent form, for the dictionary lookup
+static steno_stroke_t stroke = 0;
+#endif
+
 static inline void steno_clear_chord(void) {
     memset(chord, 0, sizeof(chord));
+#ifdef STENO_DICTIONARY_ENABLE
+    stroke = 0;
+#endif
+}
+
+#ifdef VIRTSER_ENABLE
+static struct {
+    uint8_t data[STENO_PACKET_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+} packet_queue = {0};
+
+static void steno_packet_send_byte(void) {
+    virtser_send(packet_queue.data[packet_queue.head]);
+    packet_queue.head = (packet_queue.head + 1) % STENO_PACKET_QUEUE_SIZE;
+    packet_queue.count--;
+}
+
+/**
+ * Queue a byte of a packet for steno_task(), so that a slow or absent
+ * host never stalls the processing of the next chord.
+ */
+static void steno_packet_queue_byte(uint8_t byte) {
+    // Send the oldest bytes synchronously rather than dropping part of a packet
+    while (packet_queue.count == STENO_PACKET_QUEUE_SIZE) {
+        steno_packet_send_byte();
+    }
+    packet_queue.data[(packet_queue.head + packet_queue.count) % STENO_PACKET_QUEUE_SIZE] = byte;
+    packet_queue.count++;
 }
+#endif // VIRTSER_ENABLE
 
 #ifdef STENO_ENABLE_GEMINI
 
@@ -54,7 +111,7 @@ void send_steno_chord_gemini(void) {
     // Set MSB to 1 to indicate the start of packet
     chord[0] |= 0x80;
     for (uint8_t i = 0; i < GEMINI_STROKE_SIZE; ++i) {
-        virtser_send(chord[i]);
+        steno_packet_queue_byte(chord[i]);
     }
 }
 #    else
@@ -98,13 +155,13 @@ static void send_steno_chord_bolt(void) {
         // If a user chorded the keys of the first group with keys of the last group, for example, there
         // would be bytes of 0x00 in `chord` for the middle groups which we mustn't send.
         if (chord[i]) {
-            virtser_send(chord[i]);
+            steno_packet_queue_byte(chord[i]);
         }
     }
     // Sending a null packet is not always necessary, but it is simpler and more reliable
     // to unconditionally send it every time instead of keeping track of more states and
     // creating more branches in the execution of the program.
-    virtser_send(0);
+    steno_packet_queue_byte(0);
 }
 #    else
 #        pragma message "VIRTSER_ENABLE = yes is required for TX Bolt to work properly out of the box!"
@@ -126,11 +183,160 @@ static const uint16_t combinedmap_first[] PROGMEM  = {STN_S1, STN_TL, STN_PL, ST
 static const uint16_t combinedmap_second[] PROGMEM = {STN_S2, STN_KL, STN_WL, STN_RL, STN_RR, STN_BR, STN_GR, STN_SR, STN_ZR, STN_O, STN_U};
 #endif
 
-#ifdef STENO_ENABLE_ALL
+#ifdef STENO_DICTIONARY_ENABLE
+/* The dictionary translates single strokes to text, and is stored in
+ * external flash at STENO_DICTIONARY_ADDR, all values little endian:
+ *
+ *   uint32_t magic            "STND"
+ *   uint16_t version          STENO_DICTIONARY_VERSION
+ *   uint16_t bucket_count     a power of two
+ *   uint32_t bucket[]         offset of the entry from the start of the dictionary, 0 if empty
+ *
+ * Each entry holds the stroke as 6 bytes, the length of the text and
+ * the text itself. A stroke goes in the bucket given by
+ * steno_dictionary_hash(), or the next free one after it.
+ */
+typedef struct PACKED {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t bucket_count;
+} steno_dictionary_header_t;
+
+#    define STENO_DICTIONARY_ENTRY_HEADER_SIZE 7
+
+static uint16_t dictionary_bucket_count = 0;
+static bool     dictionary_checked      = false;
+
+static struct {
+    char    data[STENO_OUTPUT_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+} output_queue = {0};
+
+uint16_t steno_dictionary_hash(steno_stroke_t stroke) {
+    uint32_t hash = (uint32_t)stroke ^ (uint32_t)(stroke >> 32) * 0x9E3779B1UL;
+    hash *= 0x9E3779B1UL;
+    return hash >> 16;
+}
+
+static bool steno_dictionary_check(void) {
+    if (!dictionary_checked) {
+        steno_dictionary_header_t header;
+
+        // A failed read is tried again with the next stroke, only a missing dictionary disables the lookups
+        if (flash_read_block(STENO_DICTIONARY_ADDR, &header, sizeof(header)) != FLASH_STATUS_SUCCESS) {
+            return false;
+        }
+        dictionary_checked = true;
+        if (header.magic == STENO_DICTIONARY_MAGIC && header.version == STENO_DICTIONARY_VERSION && header.bucket_count != 0 && (header.bucket_count & (header.bucket_count - 1)) == 0) {
+            dictionary_bucket_count = header.bucket_count;
+        }
+    }
+    return dictionary_bucket_count != 0;
+}
+
+static void steno_output_send_char(void) {
+    send_char(output_queue.data[output_queue.head]);
+    output_queue.head = (output_queue.head + 1) % STENO_OUTPUT_QUEUE_SIZE;
+    output_queue.count--;
+}
+
+static void steno_output_queue_char(char c) {
+    // Type the oldest characters synchronously rather than dropping any
+    while (output_queue.count == STENO_OUTPUT_QUEUE_SIZE) {
+        steno_output_send_char();
+    }
+    output_queue.data[(output_queue.head + output_queue.count) % STENO_OUTPUT_QUEUE_SIZE] = c;
+    output_queue.count++;
+}
+
+/**
+ * Look the stroke up in the dictionary, and queue its translation to be typed.
+ *
+ * @return true if the stroke was translated.
+ */
+bool steno_translate_stroke(steno_stroke_t stroke) {
+    if (!steno_dictionary_check()) {
+        return false;
+    }
+
+    uint16_t mask   = dictionary_bucket_count - 1;
+    uint16_t bucket = steno_dictionary_hash(stroke) & mask;
+
+    for (uint16_t probe = 0; probe < dictionary_bucket_count; probe++, bucket = (bucket + 1) & mask) {
+        uint32_t offset;
+        uint8_t  entry[STENO_DICTIONARY_ENTRY_HEADER_SIZE];
+
+        if (flash_read_block(STENO_DICTIONARY_ADDR + sizeof(steno_dictionary_header_t) + bucket * sizeof(uint32_t), &offset, sizeof(offset)) != FLASH_STATUS_SUCCESS || offset == 0) {
+            return false;
+        }
+        if (flash_read_block(STENO_DICTIONARY_ADDR + offset, entry, sizeof(entry)) != FLASH_STATUS_SUCCESS) {
+            return false;
+        }
+
+        steno_stroke_t entry_stroke = 0;
+        for (uint8_t i = 0; i < 6; i++) {
+            entry_stroke |= (steno_stroke_t)entry[i] << (i * 8);
+        }
+        if (entry_stroke != stroke) {
+            continue;
+        }
+
+        char    text[16];
+        uint8_t length = entry[6];
+        offset += STENO_DICTIONARY_ENTRY_HEADER_SIZE;
+        while (length) {
+            uint8_t chunk = MIN(length, sizeof(text));
+            if (flash_read_block(STENO_DICTIONARY_ADDR + offset, text, chunk) != FLASH_STATUS_SUCCESS) {
+                return false;
+            }
+            for (uint8_t i = 0; i < chunk; i++) {
+                steno_output_queue_char(text[i]);
+            }
+            offset += chunk;
+            length -= chunk;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool steno_output_pending(void) {
+    return output_queue.count > 0;
+}
+#endif // STENO_DICTIONARY_ENABLE
+
+/**
+ * Send queued packets and type queued translations, a little at a time.
+ */
+void steno_task(void) {
+#ifdef VIRTSER_ENABLE
+    for (uint8_t i = 0; i < MAX_STROKE_SIZE && packet_queue.count > 0; i++) {
+        steno_packet_send_byte();
+    }
+#endif
+#ifdef STENO_DICTIONARY_ENABLE
+    if (output_queue.count > 0) {
+        steno_output_send_char();
+    }
+#endif
+}
+
+#if defined(STENO_ENABLE_ALL) || defined(STENO_DICTIONARY_ENABLE)
 void steno_init(void) {
+#    ifdef STENO_ENABLE_ALL
     mode = eeprom_read_byte(EECONFIG_STENOMODE);
+#    endif
+#    ifdef STENO_DICTIONARY_ENABLE
+    // The dictionary may be the only user of the external flash, initialising it again is harmless
+    flash_init();
+    dictionary_checked      = false;
+    dictionary_bucket_count = 0;
+#    endif
 }
+#endif
 
+#ifdef STENO_ENABLE_ALL
 void steno_set_mode(steno_mode_t new_mode) {
     steno_clear_chord();
     mode = new_mode;
@@ -192,6 +398,9 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
         case STN__MIN ... STN__MAX:
             if (record->event.pressed) {
                 n_pressed_keys++;
+#ifdef STENO_DICTIONARY_ENABLE
+                stroke |= (steno_stroke_t)1 << (keycode - QK_STENO);
+#endif
                 switch (mode) {
 #ifdef STENO_ENABLE_BOLT
                     case STENO_MODE_BOLT:
@@ -224,6 +433,12 @@ bool process_steno(uint16_t keycode, keyrecord_t *record) {
                     steno_clear_chord();
                     return false;
                 }
+#ifdef STENO_DICTIONARY_ENABLE
+                if (steno_translate_stroke(stroke)) {
+                    steno_clear_chord();
+                    return false;
+                }
+#endif
                 switch (mode) {
 #if defined(STENO_ENABLE_BOLT) && defined(VIRTSER_ENABLE)
                     case STENO_MODE_BOLT:
@@ -35,8 +35,19 @@ typedef enum {
     STENO_MODE_BOLT,
 } steno_mode_t;
 
+// Bit n is set when the steno key QK_STENO + n is part of the stroke
+typedef uint64_t steno_stroke_t;
+
 bool process_steno(uint16_t keycode, keyrecord_t *record);
-#ifdef STENO_ENABLE_ALL
+void steno_task(void);
+#ifdef STENO_DICTIONARY_ENABLE
+uint16_t steno_dictionary_hash(steno_stroke_t stroke);
+bool     steno_translate_stroke(steno_stroke_t stroke);
+bool     steno_output_pending(void);
+#endif // STENO_DICTIONARY_ENABLE
+#if defined(STENO_ENABLE_ALL) || defined(STENO_DICTIONARY_ENABLE)
 void steno_init(void);
+#endif
+#ifdef STENO_ENABLE_ALL
 void steno_set_mode(steno_mode_t mode);
 #endif // STENO_ENABLE_ALL
@@ -22,8 +22,77 @@
 #include "timer.h"
 #include "wait.h"
 
-static uint16_t active_td;
-static uint16_t last_tap_time;
+// Number of tap dances on different keys that can be in progress at once
+#ifndef TAP_DANCE_MAX_SIMULTANEOUS
+#    define TAP_DANCE_MAX_SIMULTANEOUS 1
+#endif
+
+_Static_assert(TAP_DANCE_MAX_SIMULTANEOUS > 0 && TAP_DANCE_MAX_SIMULTANEOUS <= UINT8_MAX, "TAP_DANCE_MAX_SIMULTANEOUS must be between 1 and 255");
+
+typedef struct {
+    uint8_t  index;
+    uint16_t deadline;
+} tap_dance_timer_t;
+
+// Dances awaiting another tap, oldest first
+static tap_dance_timer_t active_td[TAP_DANCE_MAX_SIMULTANEOUS];
+static uint8_t           active_td_count;
+static uint16_t          next_deadline;
+
+// Returns the slot of the dance, or TAP_DANCE_MAX_SIMULTANEOUS if it isn't active
+static uint8_t tap_dance_find_active(uint8_t index) {
+    for (uint8_t i = 0; i < active_td_count; i++) {
+        if (active_td[i].index == index) {
+            return i;
+        }
+    }
+    return TAP_DANCE_MAX_SIMULTANEOUS;
+}
+
+static void tap_dance_update_next_deadline(void) {
+    if (!active_td_count) {
+        return;
+    }
+
+    next_deadline = active_td[0].deadline;
+    for (uint8_t i = 1; i < active_td_count; i++) {
+        if (TIMER_DIFF_16(active_td[i].deadline, next_deadline) < UINT16_MAX / 2) {
+            continue;
+        }
+        next_deadline = active_td[i].deadline;
+    }
+}
+
+static void tap_dance_unschedule(uint8_t index) {
+    uint8_t slot = tap_dance_find_active(index);
+    if (slot == TAP_DANCE_MAX_SIMULTANEOUS) {
+        return;
+    }
+
+    active_td_count--;
+    for (uint8_t i = slot; i < active_td_count; i++) {
+        active_td[i] = active_td[i + 1];
+    }
+    tap_dance_update_next_deadline();
+}
+
+static void tap_dance_schedule(uint8_t index, uint16_t deadline) {
+    uint8_t slot = tap_dance_find_active(index);
+    if (slot == TAP_DANCE_MAX_SIMULTANEOUS) {
+        // preprocess_tap_dance() has already made room by interrupting the oldest dance
+        if (active_td_count == TAP_DANCE_MAX_SIMULTANEOUS) {
+            return;
+        }
+        slot = active_td_count++;
+    }
+
+    active_td[slot] = (tap_dance_timer_t){.index = index, .deadline = deadline};
+    tap_dance_update_next_deadline();
+}
+
+static inline uint8_t tap_dance_action_index(tap_dance_action_t *action) {
+    return action - tap_dance_actions;
+}
 
 void tap_dance_pair_on_each_tap(tap_dance_state_t *state, void *user_data) {
     tap_dance_pair_t *pair = (tap_dance_pair_t *)user_data;
@@ -119,7 +188,7 @@ static inline void process_tap_dance_action_on_dance_finished(tap_dance_action_t
         send_keyboard_report();
         _process_tap_dance_action_fn(&action->state, action->user_data, action->fn.on_dance_finished);
     }
-    active_td = 0;
+    tap_dance_unschedule(tap_dance_action_index(action));
     if (!action->state.pressed) {
         // There will not be a key release event, so reset now.
         process_tap_dance_action_on_reset(action);
@@ -127,16 +196,33 @@ static inline void process_tap_dance_action_on_dance_finished(tap_dance_action_t
 }
 
 bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
-    tap_dance_action_t *action;
-
     if (!record->event.pressed) return false;
 
-    if (!active_td || keycode == active_td) return false;
+    if (!active_td_count) return false;
+
+    // Other tap dance keys only interrupt the oldest dance, and only when there is no room for another
+    bool is_tap_dance = IS_QK_TAP_DANCE(keycode);
+    bool make_room    = is_tap_dance && active_td_count == TAP_DANCE_MAX_SIMULTANEOUS && tap_dance_find_active(QK_TAP_DANCE_GET_INDEX(keycode)) == TAP_DANCE_MAX_SIMULTANEOUS;
+    bool interrupted  = false;
+
+    for (uint8_t i = 0; i < active_td_count;) {
+        uint8_t index = active_td[i].index;
+        if (keycode == TD(index) || (is_tap_dance && !make_room)) {
+            i++;
+            continue;
+        }
+
+        tap_dance_action_t *action         = &tap_dance_actions[index];
+        action->state.interrupted          = true;
+        action->state.interrupting_keycode = keycode;
+        // Removes the dance from active_td, so the next one moves into this slot
+        process_tap_dance_action_on_dance_finished(action);
+
+        interrupted = true;
+        make_room   = false;
+    }
 
-    action                             = &tap_dance_actions[QK_TAP_DANCE_GET_INDEX(active_td)];
-    action->state.interrupted          = true;
-    action->state.interrupting_keycode = keycode;
-    process_tap_dance_action_on_dance_finished(action);
+    if (!interrupted) return false;
 
     // Tap dance actions can leave some weak mods active (e.g., if the tap dance is mapped to a keycode with
     // modifiers), but these weak mods should not affect the keypress which interrupted the tap dance.
@@ -151,23 +237,28 @@ bool preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
 bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     tap_dance_action_t *action;
+    uint8_t             index;
 
     switch (keycode) {
         case QK_TAP_DANCE ... QK_TAP_DANCE_MAX:
-            action = &tap_dance_actions[QK_TAP_DANCE_GET_INDEX(keycode)];
+            index  = QK_TAP_DANCE_GET_INDEX(keycode);
+            action = &tap_dance_actions[index];
 
             action->state.pressed = record->event.pressed;
             if (record->event.pressed) {
-                last_tap_time = timer_read();
+                // The dance finishes once the time since this tap exceeds the tapping term
+                uint16_t deadline = timer_read() + GET_TAPPING_TERM(keycode, record) + 1;
                 process_tap_dance_action_on_each_tap(action);
-                active_td = action->state.finished ? 0 : keycode;
+                if (action->state.finished) {
+                    tap_dance_unschedule(index);
+                } else {
+                    tap_dance_schedule(index, deadline);
+                }
             } else {
                 process_tap_dance_action_on_each_release(action);
                 if (action->state.finished) {
                     process_tap_dance_action_on_reset(action);
-                    if (active_td == keycode) {
-                        active_td = 0;
-                    }
+                    tap_dance_unschedule(index);
                 }
             }
 
@@ -178,17 +269,27 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 }
 
 void tap_dance_task(void) {
-    tap_dance_action_t *action;
-
-    if (!active_td || timer_elapsed(last_tap_time) <= GET_TAPPING_TERM(active_td, &(keyrecord_t){})) return;
-
-    action = &tap_dance_actions[QK_TAP_DANCE_GET_INDEX(active_td)];
-    if (!action->state.interrupted) {
-        process_tap_dance_action_on_dance_finished(action);
+    if (!active_td_count) return;
+
+    uint16_t now = timer_read();
+    if (!timer_expired(now, next_deadline)) return;
+
+    for (uint8_t i = 0; i < active_td_count;) {
+        if (!timer_expired(now, active_td[i].deadline)) {
+            i++;
+            continue;
+        }
+
+        tap_dance_action_t *action = &tap_dance_actions[active_td[i].index];
+        if (action->state.interrupted) {
+            tap_dance_unschedule(active_td[i].index);
+        } else {
+            process_tap_dance_action_on_dance_finished(action);
+        }
     }
 }
 
 void reset_tap_dance(tap_dance_state_t *state) {
-    active_td = 0;
+    tap_dance_unschedule(tap_dance_action_index((tap_dance_action_t *)state));
     process_tap_dance_action_on_reset((tap_dance_action_t *)state);
 }
@@ -24,6 +24,10 @@
 #    include "outputselect.h"
 #endif
 
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef GRAVE_ESC_ENABLE
 #    include "process_grave_esc.h"
 #endif
@@ -198,6 +202,9 @@ void shutdown_quantum(bool jump_to_bootloader) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+#ifdef EEPROM_DRIVER
+    eeprom_driver_flush();
+#endif
 }
 
 void reset_keyboard(void) {
@@ -260,143 +267,211 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
-/* Core keycode function, hands off handling to other functions,
-    then processes internal quantum keycodes, and then processes
-    ACTIONs.                                                      */
-bool process_record_quantum(keyrecord_t *record) {
-    uint16_t keycode = get_record_keycode(record, true);
-
-    // This is how you use actions here
-    // if (keycode == QK_LEADER) {
-    //   action_t action;
-    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
-    //   process_action(record, action);
-    //   return false;
-    // }
-
-#if defined(SECURE_ENABLE)
-    if (!preprocess_secure(keycode, record)) {
-        return false;
-    }
-#endif
-
-#ifdef TAP_DANCE_ENABLE
-    if (preprocess_tap_dance(keycode, record)) {
-        // The tap dance might have updated the layer state, therefore the
-        // result of the keycode lookup might change.
-        keycode = get_record_keycode(record, true);
-    }
-#endif
-
-#ifdef RGBLIGHT_ENABLE
-    if (record->event.pressed) {
-        preprocess_rgblight();
-    }
+#if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
+static bool process_rgb_record(uint16_t keycode, keyrecord_t *record) {
+    return process_rgb(keycode, record);
+}
 #endif
 
-#ifdef WPM_ENABLE
-    if (record->event.pressed) {
-        update_wpm(keycode);
-    }
+#ifdef PROCESS_RECORD_HANDLER_STATS
+#    define PROCESS_RECORD_HANDLER(fn, first, last) {fn, first, last, #fn}
+#else
+#    define PROCESS_RECORD_HANDLER(fn, first, last) {fn, first, last}
 #endif
+#define PROCESS_RECORD_HANDLER_ALL(fn) PROCESS_RECORD_HANDLER(fn, 0x0000, 0xFFFF)
 
-    if (!(
-#if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
-#endif
+/* Feature handlers in the order process_record_quantum() invokes them, each
+ * with the range of keycodes it acts on. Handlers that return true without
+ * doing anything outside of their range are skipped for other keycodes,
+ * handlers that have to see every event are registered for all keycodes. */
+static const process_record_handler_t process_record_handlers[] = {
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+    // Must run asap to ensure all keypresses are recorded.
+    PROCESS_RECORD_HANDLER_ALL(process_dynamic_macro),
 #endif
 #ifdef REPEAT_KEY_ENABLE
-            process_last_key(keycode, record) && process_repeat_key(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_last_key),
+    PROCESS_RECORD_HANDLER_ALL(process_repeat_key),
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_clicky),
 #endif
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_haptic),
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_record_via, QK_MACRO, QK_MACRO_MAX),
 #endif
 #if defined(POINTING_DEVICE_ENABLE) && defined(POINTING_DEVICE_AUTO_MOUSE_ENABLE)
-            process_auto_mouse(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_auto_mouse),
 #endif
-            process_record_kb(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_record_kb),
 #if defined(SECURE_ENABLE)
-            process_secure(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_secure),
 #endif
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_sequencer, QK_SEQUENCER, QK_SEQUENCER_MAX),
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_midi, QK_MIDI, QK_MIDI_MAX),
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_audio, QK_AUDIO, QK_AUDIO_MAX),
 #endif
 #if defined(BACKLIGHT_ENABLE)
-            process_backlight(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_backlight, QK_BACKLIGHT_ON, QK_BACKLIGHT_TOGGLE_BREATHING),
 #endif
 #if defined(LED_MATRIX_ENABLE)
-            process_led_matrix(keycode, record) &&
+    // Also handles the backlight keycodes
+    PROCESS_RECORD_HANDLER(process_led_matrix, QK_BACKLIGHT_ON, QK_LED_MATRIX_SPEED_DOWN),
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_steno, QK_STENO, QK_STENO_MAX),
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+    // Takes over every key while music mode is on
+    PROCESS_RECORD_HANDLER_ALL(process_music),
 #endif
 #ifdef CAPS_WORD_ENABLE
-            process_caps_word(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_caps_word),
 #endif
 #ifdef KEY_OVERRIDE_ENABLE
-            process_key_override(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_key_override),
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_tap_dance, QK_TAP_DANCE, QK_TAP_DANCE_MAX),
 #endif
 #if defined(UNICODE_COMMON_ENABLE)
-            process_unicode_common(keycode, record) &&
+#    if defined(UCIS_ENABLE)
+    // Takes over every key while an input sequence is active
+    PROCESS_RECORD_HANDLER_ALL(process_unicode_common),
+#    else
+    // The input mode keycodes and the code point keycodes
+    PROCESS_RECORD_HANDLER(process_unicode_common, QK_UNICODE_MODE_NEXT, QK_UNICODE_MAX),
+#    endif
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_leader),
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_auto_shift),
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_dynamic_tapping_term, QK_DYNAMIC_TAPPING_TERM_PRINT, QK_DYNAMIC_TAPPING_TERM_DOWN),
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_space_cadet),
 #endif
 #ifdef MAGIC_ENABLE
-            process_magic(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_magic, QK_MAGIC, QK_MAGIC_MAX),
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_grave_esc, QK_GRAVE_ESCAPE, QK_GRAVE_ESCAPE),
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_rgb_record, QK_UNDERGLOW_TOGGLE, RGB_MODE_TWINKLE),
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_joystick, QK_JOYSTICK, QK_JOYSTICK_MAX),
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_programmable_button, QK_PROGRAMMABLE_BUTTON, QK_PROGRAMMABLE_BUTTON_MAX),
 #endif
 #ifdef AUTOCORRECT_ENABLE
-            process_autocorrect(keycode, record) &&
+    PROCESS_RECORD_HANDLER_ALL(process_autocorrect),
 #endif
 #ifdef TRI_LAYER_ENABLE
-            process_tri_layer(keycode, record) &&
+    PROCESS_RECORD_HANDLER(process_tri_layer, QK_TRI_LAYER_LOWER, QK_TRI_LAYER_UPPER),
 #endif
-            true)) {
+};
+
+#ifdef PROCESS_RECORD_HANDLER_STATS
+static process_record_handler_stats_t process_record_handler_stats[ARRAY_SIZE(process_record_handlers)];
+
+uint8_t process_record_handler_count(void) {
+    return ARRAY_SIZE(process_record_handlers);
+}
+
+const char *process_record_handler_name(uint8_t index) {
+    return index < ARRAY_SIZE(process_record_handlers) ? process_record_handlers[index].name : NULL;
+}
+
+const process_record_handler_stats_t *process_record_handler_get_stats(uint8_t index) {
+    return index < ARRAY_SIZE(process_record_handlers) ? &process_record_handler_stats[index] : NULL;
+}
+
+void process_record_handler_reset_stats(void) {
+    memset(process_record_handler_stats, 0, sizeof(process_record_handler_stats));
+}
+#endif
+
+/* Core keycode function, hands off handling to other functions,
+    then processes internal quantum keycodes, and then processes
+    ACTIONs.                                                      */
+bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, true);
+
+#if defined(UNICODE_COMMON_ENABLE) && defined(UNICODE_ASYNC_OUTPUT)
+    // Keys only act on the host once the characters queued before them are typed out, and never inside an input sequence
+    unicode_output_flush();
+#endif
+
+    // This is how you use actions here
+    // if (keycode == QK_LEADER) {
+    //   action_t action;
+    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
+    //   process_action(record, action);
+    //   return false;
+    // }
+
+#if defined(SECURE_ENABLE)
+    if (!preprocess_secure(keycode, record)) {
         return false;
     }
+#endif
+
+#ifdef TAP_DANCE_ENABLE
+    if (preprocess_tap_dance(keycode, record)) {
+        // The tap dance might have updated the layer state, therefore the
+        // result of the keycode lookup might change.
+        keycode = get_record_keycode(record, true);
+    }
+#endif
+
+#ifdef RGBLIGHT_ENABLE
+    if (record->event.pressed) {
+        preprocess_rgblight();
+    }
+#endif
+
+#ifdef WPM_ENABLE
+    if (record->event.pressed) {
+        update_wpm(keycode);
+    }
+#endif
+
+#if defined(KEY_LOCK_ENABLE)
+    // Must run first to be able to mask key_up events.
+    if (!process_key_lock(&keycode, record)) {
+        return false;
+    }
+#endif
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(process_record_handlers); ++i) {
+        const process_record_handler_t *handler = &process_record_handlers[i];
+        if (keycode < handler->first || keycode > handler->last) {
+#ifdef PROCESS_RECORD_HANDLER_STATS
+            process_record_handler_stats[i].skipped++;
+#endif
+            continue;
+        }
+#ifdef PROCESS_RECORD_HANDLER_STATS
+        process_record_handler_stats[i].invocations++;
+#endif
+        if (!handler->process(keycode, record)) {
+            return false;
+        }
+    }
 
     if (record->event.pressed) {
         switch (keycode) {
@@ -259,6 +259,28 @@ bool     process_record_user(uint16_t keycode, keyrecord_t *record);
 void     post_process_record_kb(uint16_t keycode, keyrecord_t *record);
 void     post_process_record_user(uint16_t keycode, keyrecord_t *record);
 
+/* A feature handler invoked by process_record_quantum() for the keycodes first to last */
+typedef struct {
+    bool (*process)(uint16_t keycode, keyrecord_t *record);
+    uint16_t first;
+    uint16_t last;
+#ifdef PROCESS_RECORD_HANDLER_STATS
+    const char *name;
+#endif
+} process_record_handler_t;
+
+#ifdef PROCESS_RECORD_HANDLER_STATS
+typedef struct {
+    uint32_t invocations; // events the handler was called for
+    uint32_t skipped;     // events the handler was skipped for, because the keycode was outside of its range
+} process_record_handler_stats_t;
+
+uint8_t                               process_record_handler_count(void);
+const char                           *process_record_handler_name(uint8_t index);
+const process_record_handler_stats_t *process_record_handler_get_stats(uint8_t index);
+void                                  process_record_handler_reset_stats(void);
+#endif
+
 void reset_keyboard(void);
 void soft_reset_keyboard(void);
 
@@ -0,0 +1,29 @@
+#pragma once
+
+#ifndef RGB_MATRIX_HSV_SPAN_SIZE
+#    define RGB_MATRIX_HSV_SPAN_SIZE 16
+#endif
+
+// Collects the colors computed by an effect runner, so they are converted to RGB together
+typedef struct {
+    uint8_t count;
+    uint8_t index[RGB_MATRIX_HSV_SPAN_SIZE];
+    HSV     hsv[RGB_MATRIX_HSV_SPAN_SIZE];
+} effect_span_t;
+
+static void effect_span_flush(effect_span_t* span) {
+    RGB rgb[RGB_MATRIX_HSV_SPAN_SIZE];
+    rgb_matrix_hsv_to_rgb_span(span->hsv, rgb, span->count);
+    for (uint8_t j = 0; j < span->count; j++) {
+        rgb_matrix_set_color(span->index[j], rgb[j].r, rgb[j].g, rgb[j].b);
+    }
+    span->count = 0;
+}
+
+static inline void effect_span_add(effect_span_t* span, uint8_t i, HSV hsv) {
+    span->index[span->count] = i;
+    span->hsv[span->count]   = hsv;
+    if (++span->count == RGB_MATRIX_HSV_SPAN_SIZE) {
+        effect_span_flush(span);
+    }
+}
@@ -39,6 +39,11 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
     return hsv_to_rgb(hsv);
 }
 
+// Used by the effect runners -- keyboards overriding rgb_matrix_hsv_to_rgb() need to override this as well
+__attribute__((weak)) void rgb_matrix_hsv_to_rgb_span(const HSV *hsv, RGB *rgb, uint8_t count) {
+    hsv_to_rgb_span(hsv, rgb, count);
+}
+
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
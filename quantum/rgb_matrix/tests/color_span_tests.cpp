@@ -0,0 +1,86 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+#include "color.h"
+}
+
+#define SPAN_SIZE 16
+
+class ColorSpan : public ::testing::Test {
+   protected:
+    // Every hue, with saturation and value at the edges and in steps across their range, in spans of SPAN_SIZE.
+    // The exhaustive sweep over every color lives in tests/bench.
+    static std::vector<HSV> sampled_colors() {
+        std::vector<uint8_t> levels = {0, 1, 2, 127, 128, 253, 254, 255};
+        for (int level = 3; level < 253; level += 10) {
+            levels.push_back(level);
+        }
+
+        std::vector<HSV> colors;
+        for (int h = 0; h < 256; h++) {
+            for (uint8_t s : levels) {
+                for (uint8_t v : levels) {
+                    colors.push_back({(uint8_t)h, s, v});
+                }
+            }
+        }
+        // Pad to whole spans
+        while (colors.size() % SPAN_SIZE) {
+            colors.push_back({HSV_WHITE});
+        }
+        return colors;
+    }
+
+    static void convert_span(const std::vector<HSV>& hsv, std::vector<RGB>& rgb, bool use_cie) {
+        for (size_t i = 0; i < hsv.size(); i += SPAN_SIZE) {
+            hsv_to_rgb_span_impl(&hsv[i], &rgb[i], SPAN_SIZE, use_cie);
+        }
+    }
+
+    static void expect_bit_exact(bool use_cie) {
+        std::vector<HSV> hsv = sampled_colors();
+        std::vector<RGB> actual(hsv.size());
+        convert_span(hsv, actual, use_cie);
+        for (size_t i = 0; i < hsv.size(); i++) {
+            RGB expected = hsv_to_rgb_impl(hsv[i], use_cie);
+            ASSERT_TRUE(expected.r == actual[i].r && expected.g == actual[i].g && expected.b == actual[i].b) << "Mismatch for HSV " << (int)hsv[i].h << "," << (int)hsv[i].s << "," << (int)hsv[i].v;
+        }
+    }
+};
+
+/**
+ * This test verifies that the span conversion matches the scalar conversion for a sample of colors covering every hue.
+ */
+TEST_F(ColorSpan, MatchesScalar) {
+    expect_bit_exact(false);
+}
+
+#ifdef USE_CIE1931_CURVE
+/**
+ * This test verifies that the span conversion matches the scalar conversion for a sample of colors, with the CIE curve applied.
+ */
+TEST_F(ColorSpan, MatchesScalarWithCie) {
+    expect_bit_exact(true);
+}
+#endif
+
+/**
+ * This test verifies that a partial span only touches the requested colors.
+ */
+TEST_F(ColorSpan, PartialSpan) {
+    HSV hsv[3] = {{HSV_RED}, {HSV_GREEN}, {HSV_WHITE}};
+    RGB rgb[3] = {{0}, {0}, {0}};
+    rgb[2].r = rgb[2].g = rgb[2].b = 0x5A;
+
+    hsv_to_rgb_span_impl(hsv, rgb, 2, false);
+    EXPECT_EQ(rgb[0].r, 255);
+    EXPECT_EQ(rgb[0].g, 0);
+    EXPECT_EQ(rgb[1].g, 255);
+    EXPECT_EQ(rgb[1].b, 0);
+    EXPECT_EQ(rgb[2].r, 0x5A);
+}
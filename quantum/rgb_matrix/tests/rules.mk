@@ -0,0 +1,8 @@
+color_span_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/rgb_matrix/tests/color_span_tests.cpp
+
+color_span_cie_DEFS := -DUSE_CIE1931_CURVE
+color_span_cie_SRC := \
+	$(color_span_SRC) \
+	$(QUANTUM_PATH)/led_tables.c
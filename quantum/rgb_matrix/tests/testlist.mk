@@ -0,0 +1,3 @@
+TEST_LIST += \
+	color_span \
+	color_span_cie
@@ -126,6 +126,20 @@ rgblight_segment_t const *const *rgblight_layers = NULL;
 static bool deferred_set_layer_state = false;
 #endif
 
+#ifndef RGBLIGHT_FRAME_INTERVAL
+#    define RGBLIGHT_FRAME_INTERVAL 16
+#endif
+
+static struct {
+    bool     governed; // The frame is an animation update, subject to RGBLIGHT_FRAME_INTERVAL
+    bool     pending;  // An animation update is waiting for the next frame
+    bool     sent;     // A frame has been sent, so last_hash is valid
+    uint16_t last_time;
+    uint32_t last_hash;
+} rgblight_frame = {0};
+
+static rgblight_frame_stats_t rgblight_frame_stats = {0};
+
 rgblight_ranges_t rgblight_ranges = {0, RGBLIGHT_LED_COUNT, 0, RGBLIGHT_LED_COUNT, RGBLIGHT_LED_COUNT};
 
 void rgblight_set_clipping_range(uint8_t start_pos, uint8_t num_leds) {
@@ -164,6 +178,29 @@ void sethsv(uint8_t hue, uint8_t sat, uint8_t val, rgb_led_t *led1) {
     sethsv_raw(hue, sat, val > RGBLIGHT_LIMIT_VAL ? RGBLIGHT_LIMIT_VAL : val, led1);
 }
 
+// Keyboards overriding rgblight_hsv_to_rgb() need to override this as well
+__attribute__((weak)) void rgblight_hsv_to_rgb_span(const HSV *hsv, RGB *rgb, uint8_t count) {
+    hsv_to_rgb_span(hsv, rgb, count);
+}
+
+#ifndef RGBLIGHT_HSV_SPAN_SIZE
+#    define RGBLIGHT_HSV_SPAN_SIZE 16
+#endif
+
+#if defined(RGBLIGHT_EFFECT_RAINBOW_SWIRL) || defined(RGBLIGHT_EFFECT_STATIC_GRADIENT)
+// Same as sethsv() for up to RGBLIGHT_HSV_SPAN_SIZE consecutive LEDs, converted together
+static void sethsv_span(HSV *hsv, uint8_t count, rgb_led_t *led1) {
+    RGB rgb[RGBLIGHT_HSV_SPAN_SIZE];
+    for (uint8_t i = 0; i < count; i++) {
+        hsv[i].v = hsv[i].v > RGBLIGHT_LIMIT_VAL ? RGBLIGHT_LIMIT_VAL : hsv[i].v;
+    }
+    rgblight_hsv_to_rgb_span(hsv, rgb, count);
+    for (uint8_t i = 0; i < count; i++) {
+        setrgb(rgb[i].r, rgb[i].g, rgb[i].b, &led1[i]);
+    }
+}
+#endif
+
 void rgblight_check_config(void) {
     /* Add some out of bound checks for RGB light config */
 
@@ -567,15 +604,21 @@ void rgblight_sethsv_eeprom_helper(uint8_t hue, uint8_t sat, uint8_t val, bool w
                 bool    direction = (delta % 2) == 0;
 
                 uint8_t range = pgm_read_byte(&RGBLED_GRADIENT_RANGES[delta / 2]);
-                for (uint8_t i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-                    uint8_t _hue = ((uint16_t)i * (uint16_t)range) / rgblight_ranges.effect_num_leds;
-                    if (direction) {
-                        _hue = hue + _hue;
-                    } else {
-                        _hue = hue - _hue;
+                HSV     span[RGBLIGHT_HSV_SPAN_SIZE];
+                for (uint16_t start = 0; start < rgblight_ranges.effect_num_leds; start += RGBLIGHT_HSV_SPAN_SIZE) {
+                    uint8_t count = MIN(rgblight_ranges.effect_num_leds - start, RGBLIGHT_HSV_SPAN_SIZE);
+                    for (uint8_t j = 0; j < count; j++) {
+                        uint8_t i    = start + j;
+                        uint8_t _hue = ((uint16_t)i * (uint16_t)range) / rgblight_ranges.effect_num_leds;
+                        if (direction) {
+                            _hue = hue + _hue;
+                        } else {
+                            _hue = hue - _hue;
+                        }
+                        dprintf("rgblight rainbow set hsv: %d,%d,%d,%u\n", i, _hue, direction, range);
+                        span[j] = (HSV){_hue, sat, val};
                     }
-                    dprintf("rgblight rainbow set hsv: %d,%d,%d,%u\n", i, _hue, direction, range);
-                    sethsv(_hue, sat, val, (rgb_led_t *)&led[i + rgblight_ranges.effect_start_pos]);
+                    sethsv_span(span, count, (rgb_led_t *)&led[start + rgblight_ranges.effect_start_pos]);
                 }
 #    ifdef RGBLIGHT_LAYERS_RETAIN_VAL
                 // needed for rgblight_layers_write() to get the new val, since it reads rgblight_config.val
@@ -784,14 +827,16 @@ static void rgblight_layers_write(void) {
             if (segment.index == RGBLIGHT_END_SEGMENT_INDEX) {
                 break; // No more segments
             }
-            // Write segment.count LEDs
-            rgb_led_t *const limit = &led[MIN(segment.index + segment.count, RGBLIGHT_LED_COUNT)];
-            for (rgb_led_t *led_ptr = &led[segment.index]; led_ptr < limit; led_ptr++) {
+            // Write segment.count LEDs, all the same color
+            rgb_led_t color;
 #    ifdef RGBLIGHT_LAYERS_RETAIN_VAL
-                sethsv(segment.hue, segment.sat, current_val, led_ptr);
+            sethsv(segment.hue, segment.sat, current_val, &color);
 #    else
-                sethsv(segment.hue, segment.sat, segment.val, led_ptr);
+            sethsv(segment.hue, segment.sat, segment.val, &color);
 #    endif
+            rgb_led_t *const limit = &led[MIN(segment.index + segment.count, RGBLIGHT_LED_COUNT)];
+            for (rgb_led_t *led_ptr = &led[segment.index]; led_ptr < limit; led_ptr++) {
+                *led_ptr = color;
             }
             segment_ptr++;
         }
@@ -880,6 +925,8 @@ void rgblight_suspend(void) {
 
 void rgblight_wakeup(void) {
     is_suspended = false;
+    // The LEDs may have lost power while suspended, so the next frame is always sent
+    rgblight_frame.sent = false;
 
     if (pre_suspend_enabled) {
         rgblight_enable_noeeprom();
@@ -896,7 +943,18 @@ void rgblight_wakeup(void) {
 
 #endif
 
-void rgblight_set(void) {
+// FNV-1a hash of the LEDs to be sent, so unchanged frames can be skipped without keeping a copy of the last one
+static uint32_t rgblight_frame_hash(const rgb_led_t *start_led, uint8_t num_leds) {
+    const uint8_t *data = (const uint8_t *)start_led;
+    uint32_t       hash = 2166136261UL ^ ((uint32_t)rgblight_ranges.clipping_start_pos << 8) ^ num_leds;
+    for (uint16_t i = 0; i < (uint16_t)num_leds * sizeof(rgb_led_t); i++) {
+        hash = (hash ^ data[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+static void rgblight_send_frame(void) {
+    uint16_t   start = timer_read();
     rgb_led_t *start_led;
     uint8_t    num_leds = rgblight_ranges.clipping_num_leds;
 
@@ -938,7 +996,42 @@ void rgblight_set(void) {
         convert_rgb_to_rgbw(&start_led[i]);
     }
 #endif
-    rgblight_driver.setleds(start_led, num_leds);
+
+    uint32_t hash = rgblight_frame_hash(start_led, num_leds);
+
+    if (rgblight_frame.sent && hash == rgblight_frame.last_hash) {
+        rgblight_frame_stats.frames_unchanged++;
+    } else {
+        rgblight_driver.setleds(start_led, num_leds);
+        rgblight_frame_stats.frames_sent++;
+    }
+
+    rgblight_frame.sent      = true;
+    rgblight_frame.pending   = false;
+    rgblight_frame.last_hash = hash;
+    rgblight_frame.last_time = timer_read();
+
+    uint16_t frame_time                  = TIMER_DIFF_16(rgblight_frame.last_time, start);
+    rgblight_frame_stats.last_frame_time = frame_time;
+    rgblight_frame_stats.max_frame_time  = MAX(rgblight_frame_stats.max_frame_time, frame_time);
+    if (frame_time > RGBLIGHT_FRAME_INTERVAL) {
+        rgblight_frame_stats.frames_over_budget++;
+    }
+}
+
+void rgblight_set(void) {
+    // Animation updates are limited to the target frame rate, anything else is shown immediately
+    if (rgblight_frame.governed && timer_elapsed(rgblight_frame.last_time) < RGBLIGHT_FRAME_INTERVAL) {
+        rgblight_frame.pending = true;
+        rgblight_frame_stats.frames_coalesced++;
+        return;
+    }
+
+    rgblight_send_frame();
+}
+
+void rgblight_get_frame_stats(rgblight_frame_stats_t *stats) {
+    *stats = rgblight_frame_stats;
 }
 
 #ifdef RGBLIGHT_SPLIT
@@ -960,7 +1053,9 @@ void rgblight_get_syncinfo(rgblight_syncinfo_t *syncinfo) {
 void rgblight_update_sync(rgblight_syncinfo_t *syncinfo, bool write_to_eeprom) {
 #    ifdef RGBLIGHT_LAYERS
     if (syncinfo->status.change_flags & RGBLIGHT_STATUS_CHANGE_LAYERS) {
+        // Only the layer mask is sent, the layers are rendered here
         rgblight_status.enabled_layer_mask = syncinfo->status.enabled_layer_mask;
+        deferred_set_layer_state           = true;
     }
 #    endif
     if (syncinfo->status.change_flags & RGBLIGHT_STATUS_CHANGE_MODE) {
@@ -1134,7 +1229,9 @@ void rgblight_timer_task(void) {
             oldpos16 = animation_status.pos16;
 #    endif
             animation_status.last_timer += interval_time;
+            rgblight_frame.governed = true;
             effect_func(&animation_status);
+            rgblight_frame.governed = false;
 #    if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
             if (animation_status.pos16 == 0 && oldpos16 != 0) {
                 tick_flag = true;
@@ -1164,6 +1261,10 @@ void rgblight_timer_task(void) {
 #        endif
     }
 #    endif
+
+    if (rgblight_frame.pending && timer_elapsed(rgblight_frame.last_time) >= RGBLIGHT_FRAME_INTERVAL) {
+        rgblight_send_frame();
+    }
 }
 
 #endif /* RGBLIGHT_USE_TIMER */
@@ -1217,12 +1318,15 @@ void rgblight_effect_rainbow_mood(animation_status_t *anim) {
 __attribute__((weak)) const uint8_t RGBLED_RAINBOW_SWIRL_INTERVALS[] PROGMEM = {100, 50, 20};
 
 void rgblight_effect_rainbow_swirl(animation_status_t *anim) {
-    uint8_t hue;
-    uint8_t i;
+    HSV span[RGBLIGHT_HSV_SPAN_SIZE];
 
-    for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        hue = (RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds * i + anim->current_hue);
-        sethsv(hue, rgblight_config.sat, rgblight_config.val, (rgb_led_t *)&led[i + rgblight_ranges.effect_start_pos]);
+    for (uint16_t start = 0; start < rgblight_ranges.effect_num_leds; start += RGBLIGHT_HSV_SPAN_SIZE) {
+        uint8_t count = MIN(rgblight_ranges.effect_num_leds - start, RGBLIGHT_HSV_SPAN_SIZE);
+        for (uint8_t j = 0; j < count; j++) {
+            uint8_t hue = (RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds * (start + j) + anim->current_hue);
+            span[j]     = (HSV){hue, rgblight_config.sat, rgblight_config.val};
+        }
+        sethsv_span(span, count, (rgb_led_t *)&led[start + rgblight_ranges.effect_start_pos]);
     }
     rgblight_set();
 
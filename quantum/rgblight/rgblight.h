@@ -288,8 +288,21 @@ typedef struct _rgblight_ranges_t {
 
 extern rgblight_ranges_t rgblight_ranges;
 
+/*
+ * Statistics of the frames sent to the driver
+ */
+typedef struct _rgblight_frame_stats_t {
+    uint32_t frames_sent;        // Frames sent to the driver
+    uint32_t frames_unchanged;   // Frames not sent, as they were identical to the previous frame
+    uint32_t frames_coalesced;   // Animation updates deferred to a later frame by RGBLIGHT_FRAME_INTERVAL
+    uint32_t frames_over_budget; // Frames that took longer than RGBLIGHT_FRAME_INTERVAL to compose and send
+    uint16_t last_frame_time;    // Milliseconds taken to compose and send the last frame
+    uint16_t max_frame_time;     // Milliseconds taken to compose and send the slowest frame
+} rgblight_frame_stats_t;
+
 /* === Low level Functions === */
 void rgblight_set(void);
+void rgblight_get_frame_stats(rgblight_frame_stats_t *stats);
 void rgblight_set_clipping_range(uint8_t start_pos, uint8_t num_leds);
 
 /* === Effects and Animations Functions === */
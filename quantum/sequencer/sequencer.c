@@ -34,7 +34,7 @@ sequencer_config_t sequencer_config = {
     SQ_RES_4, // resolution
 };
 
-sequencer_state_t sequencer_internal_state = {0, 0, 0, 0, SEQUENCER_PHASE_ATTACK};
+sequencer_state_t sequencer_internal_state = {0, 0, 0, 0, SEQUENCER_PHASE_ATTACK, 0, false, 0, 0, 0, 0, 0};
 
 bool is_sequencer_on(void) {
     return sequencer_config.enabled;
@@ -42,11 +42,12 @@ bool is_sequencer_on(void) {
 
 void sequencer_on(void) {
     dprintln("sequencer on");
-    sequencer_config.enabled               = true;
-    sequencer_internal_state.current_track = 0;
-    sequencer_internal_state.current_step  = 0;
-    sequencer_internal_state.timer         = timer_read();
-    sequencer_internal_state.phase         = SEQUENCER_PHASE_ATTACK;
+    sequencer_config.enabled                = true;
+    sequencer_internal_state.current_track  = 0;
+    sequencer_internal_state.current_step   = 0;
+    sequencer_internal_state.timer          = timer_read();
+    sequencer_internal_state.phase          = SEQUENCER_PHASE_ATTACK;
+    sequencer_internal_state.step_remainder = 0;
 }
 
 void sequencer_off(void) {
@@ -189,10 +190,6 @@ void sequencer_phase_attack(void) {
     dprintf("sequencer: step %d\n", sequencer_internal_state.current_step);
     dprintf("sequencer: time %d\n", timer_read());
 
-    if (sequencer_internal_state.current_track == 0) {
-        sequencer_internal_state.timer = timer_read();
-    }
-
     if (timer_elapsed(sequencer_internal_state.timer) < sequencer_internal_state.current_track * SEQUENCER_TRACK_THROTTLE) {
         return;
     }
@@ -226,8 +223,52 @@ void sequencer_phase_release(void) {
     }
 }
 
+/**
+ * The exact length of a step is 240000 / (tempo * steps per 4 beats) ms. Steps
+ * are scheduled one after the other from the start of the previous step rather
+ * than from when the task noticed it, and the fraction of a millisecond that
+ * doesn't fit is carried over, so neither a busy main loop nor rounding makes
+ * the sequence drift.
+ */
+static uint16_t sequencer_step_divisor(void) {
+    uint8_t tempo = sequencer_config.tempo ? sequencer_config.tempo : 60;
+    return tempo * get_steps_per_four_beats(sequencer_config.resolution);
+}
+
+static bool sequencer_step_elapsed_internal(void) {
+    uint16_t divisor  = sequencer_step_divisor();
+    uint32_t length   = 240000UL + sequencer_internal_state.step_remainder;
+    uint16_t duration = length / divisor;
+    uint16_t elapsed  = timer_elapsed(sequencer_internal_state.timer);
+    if (elapsed < duration) {
+        return false;
+    }
+
+    if (elapsed - duration < duration) {
+        sequencer_internal_state.timer += duration;
+        sequencer_internal_state.step_remainder = length % divisor;
+    } else {
+        // More than a whole step late (stalled, or the tempo was raised): restart the grid instead of rushing through steps
+        sequencer_internal_state.timer          = timer_read();
+        sequencer_internal_state.step_remainder = 0;
+    }
+    return true;
+}
+
+static bool sequencer_step_elapsed_midi_clock(void) {
+    if (sequencer_internal_state.midi_pending_steps == 0) {
+        return false;
+    }
+
+    sequencer_internal_state.midi_pending_steps--;
+    sequencer_internal_state.timer          = timer_read();
+    sequencer_internal_state.step_remainder = 0;
+    return true;
+}
+
 void sequencer_phase_pause(void) {
-    if (timer_elapsed(sequencer_internal_state.timer) < sequencer_get_step_duration()) {
+    bool elapsed = is_sequencer_midi_clock_synced() ? sequencer_step_elapsed_midi_clock() : sequencer_step_elapsed_internal();
+    if (!elapsed) {
         return;
     }
 
@@ -236,6 +277,11 @@ void sequencer_phase_pause(void) {
 }
 
 void sequencer_task(void) {
+    // Forget a stopped clock, the 16 bit timer would report it as synced again once it wraps around
+    if (sequencer_internal_state.midi_clock && timer_elapsed(sequencer_internal_state.midi_clock_timer) >= SEQUENCER_MIDI_CLOCK_TIMEOUT) {
+        sequencer_internal_state.midi_clock = false;
+    }
+
     if (!sequencer_config.enabled) {
         return;
     }
@@ -301,3 +347,63 @@ uint16_t get_step_duration(uint8_t tempo, sequencer_resolution_t resolution) {
 
     return is_binary ? binary_step_duration : 2 * binary_step_duration / 3;
 }
+
+uint8_t get_steps_per_four_beats(sequencer_resolution_t resolution) {
+    // See the cheatsheet above, ternary variants have 1.5x as many steps
+    bool is_binary = resolution % 2 == 0;
+    return (is_binary ? 2 : 3) << (resolution / 2);
+}
+
+bool is_sequencer_midi_clock_synced(void) {
+    return sequencer_internal_state.midi_clock && timer_elapsed(sequencer_internal_state.midi_clock_timer) < SEQUENCER_MIDI_CLOCK_TIMEOUT;
+}
+
+void sequencer_midi_clock(void) {
+    uint16_t now = timer_read();
+
+    if (!is_sequencer_midi_clock_synced()) {
+        dprintln("sequencer: following MIDI clock");
+        sequencer_internal_state.midi_clock_ticks   = 0;
+        sequencer_internal_state.midi_pending_steps = 0;
+        sequencer_internal_state.midi_beat_ticks    = 0;
+        sequencer_internal_state.midi_beat_timer    = now;
+    } else if (++sequencer_internal_state.midi_beat_ticks == SEQUENCER_MIDI_CLOCK_PPQN) {
+        // Follow the tempo of the clock, so that the sequencer keeps going at the same pace if the clock stops
+        uint16_t beat_duration = TIMER_DIFF_16(now, sequencer_internal_state.midi_beat_timer);
+        if (beat_duration > 0) {
+            uint32_t tempo = (60000UL + beat_duration / 2) / beat_duration;
+            if (tempo > 0 && tempo <= UINT8_MAX) {
+                sequencer_config.tempo = tempo;
+            }
+        }
+        sequencer_internal_state.midi_beat_ticks = 0;
+        sequencer_internal_state.midi_beat_timer = now;
+    }
+    sequencer_internal_state.midi_clock       = true;
+    sequencer_internal_state.midi_clock_timer = now;
+
+    // 4 beats are 96 ticks, every resolution divides them evenly
+    uint8_t ticks_per_step = (4 * SEQUENCER_MIDI_CLOCK_PPQN) / get_steps_per_four_beats(sequencer_config.resolution);
+    if (++sequencer_internal_state.midi_clock_ticks >= ticks_per_step) {
+        sequencer_internal_state.midi_clock_ticks = 0;
+        if (sequencer_config.enabled && sequencer_internal_state.midi_pending_steps < UINT8_MAX) {
+            sequencer_internal_state.midi_pending_steps++;
+        }
+    }
+}
+
+void sequencer_midi_start(void) {
+    sequencer_internal_state.midi_clock_ticks   = 0;
+    sequencer_internal_state.midi_pending_steps = 0;
+    sequencer_on();
+}
+
+void sequencer_midi_continue(void) {
+    dprintln("sequencer continue");
+    sequencer_internal_state.midi_pending_steps = 0;
+    sequencer_config.enabled                    = true;
+}
+
+void sequencer_midi_stop(void) {
+    sequencer_off();
+}
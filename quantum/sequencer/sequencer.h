@@ -37,6 +37,14 @@
 #    define SEQUENCER_PHASE_RELEASE_TIMEOUT 30
 #endif
 
+// How long (in milliseconds) after the last MIDI clock tick the sequencer falls back to its own clock
+#ifndef SEQUENCER_MIDI_CLOCK_TIMEOUT
+#    define SEQUENCER_MIDI_CLOCK_TIMEOUT 500
+#endif
+
+// MIDI clock ticks per quarter note
+#define SEQUENCER_MIDI_CLOCK_PPQN 24
+
 /**
  * Make sure that the items of this enumeration follow the powers of 2, separated by a ternary variant.
  * Check the implementation of `get_step_duration` for further explanation.
@@ -76,8 +84,15 @@ typedef struct {
     uint8_t           active_tracks;
     uint8_t           current_track;
     uint8_t           current_step;
-    uint16_t          timer;
+    uint16_t          timer; // Scheduled start of the current step
     sequencer_phase_t phase;
+    uint16_t          step_remainder; // Fraction of a millisecond carried over to the next step, in 1 / (tempo * steps per 4 beats) ms
+    bool              midi_clock;     // Whether MIDI clock ticks have been received
+    uint16_t          midi_clock_timer;
+    uint8_t           midi_clock_ticks;   // Ticks since the last step
+    uint8_t           midi_pending_steps; // Steps clocked by MIDI that haven't started yet
+    uint8_t           midi_beat_ticks;
+    uint16_t          midi_beat_timer;
 } sequencer_state_t;
 
 extern sequencer_config_t sequencer_config;
@@ -128,5 +143,12 @@ uint16_t sequencer_get_step_duration(void);
 
 uint16_t get_beat_duration(uint8_t tempo);
 uint16_t get_step_duration(uint8_t tempo, sequencer_resolution_t resolution);
+uint8_t  get_steps_per_four_beats(sequencer_resolution_t resolution);
+
+bool is_sequencer_midi_clock_synced(void);
+void sequencer_midi_clock(void);
+void sequencer_midi_start(void);
+void sequencer_midi_continue(void);
+void sequencer_midi_stop(void);
 
 void sequencer_task(void);
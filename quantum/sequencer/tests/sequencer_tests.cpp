@@ -15,6 +15,8 @@
  */
 
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <stdio.h>
 
 extern "C" {
 #include "sequencer.h"
@@ -72,6 +74,9 @@ class SequencerTest : public ::testing::Test {
         sequencer_internal_state.current_track = state_copy.current_track;
         sequencer_internal_state.current_step  = state_copy.current_step;
         sequencer_internal_state.timer         = state_copy.timer;
+
+        sequencer_internal_state.step_remainder = 0;
+        sequencer_internal_state.midi_clock     = false;
     }
 
     sequencer_config_t config_copy;
@@ -590,3 +595,215 @@ TEST_F(SequencerTest, TestMatrixScanSequencerShouldLoopOnceSequenceIsOver) {
     EXPECT_EQ(sequencer_internal_state.current_track, 1);
     EXPECT_EQ(sequencer_internal_state.phase, SEQUENCER_PHASE_ATTACK);
 }
+
+TEST_F(SequencerTest, TestGetStepsPerFourBeats) {
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_2), 2);
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_2T), 3);
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_4), 4);
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_4T), 6);
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_8), 8);
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_8T), 12);
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_16), 16);
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_16T), 24);
+    EXPECT_EQ(get_steps_per_four_beats(SQ_RES_32), 32);
+}
+
+// Small deterministic generator for the main loop period
+static uint32_t loop_state = 1;
+static uint8_t  next_loop_period(uint8_t max) {
+    loop_state = loop_state * 1103515245 + 12345;
+    return 1 + (loop_state >> 16) % max;
+}
+
+/**
+ * Runs the sequencer with an irregular main loop for the given number of steps
+ * and returns the worst difference between the time a step started and its
+ * exact position on the grid, in milliseconds.
+ */
+static uint32_t run_steps(uint8_t tempo, sequencer_resolution_t resolution, uint32_t steps, uint8_t max_loop_period) {
+    sequencer_config.tempo      = tempo;
+    sequencer_config.resolution = resolution;
+    sequencer_on();
+
+    uint64_t divisor   = (uint64_t)tempo * get_steps_per_four_beats(resolution);
+    uint64_t now       = 0;
+    uint32_t step      = 0;
+    uint32_t max_error = 0;
+    uint8_t  last_step = sequencer_internal_state.current_step;
+    while (step < steps) {
+        uint8_t period = next_loop_period(max_loop_period);
+        advance_time(period);
+        now += period;
+        sequencer_task();
+
+        if (sequencer_internal_state.current_step != last_step) {
+            last_step = sequencer_internal_state.current_step;
+            step++;
+
+            uint64_t ideal = step * 240000ULL / divisor;
+            EXPECT_GE(now, ideal) << "step " << step << " started early";
+            if (now - ideal > max_error) {
+                max_error = now - ideal;
+            }
+        }
+    }
+    return max_error;
+}
+
+TEST_F(SequencerTest, TestStepsDoNotDriftWithIrregularMainLoop) {
+    const uint8_t                tempos[]      = {60, 97, 120, 133, 174, 255};
+    const sequencer_resolution_t resolutions[] = {SQ_RES_4, SQ_RES_8T, SQ_RES_16, SQ_RES_16T, SQ_RES_32};
+
+    for (uint8_t tempo : tempos) {
+        for (sequencer_resolution_t resolution : resolutions) {
+            // Steps shorter than attacking and releasing every track can't keep up with the grid
+            uint16_t step_duration = get_step_duration(tempo, resolution);
+            uint16_t phases        = 2 * (SEQUENCER_TRACKS - 1) * SEQUENCER_TRACK_THROTTLE + SEQUENCER_PHASE_RELEASE_TIMEOUT;
+            if (step_duration < phases + 7) {
+                continue;
+            }
+
+            uint32_t max_error = run_steps(tempo, resolution, 2000, 7);
+            if (step_duration > phases + (2 * SEQUENCER_TRACKS + 1) * 7) {
+                // Every phase is done before the step ends, what's left is a one-off jitter of up to one loop period
+                EXPECT_LE(max_error, 7) << "tempo " << (int)tempo << " resolution " << resolution;
+            } else {
+                // A step may start late when the previous one took a few more loops, but that doesn't add up
+                EXPECT_LT(max_error, step_duration / 2u) << "tempo " << (int)tempo << " resolution " << resolution;
+            }
+            printf("[ SEQUENCER] tempo %3u resolution %u: max step error %u ms over 2000 steps\n", tempo, resolution, (unsigned)max_error);
+        }
+    }
+}
+
+TEST_F(SequencerTest, TestStallRestartsTheGrid) {
+    sequencer_config.tempo      = 120;
+    sequencer_config.resolution = SQ_RES_16;
+    sequencer_on();
+    sequencer_internal_state.phase = SEQUENCER_PHASE_PAUSE;
+
+    // The main loop was blocked for a few steps
+    advance_time(1000);
+    sequencer_task();
+    EXPECT_EQ(sequencer_internal_state.current_step, 1);
+    EXPECT_EQ(sequencer_internal_state.timer, 1000);
+
+    // The missed steps are skipped instead of being played in a burst
+    sequencer_internal_state.phase = SEQUENCER_PHASE_PAUSE;
+    advance_time(1);
+    sequencer_task();
+    EXPECT_EQ(sequencer_internal_state.current_step, 1);
+}
+
+static uint32_t send_midi_clock(uint32_t ticks, uint8_t tick_period) {
+    uint32_t steps     = 0;
+    uint8_t  last_step = sequencer_internal_state.current_step;
+    for (uint32_t tick = 0; tick < ticks; tick++) {
+        sequencer_midi_clock();
+        for (uint8_t ms = 0; ms < tick_period; ms++) {
+            sequencer_task();
+            if (sequencer_internal_state.current_step != last_step) {
+                last_step = sequencer_internal_state.current_step;
+                steps++;
+            }
+            advance_time(1);
+        }
+    }
+    return steps;
+}
+
+TEST_F(SequencerTest, TestMidiClockDrivesSteps) {
+    sequencer_config.tempo      = 120;
+    sequencer_config.resolution = SQ_RES_16;
+    sequencer_midi_start();
+    EXPECT_TRUE(is_sequencer_on());
+
+    // 6 ticks per 16th, 20ms per tick is a tempo of 125
+    uint32_t steps = send_midi_clock(24 * 16, 20);
+    EXPECT_TRUE(is_sequencer_midi_clock_synced());
+    EXPECT_EQ(steps, 24 * 16 / 6);
+    EXPECT_EQ(sequencer_config.tempo, 125);
+
+    sequencer_config.resolution = SQ_RES_8T;
+    steps                       = send_midi_clock(24 * 4, 20);
+    EXPECT_EQ(steps, 24 * 4 / 8);
+}
+
+TEST_F(SequencerTest, TestMidiClockFollowsTempoChanges) {
+    sequencer_config.tempo      = 120;
+    sequencer_config.resolution = SQ_RES_4;
+    sequencer_midi_start();
+
+    send_midi_clock(24 * 4, 25);
+    EXPECT_EQ(sequencer_config.tempo, 100);
+    send_midi_clock(24 * 4, 10);
+    EXPECT_EQ(sequencer_config.tempo, 250);
+}
+
+TEST_F(SequencerTest, TestMidiStopAndStart) {
+    sequencer_config.resolution = SQ_RES_16;
+    sequencer_midi_start();
+    send_midi_clock(6 * 5, 10);
+    EXPECT_EQ(sequencer_internal_state.current_step, 5);
+
+    sequencer_midi_stop();
+    EXPECT_FALSE(is_sequencer_on());
+    EXPECT_EQ(send_midi_clock(6 * 5, 10), 0);
+
+    sequencer_midi_continue();
+    EXPECT_TRUE(is_sequencer_on());
+    send_midi_clock(6 * 2, 10);
+    EXPECT_EQ(sequencer_internal_state.current_step, 2);
+
+    sequencer_midi_start();
+    EXPECT_EQ(sequencer_internal_state.current_step, 0);
+}
+
+TEST_F(SequencerTest, TestFallsBackToInternalClockWithoutMidiClock) {
+    sequencer_config.resolution = SQ_RES_16;
+    sequencer_midi_start();
+    send_midi_clock(24 + 1, 20);
+    EXPECT_EQ(sequencer_config.tempo, 125);
+    EXPECT_TRUE(is_sequencer_midi_clock_synced());
+
+    advance_time(SEQUENCER_MIDI_CLOCK_TIMEOUT);
+    EXPECT_FALSE(is_sequencer_midi_clock_synced());
+
+    // Picks up the overdue step, then keeps going at the last tempo of the clock
+    uint8_t step = sequencer_internal_state.current_step;
+    sequencer_task();
+    for (uint16_t ms = 0; ms < 3 * 120; ms++) {
+        advance_time(1);
+        sequencer_task();
+    }
+    EXPECT_EQ((uint8_t)(sequencer_internal_state.current_step - step) % SEQUENCER_STEPS, 3);
+}
+
+TEST_F(SequencerTest, TestStoppedMidiClockStaysLostWhenTheTimerWraps) {
+    sequencer_config.tempo      = 120;
+    sequencer_config.resolution = SQ_RES_16;
+    sequencer_midi_start();
+    send_midi_clock(24 + 1, 20);
+    EXPECT_EQ(sequencer_config.tempo, 125);
+
+    // Idle for longer than a wrap of the 16 bit timer, the internal clock keeps a steady 120ms per step
+    uint8_t  last_step  = sequencer_internal_state.current_step;
+    uint16_t since_step = 0;
+    uint16_t max_gap    = 0;
+    for (uint32_t ms = 0; ms < 70000; ms++) {
+        advance_time(1);
+        sequencer_task();
+        if (ms >= SEQUENCER_MIDI_CLOCK_TIMEOUT) {
+            ASSERT_FALSE(is_sequencer_midi_clock_synced()) << "at " << ms << "ms";
+        }
+        since_step++;
+        if (sequencer_internal_state.current_step != last_step) {
+            last_step = sequencer_internal_state.current_step;
+            if (ms > SEQUENCER_MIDI_CLOCK_TIMEOUT) {
+                max_gap = std::max(max_gap, since_step);
+            }
+            since_step = 0;
+        }
+    }
+    EXPECT_EQ(max_gap, 120);
+}
@@ -0,0 +1,15 @@
+split_sim_DEFS := -DSPLIT_KEYBOARD -DNO_DEBUG -DNO_PRINT
+split_sim_INC := $(QUANTUM_PATH)/split_common $(TMK_PATH)/protocol
+split_sim_CONFIG := $(QUANTUM_PATH)/split_common/tests/config_split_sim.h
+
+split_sim_SRC := \
+	platforms/test/timer.c \
+	platforms/synchronization_util.c \
+	$(QUANTUM_PATH)/crc.c \
+	$(QUANTUM_PATH)/sync_timer.c \
+	$(QUANTUM_PATH)/split_common/transactions.c \
+	$(QUANTUM_PATH)/split_common/transport.c \
+	$(QUANTUM_PATH)/split_common/tests/split_sim.c \
+	$(QUANTUM_PATH)/split_common/tests/split_sim_master.c \
+	$(QUANTUM_PATH)/split_common/tests/split_sim_slave.c \
+	$(QUANTUM_PATH)/split_common/tests/split_sim_tests.cpp
@@ -0,0 +1,385 @@
+/* Copyright 2024 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "split_sim.h"
+#include "matrix.h"
+#include "timer.h"
+#include "sync_timer.h"
+#include "serial.h"
+#include "transactions.h"
+#include "transport.h"
+#include "transaction_id_define.h"
+#include "split_util.h"
+#include "usb_util.h"
+#include "bootloader.h"
+
+#define ROWS_PER_HAND (MATRIX_ROWS / 2)
+
+void simulate_async_tick(uint32_t t);
+void set_time(uint32_t t);
+
+extern volatile int32_t sync_timer_ms;
+
+/* The copies of split_util.c linked for each half, see split_sim_half.inc */
+#define SPLIT_SIM_UTIL_DECLARE(half)                                                                  \
+    void half##_power_up(void);                                                                       \
+    void half##_split_pre_init(void);                                                                 \
+    void half##_split_post_init(void);                                                                \
+    bool half##_transport_master_if_connected(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]); \
+    bool half##_is_transport_connected(void);                                                         \
+    void half##_split_watchdog_update(bool done);                                                     \
+    bool half##_split_watchdog_check(void);                                                           \
+    void half##_split_watchdog_task(void);                                                            \
+    bool half##_is_keyboard_master(void);                                                             \
+    bool half##_is_keyboard_left(void);                                                               \
+    bool half##_watchdog_done(void);
+
+SPLIT_SIM_UTIL_DECLARE(split_sim_master)
+SPLIT_SIM_UTIL_DECLARE(split_sim_slave)
+
+typedef struct {
+    void (*power_up)(void);
+    void (*split_pre_init)(void);
+    void (*split_post_init)(void);
+    bool (*transport_master_if_connected)(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+    bool (*is_transport_connected)(void);
+    void (*split_watchdog_update)(bool done);
+    bool (*split_watchdog_check)(void);
+    void (*split_watchdog_task)(void);
+    bool (*is_keyboard_master)(void);
+    bool (*is_keyboard_left)(void);
+    bool (*watchdog_done)(void);
+} split_sim_util_t;
+
+#define SPLIT_SIM_UTIL(half) {half##_power_up, half##_split_pre_init, half##_split_post_init, half##_transport_master_if_connected, half##_is_transport_connected, half##_split_watchdog_update, half##_split_watchdog_check, half##_split_watchdog_task, half##_is_keyboard_master, half##_is_keyboard_left, half##_watchdog_done}
+
+static const split_sim_util_t util[SPLIT_SIM_NODES] = {
+    [SPLIT_SIM_MASTER] = SPLIT_SIM_UTIL(split_sim_master),
+    [SPLIT_SIM_SLAVE]  = SPLIT_SIM_UTIL(split_sim_slave),
+};
+
+/* Everything a real half keeps in its own RAM that transactions.c reaches
+ * through globals. The active half owns the globals, the other half is parked
+ * here until the simulation switches over. */
+typedef struct {
+    split_shared_memory_t shmem;
+    int32_t               sync_timer_ms;
+    uint64_t              boot_ns;
+    bool                  reset_requested;
+    matrix_row_t          matrix[MATRIX_ROWS];
+    matrix_row_t          keys[ROWS_PER_HAND];
+} split_sim_half_t;
+
+static split_sim_half_t  halves[SPLIT_SIM_NODES];
+static split_sim_node_t  active = SPLIT_SIM_MASTER;
+static split_sim_link_t  link;
+static split_sim_stats_t stats;
+static uint64_t          now_ns;
+static uint32_t          rng_state;
+static bool              last_connected;
+
+static uint32_t sim_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool sim_is_booted(split_sim_node_t node) {
+    return now_ns >= halves[node].boot_ns;
+}
+
+static void sim_sync_clock(void) {
+    // Every half counts milliseconds from its own power up
+    set_time(sim_is_booted(active) ? (uint32_t)((now_ns - halves[active].boot_ns) / 1000000) : 0);
+}
+
+static void sim_advance_ns(uint64_t ns) {
+    now_ns += ns;
+    sim_sync_clock();
+}
+
+static void sim_switch_to(split_sim_node_t node) {
+    if (node == active) return;
+
+    memcpy(&halves[active].shmem, split_shmem, sizeof(split_shared_memory_t));
+    halves[active].sync_timer_ms = sync_timer_ms;
+
+    active = node;
+
+    memcpy(split_shmem, &halves[active].shmem, sizeof(split_shared_memory_t));
+    sync_timer_ms = halves[active].sync_timer_ms;
+    sim_sync_clock();
+}
+
+// Powers a half up, it starts running the way keyboard_init() starts it once boot_ns is reached
+static void sim_boot_half(split_sim_node_t node, uint64_t boot_ns) {
+    split_sim_node_t previous = active;
+
+    memset(&halves[node], 0, sizeof(split_sim_half_t));
+    halves[node].boot_ns = boot_ns;
+    util[node].power_up();
+
+    sim_switch_to(node);
+    memset(split_shmem, 0, sizeof(split_shared_memory_t));
+    sync_timer_ms = 0;
+    sim_sync_clock();
+    util[node].split_pre_init();
+    util[node].split_post_init();
+    sim_switch_to(previous);
+}
+
+// Moves bytes across the wire in one direction, the caller's buffer receives what the other side sees
+static void sim_send(void *data, uint16_t length) {
+    uint8_t *bytes = (uint8_t *)data;
+
+    if (link.bit_error_ppm) {
+        for (uint16_t i = 0; i < length; ++i) {
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                if (sim_random() % 1000000 < link.bit_error_ppm) {
+                    bytes[i] ^= (uint8_t)(1 << bit);
+                    stats.bit_errors++;
+                }
+            }
+        }
+    }
+
+    stats.bytes += length;
+    sim_advance_ns((uint64_t)link.latency_us * 1000 + (uint64_t)length * 10 * 1000000000 / link.baud_rate);
+}
+
+static bool sim_fail(uint32_t wait_us) {
+    stats.failed_transactions++;
+    sim_advance_ns((uint64_t)wait_us * 1000);
+    return false;
+}
+
+////////////////////////////////////////////////////
+// Serial driver, follows the classic half-duplex protocol of serial_protocol.c
+
+void soft_serial_initiator_init(void) {}
+
+void soft_serial_target_init(void) {}
+
+bool soft_serial_transaction(int sstd_index) {
+    split_transaction_desc_t *trans = &split_transaction_table[sstd_index];
+    uint8_t                   buffer[sizeof(split_shared_memory_t)];
+    uint8_t                   transaction_id = (uint8_t)sstd_index;
+
+    stats.transactions++;
+
+    sim_send(&transaction_id, sizeof(transaction_id));
+    if (!sim_is_booted(SPLIT_SIM_SLAVE) || transaction_id >= NUM_TOTAL_TRANSACTIONS) {
+        // Nobody answers the handshake
+        return sim_fail(link.timeout_us);
+    }
+
+    // The slave answers whatever id it understood, the master catches the mismatch
+    uint8_t transaction_id_shake = transaction_id ^ NUM_TOTAL_TRANSACTIONS;
+    sim_send(&transaction_id_shake, sizeof(transaction_id_shake));
+    if (transaction_id_shake != (sstd_index ^ NUM_TOTAL_TRANSACTIONS)) {
+        return sim_fail(0);
+    }
+
+    if (trans->initiator2target_buffer_size) {
+        memcpy(buffer, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+        sim_send(buffer, trans->initiator2target_buffer_size);
+    }
+
+    sim_switch_to(SPLIT_SIM_SLAVE);
+    if (trans->initiator2target_buffer_size) {
+        memcpy(split_trans_initiator2target_buffer(trans), buffer, trans->initiator2target_buffer_size);
+    }
+    if (trans->slave_callback) {
+        trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+    }
+    if (trans->target2initiator_buffer_size) {
+        memcpy(buffer, split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size);
+    }
+    sim_switch_to(SPLIT_SIM_MASTER);
+
+    if (trans->target2initiator_buffer_size) {
+        sim_send(buffer, trans->target2initiator_buffer_size);
+        memcpy(split_trans_target2initiator_buffer(trans), buffer, trans->target2initiator_buffer_size);
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////
+// Hardware of each half: only the master is powered over USB
+
+bool usb_vbus_state(void) {
+    return active == SPLIT_SIM_MASTER;
+}
+
+bool usb_connected_state(void) {
+    return active == SPLIT_SIM_MASTER;
+}
+
+void usb_disconnect(void) {}
+
+void mcu_reset(void) {
+    // Takes effect once the running task returns
+    halves[active].reset_requested = true;
+}
+
+////////////////////////////////////////////////////
+// The shared code calls split_util.c of the half that is running
+
+bool is_keyboard_master(void) {
+    return util[active].is_keyboard_master();
+}
+
+bool is_keyboard_left(void) {
+    return util[active].is_keyboard_left();
+}
+
+bool is_transport_connected(void) {
+    return util[active].is_transport_connected();
+}
+
+void split_watchdog_update(bool done) {
+    util[active].split_watchdog_update(done);
+}
+
+bool split_watchdog_check(void) {
+    return util[active].split_watchdog_check();
+}
+
+////////////////////////////////////////////////////
+// Scan loops, follow keyboard_task() and matrix_post_scan()
+
+static void sim_slave_scan(void) {
+    sim_switch_to(SPLIT_SIM_SLAVE);
+    sim_advance_ns((uint64_t)link.scan_time_us * 1000);
+    if (!sim_is_booted(SPLIT_SIM_SLAVE)) return;
+
+    split_sim_half_t *half = &halves[SPLIT_SIM_SLAVE];
+    memcpy(half->matrix + ROWS_PER_HAND, half->keys, sizeof(half->keys));
+    transport_slave(half->matrix, half->matrix + ROWS_PER_HAND);
+
+#ifdef SPLIT_WATCHDOG_ENABLE
+    util[SPLIT_SIM_SLAVE].split_watchdog_task();
+#endif // SPLIT_WATCHDOG_ENABLE
+    if (half->reset_requested) {
+        stats.slave_resets++;
+        sim_boot_half(SPLIT_SIM_SLAVE, now_ns);
+    }
+}
+
+static void sim_master_scan(void) {
+    sim_switch_to(SPLIT_SIM_MASTER);
+    sim_advance_ns((uint64_t)link.scan_time_us * 1000);
+
+    split_sim_half_t *half                        = &halves[SPLIT_SIM_MASTER];
+    matrix_row_t      slave_matrix[ROWS_PER_HAND] = {0};
+    bool              changed                     = false;
+    uint32_t          failed_transactions         = stats.failed_transactions;
+    if (util[SPLIT_SIM_MASTER].transport_master_if_connected(half->matrix, slave_matrix)) {
+        changed        = memcmp(half->matrix + ROWS_PER_HAND, slave_matrix, sizeof(slave_matrix)) != 0;
+        last_connected = true;
+    } else if (last_connected) {
+        memset(slave_matrix, 0, sizeof(slave_matrix));
+        changed        = true;
+        last_connected = false;
+    }
+    if (stats.failed_transactions != failed_transactions) {
+        stats.failed_scans++;
+    }
+
+    if (changed) memcpy(half->matrix + ROWS_PER_HAND, slave_matrix, sizeof(slave_matrix));
+}
+
+////////////////////////////////////////////////////
+// Public API
+
+void split_sim_init(const split_sim_link_t *new_link, uint32_t slave_boot_delay_ms) {
+    link                   = *new_link;
+    now_ns                 = 0;
+    rng_state      = 0x2545F491;
+    last_connected = false;
+    memset(&stats, 0, sizeof(stats));
+
+    simulate_async_tick(0);
+    active = SPLIT_SIM_MASTER;
+    sim_boot_half(SPLIT_SIM_MASTER, 0);
+    sim_boot_half(SPLIT_SIM_SLAVE, (uint64_t)slave_boot_delay_ms * 1000000);
+}
+
+void split_sim_set_link(const split_sim_link_t *new_link) {
+    link = *new_link;
+}
+
+void split_sim_scan(void) {
+    sim_slave_scan();
+    sim_master_scan();
+    stats.scans++;
+}
+
+void split_sim_set_slave_key(uint8_t row, uint8_t col, bool pressed) {
+    if (pressed) {
+        halves[SPLIT_SIM_SLAVE].keys[row] |= (matrix_row_t)1 << col;
+    } else {
+        halves[SPLIT_SIM_SLAVE].keys[row] &= ~((matrix_row_t)1 << col);
+    }
+}
+
+bool split_sim_master_sees_slave_key(uint8_t row, uint8_t col) {
+    return (halves[SPLIT_SIM_MASTER].matrix[ROWS_PER_HAND + row] >> col) & 1;
+}
+
+uint32_t split_sim_slave_key_latency_us(uint8_t row, uint8_t col, bool pressed, uint32_t max_scans) {
+    uint64_t start = now_ns;
+    split_sim_set_slave_key(row, col, pressed);
+    for (uint32_t i = 0; i < max_scans; ++i) {
+        split_sim_scan();
+        if (split_sim_master_sees_slave_key(row, col) == pressed) {
+            return (uint32_t)((now_ns - start) / 1000);
+        }
+    }
+    return UINT32_MAX;
+}
+
+uint32_t split_sim_time_us(void) {
+    return (uint32_t)(now_ns / 1000);
+}
+
+uint32_t split_sim_sync_timer_read32(split_sim_node_t node) {
+    split_sim_node_t previous = active;
+    sim_switch_to(node);
+    uint32_t time = sync_timer_read32();
+    sim_switch_to(previous);
+    return time;
+}
+
+bool split_sim_watchdog_done(split_sim_node_t node) {
+    return util[node].watchdog_done();
+}
+
+bool split_sim_connected(void) {
+    return util[SPLIT_SIM_MASTER].is_transport_connected();
+}
+
+const split_sim_stats_t *split_sim_get_stats(void) {
+    return &stats;
+}
+
+void split_sim_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,76 @@
+/* Copyright 2024 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Runs a master and a slave half in one process. Both halves execute the real
+ * transactions.c, transport.c and their own copy of split_util.c, only the
+ * serial driver and USB detection below them are replaced by emulated ones. The halves take turns: every
+ * simulated scan is one slave scan followed by one master scan. */
+
+typedef enum {
+    SPLIT_SIM_MASTER,
+    SPLIT_SIM_SLAVE,
+    SPLIT_SIM_NODES,
+} split_sim_node_t;
+
+typedef struct {
+    uint32_t baud_rate;     // bits per second, every byte takes 10 bits on the wire (8N1)
+    uint32_t latency_us;    // added every time the direction of the wire changes
+    uint32_t bit_error_ppm; // flipped bits per million transferred bits
+    uint32_t timeout_us;    // how long the master waits for a handshake that never comes
+    uint32_t scan_time_us;  // time each half spends on its own matrix scan
+} split_sim_link_t;
+
+typedef struct {
+    uint32_t scans;
+    uint32_t transactions;
+    uint32_t failed_transactions;
+    uint32_t failed_scans;
+    uint32_t bytes;
+    uint32_t bit_errors;
+    uint32_t slave_resets;
+} split_sim_stats_t;
+
+void split_sim_init(const split_sim_link_t *link, uint32_t slave_boot_delay_ms);
+// Changes the link without restarting either half
+void split_sim_set_link(const split_sim_link_t *link);
+void split_sim_scan(void);
+
+void split_sim_set_slave_key(uint8_t row, uint8_t col, bool pressed);
+bool split_sim_master_sees_slave_key(uint8_t row, uint8_t col);
+// Scans until the master reports the slave key in the given state, returns the
+// elapsed simulated time or UINT32_MAX if that did not happen within max_scans.
+uint32_t split_sim_slave_key_latency_us(uint8_t row, uint8_t col, bool pressed, uint32_t max_scans);
+
+uint32_t split_sim_time_us(void);
+uint32_t split_sim_sync_timer_read32(split_sim_node_t node);
+bool     split_sim_watchdog_done(split_sim_node_t node);
+bool     split_sim_connected(void);
+
+const split_sim_stats_t *split_sim_get_stats(void);
+void                     split_sim_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
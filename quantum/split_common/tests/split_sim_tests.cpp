@@ -0,0 +1,192 @@
+/* Copyright 2024 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <stdio.h>
+
+extern "C" {
+#include "split_sim.h"
+}
+
+static split_sim_link_t make_link(uint32_t baud_rate, uint32_t bit_error_ppm) {
+    split_sim_link_t link = {};
+    link.baud_rate        = baud_rate;
+    link.latency_us       = 5;
+    link.bit_error_ppm    = bit_error_ppm;
+    link.timeout_us       = 20000;
+    link.scan_time_us     = 1000;
+    return link;
+}
+
+static void settle(uint32_t scans) {
+    for (uint32_t i = 0; i < scans; ++i) {
+        split_sim_scan();
+    }
+}
+
+class SplitSim : public ::testing::Test {};
+
+TEST_F(SplitSim, SlaveKeyReachesMaster) {
+    split_sim_link_t link = make_link(921600, 0);
+    split_sim_init(&link, 0);
+    settle(10);
+
+    uint32_t press = split_sim_slave_key_latency_us(1, 2, true, 10);
+    EXPECT_LE(press, 2 * link.scan_time_us + 200);
+    EXPECT_TRUE(split_sim_master_sees_slave_key(1, 2));
+    EXPECT_FALSE(split_sim_master_sees_slave_key(1, 3));
+
+    uint32_t release = split_sim_slave_key_latency_us(1, 2, false, 10);
+    EXPECT_LE(release, 2 * link.scan_time_us + 200);
+}
+
+TEST_F(SplitSim, SlowerLinkAddsLatency) {
+    split_sim_link_t fast = make_link(921600, 0);
+    split_sim_init(&fast, 0);
+    settle(10);
+    uint32_t fast_latency = split_sim_slave_key_latency_us(0, 0, true, 10);
+
+    split_sim_link_t slow = make_link(9600, 0);
+    split_sim_init(&slow, 0);
+    settle(10);
+    uint32_t slow_latency = split_sim_slave_key_latency_us(0, 0, true, 10);
+
+    EXPECT_LT(fast_latency, slow_latency);
+    EXPECT_NE(slow_latency, UINT32_MAX);
+}
+
+TEST_F(SplitSim, IdleLinkOnlyPollsChecksums) {
+    split_sim_link_t link = make_link(921600, 0);
+    split_sim_init(&link, 0);
+    settle(500);
+    split_sim_reset_stats();
+    settle(1000);
+
+    const split_sim_stats_t *stats = split_sim_get_stats();
+    // A 3 byte checksum poll per scan, plus the forced resyncs every FORCED_SYNC_THROTTLE_MS
+    EXPECT_GE(stats->bytes, 3 * stats->scans);
+    EXPECT_LT(stats->bytes, 4 * stats->scans);
+    EXPECT_EQ(stats->failed_transactions, 0);
+}
+
+TEST_F(SplitSim, SyncTimerFollowsMaster) {
+    split_sim_link_t link = make_link(921600, 0);
+    split_sim_init(&link, 250);
+    settle(500);
+
+    uint32_t master = split_sim_sync_timer_read32(SPLIT_SIM_MASTER);
+    uint32_t slave  = split_sim_sync_timer_read32(SPLIT_SIM_SLAVE);
+    EXPECT_LE(master > slave ? master - slave : slave - master, 3);
+}
+
+TEST_F(SplitSim, LateSlaveIsPickedUp) {
+    split_sim_link_t link = make_link(921600, 0);
+    split_sim_init(&link, 5000);
+    settle(20);
+    EXPECT_FALSE(split_sim_connected());
+    EXPECT_GT(split_sim_get_stats()->failed_transactions, 0);
+
+    settle(5000);
+    EXPECT_TRUE(split_sim_connected());
+    EXPECT_TRUE(split_sim_watchdog_done(SPLIT_SIM_MASTER));
+    EXPECT_TRUE(split_sim_watchdog_done(SPLIT_SIM_SLAVE));
+    EXPECT_EQ(split_sim_get_stats()->slave_resets, 0);
+    EXPECT_NE(split_sim_slave_key_latency_us(3, 5, true, 10), UINT32_MAX);
+}
+
+TEST_F(SplitSim, UnreachableSlaveIsResetByItsWatchdog) {
+    split_sim_link_t link = make_link(921600, 1000000);
+    split_sim_init(&link, 0);
+    settle(3000);
+
+    EXPECT_FALSE(split_sim_connected());
+    EXPECT_FALSE(split_sim_watchdog_done(SPLIT_SIM_SLAVE));
+    EXPECT_GT(split_sim_get_stats()->slave_resets, 0);
+}
+
+TEST_F(SplitSim, LostLinkKeepsSlaveRunning) {
+    split_sim_link_t link = make_link(921600, 0);
+    split_sim_init(&link, 0);
+    settle(50);
+    ASSERT_TRUE(split_sim_watchdog_done(SPLIT_SIM_SLAVE));
+
+    // Only the master notices the broken link, the slave was pinged once and keeps running
+    split_sim_link_t broken = make_link(921600, 1000000);
+    split_sim_set_link(&broken);
+    settle(5000);
+    EXPECT_FALSE(split_sim_connected());
+    EXPECT_TRUE(split_sim_watchdog_done(SPLIT_SIM_SLAVE));
+    EXPECT_EQ(split_sim_get_stats()->slave_resets, 0);
+
+    split_sim_set_link(&link);
+    settle(1000);
+    EXPECT_TRUE(split_sim_connected());
+    EXPECT_TRUE(split_sim_watchdog_done(SPLIT_SIM_MASTER));
+    EXPECT_NE(split_sim_slave_key_latency_us(1, 1, true, 10), UINT32_MAX);
+}
+
+TEST_F(SplitSim, BitErrorsNeverReachTheMatrix) {
+    split_sim_link_t link = make_link(921600, 2000);
+    split_sim_init(&link, 0);
+    settle(50);
+
+    bool pressed = false;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        if (i % 20 == 0) {
+            pressed = !pressed;
+            split_sim_set_slave_key(0, 0, pressed);
+        }
+        split_sim_scan();
+        for (uint8_t row = 0; row < 4; ++row) {
+            for (uint8_t col = 0; col < 6; ++col) {
+                if (row == 0 && col == 0) continue;
+                ASSERT_FALSE(split_sim_master_sees_slave_key(row, col)) << "phantom key at scan " << i;
+            }
+        }
+    }
+
+    const split_sim_stats_t *stats = split_sim_get_stats();
+    EXPECT_GT(stats->bit_errors, 0);
+    EXPECT_GT(stats->failed_transactions, 0);
+    EXPECT_TRUE(split_sim_connected());
+    EXPECT_NE(split_sim_slave_key_latency_us(0, 0, !pressed, 20), UINT32_MAX);
+}
+
+TEST_F(SplitSim, Report) {
+    const uint32_t baud_rates[] = {9600, 38400, 115200, 460800, 921600};
+    const uint32_t error_rates[] = {0, 1000};
+
+    for (uint32_t bit_error_ppm : error_rates) {
+        for (uint32_t baud_rate : baud_rates) {
+            split_sim_link_t link = make_link(baud_rate, bit_error_ppm);
+            split_sim_init(&link, 0);
+            settle(200);
+            split_sim_reset_stats();
+
+            uint32_t worst = 0;
+            uint32_t total = 0;
+            for (uint32_t i = 0; i < 50; ++i) {
+                uint32_t latency = split_sim_slave_key_latency_us(2, 1, (i & 1) == 0, 100);
+                ASSERT_NE(latency, UINT32_MAX);
+                worst = latency > worst ? latency : worst;
+                total += latency;
+            }
+
+            const split_sim_stats_t *stats = split_sim_get_stats();
+            printf("[ SPLITSIM ] %7u baud %5u ppm: latency avg %6u us max %6u us, %3u.%02u bytes/scan, %u/%u failed\n", (unsigned)baud_rate, (unsigned)bit_error_ppm, (unsigned)(total / 50), (unsigned)worst, (unsigned)(stats->bytes / stats->scans), (unsigned)(stats->bytes * 100 / stats->scans % 100), (unsigned)stats->failed_transactions, (unsigned)stats->transactions);
+        }
+    }
+}
@@ -101,6 +101,9 @@ enum serial_transaction_id {
     PUT_RPC_INFO,
     PUT_RPC_REQ_DATA,
     EXECUTE_RPC,
+#    if defined(SPLIT_RPC_ASYNC_ENABLE)
+    EXECUTE_RPC_FRAGMENT,
+#    endif // defined(SPLIT_RPC_ASYNC_ENABLE)
     GET_RPC_RESP_DATA,
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
@@ -30,6 +30,7 @@
 #include "transaction_id_define.h"
 #include "split_util.h"
 #include "synchronization_util.h"
+#include "util.h"
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -81,6 +82,9 @@
     { 0, 0, sizeof_member(split_shared_memory_t, member), offsetof(split_shared_memory_t, member), cb }
 #define trans_target2initiator_initializer(member) trans_target2initiator_initializer_cb(member, NULL)
 
+#define trans_bidirectional_initializer_cb(initiator2target_member, target2initiator_member, cb) \
+    { sizeof_member(split_shared_memory_t, initiator2target_member), offsetof(split_shared_memory_t, initiator2target_member), sizeof_member(split_shared_memory_t, target2initiator_member), offsetof(split_shared_memory_t, target2initiator_member), cb }
+
 #define trans_initiator2target_cb(cb) \
     { 0, 0, 0, 0, cb }
 
@@ -92,6 +96,9 @@
 // Forward-declare the RPC callback handlers
 void slave_rpc_info_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 void slave_rpc_exec_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+#    if defined(SPLIT_RPC_ASYNC_ENABLE)
+void slave_rpc_fragment_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
+#    endif // defined(SPLIT_RPC_ASYNC_ENABLE)
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
 ////////////////////////////////////////////////////
@@ -194,8 +201,16 @@ static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_ro
 }
 
 static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static const int8_t push_ids[] = {GET_SLAVE_MATRIX_DATA, GET_SLAVE_MATRIX_CHECKSUM};
+    static uint32_t     last_push  = 0;
+    bool                changed    = memcmp(split_shmem->smatrix.matrix, slave_matrix, sizeof(split_shmem->smatrix.matrix)) != 0;
     memcpy(split_shmem->smatrix.matrix, slave_matrix, sizeof(split_shmem->smatrix.matrix));
     split_shmem->smatrix.checksum = crc8(split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+    // Push again every now and then, so the master recovers from a lost push
+    if (changed || timer_elapsed32(last_push) >= FORCED_SYNC_THROTTLE_MS) {
+        last_push = timer_read32();
+        transport_slave_push(push_ids, ARRAY_SIZE(push_ids));
+    }
 }
 
 // clang-format off
@@ -241,37 +256,61 @@ static void master_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_ro
 static bool encoder_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t  last_update   = 0;
     static uint8_t   last_checksum = 0;
+    static uint8_t   consumed      = 0;
     encoder_events_t temp_events;
 
     bool okay = read_if_checksum_mismatch(GET_ENCODERS_CHECKSUM, GET_ENCODERS_DATA, &last_update, &temp_events, &split_shmem->encoders.events, sizeof(temp_events));
     if (okay) {
         if (last_checksum != split_shmem->encoders.checksum) {
-            bool    actioned = false;
             uint8_t index;
             bool    clockwise;
-            while (okay && encoder_dequeue_event_advanced(&split_shmem->encoders.events, &index, &clockwise)) {
-                okay &= encoder_queue_event(index, clockwise);
-                actioned = true;
+            uint8_t count;
+
+            // Skip events already taken that the slave hasn't drained yet, unless it has restarted in the meantime
+            if ((uint8_t)(consumed - temp_events.dequeued) > MAX_QUEUED_ENCODER_EVENTS) {
+                consumed = temp_events.dequeued;
+            }
+            while (temp_events.dequeued != consumed && encoder_dequeue_steps_advanced(&temp_events, &index, &clockwise, &count)) {
             }
 
-            if (actioned) {
-                okay &= transport_exec(CMD_ENCODER_DRAIN);
+            while (!encoder_queue_full() && encoder_dequeue_steps_advanced(&temp_events, &index, &clockwise, &count)) {
+                encoder_queue_steps(index, clockwise, count);
+            }
+
+            if (temp_events.dequeued != consumed) {
+                // Only discard what was taken, so events the slave queued after the read survive
+                consumed = temp_events.dequeued;
+                okay &= transport_write(CMD_ENCODER_DRAIN, &consumed, sizeof(consumed));
+            }
+
+            // Anything left over is retried once there's space in the queue
+            if (encoder_queue_empty_advanced(&temp_events)) {
+                last_checksum = split_shmem->encoders.checksum;
             }
-            last_checksum = split_shmem->encoders.checksum;
         }
     }
     return okay;
 }
 
 static void encoder_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static const int8_t push_ids[] = {GET_ENCODERS_DATA, GET_ENCODERS_CHECKSUM};
+    static uint32_t     last_push  = 0;
     // Always prepare the encoder state for read.
     encoder_retrieve_events(&split_shmem->encoders.events);
     // Now update the checksum given that the encoders has been written to
-    split_shmem->encoders.checksum = crc8(&split_shmem->encoders.events, sizeof(split_shmem->encoders.events));
+    uint8_t checksum = crc8(&split_shmem->encoders.events, sizeof(split_shmem->encoders.events));
+    bool    changed  = checksum != split_shmem->encoders.checksum;
+
+    split_shmem->encoders.checksum = checksum;
+    // Push again every now and then, so the master recovers from a lost push
+    if (changed || timer_elapsed32(last_push) >= FORCED_SYNC_THROTTLE_MS) {
+        last_push = timer_read32();
+        transport_slave_push(push_ids, ARRAY_SIZE(push_ids));
+    }
 }
 
 static void encoder_handlers_slave_drain(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
-    encoder_signal_queue_drain();
+    encoder_signal_queue_drain_to(*(const uint8_t *)initiator2target_buffer);
 }
 
 // clang-format off
@@ -280,7 +319,7 @@ static void encoder_handlers_slave_drain(uint8_t initiator2target_buffer_size, c
 #    define TRANSACTIONS_ENCODERS_REGISTRATIONS \
     [GET_ENCODERS_CHECKSUM] = trans_target2initiator_initializer(encoders.checksum), \
     [GET_ENCODERS_DATA]     = trans_target2initiator_initializer(encoders.events), \
-    [CMD_ENCODER_DRAIN]     = trans_initiator2target_cb(encoder_handlers_slave_drain),
+    [CMD_ENCODER_DRAIN]     = trans_initiator2target_initializer_cb(encoders.drain_to, encoder_handlers_slave_drain),
 // clang-format on
 
 #else // ENCODER_ENABLE
@@ -914,6 +953,122 @@ static void detected_os_handlers_slave(matrix_row_t master_matrix[], matrix_row_
 
 #endif // defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
 
+////////////////////////////////////////////////////
+// Asynchronous RPC
+
+#if defined(SPLIT_RPC_ASYNC_ENABLE) && (defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER))
+
+#    ifndef SPLIT_RPC_ASYNC_QUEUE_SIZE
+#        define SPLIT_RPC_ASYNC_QUEUE_SIZE 4
+#    endif // SPLIT_RPC_ASYNC_QUEUE_SIZE
+
+#    ifndef SPLIT_RPC_ASYNC_FRAGMENTS_PER_SCAN
+#        define SPLIT_RPC_ASYNC_FRAGMENTS_PER_SCAN 1
+#    endif // SPLIT_RPC_ASYNC_FRAGMENTS_PER_SCAN
+
+typedef struct split_rpc_request_t {
+    int8_t                           transaction_id;
+    uint8_t                          request_id;
+    bool                             started;
+    uint16_t                         m2s_size;
+    uint16_t                         m2s_offset;
+    const uint8_t                   *m2s;
+    uint16_t                         s2m_size;
+    uint16_t                         s2m_offset;
+    uint8_t                         *s2m;
+    transaction_rpc_async_complete_t callback;
+} split_rpc_request_t;
+
+static split_rpc_request_t        rpc_requests[SPLIT_RPC_ASYNC_QUEUE_SIZE];
+static uint8_t                    rpc_requests_head   = 0;
+static uint8_t                    rpc_requests_tail   = 0;
+static uint8_t                    rpc_last_request_id = 0;
+static split_rpc_async_stats_t    rpc_async_stats;
+static slave_rpc_async_callback_t rpc_async_callbacks[NUM_TOTAL_TRANSACTIONS];
+
+static void rpc_async_complete(bool success) {
+    split_rpc_request_t *request = &rpc_requests[rpc_requests_tail];
+    rpc_requests_tail            = (rpc_requests_tail + 1) % SPLIT_RPC_ASYNC_QUEUE_SIZE;
+    if (success) {
+        rpc_async_stats.completed++;
+    } else {
+        rpc_async_stats.failed++;
+    }
+    if (request->callback) {
+        request->callback(request->transaction_id, request->request_id, success);
+    }
+}
+
+static bool rpc_async_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    bool okay = true;
+    for (uint8_t i = 0; okay && i < SPLIT_RPC_ASYNC_FRAGMENTS_PER_SCAN && rpc_requests_tail != rpc_requests_head; i++) {
+        split_rpc_request_t *request = &rpc_requests[rpc_requests_tail];
+
+        // Requests can't make progress without the slave, so give up on them rather than blocking the queue
+        if (!is_transport_connected()) {
+            rpc_async_complete(false);
+            continue;
+        }
+
+        // Request data goes first, at least one fragment is always sent so the slave sees the request
+        rpc_fragment_sync_t fragment = {.payload = {.transaction_id = request->transaction_id, .request_id = request->request_id}};
+        if (request->m2s_offset < request->m2s_size || !request->started) {
+            fragment.payload.response   = false;
+            fragment.payload.offset     = request->m2s_offset;
+            fragment.payload.total_size = request->m2s_size;
+            fragment.payload.length     = MIN(request->m2s_size - request->m2s_offset, RPC_M2S_BUFFER_SIZE);
+            memcpy(fragment.data, &request->m2s[request->m2s_offset], fragment.payload.length);
+        } else {
+            fragment.payload.response   = true;
+            fragment.payload.offset     = request->s2m_offset;
+            fragment.payload.total_size = request->s2m_size;
+            fragment.payload.length     = MIN(request->s2m_size - request->s2m_offset, RPC_S2M_BUFFER_SIZE);
+        }
+        fragment.checksum = crc8(&fragment.payload, sizeof(fragment.payload));
+
+        rpc_fragment_result_sync_t result;
+        okay = transport_execute_transaction(EXECUTE_RPC_FRAGMENT, &fragment, sizeof(fragment), &result, sizeof(result));
+        if (!okay) {
+            // Leave the request in place, the fragment is sent again on the next attempt
+            break;
+        }
+        rpc_async_stats.fragments++;
+
+        if (result.request_id != request->request_id || !result.handled) {
+            rpc_async_complete(false);
+            continue;
+        }
+
+        request->started = true;
+        if (fragment.payload.response) {
+            memcpy(&request->s2m[request->s2m_offset], result.data, fragment.payload.length);
+            request->s2m_offset += fragment.payload.length;
+            rpc_async_stats.bytes_received += fragment.payload.length;
+        } else {
+            request->m2s_offset += fragment.payload.length;
+            rpc_async_stats.bytes_sent += fragment.payload.length;
+        }
+
+        if (request->m2s_offset == request->m2s_size && request->s2m_offset == request->s2m_size) {
+            rpc_async_complete(true);
+        }
+    }
+    return okay;
+}
+
+// clang-format off
+#    define TRANSACTIONS_RPC_ASYNC_MASTER() TRANSACTION_HANDLER_MASTER(rpc_async)
+#    define TRANSACTIONS_RPC_ASYNC_REGISTRATIONS \
+    [EXECUTE_RPC_FRAGMENT] = trans_bidirectional_initializer_cb(rpc_fragment, rpc_fragment_result, slave_rpc_fragment_callback),
+// clang-format on
+
+#else // defined(SPLIT_RPC_ASYNC_ENABLE) && (defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER))
+
+#    define TRANSACTIONS_RPC_ASYNC_MASTER()
+#    define TRANSACTIONS_RPC_ASYNC_REGISTRATIONS
+
+#endif // defined(SPLIT_RPC_ASYNC_ENABLE) && (defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER))
+
 ////////////////////////////////////////////////////
 
 split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
@@ -944,6 +1099,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_HAPTIC_REGISTRATIONS
     TRANSACTIONS_ACTIVITY_REGISTRATIONS
     TRANSACTIONS_DETECTED_OS_REGISTRATIONS
+    TRANSACTIONS_RPC_ASYNC_REGISTRATIONS
 // clang-format on
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -974,6 +1130,7 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_HAPTIC_MASTER();
     TRANSACTIONS_ACTIVITY_MASTER();
     TRANSACTIONS_DETECTED_OS_MASTER();
+    TRANSACTIONS_RPC_ASYNC_MASTER();
     return true;
 }
 
@@ -1076,4 +1233,84 @@ void slave_rpc_exec_callback(uint8_t initiator2target_buffer_size, const void *i
     }
 }
 
+#    if defined(SPLIT_RPC_ASYNC_ENABLE)
+void transaction_register_rpc_async(int8_t transaction_id, slave_rpc_async_callback_t callback) {
+    // Prevent invoking RPC on QMK core sync data
+    if (transaction_id <= GET_RPC_RESP_DATA || transaction_id >= NUM_TOTAL_TRANSACTIONS) return;
+
+    rpc_async_callbacks[transaction_id] = callback;
+}
+
+uint8_t transaction_rpc_exec_async(int8_t transaction_id, uint16_t initiator2target_buffer_size, const void *initiator2target_buffer, uint16_t target2initiator_buffer_size, void *target2initiator_buffer, transaction_rpc_async_complete_t callback) {
+    // Prevent transaction attempts while transport is disconnected
+    if (!is_transport_connected()) {
+        return 0;
+    }
+    // Prevent invoking RPC on QMK core sync data
+    if (transaction_id <= GET_RPC_RESP_DATA || transaction_id >= NUM_TOTAL_TRANSACTIONS) return 0;
+    // Drop out if we're full
+    if (rpc_requests_tail == (rpc_requests_head + 1) % SPLIT_RPC_ASYNC_QUEUE_SIZE) return 0;
+
+    // Request ids wrap around, skipping 0 which signals failure
+    if (++rpc_last_request_id == 0) {
+        rpc_last_request_id = 1;
+    }
+
+    split_rpc_request_t *request = &rpc_requests[rpc_requests_head];
+    *request                     = (split_rpc_request_t){
+        .transaction_id = transaction_id,
+        .request_id     = rpc_last_request_id,
+        .m2s_size       = initiator2target_buffer_size,
+        .m2s            = initiator2target_buffer,
+        .s2m_size       = target2initiator_buffer_size,
+        .s2m            = target2initiator_buffer,
+        .callback       = callback,
+    };
+    rpc_requests_head = (rpc_requests_head + 1) % SPLIT_RPC_ASYNC_QUEUE_SIZE;
+
+    return request->request_id;
+}
+
+bool transaction_rpc_async_pending(void) {
+    return rpc_requests_tail != rpc_requests_head;
+}
+
+void transaction_rpc_async_get_stats(split_rpc_async_stats_t *stats) {
+    memcpy(stats, &rpc_async_stats, sizeof(rpc_async_stats));
+}
+
+void slave_rpc_fragment_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    const rpc_fragment_sync_t  *fragment = &split_shmem->rpc_fragment;
+    rpc_fragment_result_sync_t *result   = &split_shmem->rpc_fragment_result;
+
+    result->request_id = fragment->payload.request_id;
+    result->handled    = false;
+
+    // As a safety precaution we check that the received header matches its checksum first.
+    if (crc8(&fragment->payload, sizeof(fragment->payload)) != fragment->checksum) {
+        return;
+    }
+
+    int8_t transaction_id = fragment->payload.transaction_id;
+    if (transaction_id < 0 || transaction_id >= NUM_TOTAL_TRANSACTIONS || !rpc_async_callbacks[transaction_id]) {
+        return;
+    }
+
+    // Reject lengths the buffers can't hold
+    if (fragment->payload.length > (fragment->payload.response ? RPC_S2M_BUFFER_SIZE : RPC_M2S_BUFFER_SIZE)) {
+        return;
+    }
+
+    split_rpc_fragment_t info = {
+        .request_id = fragment->payload.request_id,
+        .response   = fragment->payload.response,
+        .length     = fragment->payload.length,
+        .offset     = fragment->payload.offset,
+        .total_size = fragment->payload.total_size,
+    };
+    rpc_async_callbacks[transaction_id](&info, fragment->data, result->data);
+    result->handled = true;
+}
+#    endif // defined(SPLIT_RPC_ASYNC_ENABLE)
+
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -51,3 +51,33 @@ bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer
 
 #define transaction_rpc_send(transaction_id, initiator2target_buffer_size, initiator2target_buffer) transaction_rpc_exec(transaction_id, initiator2target_buffer_size, initiator2target_buffer, 0, NULL)
 #define transaction_rpc_recv(transaction_id, target2initiator_buffer_size, target2initiator_buffer) transaction_rpc_exec(transaction_id, 0, NULL, target2initiator_buffer_size, target2initiator_buffer)
+
+#if defined(SPLIT_RPC_ASYNC_ENABLE)
+// Asynchronous RPC, payloads of any size are split into fragments that are exchanged alongside the regular split sync.
+typedef struct split_rpc_fragment_t {
+    uint8_t  request_id;
+    bool     response;   // false: `request` holds the request bytes, true: `response` has to be filled in
+    uint8_t  length;     // number of bytes in this fragment
+    uint16_t offset;     // position of this fragment within the whole request/response
+    uint16_t total_size; // size of the whole request/response
+} split_rpc_fragment_t;
+
+typedef void (*slave_rpc_async_callback_t)(const split_rpc_fragment_t *fragment, const void *request, void *response);
+typedef void (*transaction_rpc_async_complete_t)(int8_t transaction_id, uint8_t request_id, bool success);
+
+typedef struct split_rpc_async_stats_t {
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
+    uint32_t fragments;
+    uint16_t completed;
+    uint16_t failed;
+} split_rpc_async_stats_t;
+
+void transaction_register_rpc_async(int8_t transaction_id, slave_rpc_async_callback_t callback);
+
+// Returns the request id passed to the completion callback, or 0 if the request could not be queued.
+// Both buffers have to stay valid until the completion callback has been invoked.
+uint8_t transaction_rpc_exec_async(int8_t transaction_id, uint16_t initiator2target_buffer_size, const void *initiator2target_buffer, uint16_t target2initiator_buffer_size, void *target2initiator_buffer, transaction_rpc_async_complete_t callback);
+bool    transaction_rpc_async_pending(void);
+void    transaction_rpc_async_get_stats(split_rpc_async_stats_t *stats);
+#endif // defined(SPLIT_RPC_ASYNC_ENABLE)
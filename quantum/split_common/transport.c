@@ -86,6 +86,8 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
     return true;
 }
 
+void transport_slave_push(const int8_t *ids, uint8_t count) {}
+
 #else // USE_I2C
 
 #    include "serial.h"
@@ -119,9 +121,18 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
     return true;
 }
 
+void transport_slave_push(const int8_t *ids, uint8_t count) {
+#    ifdef SERIAL_USART_STREAMING
+    soft_serial_target_push(ids, count);
+#    endif // SERIAL_USART_STREAMING
+}
+
 #endif // USE_I2C
 
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#if !defined(USE_I2C) && defined(SERIAL_USART_STREAMING)
+    soft_serial_initiator_apply_pushes();
+#endif
     return transactions_master(master_matrix, slave_matrix);
 }
 
@@ -40,6 +40,9 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 
 bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length);
 
+// Offer the slave's current data for the given transactions to the master without waiting to be polled, if the transport supports it
+void transport_slave_push(const int8_t *ids, uint8_t count);
+
 #ifdef ENCODER_ENABLE
 #    include "encoder.h"
 #endif // ENCODER_ENABLE
@@ -67,6 +70,7 @@ typedef struct _split_master_matrix_sync_t {
 typedef struct _split_slave_encoder_sync_t {
     uint8_t          checksum;
     encoder_events_t events;
+    uint8_t          drain_to;
 } split_slave_encoder_sync_t;
 #endif // ENCODER_ENABLE
 
@@ -141,6 +145,27 @@ typedef struct _rpc_sync_info_t {
         uint8_t s2m_length;
     } payload;
 } rpc_sync_info_t;
+
+#    if defined(SPLIT_RPC_ASYNC_ENABLE)
+typedef struct _rpc_fragment_sync_t {
+    uint8_t checksum;
+    struct {
+        int8_t   transaction_id;
+        uint8_t  request_id;
+        uint8_t  response;
+        uint8_t  length;
+        uint16_t offset;
+        uint16_t total_size;
+    } payload;
+    uint8_t data[RPC_M2S_BUFFER_SIZE];
+} rpc_fragment_sync_t;
+
+typedef struct _rpc_fragment_result_sync_t {
+    uint8_t request_id;
+    uint8_t handled;
+    uint8_t data[RPC_S2M_BUFFER_SIZE];
+} rpc_fragment_result_sync_t;
+#    endif // defined(SPLIT_RPC_ASYNC_ENABLE)
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
 #if defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
@@ -226,6 +251,11 @@ typedef struct _split_shared_memory_t {
     rpc_sync_info_t rpc_info;
     uint8_t         rpc_m2s_buffer[RPC_M2S_BUFFER_SIZE];
     uint8_t         rpc_s2m_buffer[RPC_S2M_BUFFER_SIZE];
+
+#    if defined(SPLIT_RPC_ASYNC_ENABLE)
+    rpc_fragment_sync_t        rpc_fragment;
+    rpc_fragment_result_sync_t rpc_fragment_result;
+#    endif // defined(SPLIT_RPC_ASYNC_ENABLE)
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
 #if defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
@@ -0,0 +1,154 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "state_bus.h"
+#include "action_util.h"
+#include "host.h"
+#ifdef CAPS_WORD_ENABLE
+#    include "caps_word.h"
+#endif
+#ifdef OS_DETECTION_ENABLE
+#    include "os_detection.h"
+#endif
+
+typedef struct {
+    state_bus_callback_t         callback;
+    state_domain_mask_t          domains;
+    bool                         primed; // received its first notification
+    state_bus_subscriber_stats_t stats;
+} state_bus_subscription_t;
+
+static state_bus_subscription_t subscriptions[STATE_BUS_MAX_SUBSCRIBERS];
+static state_domain_mask_t      subscribed_domains = 0;
+static state_bus_state_t        last_state;
+static state_bus_stats_t        bus_stats;
+
+static void update_subscribed_domains(void) {
+    subscribed_domains = 0;
+    for (uint8_t i = 0; i < STATE_BUS_MAX_SUBSCRIBERS; ++i) {
+        if (subscriptions[i].callback) {
+            subscribed_domains |= subscriptions[i].domains;
+        }
+    }
+}
+
+state_bus_subscriber_t state_bus_subscribe(state_domain_mask_t domains, state_bus_callback_t callback) {
+    if (!callback || !(domains & STATE_DOMAIN_ALL)) {
+        return INVALID_STATE_BUS_SUBSCRIBER;
+    }
+    for (uint8_t i = 0; i < STATE_BUS_MAX_SUBSCRIBERS; ++i) {
+        if (!subscriptions[i].callback) {
+            memset(&subscriptions[i], 0, sizeof(state_bus_subscription_t));
+            subscriptions[i].callback = callback;
+            subscriptions[i].domains  = domains & STATE_DOMAIN_ALL;
+            update_subscribed_domains();
+            return i;
+        }
+    }
+    return INVALID_STATE_BUS_SUBSCRIBER;
+}
+
+void state_bus_unsubscribe(state_bus_subscriber_t subscriber) {
+    if (subscriber < STATE_BUS_MAX_SUBSCRIBERS) {
+        subscriptions[subscriber].callback = NULL;
+        update_subscribed_domains();
+    }
+}
+
+// Only reads the domains someone subscribed to, everything else keeps its last value
+static state_domain_mask_t read_state(state_bus_state_t *state) {
+    state_domain_mask_t changed = 0;
+
+    if (subscribed_domains & STATE_DOMAIN_LAYERS) {
+        state->layer_state         = layer_state;
+        state->default_layer_state = default_layer_state;
+        if (state->layer_state != last_state.layer_state || state->default_layer_state != last_state.default_layer_state) {
+            changed |= STATE_DOMAIN_LAYERS;
+        }
+    }
+    if (subscribed_domains & STATE_DOMAIN_MODS) {
+        state->mods = get_mods();
+#ifndef NO_ACTION_ONESHOT
+        state->oneshot_mods = get_oneshot_mods();
+#endif
+        if (state->mods != last_state.mods || state->oneshot_mods != last_state.oneshot_mods) {
+            changed |= STATE_DOMAIN_MODS;
+        }
+    }
+    if (subscribed_domains & STATE_DOMAIN_LED) {
+        state->led_state = host_keyboard_led_state();
+        if (state->led_state.raw != last_state.led_state.raw) {
+            changed |= STATE_DOMAIN_LED;
+        }
+    }
+#ifdef CAPS_WORD_ENABLE
+    if (subscribed_domains & STATE_DOMAIN_CAPS_WORD) {
+        state->caps_word = is_caps_word_on();
+        if (state->caps_word != last_state.caps_word) {
+            changed |= STATE_DOMAIN_CAPS_WORD;
+        }
+    }
+#endif
+#ifdef OS_DETECTION_ENABLE
+    if (subscribed_domains & STATE_DOMAIN_OS) {
+        state->os = detected_host_os();
+        if (state->os != last_state.os) {
+            changed |= STATE_DOMAIN_OS;
+        }
+    }
+#endif
+
+    return changed;
+}
+
+void state_bus_task(void) {
+    if (!subscribed_domains) {
+        return;
+    }
+
+    state_bus_state_t   state   = last_state;
+    state_domain_mask_t changed = read_state(&state);
+    last_state                  = state;
+
+    bus_stats.scans++;
+    if (changed) {
+        bus_stats.changes++;
+    }
+
+    for (uint8_t i = 0; i < STATE_BUS_MAX_SUBSCRIBERS; ++i) {
+        state_bus_subscription_t *subscription = &subscriptions[i];
+        if (!subscription->callback) {
+            continue;
+        }
+
+        state_domain_mask_t relevant = subscription->domains & (subscription->primed ? changed : STATE_DOMAIN_ALL);
+        if (!relevant) {
+            subscription->stats.skipped++;
+            continue;
+        }
+
+        subscription->primed = true;
+        subscription->stats.notifications++;
+        subscription->callback(relevant, &last_state);
+    }
+}
+
+const state_bus_state_t *state_bus_get_state(void) {
+    return &last_state;
+}
+
+const state_bus_stats_t *state_bus_get_stats(void) {
+    return &bus_stats;
+}
+
+const state_bus_subscriber_stats_t *state_bus_get_subscriber_stats(state_bus_subscriber_t subscriber) {
+    return subscriber < STATE_BUS_MAX_SUBSCRIBERS && subscriptions[subscriber].callback ? &subscriptions[subscriber].stats : NULL;
+}
+
+void state_bus_reset_stats(void) {
+    memset(&bus_stats, 0, sizeof(bus_stats));
+    for (uint8_t i = 0; i < STATE_BUS_MAX_SUBSCRIBERS; ++i) {
+        memset(&subscriptions[i].stats, 0, sizeof(state_bus_subscriber_stats_t));
+    }
+}
@@ -0,0 +1,111 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "action_layer.h"
+#include "led.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def Maximum number of subscribers.
+ */
+#ifndef STATE_BUS_MAX_SUBSCRIBERS
+#    define STATE_BUS_MAX_SUBSCRIBERS 8
+#endif
+
+/**
+ * @enum State domains a subscriber can be notified about.
+ */
+enum state_bus_domain {
+    STATE_DOMAIN_LAYERS    = (1 << 0), // layer_state and default_layer_state
+    STATE_DOMAIN_MODS      = (1 << 1), // real and oneshot modifiers
+    STATE_DOMAIN_LED       = (1 << 2), // host LED state
+    STATE_DOMAIN_CAPS_WORD = (1 << 3),
+    STATE_DOMAIN_OS        = (1 << 4), // detected host OS
+    STATE_DOMAIN_ALL       = 0x1F,
+};
+
+typedef uint8_t state_domain_mask_t;
+
+/**
+ * @struct The state delivered to subscribers. Fields of domains nobody subscribed to are not kept up to date.
+ */
+typedef struct {
+    layer_state_t layer_state;
+    layer_state_t default_layer_state;
+    uint8_t       mods;
+    uint8_t       oneshot_mods;
+    led_t         led_state;
+    bool          caps_word;
+    uint8_t       os; // os_variant_t
+} state_bus_state_t;
+
+/**
+ * @typedef Callback invoked when subscribed state changed.
+ * @param changed[in] the subscribed domains that changed since the last notification
+ * @param state[in] the current state
+ */
+typedef void (*state_bus_callback_t)(state_domain_mask_t changed, const state_bus_state_t *state);
+
+/**
+ * @typedef A handle to a subscription.
+ */
+typedef uint8_t state_bus_subscriber_t;
+
+/**
+ * @def The handle returned when a subscription could not be made.
+ */
+#define INVALID_STATE_BUS_SUBSCRIBER UINT8_MAX
+
+/**
+ * @struct Bus wide statistics.
+ */
+typedef struct {
+    uint32_t scans;   // scans the bus ran with at least one subscriber
+    uint32_t changes; // scans in which a subscribed domain changed
+} state_bus_stats_t;
+
+/**
+ * @struct Statistics of a single subscriber.
+ */
+typedef struct {
+    uint32_t notifications; // times the callback was invoked
+    uint32_t skipped;       // scans the callback was not invoked, because nothing it subscribed to changed
+} state_bus_subscriber_stats_t;
+
+/**
+ * Subscribes to changes of the given domains. The callback is invoked with all subscribed domains on the next scan,
+ * afterwards only on scans in which one of them changed. Multiple changes within a scan are coalesced.
+ *
+ * @return a handle to the subscription, or INVALID_STATE_BUS_SUBSCRIBER if all slots are taken
+ */
+state_bus_subscriber_t state_bus_subscribe(state_domain_mask_t domains, state_bus_callback_t callback);
+
+/**
+ * Removes a subscription.
+ */
+void state_bus_unsubscribe(state_bus_subscriber_t subscriber);
+
+/**
+ * Compares the current state with the state of the last scan and notifies subscribers. Called once per scan.
+ */
+void state_bus_task(void);
+
+/**
+ * @return the state delivered in the last notification
+ */
+const state_bus_state_t *state_bus_get_state(void);
+
+const state_bus_stats_t            *state_bus_get_stats(void);
+const state_bus_subscriber_stats_t *state_bus_get_subscriber_stats(state_bus_subscriber_t subscriber);
+void                                state_bus_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
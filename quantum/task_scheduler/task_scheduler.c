@@ -0,0 +1,162 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "task_scheduler.h"
+#include "timer.h"
+#include "print.h"
+
+typedef struct {
+    task_scheduler_task_t    task;
+    task_scheduler_profile_t profile;
+    uint32_t                 last_run;
+    uint16_t                 last_us;
+    uint8_t                  deferred; // consecutive deferrals
+    bool                     enabled : 1;
+    bool                     pending : 1;
+    bool                     has_run : 1;
+} task_entry_t;
+
+static task_entry_t tasks[TASK_SCHEDULER_MAX_TASKS];
+static uint8_t      task_order[TASK_SCHEDULER_MAX_TASKS]; // handles sorted by priority
+static uint8_t      task_count = 0;
+
+__attribute__((weak)) uint32_t task_scheduler_read_us(void) {
+    return timer_read32() * 1000;
+}
+
+void task_scheduler_init(void) {
+    memset(tasks, 0, sizeof(tasks));
+    task_count = 0;
+}
+
+task_scheduler_id_t task_scheduler_register(const task_scheduler_task_t *task) {
+    if (!task || !task->task || task_count >= TASK_SCHEDULER_MAX_TASKS) {
+        return INVALID_TASK_ID;
+    }
+
+    task_scheduler_id_t id = task_count++;
+    memset(&tasks[id], 0, sizeof(task_entry_t));
+    tasks[id].task    = *task;
+    tasks[id].enabled = true;
+
+    // Insert behind every task of the same or a higher priority
+    uint8_t pos = id;
+    while (pos > 0 && tasks[task_order[pos - 1]].task.priority > task->priority) {
+        task_order[pos] = task_order[pos - 1];
+        --pos;
+    }
+    task_order[pos] = id;
+    return id;
+}
+
+task_scheduler_id_t task_scheduler_find(const char *name) {
+    for (uint8_t i = 0; i < task_count; ++i) {
+        if (tasks[i].task.name && name && strcmp(tasks[i].task.name, name) == 0) {
+            return i;
+        }
+    }
+    return INVALID_TASK_ID;
+}
+
+void task_scheduler_set_period(task_scheduler_id_t id, uint16_t period_ms) {
+    if (id < task_count) {
+        tasks[id].task.period_ms = period_ms;
+    }
+}
+
+void task_scheduler_set_enabled(task_scheduler_id_t id, bool enabled) {
+    if (id < task_count) {
+        tasks[id].enabled = enabled;
+        tasks[id].pending = false;
+    }
+}
+
+static bool task_is_due(const task_entry_t *entry, uint32_t now) {
+    if (!entry->enabled) {
+        return false;
+    }
+    if (entry->pending || !entry->has_run || entry->task.period_ms == 0) {
+        return true;
+    }
+    return TIMER_DIFF_32(now, entry->last_run) >= entry->task.period_ms;
+}
+
+static void task_run(task_entry_t *entry, uint32_t now) {
+    uint32_t start   = task_scheduler_read_us();
+    entry->pending   = entry->task.task();
+    uint32_t elapsed = task_scheduler_read_us() - start;
+
+    entry->last_run = now;
+    entry->has_run  = true;
+    entry->deferred = 0;
+    entry->last_us  = elapsed > UINT16_MAX ? UINT16_MAX : elapsed;
+
+    task_scheduler_profile_t *profile = &entry->profile;
+    profile->calls++;
+    profile->total_us += elapsed;
+    if (elapsed > profile->max_us) {
+        profile->max_us = elapsed;
+    }
+    if (entry->task.budget_us && elapsed > entry->task.budget_us) {
+        profile->overruns++;
+    }
+}
+
+#ifdef TASK_SCHEDULER_US_TIMER
+static bool task_fits(const task_entry_t *entry, uint32_t start) {
+    if (entry->task.flags & TASK_FLAG_NEVER_DEFER) {
+        return true;
+    }
+    // Estimate with whatever is larger, the declared budget or the last run
+    uint32_t used = task_scheduler_read_us() - start;
+    uint32_t cost = entry->task.budget_us > entry->last_us ? entry->task.budget_us : entry->last_us;
+    return used + cost <= TASK_SCHEDULER_LOOP_BUDGET_US;
+}
+#endif
+
+bool task_scheduler_task(void) {
+    uint32_t now      = timer_read32();
+    bool     deferred = false;
+#ifdef TASK_SCHEDULER_US_TIMER
+    uint32_t start = task_scheduler_read_us();
+#endif
+
+    for (uint8_t i = 0; i < task_count; ++i) {
+        task_entry_t *entry = &tasks[task_order[i]];
+        if (!task_is_due(entry, now)) {
+            continue;
+        }
+
+#ifdef TASK_SCHEDULER_US_TIMER
+        if (!task_fits(entry, start) && entry->deferred < TASK_SCHEDULER_MAX_DEFERRALS) {
+            entry->deferred++;
+            entry->profile.deferrals++;
+            deferred = true;
+            continue;
+        }
+#endif
+
+        task_run(entry, now);
+    }
+
+    return deferred;
+}
+
+const task_scheduler_profile_t *task_scheduler_get_profile(task_scheduler_id_t id) {
+    return id < task_count ? &tasks[id].profile : NULL;
+}
+
+void task_scheduler_reset_profile(void) {
+    for (uint8_t i = 0; i < task_count; ++i) {
+        memset(&tasks[i].profile, 0, sizeof(task_scheduler_profile_t));
+    }
+}
+
+void task_scheduler_print_profile(void) {
+    uprintf("%-16s %4s %10s %10s %8s %8s %8s\n", "task", "prio", "calls", "avg us", "max us", "overrun", "deferred");
+    for (uint8_t i = 0; i < task_count; ++i) {
+        __attribute__((unused)) const task_entry_t *entry = &tasks[task_order[i]];
+        uprintf("%-16s %4u %10lu %10lu %8lu %8lu %8lu\n", entry->task.name ? entry->task.name : "?", entry->task.priority, (unsigned long)entry->profile.calls, (unsigned long)(entry->profile.calls ? entry->profile.total_us / entry->profile.calls : 0), (unsigned long)entry->profile.max_us, (unsigned long)entry->profile.overruns, (unsigned long)entry->profile.deferrals);
+    }
+}
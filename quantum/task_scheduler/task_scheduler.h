@@ -0,0 +1,159 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def Time in microseconds that one call to task_scheduler_task() may spend running tasks. Once it is used up, due
+ *      tasks are deferred to the next loop so the matrix keeps getting scanned. Only used with
+ *      TASK_SCHEDULER_US_TIMER, without it run times cannot be budgeted and every due task runs.
+ */
+#ifndef TASK_SCHEDULER_LOOP_BUDGET_US
+#    define TASK_SCHEDULER_LOOP_BUDGET_US 1000
+#endif
+
+/**
+ * @def Number of loops a due task can be deferred in a row before it is run regardless of the remaining budget.
+ */
+#ifndef TASK_SCHEDULER_MAX_DEFERRALS
+#    define TASK_SCHEDULER_MAX_DEFERRALS 8
+#endif
+
+/**
+ * @def Maximum number of tasks that can be registered.
+ */
+#ifndef TASK_SCHEDULER_MAX_TASKS
+#    define TASK_SCHEDULER_MAX_TASKS 24
+#endif
+
+/**
+ * @enum Task priorities. The core tasks all use TASK_PRIORITY_NORMAL, so they run in the same order as they do
+ *       without the scheduler.
+ */
+enum task_scheduler_priority {
+    TASK_PRIORITY_HIGH   = 0,   // ahead of the core tasks
+    TASK_PRIORITY_NORMAL = 64,  // the core tasks
+    TASK_PRIORITY_LOW    = 128, // after the core tasks
+    TASK_PRIORITY_IDLE   = 192, // background maintenance
+};
+
+/**
+ * @enum Task flags.
+ */
+enum task_scheduler_flags {
+    TASK_FLAG_NEVER_DEFER = (1 << 0), // run whenever due, regardless of the remaining loop budget
+};
+
+/**
+ * @typedef A handle to a registered task.
+ */
+typedef uint8_t task_scheduler_id_t;
+
+/**
+ * @def The handle returned when a task could not be registered or found.
+ */
+#define INVALID_TASK_ID UINT8_MAX
+
+/**
+ * @typedef Task function invoked by the scheduler.
+ * @return true if the task has more work to do. It is then invoked again on the next loop, regardless of its period,
+ *         which allows long running work to be split into chunks.
+ */
+typedef bool (*task_scheduler_fn_t)(void);
+
+/**
+ * @struct Describes a task to the scheduler.
+ */
+typedef struct {
+    const char         *name;
+    task_scheduler_fn_t task;
+    uint16_t            period_ms; // minimum time between two runs, 0 runs the task on every loop
+    uint16_t            budget_us; // expected worst case run time, 0 uses the measured worst case
+    uint8_t             priority;  // lower values run first
+    uint8_t             flags;     // task_scheduler_flags
+} task_scheduler_task_t;
+
+/**
+ * @struct Run time statistics of a task.
+ */
+typedef struct {
+    uint32_t calls;
+    uint32_t total_us;
+    uint32_t max_us;
+    uint32_t overruns;  // runs that took longer than budget_us
+    uint32_t deferrals; // loops the task was due, but did not fit into the remaining loop budget
+} task_scheduler_profile_t;
+
+/**
+ * Removes all registered tasks.
+ */
+void task_scheduler_init(void);
+
+/**
+ * Registers a task. Tasks of the same priority run in the order they were registered.
+ *
+ * @param task[in] the task to register, it is copied
+ * @return a handle to the task, or INVALID_TASK_ID if the task table is full
+ */
+task_scheduler_id_t task_scheduler_register(const task_scheduler_task_t *task);
+
+/**
+ * Looks up a registered task by name.
+ *
+ * @param name[in] the name the task was registered with
+ * @return a handle to the task, or INVALID_TASK_ID if no such task exists
+ */
+task_scheduler_id_t task_scheduler_find(const char *name);
+
+/**
+ * Changes the period of a registered task.
+ */
+void task_scheduler_set_period(task_scheduler_id_t id, uint16_t period_ms);
+
+/**
+ * Enables or disables a registered task. Disabled tasks are never run.
+ */
+void task_scheduler_set_enabled(task_scheduler_id_t id, bool enabled);
+
+/**
+ * Runs every due task that fits into TASK_SCHEDULER_LOOP_BUDGET_US, highest priority first. Without
+ * TASK_SCHEDULER_US_TIMER every due task runs.
+ *
+ * @return true if any due task was deferred to a later loop
+ */
+bool task_scheduler_task(void);
+
+/**
+ * @return the run time statistics of a task, or NULL if the handle is invalid
+ */
+const task_scheduler_profile_t *task_scheduler_get_profile(task_scheduler_id_t id);
+
+/**
+ * Clears the run time statistics of all tasks.
+ */
+void task_scheduler_reset_profile(void);
+
+/**
+ * Prints the run time statistics of all tasks to the console.
+ */
+void task_scheduler_print_profile(void);
+
+/**
+ * Time source used to measure tasks. The default implementation only has millisecond resolution, platforms or
+ * keyboards with a finer clock (e.g. a cycle counter) should override it and define TASK_SCHEDULER_US_TIMER, which
+ * enables TASK_SCHEDULER_LOOP_BUDGET_US.
+ *
+ * @return a free running time in microseconds
+ */
+uint32_t task_scheduler_read_us(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+task_scheduler_DEFS := -DTASK_SCHEDULER_ENABLE -DNO_PRINT -DTASK_SCHEDULER_US_TIMER -DTASK_SCHEDULER_LOOP_BUDGET_US=1000 -DTASK_SCHEDULER_MAX_DEFERRALS=4
+task_scheduler_INC := $(QUANTUM_PATH)/task_scheduler
+
+task_scheduler_SRC := \
+    $(QUANTUM_PATH)/task_scheduler/tests/task_scheduler_tests.cpp \
+    $(QUANTUM_PATH)/task_scheduler/task_scheduler.c \
+    $(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+task_scheduler_ms_timer_DEFS := -DTASK_SCHEDULER_ENABLE -DNO_PRINT -DTASK_SCHEDULER_MAX_DEFERRALS=4
+task_scheduler_ms_timer_INC := $(QUANTUM_PATH)/task_scheduler
+
+task_scheduler_ms_timer_SRC := \
+    $(QUANTUM_PATH)/task_scheduler/tests/task_scheduler_ms_timer_tests.cpp \
+    $(QUANTUM_PATH)/task_scheduler/task_scheduler.c \
+    $(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
@@ -0,0 +1,80 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "task_scheduler.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+static std::vector<std::string> trace;
+
+static bool task_a(void) {
+    trace.push_back("a");
+    return false;
+}
+static bool task_b(void) {
+    trace.push_back("b");
+    return false;
+}
+static bool task_c(void) {
+    trace.push_back("c");
+    return false;
+}
+
+class TaskSchedulerMsTimer : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        task_scheduler_init();
+        set_time(0);
+        trace.clear();
+    }
+
+    void loop(uint32_t count = 1) {
+        while (count--) {
+            task_scheduler_task();
+            advance_time(1);
+        }
+    }
+
+    task_scheduler_id_t add(const char *name, task_scheduler_fn_t fn, uint8_t priority, uint16_t period_ms = 0, uint16_t budget_us = 0) {
+        task_scheduler_task_t task = {name, fn, period_ms, budget_us, priority};
+        return task_scheduler_register(&task);
+    }
+};
+
+TEST_F(TaskSchedulerMsTimer, RunsEveryDueTask) {
+    add("a", task_a, TASK_PRIORITY_HIGH);
+    add("b", task_b, TASK_PRIORITY_NORMAL);
+    add("c", task_c, TASK_PRIORITY_LOW);
+
+    loop(10);
+    EXPECT_EQ(std::vector<std::string>(trace.begin(), trace.begin() + 3), (std::vector<std::string>{"a", "b", "c"}));
+    for (task_scheduler_id_t id = 0; id < 3; ++id) {
+        EXPECT_EQ(task_scheduler_get_profile(id)->calls, 10);
+        EXPECT_EQ(task_scheduler_get_profile(id)->deferrals, 0);
+    }
+}
+
+TEST_F(TaskSchedulerMsTimer, DeclaredBudgetsAreIgnored) {
+    add("a", task_a, TASK_PRIORITY_HIGH, 0, 60000);
+    add("b", task_b, TASK_PRIORITY_NORMAL, 0, 60000);
+
+    loop();
+    EXPECT_EQ(trace, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST_F(TaskSchedulerMsTimer, PeriodsAreRespected) {
+    add("a", task_a, TASK_PRIORITY_NORMAL, 10);
+    add("b", task_b, TASK_PRIORITY_NORMAL, 1);
+
+    loop(30);
+    EXPECT_EQ(task_scheduler_get_profile(0)->calls, 3);
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 30);
+}
@@ -0,0 +1,206 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "task_scheduler.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+// Simulated clock, every task advances it by its configured cost
+static uint32_t fake_us = 0;
+uint32_t        task_scheduler_read_us(void) {
+    return fake_us;
+}
+}
+
+static std::vector<std::string> trace;
+static uint32_t                 cost_us[4];
+static uint8_t                  chunks_left;
+
+static bool run_task(uint8_t index, const char *name) {
+    trace.push_back(name);
+    fake_us += cost_us[index];
+    return false;
+}
+
+static bool task_a(void) {
+    return run_task(0, "a");
+}
+static bool task_b(void) {
+    return run_task(1, "b");
+}
+static bool task_c(void) {
+    return run_task(2, "c");
+}
+static bool task_chunked(void) {
+    run_task(3, "chunked");
+    return --chunks_left > 0;
+}
+
+class TaskScheduler : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        task_scheduler_init();
+        set_time(0);
+        fake_us     = 0;
+        chunks_left = 0;
+        trace.clear();
+        memset(cost_us, 0, sizeof(cost_us));
+    }
+
+    void loop(uint32_t count = 1) {
+        while (count--) {
+            task_scheduler_task();
+            advance_time(1);
+        }
+    }
+
+    task_scheduler_id_t add(const char *name, task_scheduler_fn_t fn, uint8_t priority, uint16_t period_ms = 0, uint16_t budget_us = 0) {
+        task_scheduler_task_t task = {name, fn, period_ms, budget_us, priority};
+        return task_scheduler_register(&task);
+    }
+};
+
+TEST_F(TaskScheduler, RunsTasksInPriorityOrder) {
+    add("c", task_c, TASK_PRIORITY_LOW);
+    add("a", task_a, TASK_PRIORITY_HIGH);
+    add("b", task_b, TASK_PRIORITY_NORMAL);
+    loop();
+    EXPECT_EQ(trace, (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST_F(TaskScheduler, SamePriorityKeepsRegistrationOrder) {
+    add("b", task_b, TASK_PRIORITY_NORMAL);
+    add("a", task_a, TASK_PRIORITY_NORMAL);
+    add("c", task_c, TASK_PRIORITY_HIGH);
+    loop();
+    EXPECT_EQ(trace, (std::vector<std::string>{"c", "b", "a"}));
+}
+
+TEST_F(TaskScheduler, PeriodIsRespected) {
+    add("a", task_a, TASK_PRIORITY_NORMAL, 10);
+    add("b", task_b, TASK_PRIORITY_NORMAL);
+    loop(30);
+    EXPECT_EQ(task_scheduler_get_profile(0)->calls, 3);
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 30);
+}
+
+TEST_F(TaskScheduler, PendingWorkRunsAgainOnTheNextLoop) {
+    add("chunked", task_chunked, TASK_PRIORITY_NORMAL, 100);
+    chunks_left = 3;
+    loop(5);
+    EXPECT_EQ(task_scheduler_get_profile(0)->calls, 3);
+}
+
+TEST_F(TaskScheduler, OverBudgetTasksAreDeferred) {
+    cost_us[0] = 800;
+    cost_us[1] = 400;
+    add("a", task_a, TASK_PRIORITY_HIGH);
+    add("b", task_b, TASK_PRIORITY_NORMAL, 0, 400);
+
+    // b does not fit behind a until it was deferred TASK_SCHEDULER_MAX_DEFERRALS times in a row
+    loop(TASK_SCHEDULER_MAX_DEFERRALS);
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 0);
+    EXPECT_EQ(task_scheduler_get_profile(1)->deferrals, TASK_SCHEDULER_MAX_DEFERRALS);
+    loop();
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 1);
+    loop(TASK_SCHEDULER_MAX_DEFERRALS);
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 1);
+    EXPECT_EQ(task_scheduler_get_profile(0)->calls, 2 * TASK_SCHEDULER_MAX_DEFERRALS + 1);
+}
+
+TEST_F(TaskScheduler, NeverDeferredTasksIgnoreTheBudget) {
+    cost_us[0] = 1000;
+    cost_us[1] = 100;
+    add("a", task_a, TASK_PRIORITY_HIGH);
+    task_scheduler_task_t task = {"b", task_b, 0, 100, TASK_PRIORITY_NORMAL, TASK_FLAG_NEVER_DEFER};
+    task_scheduler_register(&task);
+
+    loop(10);
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 10);
+    EXPECT_EQ(task_scheduler_get_profile(1)->deferrals, 0);
+}
+
+TEST_F(TaskScheduler, MeasuredCostIsUsedWithoutBudget) {
+    cost_us[0] = 600;
+    cost_us[1] = 600;
+    add("a", task_a, TASK_PRIORITY_HIGH);
+    add("b", task_b, TASK_PRIORITY_NORMAL);
+
+    // The first run of b is not known to be expensive yet
+    loop();
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 1);
+    loop();
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 1);
+    EXPECT_EQ(task_scheduler_get_profile(1)->deferrals, 1);
+}
+
+TEST_F(TaskScheduler, LoopTimeStaysWithinBudget) {
+    cost_us[0] = 100;
+    cost_us[1] = 300;
+    cost_us[2] = 700;
+    add("a", task_a, TASK_PRIORITY_HIGH);
+    add("b", task_b, TASK_PRIORITY_NORMAL, 0, 300);
+    add("c", task_c, TASK_PRIORITY_LOW, 0, 700);
+
+    uint32_t worst = 0;
+    for (int i = 0; i < 1000; ++i) {
+        uint32_t start = fake_us;
+        loop();
+        worst = std::max(worst, fake_us - start);
+    }
+    // Only the forced run of a starved task may exceed the budget
+    EXPECT_LE(worst, TASK_SCHEDULER_LOOP_BUDGET_US + cost_us[2]);
+    EXPECT_GT(task_scheduler_get_profile(1)->calls, 0);
+    EXPECT_GT(task_scheduler_get_profile(2)->calls, 0);
+    EXPECT_EQ(task_scheduler_get_profile(0)->calls, 1000);
+}
+
+TEST_F(TaskScheduler, ProfileTracksCallsAndWorstCase) {
+    add("a", task_a, TASK_PRIORITY_NORMAL, 0, 50);
+    cost_us[0] = 20;
+    loop();
+    cost_us[0] = 70;
+    loop();
+    cost_us[0] = 30;
+    loop();
+
+    const task_scheduler_profile_t *profile = task_scheduler_get_profile(0);
+    EXPECT_EQ(profile->calls, 3);
+    EXPECT_EQ(profile->total_us, 120);
+    EXPECT_EQ(profile->max_us, 70);
+    EXPECT_EQ(profile->overruns, 1);
+
+    task_scheduler_reset_profile();
+    EXPECT_EQ(profile->calls, 0);
+    EXPECT_EQ(profile->max_us, 0);
+}
+
+TEST_F(TaskScheduler, TasksCanBeFoundAndReconfigured) {
+    add("a", task_a, TASK_PRIORITY_NORMAL);
+    add("b", task_b, TASK_PRIORITY_NORMAL);
+    EXPECT_EQ(task_scheduler_find("b"), 1);
+    EXPECT_EQ(task_scheduler_find("missing"), INVALID_TASK_ID);
+
+    task_scheduler_set_enabled(task_scheduler_find("a"), false);
+    task_scheduler_set_period(task_scheduler_find("b"), 5);
+    loop(10);
+    EXPECT_EQ(task_scheduler_get_profile(0)->calls, 0);
+    EXPECT_EQ(task_scheduler_get_profile(1)->calls, 2);
+}
+
+TEST_F(TaskScheduler, FullTableRejectsTasks) {
+    for (int i = 0; i < TASK_SCHEDULER_MAX_TASKS; ++i) {
+        EXPECT_NE(add("a", task_a, TASK_PRIORITY_NORMAL), INVALID_TASK_ID);
+    }
+    EXPECT_EQ(add("a", task_a, TASK_PRIORITY_NORMAL), INVALID_TASK_ID);
+    EXPECT_EQ(task_scheduler_get_profile(TASK_SCHEDULER_MAX_TASKS), nullptr);
+}
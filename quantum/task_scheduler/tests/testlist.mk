@@ -0,0 +1 @@
+TEST_LIST += task_scheduler task_scheduler_ms_timer
@@ -16,6 +16,7 @@
 
 #include "unicode.h"
 
+#include <string.h>
 #include "eeprom.h"
 #include "eeconfig.h"
 #include "action.h"
@@ -23,6 +24,7 @@
 #include "host.h"
 #include "keycode.h"
 #include "wait.h"
+#include "timer.h"
 #include "send_string.h"
 #include "utf8.h"
 #include "debug.h"
@@ -63,10 +65,39 @@
 #    define UNICODE_TYPE_DELAY 10
 #endif
 
+// Number of code points that can be waiting for asynchronous output
+#ifndef UNICODE_ASYNC_QUEUE_SIZE
+#    define UNICODE_ASYNC_QUEUE_SIZE 16
+#endif
+
 unicode_config_t unicode_config;
 uint8_t          unicode_saved_mods;
 led_t            unicode_saved_led_state;
 
+#ifdef UNICODE_ASYNC_OUTPUT
+typedef enum {
+    UNICODE_OUTPUT_IDLE,
+    UNICODE_OUTPUT_DELAY,
+    UNICODE_OUTPUT_DIGITS,
+} unicode_output_state_t;
+
+static struct {
+    uint32_t               queue[UNICODE_ASYNC_QUEUE_SIZE];
+    uint8_t                head;
+    uint8_t                count;
+    unicode_output_state_t state;
+    unicode_sequence_t     sequence;
+    uint8_t                input_mode; // the mode the sequence was opened in
+    uint8_t                position;
+    uint16_t               timer;
+} unicode_output;
+#endif
+
+#ifdef UNICODE_OUTPUT_STATS
+static unicode_output_stats_t unicode_stats[UNICODE_MODE_COUNT];
+static uint16_t               unicode_stats_timer;
+#endif
+
 #if UNICODE_SELECTED_MODES != -1
 static uint8_t selected[]     = {UNICODE_SELECTED_MODES};
 static int8_t  selected_count = ARRAY_SIZE(selected);
@@ -251,7 +282,10 @@ __attribute__((weak)) void unicode_input_start(void) {
             break;
     }
 
+#ifndef UNICODE_ASYNC_OUTPUT
+    // In asynchronous mode the output task waits this out without blocking
     wait_ms(UNICODE_TYPE_DELAY);
+#endif
 }
 
 __attribute__((weak)) void unicode_input_finish(void) {
@@ -325,16 +359,14 @@ static void send_nibble_wrapper(uint8_t digit) {
 
 // clang-format on
 
-void register_hex(uint16_t hex) {
-    for (int i = 3; i >= 0; i--) {
-        uint8_t digit = ((hex >> (i * 4)) & 0xF);
-        send_nibble_wrapper(digit);
+static void send_sequence(const unicode_sequence_t *sequence) {
+    for (uint8_t i = 0; i < sequence->length; i++) {
+        send_nibble_wrapper(sequence->digits[i]);
     }
 }
 
-void register_hex32(uint32_t hex) {
-    bool first_digit        = true;
-    bool needs_leading_zero = (unicode_config.input_mode == UNICODE_MODE_WINCOMPOSE);
+static void compile_hex32(unicode_sequence_t *sequence, uint32_t hex, bool needs_leading_zero) {
+    bool first_digit = true;
     for (int i = 7; i >= 0; i--) {
         // Work out the digit we're going to transmit
         uint8_t digit = ((hex >> (i * 4)) & 0xF);
@@ -342,7 +374,7 @@ void register_hex32(uint32_t hex) {
         // If we're still searching for the first digit, and found one
         // that needs a leading zero sent out, send the zero.
         if (first_digit && needs_leading_zero && digit > 9) {
-            send_nibble_wrapper(0);
+            sequence->digits[sequence->length++] = 0;
         }
 
         // Always send digits (including zero) if we're down to the last
@@ -351,29 +383,175 @@ void register_hex32(uint32_t hex) {
 
         // If we've found a digit worth transmitting, do so.
         if (digit != 0 || !first_digit || must_send) {
-            send_nibble_wrapper(digit);
-            first_digit = false;
+            sequence->digits[sequence->length++] = digit;
+            first_digit                          = false;
         }
     }
 }
 
-void register_unicode(uint32_t code_point) {
-    if (code_point > 0x10FFFF || (code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_WINDOWS)) {
+void register_hex(uint16_t hex) {
+    for (int i = 3; i >= 0; i--) {
+        uint8_t digit = ((hex >> (i * 4)) & 0xF);
+        send_nibble_wrapper(digit);
+    }
+}
+
+void register_hex32(uint32_t hex) {
+    unicode_sequence_t sequence = {0};
+    compile_hex32(&sequence, hex, unicode_config.input_mode == UNICODE_MODE_WINCOMPOSE);
+    send_sequence(&sequence);
+}
+
+bool unicode_compile_sequence(uint32_t code_point, uint8_t input_mode, unicode_sequence_t *sequence) {
+    sequence->length = 0;
+
+    if (code_point > 0x10FFFF || (code_point > 0xFFFF && input_mode == UNICODE_MODE_WINDOWS)) {
         // Code point out of range, do nothing
-        return;
+        return false;
     }
 
-    unicode_input_start();
-    if (code_point > 0xFFFF && unicode_config.input_mode == UNICODE_MODE_MACOS) {
+    bool needs_leading_zero = (input_mode == UNICODE_MODE_WINCOMPOSE);
+    if (code_point > 0xFFFF && input_mode == UNICODE_MODE_MACOS) {
         // Convert code point to UTF-16 surrogate pair on macOS
         code_point -= 0x10000;
         uint32_t lo = code_point & 0x3FF, hi = (code_point & 0xFFC00) >> 10;
-        register_hex32(hi + 0xD800);
-        register_hex32(lo + 0xDC00);
+        compile_hex32(sequence, hi + 0xD800, needs_leading_zero);
+        compile_hex32(sequence, lo + 0xDC00, needs_leading_zero);
     } else {
-        register_hex32(code_point);
+        compile_hex32(sequence, code_point, needs_leading_zero);
     }
+
+    return true;
+}
+
+static void unicode_output_begin(void) {
+#ifdef UNICODE_OUTPUT_STATS
+    unicode_stats_timer = timer_read();
+#endif
+    unicode_input_start();
+}
+
+static void unicode_output_end(void) {
     unicode_input_finish();
+#ifdef UNICODE_OUTPUT_STATS
+    uint16_t                elapsed = timer_elapsed(unicode_stats_timer);
+    unicode_output_stats_t *stats   = &unicode_stats[unicode_config.input_mode];
+
+    stats->count++;
+    stats->last_time = elapsed;
+    stats->total_time += elapsed;
+    if (elapsed > stats->max_time) {
+        stats->max_time = elapsed;
+    }
+    dprintf("Unicode output in mode %u took %u ms\n", unicode_config.input_mode, elapsed);
+#endif
+}
+
+#ifdef UNICODE_ASYNC_OUTPUT
+/**
+ * \brief Advance the asynchronous output by one keystroke.
+ *
+ * When `blocking` is set, the input start delay is waited out instead of deferred to a later call.
+ */
+static void unicode_output_step(bool blocking) {
+    uint8_t input_mode = unicode_config.input_mode;
+    if (unicode_output.state != UNICODE_OUTPUT_IDLE) {
+        // An open sequence is finished in the mode it was opened in, even if the mode changed since
+        unicode_config.input_mode = unicode_output.input_mode;
+    }
+
+    switch (unicode_output.state) {
+        case UNICODE_OUTPUT_IDLE: {
+            if (unicode_output.count == 0) {
+                break;
+            }
+
+            uint32_t code_point = unicode_output.queue[unicode_output.head];
+            unicode_output.head = (unicode_output.head + 1) % UNICODE_ASYNC_QUEUE_SIZE;
+            unicode_output.count--;
+
+            // Compile against the mode in effect now, as it may have changed since the code point was queued
+            if (!unicode_compile_sequence(code_point, unicode_config.input_mode, &unicode_output.sequence)) {
+                break;
+            }
+
+            unicode_output_begin();
+            unicode_output.input_mode = unicode_config.input_mode;
+            unicode_output.position   = 0;
+            unicode_output.timer      = timer_read();
+            unicode_output.state      = UNICODE_OUTPUT_DELAY;
+        }
+            // fall through
+        case UNICODE_OUTPUT_DELAY: {
+            uint16_t elapsed = timer_elapsed(unicode_output.timer);
+            if (elapsed < UNICODE_TYPE_DELAY) {
+                if (!blocking) {
+                    break;
+                }
+                wait_ms(UNICODE_TYPE_DELAY - elapsed);
+            }
+            unicode_output.state = UNICODE_OUTPUT_DIGITS;
+        }
+            // fall through
+        case UNICODE_OUTPUT_DIGITS:
+            send_nibble_wrapper(unicode_output.sequence.digits[unicode_output.position++]);
+            if (unicode_output.position >= unicode_output.sequence.length) {
+                unicode_output_end();
+                unicode_output.state = UNICODE_OUTPUT_IDLE;
+            }
+            break;
+    }
+
+    unicode_config.input_mode = input_mode;
+}
+
+bool unicode_output_pending(void) {
+    return unicode_output.state != UNICODE_OUTPUT_IDLE || unicode_output.count > 0;
+}
+
+void unicode_output_flush(void) {
+    while (unicode_output_pending()) {
+        unicode_output_step(true);
+    }
+}
+
+void unicode_task(void) {
+    unicode_output_step(false);
+}
+#endif
+
+#ifdef UNICODE_OUTPUT_STATS
+const unicode_output_stats_t *unicode_get_output_stats(uint8_t input_mode) {
+    if (input_mode >= UNICODE_MODE_COUNT) {
+        return NULL;
+    }
+    return &unicode_stats[input_mode];
+}
+
+void unicode_clear_output_stats(void) {
+    memset(unicode_stats, 0, sizeof(unicode_stats));
+}
+#endif
+
+void register_unicode(uint32_t code_point) {
+#ifdef UNICODE_ASYNC_OUTPUT
+    // Drain the oldest entries synchronously rather than dropping characters
+    while (unicode_output.count == UNICODE_ASYNC_QUEUE_SIZE) {
+        unicode_output_step(true);
+    }
+
+    unicode_output.queue[(unicode_output.head + unicode_output.count) % UNICODE_ASYNC_QUEUE_SIZE] = code_point;
+    unicode_output.count++;
+#else
+    unicode_sequence_t sequence;
+    if (!unicode_compile_sequence(code_point, unicode_config.input_mode, &sequence)) {
+        return;
+    }
+
+    unicode_output_begin();
+    send_sequence(&sequence);
+    unicode_output_end();
+#endif
 }
 
 void send_unicode_string(const char *str) {
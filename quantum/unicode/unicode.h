@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "unicode_keycodes.h"
 
@@ -48,6 +49,29 @@ enum unicode_input_modes {
     UNICODE_MODE_COUNT // Number of available input modes (always leave at the end)
 };
 
+/**
+ * \brief The maximum number of hex digits in an input sequence (a UTF-16 surrogate pair on macOS).
+ */
+#define UNICODE_SEQUENCE_MAX_DIGITS 8
+
+/**
+ * \brief The hex digits to type for a single code point, in a given input mode.
+ */
+typedef struct {
+    uint8_t length;
+    uint8_t digits[UNICODE_SEQUENCE_MAX_DIGITS];
+} unicode_sequence_t;
+
+/**
+ * \brief Per-input mode timing of complete Unicode input sequences, in milliseconds.
+ */
+typedef struct {
+    uint16_t count;
+    uint16_t last_time;
+    uint16_t max_time;
+    uint32_t total_time;
+} unicode_output_stats_t;
+
 void unicode_input_mode_init(void);
 
 /**
@@ -117,9 +141,22 @@ void register_hex(uint16_t hex);
  */
 void register_hex32(uint32_t hex);
 
+/**
+ * \brief Compute the hex digits to type for a code point, without sending anything.
+ *
+ * \param code_point The code point to compile.
+ * \param input_mode The input mode the sequence will be typed in.
+ * \param sequence The sequence to fill in.
+ *
+ * \return `false` if the code point cannot be entered in the given input mode.
+ */
+bool unicode_compile_sequence(uint32_t code_point, uint8_t input_mode, unicode_sequence_t *sequence);
+
 /**
  * \brief Input a single Unicode character. A surrogate pair will be sent if required by the input mode.
  *
+ * With `UNICODE_ASYNC_OUTPUT` defined, the character is queued and typed out by `unicode_task()`.
+ *
  * \param code_point The code point of the character to send.
  */
 void register_unicode(uint32_t code_point);
@@ -131,4 +168,42 @@ void register_unicode(uint32_t code_point);
  */
 void send_unicode_string(const char *str);
 
+#ifdef UNICODE_ASYNC_OUTPUT
+/**
+ * \brief Check whether any queued Unicode characters have yet to be typed out.
+ *
+ * \return `true` if output is in progress.
+ */
+bool unicode_output_pending(void);
+
+/**
+ * \brief Type out all queued Unicode characters before returning.
+ *
+ * Every key event does this before it is processed. Code sending other output outside of key processing, such as
+ * `housekeeping_task_user()`, must call it first so its output doesn't end up inside an input sequence.
+ */
+void unicode_output_flush(void);
+
+/**
+ * \brief Type out queued Unicode characters, one keystroke per call.
+ */
+void unicode_task(void);
+#endif
+
+#ifdef UNICODE_OUTPUT_STATS
+/**
+ * \brief Get the output timing statistics for an input mode.
+ *
+ * \param input_mode The input mode to query.
+ *
+ * \return The statistics, or `NULL` if the input mode is invalid.
+ */
+const unicode_output_stats_t *unicode_get_output_stats(uint8_t input_mode);
+
+/**
+ * \brief Reset the output timing statistics for all input modes.
+ */
+void unicode_clear_output_stats(void);
+#endif
+
 /** \} */
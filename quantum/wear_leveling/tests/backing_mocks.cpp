@@ -24,15 +24,34 @@ void MockBackingStore::reset_instance() {
     backing_write_invoke_count  = 0;
     backing_lock_invoke_count   = 0;
 
+    backing_erase_sector_invoke_count = 0;
+    backing_read_invoke_count         = 0;
+    backing_elapsed_time              = 0;
+    backing_modification_count        = 0;
+    backing_power_loss_threshold      = UINT64_MAX;
+
     init_success_callback   = [](std::uint64_t) { return true; };
     erase_success_callback  = [](std::uint64_t) { return true; };
     unlock_success_callback = [](std::uint64_t) { return true; };
     write_success_callback  = [](std::uint64_t, std::uint32_t) { return true; };
     lock_success_callback   = [](std::uint64_t) { return true; };
+    timing_callback         = nullptr;
 
     write_log.clear();
 }
 
+bool MockBackingStore::perform_operation(MockBackingStoreOperation operation, std::uint32_t address) {
+    if (power_lost()) {
+        return false;
+    }
+    ++backing_modification_count;
+
+    if (timing_callback) {
+        backing_elapsed_time += timing_callback(operation, address);
+    }
+    return true;
+}
+
 bool MockBackingStore::init(void) {
     ++backing_init_invoke_count;
 
@@ -57,6 +76,10 @@ bool MockBackingStore::unlock(void) {
 bool MockBackingStore::erase(void) {
     ++backing_erase_invoke_count;
 
+    if (!perform_operation(MockBackingStoreOperation::erase, 0)) {
+        return false;
+    }
+
     // Erase each slot
     for (std::size_t i = 0; i < backing_storage.size(); ++i) {
         // Drop out of erase early with failure if we need to
@@ -75,6 +98,26 @@ bool MockBackingStore::erase(void) {
     return true;
 }
 
+#ifdef BACKING_STORE_SECTOR_SIZE
+bool MockBackingStore::erase_sector(uint32_t address) {
+    ++backing_erase_sector_invoke_count;
+
+    EXPECT_TRUE(address % BACKING_STORE_SECTOR_SIZE == 0) << "Supplied address was not aligned with the sector size";
+    EXPECT_TRUE(address + BACKING_STORE_SECTOR_SIZE <= WEAR_LEVELING_BACKING_SIZE) << "Address would result of out-of-bounds access";
+    EXPECT_FALSE(is_locked()) << "Sector erase was attempted without being unlocked first";
+
+    if (!perform_operation(MockBackingStoreOperation::erase_sector, address)) {
+        return false;
+    }
+
+    std::size_t index = address / BACKING_STORE_WRITE_SIZE;
+    for (std::size_t i = 0; i < BACKING_STORE_SECTOR_SIZE / BACKING_STORE_WRITE_SIZE; ++i) {
+        backing_storage[index + i].erase();
+    }
+    return true;
+}
+#endif // BACKING_STORE_SECTOR_SIZE
+
 bool MockBackingStore::write(uint32_t address, backing_store_int_t value) {
     ++backing_write_invoke_count;
 
@@ -88,6 +131,10 @@ bool MockBackingStore::write(uint32_t address, backing_store_int_t value) {
         return false;
     }
 
+    if (!perform_operation(MockBackingStoreOperation::write, address)) {
+        return false;
+    }
+
     // Write the complement as we're simulating flash memory -- 0xFF means 0x00
     std::size_t index = address / BACKING_STORE_WRITE_SIZE;
     backing_storage[index].set(~value);
@@ -114,6 +161,8 @@ bool MockBackingStore::lock(void) {
 }
 
 bool MockBackingStore::read(uint32_t address, backing_store_int_t& value) const {
+    ++backing_read_invoke_count;
+
     // precondition: value's buffer size already matches BACKING_STORE_WRITE_SIZE
     EXPECT_TRUE(address % BACKING_STORE_WRITE_SIZE == 0) << "Supplied address was not aligned with the backing store integral size";
     EXPECT_TRUE(address + BACKING_STORE_WRITE_SIZE <= WEAR_LEVELING_BACKING_SIZE) << "Address would result of out-of-bounds access";
@@ -141,6 +190,12 @@ extern "C" bool backing_store_erase(void) {
     return MockBackingStore::Instance().erase();
 }
 
+#ifdef BACKING_STORE_SECTOR_SIZE
+extern "C" bool backing_store_erase_sector(uint32_t address) {
+    return MockBackingStore::Instance().erase_sector(address);
+}
+#endif // BACKING_STORE_SECTOR_SIZE
+
 extern "C" bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return MockBackingStore::Instance().write(address, value);
 }
@@ -60,6 +60,9 @@ class MockBackingStoreElement {
     }
 };
 
+// Operations performed on the backing store, used for simulating timing
+enum class MockBackingStoreOperation { erase, erase_sector, write };
+
 struct MockBackingStoreLogEntry {
     MockBackingStoreLogEntry(uint32_t address, backing_store_int_t value) : address(address), value(value), erased(false) {}
     MockBackingStoreLogEntry(bool erased) : address(0), value(0), erased(erased) {}
@@ -96,6 +99,15 @@ class MockBackingStore {
     std::uint64_t backing_erase_invoke_count;
     std::uint64_t backing_write_invoke_count;
     std::uint64_t backing_lock_invoke_count;
+    std::uint64_t backing_erase_sector_invoke_count;
+    mutable std::uint64_t backing_read_invoke_count;
+
+    // The simulated time spent performing backing store operations
+    std::uint64_t backing_elapsed_time;
+    // The number of operations which modified the backing store
+    std::uint64_t backing_modification_count;
+    // The number of modifications allowed before simulating a power loss
+    std::uint64_t backing_power_loss_threshold;
 
     // Whether init should succeed
     std::function<bool(std::uint64_t)> init_success_callback;
@@ -107,6 +119,11 @@ class MockBackingStore {
     std::function<bool(std::uint64_t, std::uint32_t)> write_success_callback;
     // Whether locks should succeed
     std::function<bool(std::uint64_t)> lock_success_callback;
+    // The simulated duration of each operation
+    std::function<std::uint64_t(MockBackingStoreOperation, std::uint32_t)> timing_callback;
+
+    // Accounts for the time taken by an operation, returning false if power has been lost
+    bool perform_operation(MockBackingStoreOperation operation, std::uint32_t address);
 
     template <typename... Args>
     void append_log(Args&&... args) {
@@ -147,6 +164,33 @@ class MockBackingStore {
     std::uint64_t lock_invoke_count() const {
         return backing_lock_invoke_count;
     }
+    std::uint64_t erase_sector_invoke_count() const {
+        return backing_erase_sector_invoke_count;
+    }
+    std::uint64_t read_invoke_count() const {
+        return backing_read_invoke_count;
+    }
+
+    // The simulated time spent performing backing store operations
+    std::uint64_t elapsed_time() const {
+        return backing_elapsed_time;
+    }
+    // The number of operations which modified the backing store
+    std::uint64_t modification_count() const {
+        return backing_modification_count;
+    }
+
+    // Simulates a power loss after the supplied number of further modifications, ignoring any subsequent ones
+    void set_power_loss_after(std::uint64_t modifications) {
+        backing_power_loss_threshold = backing_modification_count + modifications;
+    }
+    // Restores power, retaining the current contents of the backing store
+    void restore_power() {
+        backing_power_loss_threshold = UINT64_MAX;
+    }
+    bool power_lost() const {
+        return backing_modification_count >= backing_power_loss_threshold;
+    }
 
     // Clear out the internal data for the next run
     void reset_instance();
@@ -159,6 +203,9 @@ class MockBackingStore {
     bool init();
     bool unlock();
     bool erase();
+#ifdef BACKING_STORE_SECTOR_SIZE
+    bool erase_sector(std::uint32_t address);
+#endif // BACKING_STORE_SECTOR_SIZE
     bool write(std::uint32_t address, backing_store_int_t value);
     bool lock();
     bool read(std::uint32_t address, backing_store_int_t& value) const;
@@ -179,6 +226,9 @@ class MockBackingStore {
     void set_lock_callback(std::function<bool(std::uint64_t)> callback) {
         lock_success_callback = callback;
     }
+    void set_timing_callback(std::function<std::uint64_t(MockBackingStoreOperation, std::uint32_t)> callback) {
+        timing_callback = callback;
+    }
 
     auto storage_begin() const -> decltype(backing_storage.begin()) {
         return backing_storage.begin();
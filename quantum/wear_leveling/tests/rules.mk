@@ -63,4 +63,57 @@ wear_leveling_8byte_SRC := \
 	$(wear_leveling_common_SRC) \
 	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_8byte.cpp
 wear_leveling_8byte_INC := \
-	$(wear_leveling_common_INC)
\ No newline at end of file
+	$(wear_leveling_common_INC)
+
+wear_leveling_dual_bank_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DWEAR_LEVELING_DUAL_BANK \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DBACKING_STORE_SECTOR_SIZE=64 \
+	-DWEAR_LEVELING_BACKING_SIZE=512 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=64 \
+	-DWEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE=16
+wear_leveling_dual_bank_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_dual_bank.cpp
+wear_leveling_dual_bank_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_checkpoint_2byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DWEAR_LEVELING_CHECKPOINTS \
+	-DWEAR_LEVELING_CHECKPOINT_INTERVAL=1024 \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=16384 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=4096
+wear_leveling_checkpoint_2byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_checkpoint.cpp
+wear_leveling_checkpoint_2byte_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_checkpoint_4byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DWEAR_LEVELING_CHECKPOINTS \
+	-DWEAR_LEVELING_CHECKPOINT_INTERVAL=1024 \
+	-DBACKING_STORE_WRITE_SIZE=4 \
+	-DWEAR_LEVELING_BACKING_SIZE=16384 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=4096
+wear_leveling_checkpoint_4byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_checkpoint.cpp
+wear_leveling_checkpoint_4byte_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_checkpoint_8byte_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DWEAR_LEVELING_CHECKPOINTS \
+	-DWEAR_LEVELING_CHECKPOINT_INTERVAL=1024 \
+	-DBACKING_STORE_WRITE_SIZE=8 \
+	-DWEAR_LEVELING_BACKING_SIZE=16384 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=4096
+wear_leveling_checkpoint_8byte_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_checkpoint.cpp
+wear_leveling_checkpoint_8byte_INC := \
+	$(wear_leveling_common_INC)
@@ -0,0 +1,190 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <chrono>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+// Size of the write log within the backing store
+#define LOG_SIZE ((WEAR_LEVELING_BACKING_SIZE) - (WEAR_LEVELING_LOG_START))
+
+class WearLevelingCheckpoint : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+    }
+
+    // Deterministic pseudo-random number generator
+    static std::uint32_t next(std::uint32_t& seed) {
+        seed = seed * 1103515245 + 12345;
+        return seed >> 8;
+    }
+
+    // Settings-like workload -- most writes hit the first couple of pages, with occasional writes anywhere
+    static std::uint32_t workload_address(std::uint32_t& seed, std::uint32_t length) {
+        std::uint32_t limit = (next(seed) % 50 == 0) ? WEAR_LEVELING_LOGICAL_SIZE : 128;
+        return next(seed) % (limit - length + 1);
+    }
+
+    // Number of bytes of the write log currently in use
+    static std::size_t log_bytes_used() {
+        auto&       inst  = MockBackingStore::Instance();
+        std::size_t count = 0;
+        for (auto it = inst.storage_begin() + (WEAR_LEVELING_LOG_START / BACKING_STORE_WRITE_SIZE); it != inst.storage_end(); ++it) {
+            if (!it->is_erased()) {
+                count = (it - inst.storage_begin()) * BACKING_STORE_WRITE_SIZE + BACKING_STORE_WRITE_SIZE - WEAR_LEVELING_LOG_START;
+            }
+        }
+        return count;
+    }
+
+    static void verify_readback(const std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE>& expected) {
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+        EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        EXPECT_EQ(actual, expected) << "Readback did not match";
+    }
+};
+
+/**
+ * This test verifies that data is correctly restored after re-init, regardless of where in the log the latest checkpoint lies.
+ */
+TEST_F(WearLevelingCheckpoint, Readback_MatchesAfterReinit) {
+    auto&                                                inst = MockBackingStore::Instance();
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    std::uint32_t                                        seed = 1;
+
+    for (int i = 0; i < 20000; ++i) {
+        std::uint8_t  value[8];
+        std::uint32_t length  = 1 + next(seed) % sizeof(value);
+        std::uint32_t address = workload_address(seed, length);
+        for (std::uint32_t j = 0; j < length; ++j) {
+            value[j] = (std::uint8_t)next(seed);
+        }
+        EXPECT_NE(wear_leveling_write(address, value, length), WEAR_LEVELING_FAILED) << "Write failed";
+        std::copy(value, value + length, expected.begin() + address);
+
+        if (i % 97 == 0) {
+            EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init failed";
+            verify_readback(expected);
+        }
+    }
+
+    EXPECT_GT(inst.erasure_count(), 1) << "Log should have been consolidated multiple times";
+    EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init failed";
+    verify_readback(expected);
+}
+
+/**
+ * This test verifies that a power loss at any point, including part-way through writing a checkpoint, recovers every write which had completed beforehand.
+ */
+TEST_F(WearLevelingCheckpoint, PowerLoss_AnyStep_RecoversLatestData) {
+    auto& inst = MockBackingStore::Instance();
+
+    // Only use writes which fit in a single backing store write, as a partially-written log entry cannot be recovered
+#if BACKING_STORE_WRITE_SIZE == 2
+    const std::uint32_t length = 2;
+#else
+    const std::uint32_t length = 1;
+#endif
+    const int   write_count = (5 * (WEAR_LEVELING_CHECKPOINT_INTERVAL) / 2) / BACKING_STORE_WRITE_SIZE;
+    const auto  next_write  = [&](std::uint32_t& seed, std::uint8_t* value) {
+        std::uint32_t address = workload_address(seed, length) & ~1;
+        value[0]              = next(seed) % 2;
+        value[1]              = 0;
+        return address;
+    };
+
+    // Determine how many modifications the scenario performs when power is never lost
+    std::uint32_t seed = 2;
+    std::uint8_t  value[2];
+    for (int i = 0; i < write_count; ++i) {
+        std::uint32_t address = next_write(seed, value);
+        wear_leveling_write(address, value, length);
+    }
+    const std::uint64_t total_modifications = inst.modification_count();
+
+    for (std::uint64_t cut = 0; cut < total_modifications; ++cut) {
+        inst.reset_instance();
+        wear_leveling_init();
+        inst.set_power_loss_after(cut);
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+        std::uint32_t                                        pending_address = UINT32_MAX;
+        std::uint8_t                                         pending_value   = 0;
+        seed                                                                 = 2;
+        for (int i = 0; i < write_count; ++i) {
+            std::uint32_t address = next_write(seed, value);
+            wear_leveling_write(address, value, length);
+            if (inst.power_lost()) {
+                // The write in progress when power was lost may or may not have persisted
+                pending_address = address;
+                pending_value   = value[0];
+                break;
+            }
+            std::copy(value, value + length, expected.begin() + address);
+        }
+
+        inst.restore_power();
+        EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init failed after power loss at modification " << cut;
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+        EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        for (std::uint32_t a = 0; a < WEAR_LEVELING_LOGICAL_SIZE; ++a) {
+            if (a == pending_address && actual[a] == pending_value) {
+                continue;
+            }
+            ASSERT_EQ(actual[a], expected[a]) << "Invalid readback at address " << a << " after power loss at modification " << cut;
+        }
+    }
+}
+
+/**
+ * Reports the cost of init against how full the write log is, compared with playing back the entire write log.
+ */
+TEST_F(WearLevelingCheckpoint, Benchmark_PlaybackVersusLogFill) {
+    auto&      inst       = MockBackingStore::Instance();
+    const int  fills[]    = {10, 25, 50, 75, 95};
+    const int  iterations = 50;
+    // Reads of the consolidated area are common to both, so only reads of the write log are compared
+    const auto consolidated_reads = (WEAR_LEVELING_LOG_START) / BACKING_STORE_WRITE_SIZE;
+    const auto full_reads         = [](std::size_t used) { return used / BACKING_STORE_WRITE_SIZE + 1; };
+
+    printf("BENCH %d-byte writes, %d byte log, %d byte checkpoint interval\n", (int)BACKING_STORE_WRITE_SIZE, (int)LOG_SIZE, (int)WEAR_LEVELING_CHECKPOINT_INTERVAL);
+    printf("BENCH  fill | log bytes | full playback log reads | checkpoint log reads | init time\n");
+    for (int fill : fills) {
+        inst.reset_instance();
+        wear_leveling_init();
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+        std::uint32_t                                        seed = 3;
+        while (log_bytes_used() < (std::size_t)LOG_SIZE * fill / 100) {
+            for (int i = 0; i < 16; ++i) {
+                std::uint8_t  value[4];
+                std::uint32_t length  = 1 + next(seed) % sizeof(value);
+                std::uint32_t address = workload_address(seed, length);
+                for (std::uint32_t j = 0; j < length; ++j) {
+                    value[j] = (std::uint8_t)next(seed);
+                }
+                wear_leveling_write(address, value, length);
+                std::copy(value, value + length, expected.begin() + address);
+            }
+        }
+        ASSERT_EQ(inst.erasure_count(), 0) << "Log should not have been consolidated";
+
+        const std::size_t used        = log_bytes_used();
+        const auto        reads_start = inst.read_invoke_count();
+        const auto        time_start  = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+        }
+        const auto time_taken = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_start).count() / iterations;
+        const auto reads      = (inst.read_invoke_count() - reads_start) / iterations - consolidated_reads;
+        verify_readback(expected);
+
+        printf("BENCH  %3d%% | %9d | %23d | %20d | %7dns\n", fill, (int)used, (int)full_reads(used), (int)reads, (int)time_taken);
+        if (fill >= 50) {
+            EXPECT_LT(reads, full_reads(used) / 2) << "Checkpoint should have avoided most of the playback";
+        }
+    }
+}
@@ -0,0 +1,205 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <algorithm>
+#include <numeric>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+// Simulated durations of each backing store operation, in microseconds
+#define ERASE_SECTOR_DURATION 20000
+#define ERASE_DURATION (ERASE_SECTOR_DURATION * (WEAR_LEVELING_BACKING_SIZE / BACKING_STORE_SECTOR_SIZE))
+#define WRITE_DURATION 50
+
+class WearLevelingDualBank : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        MockBackingStore::Instance().set_timing_callback([](MockBackingStoreOperation operation, std::uint32_t) -> std::uint64_t {
+            switch (operation) {
+                case MockBackingStoreOperation::erase:
+                    return ERASE_DURATION;
+                case MockBackingStoreOperation::erase_sector:
+                    return ERASE_SECTOR_DURATION;
+                case MockBackingStoreOperation::write:
+                    return WRITE_DURATION;
+            }
+            return 0;
+        });
+        wear_leveling_init();
+    }
+
+    // Deterministic sequence of single-byte writes, each of which fits into a single backing store write
+    struct scenario_write {
+        std::uint32_t address;
+        std::uint8_t  value;
+    };
+    static scenario_write scenario_step(std::uint32_t& seed) {
+        seed = seed * 1103515245 + 12345;
+        return {(seed >> 8) % WEAR_LEVELING_LOGICAL_SIZE, (std::uint8_t)(seed >> 20)};
+    }
+};
+
+/**
+ * This test verifies that consolidation performed by the task never stalls for longer than a single sector erase, and never erases the entire backing store.
+ */
+TEST_F(WearLevelingDualBank, BackgroundConsolidation_StallIsBounded) {
+    auto&                                                inst = MockBackingStore::Instance();
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    std::uint64_t                                        longest_stall = 0;
+    int                                                  switches      = 0;
+    std::uint32_t                                        seed          = 1;
+
+    for (int i = 0; i < 2000; ++i) {
+        auto w = scenario_step(seed);
+
+        std::uint64_t start = inst.elapsed_time();
+        EXPECT_NE(wear_leveling_write(w.address, &w.value, 1), WEAR_LEVELING_FAILED) << "Write failed";
+        expected[w.address] = w.value;
+        longest_stall       = std::max(longest_stall, inst.elapsed_time() - start);
+
+        start                         = inst.elapsed_time();
+        wear_leveling_status_t status = wear_leveling_task();
+        EXPECT_NE(status, WEAR_LEVELING_FAILED) << "Task failed";
+        if (status == WEAR_LEVELING_CONSOLIDATED) {
+            ++switches;
+        }
+        longest_stall = std::max(longest_stall, inst.elapsed_time() - start);
+    }
+
+    EXPECT_GT(switches, 10) << "Consolidation should have occurred in the background";
+    EXPECT_EQ(inst.erase_invoke_count(), 0) << "Full erase should never have been needed";
+    EXPECT_LE(longest_stall, ERASE_SECTOR_DURATION) << "Longest stall should be bounded by a single sector erase";
+    printf("Longest stall: %dus over %d bank switches, full erase would take %dus\n", (int)longest_stall, switches, (int)ERASE_DURATION);
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+    EXPECT_EQ(actual, expected) << "Readback after re-init did not match";
+}
+
+/**
+ * This test verifies that if the task is never invoked, consolidation still occurs in-line when the write log fills, without erasing the active bank.
+ */
+TEST_F(WearLevelingDualBank, NoTask_InlineConsolidation) {
+    auto&                                                inst = MockBackingStore::Instance();
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+    int                                                  switches = 0;
+    std::uint32_t                                        seed     = 2;
+
+    for (int i = 0; i < 500; ++i) {
+        auto                   w      = scenario_step(seed);
+        wear_leveling_status_t status = wear_leveling_write(w.address, &w.value, 1);
+        EXPECT_NE(status, WEAR_LEVELING_FAILED) << "Write failed";
+        if (status == WEAR_LEVELING_CONSOLIDATED) {
+            ++switches;
+        }
+        expected[w.address] = w.value;
+    }
+
+    EXPECT_GT(switches, 0) << "Consolidation should have occurred in-line";
+    EXPECT_EQ(inst.erase_invoke_count(), 0) << "Full erase should never have been needed";
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+    EXPECT_EQ(actual, expected) << "Readback after re-init did not match";
+}
+
+/**
+ * This test verifies that a power loss after any modification of the backing store recovers every write which had completed beforehand.
+ */
+TEST_F(WearLevelingDualBank, PowerLoss_AnyStep_RecoversLatestData) {
+    auto&     inst        = MockBackingStore::Instance();
+    const int write_count = 300;
+
+    // Determine how many modifications the scenario performs when power is never lost
+    std::uint32_t seed = 3;
+    for (int i = 0; i < write_count; ++i) {
+        auto w = scenario_step(seed);
+        wear_leveling_write(w.address, &w.value, 1);
+        wear_leveling_task();
+    }
+    const std::uint64_t total_modifications = inst.modification_count();
+
+    for (std::uint64_t cut = 0; cut < total_modifications; ++cut) {
+        inst.reset_instance();
+        wear_leveling_init();
+        inst.set_power_loss_after(cut);
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected{};
+        std::uint32_t                                        pending_address = UINT32_MAX;
+        std::uint8_t                                         pending_value   = 0;
+        seed                                                                 = 3;
+        for (int i = 0; i < write_count && !inst.power_lost(); ++i) {
+            auto w = scenario_step(seed);
+            wear_leveling_write(w.address, &w.value, 1);
+            if (inst.power_lost()) {
+                // The write in progress when power was lost may or may not have persisted
+                pending_address = w.address;
+                pending_value   = w.value;
+                break;
+            }
+            expected[w.address] = w.value;
+            wear_leveling_task();
+        }
+
+        inst.restore_power();
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status after power loss at modification " << cut;
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+        EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        for (std::uint32_t a = 0; a < WEAR_LEVELING_LOGICAL_SIZE; ++a) {
+            if (a == pending_address && actual[a] == pending_value) {
+                continue;
+            }
+            ASSERT_EQ(actual[a], expected[a]) << "Invalid readback at address " << a << " after power loss at modification " << cut;
+        }
+    }
+}
+
+/**
+ * This test verifies that data written without WEAR_LEVELING_DUAL_BANK is converted into a committed bank, including its write log, wherever it starts.
+ */
+TEST_F(WearLevelingDualBank, SingleBankData_Converted) {
+    auto& inst = MockBackingStore::Instance();
+    for (std::uint32_t bank_address : {(std::uint32_t)0, (std::uint32_t)(WEAR_LEVELING_BACKING_SIZE / 2)}) {
+        inst.reset_instance();
+        auto start = inst.storage_begin() + (bank_address / sizeof(backing_store_int_t));
+
+        // Consolidated data, followed by its FNV1a_64
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> expected;
+        std::iota(expected.begin(), expected.end(), 0x20);
+        for (std::size_t i = 0; i < expected.size(); i += 2) {
+            (start + (i / 2))->set(~(backing_store_int_t)(expected[i] | (expected[i + 1] << 8)));
+        }
+        write_log_entry_t checksum;
+        checksum.raw64 = fnv_64a_buf(expected.data(), expected.size(), FNV1A_64_INIT);
+        auto logstart  = start + (WEAR_LEVELING_LOGICAL_SIZE / sizeof(backing_store_int_t));
+        for (int i = 0; i < 4; ++i) {
+            (logstart + i)->set(~checksum.raw16[i]);
+        }
+
+        // Single-bank write log entries directly after the checksum, where a dual-bank sequence number would be
+        auto entry0 = LOG_ENTRY_MAKE_OPTIMIZED_64(0x01, 0x11);
+        (logstart + 4)->set(~entry0.raw16[0]);
+        expected[0x01] = 0x11;
+        auto entry1 = LOG_ENTRY_MAKE_OPTIMIZED_64(0x30, 0x12);
+        (logstart + 5)->set(~entry1.raw16[0]);
+        expected[0x30] = 0x12;
+
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> actual;
+        EXPECT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init failed converting data at " << bank_address;
+        EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        EXPECT_EQ(actual, expected) << "Converted data did not match for data at " << bank_address;
+        EXPECT_EQ(inst.erase_invoke_count(), 0) << "Full erase should not have been needed";
+
+        // Subsequent writes are logged against the converted bank, and survive re-init
+        std::uint8_t value = 0x13;
+        EXPECT_NE(wear_leveling_write(0x02, &value, 1), WEAR_LEVELING_FAILED) << "Write failed";
+        expected[0x02] = value;
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+        EXPECT_EQ(wear_leveling_read(0, actual.data(), actual.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        EXPECT_EQ(actual, expected) << "Readback after re-init did not match for data at " << bank_address;
+    }
+}
@@ -61,6 +61,11 @@
             to other subsystems performing reads/writes. This must be a multiple
             of the write size.
 
+        - WEAR_LEVELING_DUAL_BANK: Splits the backing store into two equally
+            sized banks, see "Dual-bank operation" below. Requires the backing
+            store to provide BACKING_STORE_SECTOR_SIZE and
+            backing_store_erase_sector().
+
     General algorithm:
 
         During initialization:
@@ -76,6 +81,51 @@
             * A new write log entry is appended to the log.
             * If the log's full, data is consolidated and the write log cleared.
 
+    Dual-bank operation:
+
+        Each bank is laid out identically to the single-bank backing store,
+        with an additional 8-byte sequence number following the FNV1a_64 hash.
+        The sequence number is stored as the value and its complement so that
+        an erased or partially-written sequence is never considered valid.
+        On startup, the valid bank with the newest sequence number is used.
+
+        Consolidation targets the standby bank and is split into small steps,
+        each performed by a single invocation of wear_leveling_task():
+            * Erase one sector of the standby bank.
+            * Copy one chunk of the cache into the standby bank.
+            * Write the FNV1a_64 hash, then the incremented sequence number,
+                which atomically switches the active bank.
+
+        Once copying has started, any writes are appended to the write logs of
+        both banks, so that data copied earlier is kept up to date. If power is
+        lost at any point before the sequence number is written, the previous
+        bank is still intact and remains active.
+
+        Background consolidation starts once the active write log has less
+        than WEAR_LEVELING_CONSOLIDATION_THRESHOLD bytes remaining. If the
+        write log fills before the steps have completed, the remaining steps
+        are performed in-line, as per the single-bank behaviour.
+
+    Checkpoints:
+
+        When WEAR_LEVELING_CHECKPOINTS is defined, startup no longer needs to
+        play back the entire write log. Checkpoints may only start at fixed
+        slots, every WEAR_LEVELING_CHECKPOINT_INTERVAL bytes into the write
+        log. The first log entry written at or beyond a slot is preceded by
+        padding up to the slot, followed by a checkpoint consisting of:
+            * A header, containing the number of snapshots and the location of
+                the previous checkpoint.
+            * A snapshot of each page of logical data which has been modified
+                since the previous checkpoint.
+            * A commit record, written last, such that a partially-written
+                checkpoint is never considered valid.
+
+        On startup, the last slot containing a valid checkpoint is located by
+        binary search. The chain of previous checkpoints is then followed to
+        restore the latest snapshot of each page, and only the write log after
+        the last checkpoint is played back. If no valid checkpoint is found,
+        the entire write log is played back as usual.
+
     Write log structure:
 
         The first 8 bytes of the write log are a FNV1a_64 hash of the contents
@@ -161,9 +211,37 @@
 static struct __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) {
     __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) uint8_t cache[(WEAR_LEVELING_LOGICAL_SIZE)];
     uint32_t                                                       write_address;
+    uint32_t                                                       bank_address;
     bool                                                           unlocked;
+#ifdef WEAR_LEVELING_DUAL_BANK
+    uint32_t sequence;
+    struct {
+        uint8_t  phase;
+        uint32_t offset;
+        uint32_t write_address;
+        uint64_t checksum;
+    } consolidation;
+#endif // WEAR_LEVELING_DUAL_BANK
+#ifdef WEAR_LEVELING_CHECKPOINTS
+    uint32_t checkpoint_address;
+    uint8_t  dirty_pages[((WEAR_LEVELING_CHECKPOINT_PAGES) + 7) / 8];
+#endif // WEAR_LEVELING_CHECKPOINTS
 } wear_leveling;
 
+#ifdef WEAR_LEVELING_DUAL_BANK
+/**
+ * Dual-bank consolidation phases, performed one step at a time.
+ */
+enum { CONSOLIDATION_IDLE, CONSOLIDATION_ERASING, CONSOLIDATION_COPYING, CONSOLIDATION_COMMITTING };
+
+/**
+ * Address of the bank not currently in use.
+ */
+static inline uint32_t wear_leveling_standby_bank(void) {
+    return (WEAR_LEVELING_BANK_SIZE) - wear_leveling.bank_address;
+}
+#endif // WEAR_LEVELING_DUAL_BANK
+
 /**
  * Locking helper: status
  */
@@ -202,18 +280,308 @@ static inline backing_store_lock_status_t wear_leveling_lock(void) {
  */
 static void wear_leveling_clear_cache(void) {
     memset(wear_leveling.cache, 0, (WEAR_LEVELING_LOGICAL_SIZE));
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 is due to the FNV1a_64 of the consolidated buffer
+    wear_leveling.write_address = wear_leveling.bank_address + (WEAR_LEVELING_LOG_START); // skips the FNV1a_64 of the consolidated buffer
+}
+
+#if defined(WEAR_LEVELING_DUAL_BANK) || defined(WEAR_LEVELING_CHECKPOINTS)
+/**
+ * Writes an 8-byte entry, such as a checksum or sequence number, to the backing store.
+ */
+static bool wear_leveling_write_entry(uint32_t address, write_log_entry_t *entry) {
+#    if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_write_bulk(address, entry->raw16, 4);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_write_bulk(address, entry->raw32, 2);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_write(address, entry->raw64);
+#    endif
+}
+
+/**
+ * Reads an 8-byte entry, such as a checksum or sequence number, from the backing store.
+ */
+static bool wear_leveling_read_entry(uint32_t address, write_log_entry_t *entry) {
+#    if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_read_bulk(address, entry->raw16, 4);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_read_bulk(address, entry->raw32, 2);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_read(address, &entry->raw64);
+#    endif
+}
+#endif // defined(WEAR_LEVELING_DUAL_BANK) || defined(WEAR_LEVELING_CHECKPOINTS)
+
+#ifdef WEAR_LEVELING_CHECKPOINTS
+/**
+ * Marks the checkpoint pages covering the supplied logical range as modified since the last checkpoint.
+ */
+static void wear_leveling_mark_dirty(uint32_t address, size_t length) {
+    for (uint32_t page = address / (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE); page <= (address + length - 1) / (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE); ++page) {
+        wear_leveling.dirty_pages[page / 8] |= (uint8_t)(1 << (page % 8));
+    }
+}
+
+/**
+ * Forgets any previous checkpoint, optionally also considering all pages unmodified.
+ */
+static void wear_leveling_checkpoint_reset(bool clear_dirty) {
+    wear_leveling.checkpoint_address = 0;
+    if (clear_dirty) {
+        memset(wear_leveling.dirty_pages, 0, sizeof(wear_leveling.dirty_pages));
+    }
+}
+
+/**
+ * Converts a backing store address into a location relative to the active bank, as stored in checkpoint records.
+ */
+static inline uint16_t wear_leveling_checkpoint_location(uint32_t address) {
+    return (uint16_t)((address - wear_leveling.bank_address) / (BACKING_STORE_WRITE_SIZE));
+}
+
+/**
+ * Computes the check value of a checkpoint record.
+ */
+static uint16_t wear_leveling_checkpoint_check(const write_log_entry_t *entry) {
+    uint64_t hash = fnv_64a_buf((void *)entry->raw8, 6, FNV1A_64_INIT);
+    return (uint16_t)(hash ^ (hash >> 16) ^ (hash >> 32) ^ (hash >> 48));
+}
+
+/**
+ * Writes a single-width extended entry, used for padding.
+ */
+static bool wear_leveling_write_padding(uint32_t address) {
+    write_log_entry_t entry = {.raw64 = 0};
+    entry.raw8[0]           = LOG_ENTRY_MAKE_EXTENDED_TAG(LOG_ENTRY_EXTENDED_PADDING);
+#    if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_write(address, entry.raw16[0]);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_write(address, entry.raw32[0]);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_write(address, entry.raw64);
+#    endif
+}
+
+/**
+ * Writes a checkpoint if the next write log entry would reach the next checkpoint slot.
+ *
+ * Checkpoints are always placed at a multiple of WEAR_LEVELING_CHECKPOINT_INTERVAL from the start of the write log, so
+ * that init can find the latest one without scanning the log. Each checkpoint contains snapshots of the pages modified
+ * since the previous checkpoint, and refers back to the previous checkpoint for older snapshots. The trailing commit
+ * record is written last, so an incomplete checkpoint is ignored.
+ *
+ * @param length[in] the size in bytes of the log entry about to be appended
+ */
+static wear_leveling_status_t wear_leveling_checkpoint_if_needed(size_t length) {
+#    ifdef WEAR_LEVELING_DUAL_BANK
+    // Pages modified while copying into the standby bank need to stay dirty for its first checkpoint
+    if (wear_leveling.consolidation.phase >= CONSOLIDATION_COPYING) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+#    endif // WEAR_LEVELING_DUAL_BANK
+
+    const uint32_t log_start = wear_leveling.bank_address + (WEAR_LEVELING_LOG_START);
+    const uint32_t offset    = wear_leveling.write_address - log_start;
+    uint32_t       slot      = ((offset + (WEAR_LEVELING_CHECKPOINT_INTERVAL)-1) / (WEAR_LEVELING_CHECKPOINT_INTERVAL)) * (WEAR_LEVELING_CHECKPOINT_INTERVAL);
+    if (slot == 0) {
+        slot = (WEAR_LEVELING_CHECKPOINT_INTERVAL);
+    }
+    if (offset + length <= slot) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    uint16_t snapshots = 0;
+    for (uint32_t page = 0; page < (WEAR_LEVELING_CHECKPOINT_PAGES); ++page) {
+        if (wear_leveling.dirty_pages[page / 8] & (1 << (page % 8))) {
+            ++snapshots;
+        }
+    }
+
+    // Skip this slot if the checkpoint is too large, or there's no room left in the log
+    const uint32_t size = (slot - offset) + 16 + snapshots * (8 + (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE));
+    if (size > (WEAR_LEVELING_CHECKPOINT_MAX_SIZE) || wear_leveling.write_address + size + length > wear_leveling.bank_address + (WEAR_LEVELING_BANK_SIZE)) {
+        wl_dprintf("Skipping checkpoint\n");
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    wl_dprintf("Writing checkpoint with %d snapshots\n", (int)snapshots);
+    while (wear_leveling.write_address < log_start + slot) {
+        if (!wear_leveling_write_padding(wear_leveling.write_address)) {
+            return WEAR_LEVELING_FAILED;
+        }
+        wear_leveling.write_address += (BACKING_STORE_WRITE_SIZE);
+    }
+
+    const uint32_t    checkpoint = wear_leveling.write_address;
+    write_log_entry_t entry      = {.raw64 = 0};
+    entry.raw8[0]                = LOG_ENTRY_MAKE_EXTENDED_TAG(LOG_ENTRY_EXTENDED_CHECKPOINT);
+    entry.raw16[1]               = snapshots;
+    entry.raw16[2]               = wear_leveling.checkpoint_address ? wear_leveling_checkpoint_location(wear_leveling.checkpoint_address) : 0;
+    entry.raw16[3]               = wear_leveling_checkpoint_check(&entry);
+    const uint16_t check         = entry.raw16[3];
+    if (!wear_leveling_write_entry(wear_leveling.write_address, &entry)) {
+        return WEAR_LEVELING_FAILED;
+    }
+    wear_leveling.write_address += 8;
+
+    for (uint16_t page = 0; page < (WEAR_LEVELING_CHECKPOINT_PAGES); ++page) {
+        if (!(wear_leveling.dirty_pages[page / 8] & (1 << (page % 8)))) {
+            continue;
+        }
+        entry.raw64    = 0;
+        entry.raw8[0]  = LOG_ENTRY_MAKE_EXTENDED_TAG(LOG_ENTRY_EXTENDED_SNAPSHOT);
+        entry.raw16[1] = page;
+        entry.raw16[2] = (uint16_t)~page;
+        if (!wear_leveling_write_entry(wear_leveling.write_address, &entry)) {
+            return WEAR_LEVELING_FAILED;
+        }
+        wear_leveling.write_address += 8;
+        if (!backing_store_write_bulk(wear_leveling.write_address, (backing_store_int_t *)&wear_leveling.cache[page * (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE)], (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE) / sizeof(backing_store_int_t))) {
+            return WEAR_LEVELING_FAILED;
+        }
+        wear_leveling.write_address += (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE);
+    }
+
+    entry.raw64    = 0;
+    entry.raw8[0]  = LOG_ENTRY_MAKE_EXTENDED_TAG(LOG_ENTRY_EXTENDED_COMMIT);
+    entry.raw16[1] = wear_leveling_checkpoint_location(checkpoint);
+    entry.raw16[2] = (uint16_t)~entry.raw16[1];
+    entry.raw16[3] = check;
+    if (!wear_leveling_write_entry(wear_leveling.write_address, &entry)) {
+        return WEAR_LEVELING_FAILED;
+    }
+    wear_leveling.write_address += 8;
+
+    wear_leveling.checkpoint_address = checkpoint;
+    memset(wear_leveling.dirty_pages, 0, sizeof(wear_leveling.dirty_pages));
+    return WEAR_LEVELING_SUCCESS;
+}
+
+/**
+ * Reads and validates the checkpoint at the supplied address.
+ *
+ * @param snapshots[out] the number of page snapshots in the checkpoint
+ * @param previous[out] the address of the previous checkpoint, or zero if none
+ * @param end[out] the address immediately following the checkpoint
+ * @return true if a complete checkpoint is present
+ */
+static bool wear_leveling_checkpoint_read(uint32_t address, uint16_t *snapshots, uint32_t *previous, uint32_t *end) {
+    write_log_entry_t checkpoint;
+    if (!wear_leveling_read_entry(address, &checkpoint)) {
+        return false;
+    }
+    if (checkpoint.raw8[0] != LOG_ENTRY_MAKE_EXTENDED_TAG(LOG_ENTRY_EXTENDED_CHECKPOINT) || checkpoint.raw8[1] != 0 || checkpoint.raw16[3] != wear_leveling_checkpoint_check(&checkpoint)) {
+        return false;
+    }
+
+    const uint32_t commit_address = address + 8 + checkpoint.raw16[1] * (8 + (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE));
+    if (commit_address + 8 > wear_leveling.bank_address + (WEAR_LEVELING_BANK_SIZE)) {
+        return false;
+    }
+
+    write_log_entry_t commit;
+    if (!wear_leveling_read_entry(commit_address, &commit)) {
+        return false;
+    }
+    const uint16_t location = wear_leveling_checkpoint_location(address);
+    if (commit.raw8[0] != LOG_ENTRY_MAKE_EXTENDED_TAG(LOG_ENTRY_EXTENDED_COMMIT) || commit.raw16[1] != location || commit.raw16[2] != (uint16_t)~location || commit.raw16[3] != checkpoint.raw16[3]) {
+        return false;
+    }
+
+    *snapshots = checkpoint.raw16[1];
+    *previous  = checkpoint.raw16[2] ? wear_leveling.bank_address + checkpoint.raw16[2] * (BACKING_STORE_WRITE_SIZE) : 0;
+    *end       = commit_address + 8;
+    return true;
+}
+
+/**
+ * Restores the cache from the latest checkpoint, on top of the consolidated data already in the cache.
+ *
+ * @param playback_address[out] the address from which the write log should be played back
+ * @return false if a checkpoint was found but could not be restored
+ */
+static bool wear_leveling_checkpoint_restore(uint32_t *playback_address) {
+    const uint32_t log_start = wear_leveling.bank_address + (WEAR_LEVELING_LOG_START);
+    *playback_address        = log_start;
+
+    // Binary search for the last slot containing a checkpoint -- slots are filled in order as the log grows
+    uint16_t snapshots;
+    uint32_t previous;
+    uint32_t end;
+    uint32_t lo = 0;
+    uint32_t hi = ((WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_START)-16) / (WEAR_LEVELING_CHECKPOINT_INTERVAL);
+    while (lo < hi) {
+        uint32_t mid = (lo + hi + 1) / 2;
+        if (wear_leveling_checkpoint_read(log_start + mid * (WEAR_LEVELING_CHECKPOINT_INTERVAL), &snapshots, &previous, &end)) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (lo == 0) {
+        wl_dprintf("No checkpoint found\n");
+        return true;
+    }
+
+    // Walk back through the checkpoints, restoring the newest snapshot of each page
+    uint8_t  restored[((WEAR_LEVELING_CHECKPOINT_PAGES) + 7) / 8] = {0};
+    uint32_t checkpoint                                           = log_start + lo * (WEAR_LEVELING_CHECKPOINT_INTERVAL);
+    wl_dprintf("Restoring checkpoint at 0x%04X\n", (int)checkpoint);
+    wear_leveling_checkpoint_read(checkpoint, &snapshots, &previous, &end);
+    wear_leveling.checkpoint_address = checkpoint;
+    *playback_address                = end;
+    while (true) {
+        uint32_t address = checkpoint + 8;
+        for (uint16_t i = 0; i < snapshots; ++i) {
+            write_log_entry_t entry;
+            if (!wear_leveling_read_entry(address, &entry)) {
+                return false;
+            }
+            const uint16_t page = entry.raw16[1];
+            if (entry.raw8[0] != LOG_ENTRY_MAKE_EXTENDED_TAG(LOG_ENTRY_EXTENDED_SNAPSHOT) || entry.raw16[2] != (uint16_t)~page || page >= (WEAR_LEVELING_CHECKPOINT_PAGES)) {
+                return false;
+            }
+            if (!(restored[page / 8] & (1 << (page % 8)))) {
+                if (!backing_store_read_bulk(address + 8, (backing_store_int_t *)&wear_leveling.cache[page * (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE)], (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE) / sizeof(backing_store_int_t))) {
+                    return false;
+                }
+                restored[page / 8] |= (uint8_t)(1 << (page % 8));
+            }
+            address += 8 + (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE);
+        }
+
+        if (previous == 0) {
+            break;
+        }
+        checkpoint = previous;
+        if (!wear_leveling_checkpoint_read(checkpoint, &snapshots, &previous, &end)) {
+            return false;
+        }
+    }
+
+    return true;
 }
+#else  // WEAR_LEVELING_CHECKPOINTS
+#    define wear_leveling_mark_dirty(address, length) \
+        do {                                          \
+        } while (0)
+#    define wear_leveling_checkpoint_reset(clear_dirty) \
+        do {                                            \
+        } while (0)
+#    define wear_leveling_checkpoint_if_needed(length) (WEAR_LEVELING_SUCCESS)
+#endif // WEAR_LEVELING_CHECKPOINTS
 
 /**
- * Reads the consolidated data from the backing store into the cache.
+ * Reads the consolidated data of the supplied bank from the backing store into the cache.
  * Does not consider the write log.
+ *
+ * @param verified[out] whether the FNV1a_64 of the consolidated data matched
  */
-static wear_leveling_status_t wear_leveling_read_consolidated(void) {
+static wear_leveling_status_t wear_leveling_read_consolidated(uint32_t bank_address, bool *verified) {
     wl_dprintf("Reading consolidated data\n");
 
+    *verified                     = false;
     wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
-    if (!backing_store_read_bulk(0, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
+    if (!backing_store_read_bulk(bank_address, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
         wl_dprintf("Failed to read from backing store\n");
         status = WEAR_LEVELING_FAILED;
     }
@@ -224,16 +592,17 @@ static wear_leveling_status_t wear_leveling_read_consolidated(void) {
         write_log_entry_t entry;
         wl_dprintf("Reading checksum\n");
 #if BACKING_STORE_WRITE_SIZE == 2
-        backing_store_read_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4);
+        backing_store_read_bulk(bank_address + (WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4);
 #elif BACKING_STORE_WRITE_SIZE == 4
-        backing_store_read_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2);
+        backing_store_read_bulk(bank_address + (WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2);
 #elif BACKING_STORE_WRITE_SIZE == 8
-        backing_store_read((WEAR_LEVELING_LOGICAL_SIZE) + 0, &entry.raw64);
+        backing_store_read(bank_address + (WEAR_LEVELING_LOGICAL_SIZE) + 0, &entry.raw64);
 #endif
         // If we have a mismatch, clear the cache but do not flag a failure,
         // which will cater for the completely clean MCU case.
         if (entry.raw64 == expected) {
             wl_dprintf("Checksum matches, consolidated data is correct\n");
+            *verified = true;
         } else {
             wl_dprintf("Checksum mismatch, clearing cache\n");
             wear_leveling_clear_cache();
@@ -248,6 +617,164 @@ static wear_leveling_status_t wear_leveling_read_consolidated(void) {
     return status;
 }
 
+/**
+ * Plays back write log entries into the cache, stopping at the first empty slot.
+ *
+ * @param address_ptr[in,out] the address of the first entry, updated to the address following the last entry
+ * @param end the address at which playback stops
+ */
+static wear_leveling_status_t wear_leveling_playback_entries(uint32_t *address_ptr, uint32_t end) {
+    wear_leveling_status_t status          = WEAR_LEVELING_SUCCESS;
+    bool                   cancel_playback = false;
+    uint32_t               address         = *address_ptr;
+
+    while (!cancel_playback && address < end) {
+        backing_store_int_t value;
+        bool                ok = backing_store_read(address, &value);
+        if (!ok) {
+            wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
+            cancel_playback = true;
+            status          = WEAR_LEVELING_FAILED;
+            break;
+        }
+        if (value == 0) {
+            wl_dprintf("Found empty slot, no more log entries\n");
+            cancel_playback = true;
+            break;
+        }
+
+        // If we got a nonzero value, then we need to increment the address to ensure next write occurs at next location
+        address += (BACKING_STORE_WRITE_SIZE);
+
+        // Read from the write log
+        write_log_entry_t log;
+#if BACKING_STORE_WRITE_SIZE == 2
+        log.raw16[0] = value;
+#elif BACKING_STORE_WRITE_SIZE == 4
+        log.raw32[0] = value;
+#elif BACKING_STORE_WRITE_SIZE == 8
+        log.raw64 = value;
+#endif
+
+        switch (LOG_ENTRY_GET_TYPE(log)) {
+            case LOG_ENTRY_TYPE_MULTIBYTE: {
+#if BACKING_STORE_WRITE_SIZE == 2
+                ok = backing_store_read(address, &log.raw16[1]);
+                if (!ok) {
+                    wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
+                    cancel_playback = true;
+                    status          = WEAR_LEVELING_FAILED;
+                    break;
+                }
+                address += (BACKING_STORE_WRITE_SIZE);
+#endif // BACKING_STORE_WRITE_SIZE == 2
+                const uint32_t a = LOG_ENTRY_MULTIBYTE_GET_ADDRESS(log);
+                const uint8_t  l = LOG_ENTRY_MULTIBYTE_GET_LENGTH(log);
+
+                if (a + l > (WEAR_LEVELING_LOGICAL_SIZE)) {
+                    cancel_playback = true;
+                    status          = WEAR_LEVELING_FAILED;
+                    break;
+                }
+
+#if BACKING_STORE_WRITE_SIZE == 2
+                if (l > 1) {
+                    ok = backing_store_read(address, &log.raw16[2]);
+                    if (!ok) {
+                        wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
+                        cancel_playback = true;
+                        status          = WEAR_LEVELING_FAILED;
+                        break;
+                    }
+                    address += (BACKING_STORE_WRITE_SIZE);
+                }
+                if (l > 3) {
+                    ok = backing_store_read(address, &log.raw16[3]);
+                    if (!ok) {
+                        wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
+                        cancel_playback = true;
+                        status          = WEAR_LEVELING_FAILED;
+                        break;
+                    }
+                    address += (BACKING_STORE_WRITE_SIZE);
+                }
+#elif BACKING_STORE_WRITE_SIZE == 4
+                if (l > 1) {
+                    ok = backing_store_read(address, &log.raw32[1]);
+                    if (!ok) {
+                        wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
+                        cancel_playback = true;
+                        status          = WEAR_LEVELING_FAILED;
+                        break;
+                    }
+                    address += (BACKING_STORE_WRITE_SIZE);
+                }
+#endif
+
+                memcpy(&wear_leveling.cache[a], &log.raw8[3], l);
+                wear_leveling_mark_dirty(a, l);
+            } break;
+#if BACKING_STORE_WRITE_SIZE == 2
+            case LOG_ENTRY_TYPE_OPTIMIZED_64: {
+                const uint32_t a = LOG_ENTRY_OPTIMIZED_64_GET_ADDRESS(log);
+                const uint8_t  v = LOG_ENTRY_OPTIMIZED_64_GET_VALUE(log);
+
+                if (a >= (WEAR_LEVELING_LOGICAL_SIZE)) {
+                    cancel_playback = true;
+                    status          = WEAR_LEVELING_FAILED;
+                    break;
+                }
+
+                wear_leveling.cache[a] = v;
+                wear_leveling_mark_dirty(a, 1);
+            } break;
+            case LOG_ENTRY_TYPE_WORD_01: {
+                const uint32_t a = LOG_ENTRY_WORD_01_GET_ADDRESS(log);
+                const uint8_t  v = LOG_ENTRY_WORD_01_GET_VALUE(log);
+
+                if (a + 1 >= (WEAR_LEVELING_LOGICAL_SIZE)) {
+                    cancel_playback = true;
+                    status          = WEAR_LEVELING_FAILED;
+                    break;
+                }
+
+                wear_leveling.cache[a + 0] = v;
+                wear_leveling.cache[a + 1] = 0;
+                wear_leveling_mark_dirty(a, 2);
+            } break;
+#endif // BACKING_STORE_WRITE_SIZE == 2
+#ifdef WEAR_LEVELING_CHECKPOINTS
+            case LOG_ENTRY_TYPE_EXTENDED: {
+                // Checkpoints have already been restored, or are older than the restored checkpoint, so skip over them
+                switch (LOG_ENTRY_EXTENDED_GET_SUBTYPE(log)) {
+                    case LOG_ENTRY_EXTENDED_PADDING:
+                        break;
+                    case LOG_ENTRY_EXTENDED_CHECKPOINT:
+                    case LOG_ENTRY_EXTENDED_COMMIT:
+                        address += 8 - (BACKING_STORE_WRITE_SIZE);
+                        break;
+                    case LOG_ENTRY_EXTENDED_SNAPSHOT:
+                        address += 8 - (BACKING_STORE_WRITE_SIZE) + (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE);
+                        break;
+                    default:
+                        cancel_playback = true;
+                        status          = WEAR_LEVELING_FAILED;
+                        break;
+                }
+            } break;
+#endif // WEAR_LEVELING_CHECKPOINTS
+            default: {
+                cancel_playback = true;
+                status          = WEAR_LEVELING_FAILED;
+            } break;
+        }
+    }
+
+    *address_ptr = address;
+    return status;
+}
+
+#ifndef WEAR_LEVELING_DUAL_BANK
 /**
  * Writes the current cache to consolidated data at the beginning of the backing store.
  * Does not clear the write log.
@@ -316,11 +843,200 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
     }
 
     // Next write of the log occurs after the consolidated values at the start of the backing store.
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+    wear_leveling.write_address = (WEAR_LEVELING_LOG_START); // skips the FNV1a_64 of the consolidated area
+    wear_leveling_checkpoint_reset(true);
+
+    return status;
+}
+#else  // WEAR_LEVELING_DUAL_BANK
+/**
+ * Reads the sequence number of the supplied bank.
+ *
+ * @return true if the bank has been committed with a valid sequence number
+ */
+static bool wear_leveling_read_sequence(uint32_t bank_address, uint32_t *sequence) {
+    write_log_entry_t entry;
+    if (!wear_leveling_read_entry(bank_address + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &entry)) {
+        return false;
+    }
+    *sequence = entry.raw32[0];
+    return entry.raw32[1] == ~entry.raw32[0];
+}
+
+/**
+ * Performs a single step of consolidation into the standby bank.
+ * The active bank is not modified, so a power loss at any point leaves the previous data intact.
+ *
+ * @return WEAR_LEVELING_CONSOLIDATED once the banks have been switched
+ */
+static wear_leveling_status_t wear_leveling_consolidation_step(void) {
+    const uint32_t standby = wear_leveling_standby_bank();
+    switch (wear_leveling.consolidation.phase) {
+        case CONSOLIDATION_ERASING: {
+            if (!backing_store_erase_sector(standby + wear_leveling.consolidation.offset)) {
+                wl_dprintf("Failed to erase standby bank\n");
+                break;
+            }
+            wear_leveling.consolidation.offset += (BACKING_STORE_SECTOR_SIZE);
+            if (wear_leveling.consolidation.offset >= (WEAR_LEVELING_BANK_SIZE)) {
+                wear_leveling.consolidation.phase         = CONSOLIDATION_COPYING;
+                wear_leveling.consolidation.offset        = 0;
+                wear_leveling.consolidation.write_address = standby + (WEAR_LEVELING_LOG_START);
+                wear_leveling.consolidation.checksum      = FNV1A_64_INIT;
+            }
+            return WEAR_LEVELING_SUCCESS;
+        }
+
+        case CONSOLIDATION_COPYING: {
+            const uint32_t offset = wear_leveling.consolidation.offset;
+            const uint32_t length = ((WEAR_LEVELING_LOGICAL_SIZE) - offset) < (WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE) ? ((WEAR_LEVELING_LOGICAL_SIZE) - offset) : (WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE);
+            if (!backing_store_write_bulk(standby + offset, (backing_store_int_t *)&wear_leveling.cache[offset], length / sizeof(backing_store_int_t))) {
+                wl_dprintf("Failed to write consolidated data to standby bank\n");
+                break;
+            }
+            // The checksum covers exactly what was copied -- later changes are picked up by the standby bank's write log
+            wear_leveling.consolidation.checksum = fnv_64a_buf(&wear_leveling.cache[offset], length, wear_leveling.consolidation.checksum);
+            wear_leveling.consolidation.offset += length;
+            if (wear_leveling.consolidation.offset >= (WEAR_LEVELING_LOGICAL_SIZE)) {
+                wear_leveling.consolidation.phase = CONSOLIDATION_COMMITTING;
+            }
+            return WEAR_LEVELING_SUCCESS;
+        }
+
+        case CONSOLIDATION_COMMITTING: {
+            write_log_entry_t entry;
+            entry.raw64 = wear_leveling.consolidation.checksum;
+            if (!wear_leveling_write_entry(standby + (WEAR_LEVELING_LOGICAL_SIZE), &entry)) {
+                wl_dprintf("Failed to write checksum to standby bank\n");
+                break;
+            }
 
+            // Writing the sequence number is what makes the standby bank valid, so it must be last
+            const uint32_t sequence = wear_leveling.sequence + 1;
+            entry.raw32[0]          = sequence;
+            entry.raw32[1]          = ~sequence;
+            if (!wear_leveling_write_entry(standby + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &entry)) {
+                wl_dprintf("Failed to write sequence number to standby bank\n");
+                break;
+            }
+
+            wl_dprintf("Switched to bank at 0x%04X\n", (int)standby);
+            wear_leveling.bank_address        = standby;
+            wear_leveling.sequence            = sequence;
+            wear_leveling.write_address       = wear_leveling.consolidation.write_address;
+            wear_leveling.consolidation.phase = CONSOLIDATION_IDLE;
+            // Pages modified since copying started are still marked as dirty, so only the checkpoint chain is reset
+            wear_leveling_checkpoint_reset(false);
+            return WEAR_LEVELING_CONSOLIDATED;
+        }
+
+        default:
+            return WEAR_LEVELING_SUCCESS;
+    }
+
+    // Any failure leaves the standby bank in an unknown state, so the next attempt needs to start from scratch
+    wear_leveling.consolidation.phase = CONSOLIDATION_IDLE;
+    return WEAR_LEVELING_FAILED;
+}
+
+/**
+ * Completes consolidation into the standby bank in-line.
+ * The active bank is left untouched until the switch occurs, so there is no potential for data loss if a power loss occurs.
+ */
+static wear_leveling_status_t wear_leveling_consolidate_force(void) {
+    wl_dprintf("Consolidating into standby bank\n");
+
+    // Anything already copied may be missing a partially-appended log entry, so start again unless only erasure has occurred
+    if (wear_leveling.consolidation.phase != CONSOLIDATION_ERASING) {
+        wear_leveling.consolidation.phase  = CONSOLIDATION_ERASING;
+        wear_leveling.consolidation.offset = 0;
+    }
+
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    wear_leveling_status_t      status      = WEAR_LEVELING_SUCCESS;
+    while (status == WEAR_LEVELING_SUCCESS) {
+        status = wear_leveling_consolidation_step();
+    }
+
+    if (lock_status == STATUS_SUCCESS) {
+        wear_leveling_lock();
+    }
     return status;
 }
 
+/**
+ * Determines which bank holds the latest data, reading its consolidated data into the cache.
+ * Does not consider the write log.
+ */
+static wear_leveling_status_t wear_leveling_select_bank(void) {
+    uint32_t sequence[2];
+    bool     valid[2];
+    for (int i = 0; i < 2; ++i) {
+        valid[i] = wear_leveling_read_sequence(i * (WEAR_LEVELING_BANK_SIZE), &sequence[i]);
+    }
+
+    // Try the newest bank first, then fall back to the other if its consolidated data is corrupt
+    const int newest = (valid[1] && (!valid[0] || (int32_t)(sequence[1] - sequence[0]) > 0)) ? 1 : 0;
+    for (int i = 0; i < 2; ++i) {
+        const int bank = (i == 0) ? newest : (1 - newest);
+        if (!valid[bank]) {
+            continue;
+        }
+
+        bool                   verified;
+        wear_leveling_status_t status = wear_leveling_read_consolidated(bank * (WEAR_LEVELING_BANK_SIZE), &verified);
+        if (status == WEAR_LEVELING_FAILED) {
+            return status;
+        }
+        if (verified) {
+            wl_dprintf("Using bank at 0x%04X\n", (int)(bank * (WEAR_LEVELING_BANK_SIZE)));
+            wear_leveling.bank_address = bank * (WEAR_LEVELING_BANK_SIZE);
+            wear_leveling.sequence     = sequence[bank];
+            return WEAR_LEVELING_SUCCESS;
+        }
+    }
+
+    // Without a committed bank, verified consolidated data was written either by a build without WEAR_LEVELING_DUAL_BANK,
+    // or by an interrupted first commit -- which always targets the second bank, leaving the first with its write log.
+    for (int bank = 0; bank < 2; ++bank) {
+        bool                   verified;
+        wear_leveling_status_t status = wear_leveling_read_consolidated(bank * (WEAR_LEVELING_BANK_SIZE), &verified);
+        if (status == WEAR_LEVELING_FAILED) {
+            return status;
+        }
+        if (!verified) {
+            continue;
+        }
+
+        if (bank == 1) {
+            backing_store_int_t value;
+            if (!backing_store_read((WEAR_LEVELING_LOG_START), &value)) {
+                return WEAR_LEVELING_FAILED;
+            }
+            if (value != 0) {
+                break;
+            }
+        }
+
+        // The single-bank write log follows the checksum, and may run on into the other bank -- so only replace it once
+        // it's all in the cache
+        wl_dprintf("Converting single-bank data at 0x%04X\n", (int)(bank * (WEAR_LEVELING_BANK_SIZE)));
+        wear_leveling.bank_address = bank * (WEAR_LEVELING_BANK_SIZE);
+        wear_leveling.sequence     = 0;
+        uint32_t address           = wear_leveling.bank_address + (WEAR_LEVELING_LOGICAL_SIZE) + 8;
+        wear_leveling_playback_entries(&address, WEAR_LEVELING_BACKING_SIZE);
+        return wear_leveling_consolidate_force();
+    }
+
+    // Nothing has been committed yet, so treat the first bank as active with an empty consolidated area
+    wl_dprintf("No valid bank found, using first bank\n");
+    wear_leveling.bank_address = 0;
+    wear_leveling.sequence     = valid[newest] ? sequence[newest] : 0;
+    wear_leveling_clear_cache();
+    return WEAR_LEVELING_SUCCESS;
+}
+#endif // WEAR_LEVELING_DUAL_BANK
+
 /**
  * Potential write of the current cache to the backing store.
  * Skipped if the current write log position is not at the end of the backing store.
@@ -329,7 +1045,7 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
  * @return true if consolidation occurred
  */
 static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
-    if (wear_leveling.write_address >= (WEAR_LEVELING_BACKING_SIZE)) {
+    if (wear_leveling.write_address >= wear_leveling.bank_address + (WEAR_LEVELING_BANK_SIZE)) {
         return wear_leveling_consolidate_force();
     }
 
@@ -348,6 +1064,19 @@ static wear_leveling_status_t wear_leveling_append_raw(backing_store_int_t value
         return WEAR_LEVELING_FAILED;
     }
     wear_leveling.write_address += (BACKING_STORE_WRITE_SIZE);
+
+#ifdef WEAR_LEVELING_DUAL_BANK
+    // Once copying has started, the standby bank's write log needs to track any changes to data that was already copied
+    if (wear_leveling.consolidation.phase >= CONSOLIDATION_COPYING) {
+        if (wear_leveling.consolidation.write_address < wear_leveling_standby_bank() + (WEAR_LEVELING_BANK_SIZE) && backing_store_write(wear_leveling.consolidation.write_address, value)) {
+            wear_leveling.consolidation.write_address += (BACKING_STORE_WRITE_SIZE);
+        } else {
+            wl_dprintf("Failed to write to standby bank, restarting consolidation\n");
+            wear_leveling.consolidation.phase = CONSOLIDATION_IDLE;
+        }
+    }
+#endif // WEAR_LEVELING_DUAL_BANK
+
     return wear_leveling_consolidate_if_needed();
 }
 
@@ -363,8 +1092,19 @@ static wear_leveling_status_t wear_leveling_write_raw_multibyte(uint32_t address
         log.raw8[3 + i] = p[i];
     }
 
+    // Make sure the entry isn't split by a checkpoint
+#if BACKING_STORE_WRITE_SIZE == 2
+    wear_leveling_status_t status = wear_leveling_checkpoint_if_needed((2 + (length > 1) + (length > 3)) * (BACKING_STORE_WRITE_SIZE));
+#elif BACKING_STORE_WRITE_SIZE == 4
+    wear_leveling_status_t status = wear_leveling_checkpoint_if_needed((1 + (length > 1)) * (BACKING_STORE_WRITE_SIZE));
+#elif BACKING_STORE_WRITE_SIZE == 8
+    wear_leveling_status_t status = wear_leveling_checkpoint_if_needed(BACKING_STORE_WRITE_SIZE);
+#endif
+    if (status != WEAR_LEVELING_SUCCESS) {
+        return status;
+    }
+
     // Write to the backing store. See the multi-byte log format in the documentation header at the top of the file.
-    wear_leveling_status_t status;
 #if BACKING_STORE_WRITE_SIZE == 2
     status = wear_leveling_append_raw(log.raw16[0]);
     if (status != WEAR_LEVELING_SUCCESS) {
@@ -424,7 +1164,11 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
             const uint16_t v = ((uint16_t)p[1]) << 8 | p[0]; // don't just dereference a uint16_t here -- if unaligned it generates faults on some MCUs
             if (v == 0 || v == 1) {
                 const write_log_entry_t log = LOG_ENTRY_MAKE_WORD_01(address, v);
-                status                      = wear_leveling_append_raw(log.raw16[0]);
+                status                      = wear_leveling_checkpoint_if_needed(BACKING_STORE_WRITE_SIZE);
+                if (status != WEAR_LEVELING_SUCCESS) {
+                    return status;
+                }
+                status = wear_leveling_append_raw(log.raw16[0]);
                 if (status != WEAR_LEVELING_SUCCESS) {
                     // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
                     // If a failure occurred, pass it on.
@@ -441,7 +1185,11 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
         // Small-write optimizations - address<64:
         if (address < 64) {
             const write_log_entry_t log = LOG_ENTRY_MAKE_OPTIMIZED_64(address, *p);
-            status                      = wear_leveling_append_raw(log.raw16[0]);
+            status                      = wear_leveling_checkpoint_if_needed(BACKING_STORE_WRITE_SIZE);
+            if (status != WEAR_LEVELING_SUCCESS) {
+                return status;
+            }
+            status = wear_leveling_append_raw(log.raw16[0]);
             if (status != WEAR_LEVELING_SUCCESS) {
                 // If consolidation occurred, then the cache has already been written to the consolidated area. No need to continue.
                 // If a failure occurred, pass it on.
@@ -477,125 +1225,25 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
 
     wear_leveling_status_t status          = WEAR_LEVELING_SUCCESS;
     bool                   cancel_playback = false;
-    uint32_t               address         = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
-    while (!cancel_playback && address < (WEAR_LEVELING_BACKING_SIZE)) {
-        backing_store_int_t value;
-        bool                ok = backing_store_read(address, &value);
-        if (!ok) {
-            wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
+    uint32_t               address         = wear_leveling.bank_address + (WEAR_LEVELING_LOG_START); // skips the FNV1a_64 of the consolidated area
+
+#ifdef WEAR_LEVELING_CHECKPOINTS
+    // Start from the latest checkpoint if there is one, so that only the tail of the log needs to be played back
+    wear_leveling_checkpoint_reset(true);
+    if (!wear_leveling_checkpoint_restore(&address)) {
+        wl_dprintf("Failed to restore checkpoint, playing back entire write log\n");
+        bool verified;
+        wear_leveling_checkpoint_reset(true);
+        status  = wear_leveling_read_consolidated(wear_leveling.bank_address, &verified);
+        address = wear_leveling.bank_address + (WEAR_LEVELING_LOG_START);
+        if (status == WEAR_LEVELING_FAILED) {
             cancel_playback = true;
-            status          = WEAR_LEVELING_FAILED;
-            break;
-        }
-        if (value == 0) {
-            wl_dprintf("Found empty slot, no more log entries\n");
-            cancel_playback = true;
-            break;
-        }
-
-        // If we got a nonzero value, then we need to increment the address to ensure next write occurs at next location
-        address += (BACKING_STORE_WRITE_SIZE);
-
-        // Read from the write log
-        write_log_entry_t log;
-#if BACKING_STORE_WRITE_SIZE == 2
-        log.raw16[0] = value;
-#elif BACKING_STORE_WRITE_SIZE == 4
-        log.raw32[0] = value;
-#elif BACKING_STORE_WRITE_SIZE == 8
-        log.raw64 = value;
-#endif
-
-        switch (LOG_ENTRY_GET_TYPE(log)) {
-            case LOG_ENTRY_TYPE_MULTIBYTE: {
-#if BACKING_STORE_WRITE_SIZE == 2
-                ok = backing_store_read(address, &log.raw16[1]);
-                if (!ok) {
-                    wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
-                    cancel_playback = true;
-                    status          = WEAR_LEVELING_FAILED;
-                    break;
-                }
-                address += (BACKING_STORE_WRITE_SIZE);
-#endif // BACKING_STORE_WRITE_SIZE == 2
-                const uint32_t a = LOG_ENTRY_MULTIBYTE_GET_ADDRESS(log);
-                const uint8_t  l = LOG_ENTRY_MULTIBYTE_GET_LENGTH(log);
-
-                if (a + l > (WEAR_LEVELING_LOGICAL_SIZE)) {
-                    cancel_playback = true;
-                    status          = WEAR_LEVELING_FAILED;
-                    break;
-                }
-
-#if BACKING_STORE_WRITE_SIZE == 2
-                if (l > 1) {
-                    ok = backing_store_read(address, &log.raw16[2]);
-                    if (!ok) {
-                        wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
-                        cancel_playback = true;
-                        status          = WEAR_LEVELING_FAILED;
-                        break;
-                    }
-                    address += (BACKING_STORE_WRITE_SIZE);
-                }
-                if (l > 3) {
-                    ok = backing_store_read(address, &log.raw16[3]);
-                    if (!ok) {
-                        wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
-                        cancel_playback = true;
-                        status          = WEAR_LEVELING_FAILED;
-                        break;
-                    }
-                    address += (BACKING_STORE_WRITE_SIZE);
-                }
-#elif BACKING_STORE_WRITE_SIZE == 4
-                if (l > 1) {
-                    ok = backing_store_read(address, &log.raw32[1]);
-                    if (!ok) {
-                        wl_dprintf("Failed to load from backing store, skipping playback of write log\n");
-                        cancel_playback = true;
-                        status = WEAR_LEVELING_FAILED;
-                        break;
-                    }
-                    address += (BACKING_STORE_WRITE_SIZE);
-                }
-#endif
-
-                memcpy(&wear_leveling.cache[a], &log.raw8[3], l);
-            } break;
-#if BACKING_STORE_WRITE_SIZE == 2
-            case LOG_ENTRY_TYPE_OPTIMIZED_64: {
-                const uint32_t a = LOG_ENTRY_OPTIMIZED_64_GET_ADDRESS(log);
-                const uint8_t  v = LOG_ENTRY_OPTIMIZED_64_GET_VALUE(log);
-
-                if (a >= (WEAR_LEVELING_LOGICAL_SIZE)) {
-                    cancel_playback = true;
-                    status          = WEAR_LEVELING_FAILED;
-                    break;
-                }
-
-                wear_leveling.cache[a] = v;
-            } break;
-            case LOG_ENTRY_TYPE_WORD_01: {
-                const uint32_t a = LOG_ENTRY_WORD_01_GET_ADDRESS(log);
-                const uint8_t  v = LOG_ENTRY_WORD_01_GET_VALUE(log);
-
-                if (a + 1 >= (WEAR_LEVELING_LOGICAL_SIZE)) {
-                    cancel_playback = true;
-                    status          = WEAR_LEVELING_FAILED;
-                    break;
-                }
-
-                wear_leveling.cache[a + 0] = v;
-                wear_leveling.cache[a + 1] = 0;
-            } break;
-#endif // BACKING_STORE_WRITE_SIZE == 2
-            default: {
-                cancel_playback = true;
-                status          = WEAR_LEVELING_FAILED;
-            } break;
         }
     }
+#endif // WEAR_LEVELING_CHECKPOINTS
+    if (!cancel_playback) {
+        status = wear_leveling_playback_entries(&address, wear_leveling.bank_address + (WEAR_LEVELING_BANK_SIZE));
+    }
 
     // We've reached the end of the log, so we're at the new write location
     wear_leveling.write_address = address;
@@ -618,6 +1266,11 @@ wear_leveling_status_t wear_leveling_init(void) {
     wl_dprintf("Init\n");
 
     // Reset the cache
+    wear_leveling.bank_address = 0;
+#ifdef WEAR_LEVELING_DUAL_BANK
+    wear_leveling.sequence            = 0;
+    wear_leveling.consolidation.phase = CONSOLIDATION_IDLE;
+#endif // WEAR_LEVELING_DUAL_BANK
     wear_leveling_clear_cache();
 
     // Initialise the backing store
@@ -628,7 +1281,12 @@ wear_leveling_status_t wear_leveling_init(void) {
     }
 
     // Read the previous consolidated values, then replay the existing write log so that the cache has the "live" values
-    wear_leveling_status_t status = wear_leveling_read_consolidated();
+#ifdef WEAR_LEVELING_DUAL_BANK
+    wear_leveling_status_t status = wear_leveling_select_bank();
+#else
+    bool                   verified;
+    wear_leveling_status_t status = wear_leveling_read_consolidated(0, &verified);
+#endif // WEAR_LEVELING_DUAL_BANK
     if (status == WEAR_LEVELING_FAILED) {
         // If it failed, clear the cache and return with failure
         wear_leveling_clear_cache();
@@ -660,7 +1318,13 @@ wear_leveling_status_t wear_leveling_erase(void) {
     }
 
     // Perform the erase
-    bool ret = backing_store_erase();
+    bool ret                   = backing_store_erase();
+    wear_leveling.bank_address = 0;
+#ifdef WEAR_LEVELING_DUAL_BANK
+    wear_leveling.sequence            = 0;
+    wear_leveling.consolidation.phase = CONSOLIDATION_IDLE;
+#endif // WEAR_LEVELING_DUAL_BANK
+    wear_leveling_checkpoint_reset(true);
     wear_leveling_clear_cache();
 
     // Lock the backing store if we acquired the lock successfully
@@ -690,6 +1354,7 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
 
     // Update the cache before writing to the backing store -- if we hit the end of the backing store during writes to the log then we'll force a consolidation in-line
     memcpy(&wear_leveling.cache[address], value, length);
+    wear_leveling_mark_dirty(address, length);
 
     // Unlock the backing store
     backing_store_lock_status_t lock_status = wear_leveling_unlock();
@@ -743,6 +1408,42 @@ wear_leveling_status_t wear_leveling_read(const uint32_t address, void *value, s
     return WEAR_LEVELING_SUCCESS;
 }
 
+/**
+ * Performs a single step of any pending background consolidation.
+ */
+wear_leveling_status_t wear_leveling_task(void) {
+#ifdef WEAR_LEVELING_DUAL_BANK
+    if (wear_leveling.consolidation.phase == CONSOLIDATION_IDLE) {
+        // Only start consolidating once the write log is nearly full
+        if (wear_leveling.bank_address + (WEAR_LEVELING_BANK_SIZE) - wear_leveling.write_address > (WEAR_LEVELING_CONSOLIDATION_THRESHOLD)) {
+            return WEAR_LEVELING_SUCCESS;
+        }
+        wl_dprintf("Starting background consolidation\n");
+        wear_leveling.consolidation.phase  = CONSOLIDATION_ERASING;
+        wear_leveling.consolidation.offset = 0;
+    }
+
+    // Unlock the backing store
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wear_leveling_status_t status = wear_leveling_consolidation_step();
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    return status;
+#else  // WEAR_LEVELING_DUAL_BANK
+    return WEAR_LEVELING_SUCCESS;
+#endif // WEAR_LEVELING_DUAL_BANK
+}
+
 /**
  * Weak implementation of bulk read, drivers can implement more optimised implementations.
  */
@@ -52,3 +52,13 @@ wear_leveling_status_t wear_leveling_write(uint32_t address, const void* value,
  * @return Status of the request
  */
 wear_leveling_status_t wear_leveling_read(uint32_t address, void* value, size_t length);
+
+/**
+ * Performs a single step of any pending background consolidation.
+ *
+ * Only has an effect when WEAR_LEVELING_DUAL_BANK is enabled, and is intended to be invoked periodically from the main
+ * loop so that the standby bank is prepared without stalling for the duration of a full erase.
+ *
+ * @return Status of the request
+ */
+wear_leveling_status_t wear_leveling_task(void);
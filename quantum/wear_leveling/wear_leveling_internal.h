@@ -66,10 +66,62 @@ _Static_assert(WEAR_LEVELING_BACKING_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "
 _Static_assert(WEAR_LEVELING_LOGICAL_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Logical size must be a multiple of write size");
 _Static_assert(WEAR_LEVELING_BACKING_SIZE % WEAR_LEVELING_LOGICAL_SIZE == 0, "Backing size must be a multiple of logical size");
 
+#ifdef WEAR_LEVELING_DUAL_BANK
+#    ifndef BACKING_STORE_SECTOR_SIZE
+#        error BACKING_STORE_SECTOR_SIZE was not set, and is required for WEAR_LEVELING_DUAL_BANK -- set it to the largest flash sector size used by the backing store.
+#    endif
+
+// Each bank holds consolidated data, its FNV1a_64, a sequence number, then its own write log
+#    define WEAR_LEVELING_BANK_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    define WEAR_LEVELING_LOG_START ((WEAR_LEVELING_LOGICAL_SIZE) + 16)
+
+// Number of bytes of consolidated data copied into the standby bank per consolidation step
+#    ifndef WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE
+#        define WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE 256
+#    endif
+
+// Background consolidation starts once the remaining space in the active write log drops to this many bytes
+#    ifndef WEAR_LEVELING_CONSOLIDATION_THRESHOLD
+#        define WEAR_LEVELING_CONSOLIDATION_THRESHOLD (((WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_START)) / 4)
+#    endif
+
+_Static_assert(WEAR_LEVELING_BANK_SIZE % BACKING_STORE_SECTOR_SIZE == 0, "WEAR_LEVELING_DUAL_BANK: WEAR_LEVELING_BACKING_SIZE must be a multiple of twice BACKING_STORE_SECTOR_SIZE");
+_Static_assert(WEAR_LEVELING_BANK_SIZE > WEAR_LEVELING_LOG_START, "WEAR_LEVELING_DUAL_BANK: each half of WEAR_LEVELING_BACKING_SIZE needs room for WEAR_LEVELING_LOGICAL_SIZE and a write log -- increase WEAR_LEVELING_BACKING_SIZE or decrease WEAR_LEVELING_LOGICAL_SIZE");
+_Static_assert(WEAR_LEVELING_CONSOLIDATION_CHUNK_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Consolidation chunk size must be a multiple of write size");
+#else
+#    define WEAR_LEVELING_BANK_SIZE (WEAR_LEVELING_BACKING_SIZE)
+#    define WEAR_LEVELING_LOG_START ((WEAR_LEVELING_LOGICAL_SIZE) + 8)
+#endif // WEAR_LEVELING_DUAL_BANK
+
+#ifdef WEAR_LEVELING_CHECKPOINTS
+// Number of bytes of write log between checkpoint slots
+#    ifndef WEAR_LEVELING_CHECKPOINT_INTERVAL
+#        define WEAR_LEVELING_CHECKPOINT_INTERVAL (((((WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_START)) / 8) / (BACKING_STORE_WRITE_SIZE)) * (BACKING_STORE_WRITE_SIZE))
+#    endif
+
+// Granularity of logical data snapshots stored in checkpoints
+#    ifndef WEAR_LEVELING_CHECKPOINT_PAGE_SIZE
+#        define WEAR_LEVELING_CHECKPOINT_PAGE_SIZE ((WEAR_LEVELING_LOGICAL_SIZE) < 64 ? (WEAR_LEVELING_LOGICAL_SIZE) : 64)
+#    endif
+
+// Checkpoints larger than this are skipped, and playback falls back to the previous checkpoint
+#    ifndef WEAR_LEVELING_CHECKPOINT_MAX_SIZE
+#        define WEAR_LEVELING_CHECKPOINT_MAX_SIZE (WEAR_LEVELING_CHECKPOINT_INTERVAL)
+#    endif
+
+#    define WEAR_LEVELING_CHECKPOINT_PAGES ((WEAR_LEVELING_LOGICAL_SIZE) / (WEAR_LEVELING_CHECKPOINT_PAGE_SIZE))
+
+_Static_assert(WEAR_LEVELING_CHECKPOINT_INTERVAL >= 16 && WEAR_LEVELING_CHECKPOINT_INTERVAL % BACKING_STORE_WRITE_SIZE == 0, "Checkpoint interval must be a multiple of write size");
+_Static_assert(WEAR_LEVELING_CHECKPOINT_PAGE_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Checkpoint page size must be a multiple of write size");
+_Static_assert(WEAR_LEVELING_LOGICAL_SIZE % WEAR_LEVELING_CHECKPOINT_PAGE_SIZE == 0, "Logical size must be a multiple of checkpoint page size");
+_Static_assert(WEAR_LEVELING_BANK_SIZE / BACKING_STORE_WRITE_SIZE <= 65536, "Checkpoints can only address 65536 write log locations");
+#endif // WEAR_LEVELING_CHECKPOINTS
+
 // Backing Store API, to be implemented elsewhere by flash driver etc.
 bool backing_store_init(void);
 bool backing_store_unlock(void);
 bool backing_store_erase(void);
+bool backing_store_erase_sector(uint32_t address); // only required for WEAR_LEVELING_DUAL_BANK, erases the BACKING_STORE_SECTOR_SIZE bytes starting at the supplied address
 bool backing_store_write(uint32_t address, backing_store_int_t value);
 bool backing_store_write_bulk(uint32_t address, backing_store_int_t* values, size_t item_count); // weak implementation already provided, optimized implementation can be implemented by driver
 bool backing_store_lock(void);
@@ -101,6 +153,9 @@ enum {
     // 0x02 -- 2-byte backing store write optimization: word-encoded 0/1 values
     LOG_ENTRY_TYPE_WORD_01,
 
+    // 0x03 -- Extended entries, currently only checkpoint records
+    LOG_ENTRY_TYPE_EXTENDED,
+
     LOG_ENTRY_TYPES
 };
 
@@ -149,3 +204,23 @@ _Static_assert(LOG_ENTRY_TYPES <= (1 << 2), "Too many log entry types to fit int
             [1] = (uint8_t)((address) >> 1), /* address */                                            \
         }                                                                                             \
     }
+
+/**
+ * Extended log entry subtype discriminator, stored in the remaining 6 bits of the first byte.
+ */
+enum {
+    // Single write of padding, used to align checkpoints
+    LOG_ENTRY_EXTENDED_PADDING,
+
+    // 8 bytes: snapshot count, previous checkpoint location, check value
+    LOG_ENTRY_EXTENDED_CHECKPOINT,
+
+    // 8 bytes: page index and its complement, followed by WEAR_LEVELING_CHECKPOINT_PAGE_SIZE bytes of logical data
+    LOG_ENTRY_EXTENDED_SNAPSHOT,
+
+    // 8 bytes: checkpoint location and its complement, check value
+    LOG_ENTRY_EXTENDED_COMMIT,
+};
+
+#define LOG_ENTRY_EXTENDED_GET_SUBTYPE(entry) ((entry).raw8[0] & BITMASK_FOR_BITCOUNT(6))
+#define LOG_ENTRY_MAKE_EXTENDED_TAG(subtype) ((uint8_t)(((((uint8_t)LOG_ENTRY_TYPE_EXTENDED) & BITMASK_FOR_BITCOUNT(2)) << 6) | (((uint8_t)(subtype)) & BITMASK_FOR_BITCOUNT(6))))
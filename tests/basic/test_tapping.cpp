@@ -41,9 +41,10 @@ TEST_F(Tapping, TapA_SHFT_T_KeyReportsKey) {
     key_shift_hold_p_tap.release();
     EXPECT_REPORT(driver, (KC_P));
 
-    // Then the release
+    // Then the release, once the tap has been held for TAP_CODE_DELAY
     EXPECT_EMPTY_REPORT(driver);
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
 }
 
 TEST_F(Tapping, HoldA_SHFT_T_KeyReportsShift) {
@@ -153,6 +154,7 @@ TEST_F(Tapping, TapA_CTL_T_KeyWhileReleasingShift) {
     EXPECT_REPORT(driver, (KC_P));
     EXPECT_EMPTY_REPORT(driver);
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -188,5 +190,6 @@ TEST_F(Tapping, TapA_CTL_T_KeyWhileReleasingLayer) {
     EXPECT_REPORT(driver, (KC_Q));
     EXPECT_EMPTY_REPORT(driver);
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
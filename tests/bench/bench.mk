@@ -0,0 +1,10 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# A representative set of features in the process_record_quantum() chain
+COMBO_ENABLE = yes
+CAPS_WORD_ENABLE = yes
+REPEAT_KEY_ENABLE = yes
+
+# The HSV conversions swept by bench_color_span.cpp
+SRC += $(QUANTUM_DIR)/color.c
@@ -0,0 +1,60 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include "bench_fixture.hpp"
+
+extern "C" {
+#include "color.h"
+}
+
+#define SPAN_SIZE 16
+
+class ColorSpan : public testing::Test {};
+
+/**
+ * Converts every HSV value with the scalar and the span conversion, checks that
+ * both agree and reports the time each of them took. Colors are generated one
+ * span at a time, so the sweep needs no memory beyond a single span.
+ */
+TEST_F(ColorSpan, all_colors) {
+    using clock = std::chrono::steady_clock;
+
+    HSV           hsv[SPAN_SIZE];
+    RGB           scalar[SPAN_SIZE];
+    RGB           span[SPAN_SIZE];
+    uint32_t      mismatches = 0;
+    clock::duration scalar_time{}, span_time{};
+
+    for (uint32_t color = 0; color < 256 * 256 * 256; color += SPAN_SIZE) {
+        for (uint8_t i = 0; i < SPAN_SIZE; i++) {
+            uint32_t value = color + i;
+            hsv[i]         = {(uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value};
+        }
+
+        auto start = clock::now();
+        for (uint8_t i = 0; i < SPAN_SIZE; i++) {
+            scalar[i] = hsv_to_rgb_impl(hsv[i], false);
+        }
+        auto middle = clock::now();
+        hsv_to_rgb_span_impl(hsv, span, SPAN_SIZE, false);
+        auto end = clock::now();
+
+        scalar_time += middle - start;
+        span_time += end - middle;
+
+        for (uint8_t i = 0; i < SPAN_SIZE; i++) {
+            if (scalar[i].r != span[i].r || scalar[i].g != span[i].g || scalar[i].b != span[i].b) {
+                if (!mismatches++) {
+                    ADD_FAILURE() << "Mismatch for HSV " << (int)hsv[i].h << "," << (int)hsv[i].s << "," << (int)hsv[i].v;
+                }
+            }
+        }
+    }
+    EXPECT_EQ(mismatches, 0u);
+
+    char line[256];
+    snprintf(line, sizeof(line), "{\"bench\":\"ColorSpan\",\"trace\":\"all_colors\",\"colors\":%u,\"scalar_ns\":%llu,\"span_ns\":%llu,\"mismatches\":%u}", 256u * 256 * 256, (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(scalar_time).count(), (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(span_time).count(), (unsigned)mismatches);
+    BenchFixture::report(line);
+}
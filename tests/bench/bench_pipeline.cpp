@@ -0,0 +1,80 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstdlib>
+#include <sstream>
+#include "bench_fixture.hpp"
+#include "bench_trace.hpp"
+
+class KeycodePipeline : public BenchFixture {};
+
+static keypos_t key(uint8_t row, uint8_t col) {
+    return {col, row};
+}
+
+static std::vector<keypos_t> letter_keys() {
+    std::vector<keypos_t> keys;
+    for (uint8_t col = 0; col < 10; col++) {
+        keys.push_back(key(0, col));
+        keys.push_back(key(2, col));
+    }
+    keys.push_back(key(1, 4));
+    keys.push_back(key(1, 5));
+    keys.push_back(key(3, 4));
+    return keys;
+}
+
+static std::vector<keypos_t> home_row_mods() {
+    return {key(1, 0), key(1, 1), key(1, 2), key(1, 3), key(1, 6), key(1, 7), key(1, 8), key(1, 9)};
+}
+
+TEST_F(KeycodePipeline, fast_typing) {
+    BenchResult result = replay("fast_typing", bench_fast_typing(letter_keys(), 2000 * scale(), 1));
+    EXPECT_EQ(result.events, 4000 * scale());
+    EXPECT_TRUE(result.released);
+}
+
+TEST_F(KeycodePipeline, rolls) {
+    BenchResult result = replay("rolls", bench_rolls(letter_keys(), 2000 * scale(), 2));
+    EXPECT_TRUE(result.released);
+}
+
+TEST_F(KeycodePipeline, chords) {
+    std::vector<std::vector<keypos_t>> chords = {
+        {key(0, 1), key(0, 2)},            // combo
+        {key(2, 2), key(2, 3)},            // combo
+        {key(0, 7), key(0, 8)},            // combo
+        {key(0, 0), key(2, 5), key(2, 6)}, // plain chord
+        {key(3, 3), key(0, 0)},            // layer-tap
+        {key(3, 6), key(1, 5), key(1, 6)}, // layer-tap into mod-tap
+    };
+    BenchResult result = replay("chords", bench_chords(chords, 1000 * scale(), 3));
+    EXPECT_TRUE(result.released);
+}
+
+TEST_F(KeycodePipeline, home_row_mods) {
+    BenchResult result = replay("home_row_mods", bench_home_row_mods(home_row_mods(), letter_keys(), 500 * scale(), 4));
+    EXPECT_TRUE(result.released);
+}
+
+TEST_F(KeycodePipeline, recorded) {
+    // The bundled sample and any other recordings, separated by ':'
+    std::string paths = BENCH_PATH "/traces/pangrams.txt";
+    if (getenv("QMK_BENCH_TRACES")) {
+        paths += std::string(":") + getenv("QMK_BENCH_TRACES");
+    }
+
+    std::istringstream list(paths);
+    std::string        path;
+    while (std::getline(list, path, ':')) {
+        BenchTrace recording;
+        ASSERT_TRUE(bench_load_trace(path, recording)) << "can't load " << path;
+
+        BenchTrace trace;
+        for (uint32_t i = 0; i < scale() * 20; i++) {
+            trace.insert(trace.end(), recording.begin(), recording.end());
+        }
+        BenchResult result = replay(path.substr(path.find_last_of('/') + 1), trace);
+        EXPECT_TRUE(result.released) << path;
+    }
+}
@@ -0,0 +1,12 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#define EEPROM_SIZE 1024
+
+#define TAPPING_TERM 200
+#define PERMISSIVE_HOLD
@@ -0,0 +1,39 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+enum layers { _BASE, _NUM, _NAV };
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [_BASE] = {
+        {KC_Q,         KC_W,         KC_E,         KC_R,         KC_T,          KC_Y,    KC_U,         KC_I,         KC_O,         KC_P           },
+        {LGUI_T(KC_A), LALT_T(KC_S), LCTL_T(KC_D), LSFT_T(KC_F), KC_G,          KC_H,    RSFT_T(KC_J), RCTL_T(KC_K), LALT_T(KC_L), RGUI_T(KC_SCLN)},
+        {KC_Z,         KC_X,         KC_C,         KC_V,         KC_B,          KC_N,    KC_M,         KC_COMM,      KC_DOT,       KC_SLSH        },
+        {KC_NO,        KC_NO,        KC_LCTL,      LT(_NUM, KC_TAB), KC_SPC,    KC_ENT,  LT(_NAV, KC_BSPC), QK_REP,  CW_TOGG,      KC_NO          }
+    },
+    [_NUM] = {
+        {KC_1,    KC_2,    KC_3,    KC_4,    KC_5,    KC_6,    KC_7,    KC_8,    KC_9,    KC_0   },
+        {_______, _______, _______, _______, KC_MINS, KC_EQL,  _______, _______, _______, _______},
+        {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______}
+    },
+    [_NAV] = {
+        {_______, _______, _______, _______, _______, KC_HOME, KC_PGDN, KC_PGUP, KC_END,  _______},
+        {_______, _______, _______, _______, _______, KC_LEFT, KC_DOWN, KC_UP,   KC_RGHT, _______},
+        {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______},
+        {_______, _______, _______, _______, _______, _______, _______, _______, _______, _______}
+    },
+};
+
+const uint16_t PROGMEM escape_combo[] = {KC_W, KC_E, COMBO_END};
+const uint16_t PROGMEM enter_combo[]  = {KC_C, KC_V, COMBO_END};
+const uint16_t PROGMEM delete_combo[] = {KC_I, KC_O, COMBO_END};
+
+combo_t key_combos[] = {
+    COMBO(escape_combo, KC_ESC),
+    COMBO(enter_combo, KC_ENT),
+    COMBO(delete_combo, KC_DEL),
+};
+// clang-format on
@@ -0,0 +1,37 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "eeprom.h"
+#include "eeprom_driver.h"
+#include "bench_eeprom.h"
+
+static uint8_t buffer[EEPROM_SIZE];
+
+uint32_t bench_eeprom_reads  = 0;
+uint32_t bench_eeprom_writes = 0;
+
+void eeprom_driver_init(void) {
+    eeprom_driver_erase();
+}
+
+void eeprom_driver_erase(void) {
+    memset(buffer, 0x00, sizeof(buffer));
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+    bench_eeprom_reads++;
+    memset(buf, 0x00, len);
+    if (offset < sizeof(buffer)) {
+        memcpy(buf, &buffer[offset], offset + len > sizeof(buffer) ? sizeof(buffer) - offset : len);
+    }
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    uintptr_t offset = (uintptr_t)addr;
+    bench_eeprom_writes++;
+    if (offset < sizeof(buffer)) {
+        memcpy(&buffer[offset], buf, offset + len > sizeof(buffer) ? sizeof(buffer) - offset : len);
+    }
+}
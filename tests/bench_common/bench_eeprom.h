@@ -0,0 +1,18 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Every read or write of the EEPROM driver, whatever its size
+extern uint32_t bench_eeprom_reads;
+extern uint32_t bench_eeprom_writes;
+
+#ifdef __cplusplus
+}
+#endif
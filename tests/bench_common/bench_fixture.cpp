@@ -0,0 +1,144 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "bench_fixture.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+extern "C" {
+#include "action.h"
+#include "action_layer.h"
+#include "action_util.h"
+#include "debug.h"
+#include "eeconfig.h"
+#include "host.h"
+#include "keyboard.h"
+#include "keymap_introspection.h"
+#include "timer.h"
+#include "../test_common/test_matrix.h"
+#include "bench_eeprom.h"
+
+void advance_time(uint32_t ms);
+}
+
+static uint32_t bench_keymap_reads = 0;
+static uint32_t bench_reports      = 0;
+static uint32_t bench_report_hash  = 0;
+static bool     bench_report_empty = true;
+
+/* Counts the keymap lookups made by the pipeline, the keymap itself is the bench's keymap.c. */
+extern "C" uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    bench_keymap_reads++;
+    return keycode_at_keymap_location_raw(layer_num, row, column);
+}
+
+static uint8_t bench_keyboard_leds(void) {
+    return 0;
+}
+
+static void bench_send_keyboard(report_keyboard_t *report) {
+    const uint8_t *bytes = (const uint8_t *)report;
+    for (size_t i = 0; i < sizeof(*report); i++) {
+        bench_report_hash = (bench_report_hash ^ bytes[i]) * 16777619;
+    }
+    bench_reports++;
+
+    bench_report_empty = report->mods == 0;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        bench_report_empty &= report->keys[i] == 0;
+    }
+}
+
+static void bench_send_nkro(report_nkro_t *report) {
+    bench_reports++;
+}
+
+static void bench_send_mouse(report_mouse_t *report) {
+    bench_reports++;
+}
+
+static void bench_send_extra(report_extra_t *report) {
+    bench_reports++;
+}
+
+static host_driver_t bench_driver = {bench_keyboard_leds, bench_send_keyboard, bench_send_nkro, bench_send_mouse, bench_send_extra};
+
+void BenchFixture::SetUpTestCase() {
+    eeconfig_init_quantum();
+    host_set_driver(&bench_driver);
+    keyboard_init();
+    debug_config.raw = 0;
+}
+
+BenchFixture::BenchFixture() {
+    clear_all_keys();
+    clear_keyboard();
+    layer_clear();
+    timer_clear();
+}
+
+uint32_t BenchFixture::scale() {
+    const char *value = getenv("QMK_BENCH_SCALE");
+    long        scale = value ? strtol(value, NULL, 10) : 1;
+    return scale > 0 ? scale : 1;
+}
+
+BenchResult BenchFixture::replay(const std::string &name, const BenchTrace &trace) {
+    BenchResult result = {name};
+    bench_keymap_reads = 0;
+    bench_eeprom_reads = 0;
+    bench_reports      = 0;
+    bench_report_hash  = 2166136261u;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const BenchEvent &event : trace) {
+        for (uint32_t ms = 0; ms < event.delay_ms; ms++) {
+            keyboard_task();
+            advance_time(1);
+            result.scans++;
+        }
+        if (event.pressed) {
+            press_key(event.key.col, event.key.row);
+        } else {
+            release_key(event.key.col, event.key.row);
+        }
+        result.events++;
+    }
+    // Let every pending tap, combo and timeout resolve
+    for (uint32_t ms = 0; ms < 1000; ms++) {
+        keyboard_task();
+        advance_time(1);
+        result.scans++;
+    }
+    result.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    result.reports      = bench_reports;
+    result.keymap_reads = bench_keymap_reads;
+    result.eeprom_reads = bench_eeprom_reads;
+    result.report_hash  = bench_report_hash;
+    result.released     = bench_report_empty;
+
+    double ns_per_scan       = result.scans ? (double)result.elapsed_ns / result.scans : 0;
+    double ns_per_event      = result.events ? (double)result.elapsed_ns / result.events : 0;
+    double events_per_second = result.elapsed_ns ? result.events * 1e9 / result.elapsed_ns : 0;
+    char   line[512];
+    snprintf(line, sizeof(line),
+             "{\"bench\":\"%s\",\"trace\":\"%s\",\"events\":%u,\"scans\":%u,\"reports\":%u,\"elapsed_ns\":%llu,\"ns_per_scan\":%.1f,\"ns_per_event\":%.1f,\"events_per_second\":%.0f,\"keymap_reads\":%u,\"eeprom_reads\":%u,\"report_hash\":\"%08x\"}",
+             testing::UnitTest::GetInstance()->current_test_suite()->name(), name.c_str(), (unsigned)result.events, (unsigned)result.scans, (unsigned)result.reports, (unsigned long long)result.elapsed_ns, ns_per_scan, ns_per_event, events_per_second, (unsigned)result.keymap_reads, (unsigned)result.eeprom_reads, (unsigned)result.report_hash);
+    report(line);
+    return result;
+}
+
+void BenchFixture::report(const char *json) {
+    printf("BENCH %s\n", json);
+
+    const char *output = getenv("QMK_BENCH_OUTPUT");
+    if (output) {
+        FILE *file = fopen(output, "a");
+        if (file) {
+            fprintf(file, "%s\n", json);
+            fclose(file);
+        }
+    }
+}
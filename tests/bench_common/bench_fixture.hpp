@@ -0,0 +1,44 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "gtest/gtest.h"
+#include "bench_trace.hpp"
+
+struct BenchResult {
+    std::string trace;
+    uint32_t    events;
+    uint32_t    scans;
+    uint32_t    reports;
+    uint64_t    elapsed_ns;
+    uint32_t    keymap_reads;
+    uint32_t    eeprom_reads;
+    uint32_t    report_hash; // FNV-1a over every keyboard report, changes when the output does
+    bool        released;    // whether the host saw every key released at the end
+};
+
+/**
+ * @brief Replays key traces through the real keyboard_task() on the test
+ * platform's simulated clock, and measures the host time it takes.
+ *
+ * Every replay prints one JSON object per line on stdout, prefixed with
+ * `BENCH `, and appends it to the file named by the `QMK_BENCH_OUTPUT`
+ * environment variable if set. `QMK_BENCH_SCALE` multiplies the length of the
+ * generated traces for steadier numbers.
+ */
+class BenchFixture : public testing::Test {
+   public:
+    static void SetUpTestCase();
+
+    BenchFixture();
+
+    BenchResult replay(const std::string& name, const BenchTrace& trace);
+
+    static uint32_t scale();
+
+    // Prints a JSON result and appends it to QMK_BENCH_OUTPUT
+    static void report(const char* json);
+};
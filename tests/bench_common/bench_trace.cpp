@@ -0,0 +1,130 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "bench_trace.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+uint32_t BenchTraceBuilder::random(uint32_t min, uint32_t max) {
+    m_state = m_state * 1103515245 + 12345;
+    return min + (m_state >> 16) % (max - min + 1);
+}
+
+uint32_t BenchTraceBuilder::tap(keypos_t key, uint32_t at_ms, uint32_t hold_ms) {
+    uint16_t id   = key.row << 8 | key.col;
+    auto     last = m_released.find(id);
+    if (last != m_released.end() && at_ms <= last->second) {
+        at_ms = last->second + 1;
+    }
+
+    uint32_t order = m_events.size();
+    m_events.push_back({at_ms, order, {0, key, true}});
+    m_events.push_back({at_ms + hold_ms, order + 1, {0, key, false}});
+    m_released[id] = at_ms + hold_ms;
+    return at_ms;
+}
+
+BenchTrace BenchTraceBuilder::build() const {
+    std::vector<TimedEvent> events = m_events;
+    std::sort(events.begin(), events.end(), [](const TimedEvent& a, const TimedEvent& b) { return a.time != b.time ? a.time < b.time : a.order < b.order; });
+
+    BenchTrace trace;
+    uint32_t   time = 0;
+    for (const TimedEvent& timed : events) {
+        BenchEvent event = timed.event;
+        event.delay_ms   = timed.time - time;
+        time             = timed.time;
+        trace.push_back(event);
+    }
+    return trace;
+}
+
+BenchTrace bench_fast_typing(const std::vector<keypos_t>& keys, uint32_t taps, uint32_t seed) {
+    BenchTraceBuilder builder(seed);
+    uint32_t          time = 0;
+    for (uint32_t i = 0; i < taps; i++) {
+        uint32_t hold = builder.random(15, 40);
+        time          = builder.tap(keys[builder.random(0, keys.size() - 1)], time, hold);
+        time += hold + builder.random(10, 40);
+    }
+    return builder.build();
+}
+
+BenchTrace bench_rolls(const std::vector<keypos_t>& keys, uint32_t taps, uint32_t seed) {
+    BenchTraceBuilder builder(seed);
+    uint32_t          time = 0;
+    for (uint32_t i = 0; i < taps; i++) {
+        time = builder.tap(keys[builder.random(0, keys.size() - 1)], time, builder.random(40, 90));
+        time += builder.random(15, 45);
+    }
+    return builder.build();
+}
+
+BenchTrace bench_chords(const std::vector<std::vector<keypos_t>>& chords, uint32_t count, uint32_t seed) {
+    BenchTraceBuilder builder(seed);
+    uint32_t          time = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const std::vector<keypos_t>& chord = chords[builder.random(0, chords.size() - 1)];
+        uint32_t                     hold  = builder.random(40, 120);
+        uint32_t                     end   = time;
+        for (keypos_t key : chord) {
+            uint32_t key_hold = hold + builder.random(0, 8);
+            uint32_t pressed  = builder.tap(key, time + builder.random(0, 8), key_hold);
+            end               = std::max(end, pressed + key_hold);
+        }
+        time = end + builder.random(80, 200);
+    }
+    return builder.build();
+}
+
+BenchTrace bench_home_row_mods(const std::vector<keypos_t>& mod_taps, const std::vector<keypos_t>& keys, uint32_t count, uint32_t seed) {
+    BenchTraceBuilder     builder(seed);
+    std::vector<keypos_t> all = keys;
+    all.insert(all.end(), mod_taps.begin(), mod_taps.end());
+
+    uint32_t time = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (builder.random(0, 9) < 7) {
+            // A word typed across the home row, taps rolling into each other
+            for (uint32_t letter = builder.random(3, 8); letter; letter--) {
+                time = builder.tap(all[builder.random(0, all.size() - 1)], time, builder.random(30, 80));
+                time += builder.random(20, 60);
+            }
+        } else {
+            // A shortcut, the mod held past the tapping term
+            uint32_t hold = builder.random(250, 450);
+            uint32_t mod  = builder.tap(mod_taps[builder.random(0, mod_taps.size() - 1)], time, hold);
+            uint32_t key  = mod + builder.random(60, 120);
+            for (uint32_t tap = builder.random(1, 3); tap; tap--) {
+                key = builder.tap(keys[builder.random(0, keys.size() - 1)], key, builder.random(30, 60)) + 70;
+            }
+            time = std::max(key, mod + hold);
+        }
+        time += builder.random(100, 300);
+    }
+    return builder.build();
+}
+
+bool bench_load_trace(const std::string& path, BenchTrace& trace) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        uint32_t           delay, row, col;
+        char               direction;
+        if (!(fields >> delay >> row >> col >> direction) || row >= MATRIX_ROWS || col >= MATRIX_COLS || (direction != 'd' && direction != 'u')) {
+            return false;
+        }
+        trace.push_back({delay, {(uint8_t)col, (uint8_t)row}, direction == 'd'});
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "keyboard.h"
+
+struct BenchEvent {
+    uint32_t delay_ms; // since the previous event
+    keypos_t key;
+    bool     pressed;
+};
+
+using BenchTrace = std::vector<BenchEvent>;
+
+/**
+ * @brief Builds a trace out of taps at absolute times, with a deterministic
+ * random generator so that every run replays exactly the same events.
+ */
+class BenchTraceBuilder {
+   public:
+    explicit BenchTraceBuilder(uint32_t seed) : m_state(seed) {}
+
+    /**
+     * @brief Returns a pseudo-random number between `min` and `max` included.
+     */
+    uint32_t random(uint32_t min, uint32_t max);
+
+    /**
+     * @brief Taps `key` for `hold_ms`, no earlier than `at_ms` and after its previous tap was released.
+     *
+     * @return the time at which the key is pressed
+     */
+    uint32_t tap(keypos_t key, uint32_t at_ms, uint32_t hold_ms);
+
+    BenchTrace build() const;
+
+   private:
+    struct TimedEvent {
+        uint32_t   time;
+        uint32_t   order;
+        BenchEvent event;
+    };
+
+    uint32_t                     m_state;
+    std::vector<TimedEvent>      m_events;
+    std::map<uint16_t, uint32_t> m_released;
+};
+
+/**
+ * @brief Taps of single keys that never overlap, like a fast typist who doesn't roll.
+ */
+BenchTrace bench_fast_typing(const std::vector<keypos_t>& keys, uint32_t taps, uint32_t seed);
+
+/**
+ * @brief Taps where the next key is pressed before the previous one is released.
+ */
+BenchTrace bench_rolls(const std::vector<keypos_t>& keys, uint32_t taps, uint32_t seed);
+
+/**
+ * @brief Groups of keys pressed and released (almost) together.
+ */
+BenchTrace bench_chords(const std::vector<std::vector<keypos_t>>& chords, uint32_t count, uint32_t seed);
+
+/**
+ * @brief Typing on mod-tap keys: mostly quick and rolled taps, sometimes a held mod with other keys tapped under it.
+ */
+BenchTrace bench_home_row_mods(const std::vector<keypos_t>& mod_taps, const std::vector<keypos_t>& keys, uint32_t count, uint32_t seed);
+
+/**
+ * @brief Loads a recorded trace, one event per line: `<ms since the previous event> <row> <col> <d|u>`.
+ *
+ * Empty lines and lines starting with `#` are ignored.
+ *
+ * @return false if the file can't be read or has a malformed line
+ */
+bool bench_load_trace(const std::string& path, BenchTrace& trace);
@@ -0,0 +1,7 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+CUSTOM_MATRIX = yes
+
+# Counts the reads, see bench_eeprom.c
+EEPROM_DRIVER = custom
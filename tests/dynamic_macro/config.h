@@ -0,0 +1,10 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define DYNAMIC_MACRO_BUFFER_SIZE 256
+#define DYNAMIC_MACRO_PERSIST
+#define EEPROM_TEST_HARNESS_SIZE 1024
@@ -0,0 +1,69 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+
+class DynamicMacroTiming : public TestFixture {
+   public:
+    void SetUp() override {
+        dynamic_macro_init();
+    }
+};
+
+TEST_F(DynamicMacroTiming, plays_back_with_recorded_timing) {
+    TestDriver driver;
+
+    auto key_rec  = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_stop = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_play = KeymapKey(0, 2, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_a    = KeymapKey(0, 3, 0, KC_A);
+    auto key_b    = KeymapKey(0, 4, 0, KC_B);
+
+    set_keymap({key_rec, key_stop, key_play, key_a, key_b});
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_B));
+    tap_key(key_rec);
+    // A held for 50 ms, then B pressed 300 ms later, which needs a varint time delta
+    tap_key(key_a, 50);
+    idle_for(299);
+    tap_key(key_b);
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_play);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // A is released after the recorded 50 ms
+    EXPECT_NO_REPORT(driver);
+    idle_for(48);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(2);
+    VERIFY_AND_CLEAR(driver);
+
+    // B is pressed 300 ms after that
+    EXPECT_NO_REPORT(driver);
+    idle_for(298);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    idle_for(2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
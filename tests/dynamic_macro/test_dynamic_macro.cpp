@@ -0,0 +1,340 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class DynamicMacro : public TestFixture {
+   public:
+    void SetUp() override {
+        dynamic_macro_init();
+    }
+
+    // Tap the given keys in order, expecting each to be typed
+    void type_keys(const std::vector<KeymapKey> &keys, TestDriver &driver) {
+        EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+        {
+            InSequence s;
+            for (auto &key : keys) {
+                EXPECT_REPORT(driver, (key.code));
+            }
+        }
+        for (auto &key : keys) {
+            tap_key(key);
+        }
+        VERIFY_AND_CLEAR(driver);
+    }
+
+    // Play back a macro, expecting the given keys to be typed
+    void play_macro(KeymapKey key_play, const std::vector<KeymapKey> &keys, TestDriver &driver) {
+        EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+        {
+            InSequence s;
+            for (auto &key : keys) {
+                EXPECT_REPORT(driver, (key.code));
+            }
+        }
+        tap_key(key_play);
+        EXPECT_TRUE(dynamic_macro_is_playing());
+        idle_for(keys.size() * 2 + 10);
+        EXPECT_FALSE(dynamic_macro_is_playing());
+        VERIFY_AND_CLEAR(driver);
+    }
+};
+
+TEST_F(DynamicMacro, records_and_plays_back) {
+    TestDriver driver;
+
+    auto key_rec  = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_stop = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_play = KeymapKey(0, 2, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_a    = KeymapKey(0, 3, 0, KC_A);
+    auto key_b    = KeymapKey(0, 4, 0, KC_B);
+    auto key_c    = KeymapKey(0, 5, 0, KC_C);
+
+    set_keymap({key_rec, key_stop, key_play, key_a, key_b, key_c});
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_rec);
+    type_keys({key_a, key_b, key_c}, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    play_macro(key_play, {key_a, key_b, key_c}, driver);
+}
+
+TEST_F(DynamicMacro, plays_back_asynchronously) {
+    TestDriver driver;
+
+    auto key_rec  = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_stop = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_play = KeymapKey(0, 2, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_a    = KeymapKey(0, 3, 0, KC_A);
+    auto key_b    = KeymapKey(0, 4, 0, KC_B);
+
+    set_keymap({key_rec, key_stop, key_play, key_a, key_b});
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_rec);
+    type_keys({key_a, key_b}, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    // Releasing the play key only starts the playback
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_play);
+    VERIFY_AND_CLEAR(driver);
+
+    // One event is sent per scan
+    EXPECT_REPORT(driver, (KC_A));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, long_macro_fits) {
+    TestDriver driver;
+
+    auto key_rec  = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_stop = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_play = KeymapKey(0, 2, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_a    = KeymapKey(0, 3, 0, KC_A);
+    auto key_b    = KeymapKey(0, 4, 0, KC_B);
+    auto key_c    = KeymapKey(0, 5, 0, KC_C);
+    auto key_d    = KeymapKey(0, 6, 0, KC_D);
+
+    set_keymap({key_rec, key_stop, key_play, key_a, key_b, key_c, key_d});
+
+    // 120 events, where the buffer would only hold 256 / sizeof(keyrecord_t) in the uncompressed format
+    std::vector<KeymapKey> keys;
+    for (int i = 0; i < 15; i++) {
+        keys.push_back(key_a);
+        keys.push_back(key_b);
+        keys.push_back(key_c);
+        keys.push_back(key_d);
+    }
+    ASSERT_GT(keys.size() * 2, DYNAMIC_MACRO_BUFFER_SIZE / sizeof(keyrecord_t));
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_rec);
+    type_keys(keys, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    play_macro(key_play, keys, driver);
+}
+
+TEST_F(DynamicMacro, persists_macros) {
+    TestDriver driver;
+
+    auto key_rec1  = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_rec2  = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_START_2);
+    auto key_stop  = KeymapKey(0, 2, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_play1 = KeymapKey(0, 3, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_play2 = KeymapKey(0, 4, 0, QK_DYNAMIC_MACRO_PLAY_2);
+    auto key_a     = KeymapKey(0, 5, 0, KC_A);
+    auto key_b     = KeymapKey(0, 6, 0, KC_B);
+    auto key_c     = KeymapKey(0, 7, 3, KC_C);
+    auto key_d     = KeymapKey(0, 8, 3, KC_D);
+
+    set_keymap({key_rec1, key_rec2, key_stop, key_play1, key_play2, key_a, key_b, key_c, key_d});
+
+    std::vector<KeymapKey> keys1, keys2;
+    for (int i = 0; i < 15; i++) {
+        keys1.push_back(key_a);
+        keys1.push_back(key_b);
+        keys2.push_back(key_c);
+        keys2.push_back(key_d);
+    }
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_rec1);
+    type_keys(keys1, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+    tap_key(key_rec2);
+    type_keys(keys2, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    // The macros are written to EEPROM in the background
+    idle_for(100);
+
+    // Drop the macros from RAM, as on a power cycle, and load them back from EEPROM
+    dynamic_macro_init();
+
+    play_macro(key_play1, keys1, driver);
+    play_macro(key_play2, keys2, driver);
+}
+
+TEST_F(DynamicMacro, plays_nested_macro) {
+    TestDriver driver;
+
+    auto key_rec1  = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_rec2  = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_START_2);
+    auto key_stop  = KeymapKey(0, 2, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_play1 = KeymapKey(0, 3, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_play2 = KeymapKey(0, 4, 0, QK_DYNAMIC_MACRO_PLAY_2);
+    auto key_a     = KeymapKey(0, 5, 0, KC_A);
+    auto key_b     = KeymapKey(0, 6, 0, KC_B);
+    auto key_c     = KeymapKey(0, 7, 0, KC_C);
+
+    set_keymap({key_rec1, key_rec2, key_stop, key_play1, key_play2, key_a, key_b, key_c});
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_rec2);
+    type_keys({key_b}, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+
+    // Macro 1 plays macro 2 between typing A and C
+    tap_key(key_rec1);
+    type_keys({key_a}, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_play2);
+    type_keys({key_c}, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    play_macro(key_play1, {key_a, key_b, key_c}, driver);
+}
+
+TEST_F(DynamicMacro, layer_released_during_playback_stays_off) {
+    TestDriver driver;
+
+    auto key_rec  = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_stop = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_mo   = KeymapKey(0, 2, 0, MO(1));
+    auto key_play = KeymapKey(1, 3, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_a    = KeymapKey(0, 4, 0, KC_A);
+    auto key_b    = KeymapKey(0, 5, 0, KC_B);
+    auto key_c    = KeymapKey(0, 6, 0, KC_C);
+
+    set_keymap({key_rec, key_stop, key_mo, key_play, key_a, key_b, key_c});
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_rec);
+    type_keys({key_a, key_b, key_c}, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    // The macro keys resolve on the layers they were recorded on, even though layer 1 is held to play it
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_A));
+        EXPECT_REPORT(driver, (KC_B));
+        EXPECT_REPORT(driver, (KC_C));
+    }
+    key_mo.press();
+    run_one_scan_loop();
+    tap_key(key_play);
+    EXPECT_TRUE(layer_state_is(1));
+    key_mo.release();
+    run_one_scan_loop();
+    idle_for(20);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(layer_state, 0);
+}
+
+TEST_F(DynamicMacro, keys_held_during_playback_stay_pressed) {
+    TestDriver driver;
+
+    auto key_rec   = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_stop  = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_play  = KeymapKey(0, 2, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_a     = KeymapKey(0, 3, 0, KC_A);
+    auto key_shift = KeymapKey(0, 4, 0, KC_LSFT);
+
+    set_keymap({key_rec, key_stop, key_play, key_a, key_shift});
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_rec);
+    type_keys({key_a}, driver);
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_stop);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    key_shift.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+        EXPECT_REPORT(driver, (KC_LSFT));
+    }
+    tap_key(key_play);
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_shift.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicMacro, releases_keys_held_at_the_end_of_the_macro) {
+    TestDriver driver;
+
+    auto key_rec   = KeymapKey(0, 0, 0, QK_DYNAMIC_MACRO_RECORD_START_1);
+    auto key_stop  = KeymapKey(0, 1, 0, QK_DYNAMIC_MACRO_RECORD_STOP);
+    auto key_play  = KeymapKey(0, 2, 0, QK_DYNAMIC_MACRO_PLAY_1);
+    auto key_a     = KeymapKey(0, 3, 0, KC_A);
+    auto key_shift = KeymapKey(0, 4, 0, KC_LSFT);
+
+    set_keymap({key_rec, key_stop, key_play, key_a, key_shift});
+
+    // Shift is still held when the recording is stopped
+    EXPECT_REPORT(driver, (KC_LSFT)).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A)).Times(AnyNumber());
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    tap_key(key_rec);
+    key_shift.press();
+    run_one_scan_loop();
+    tap_key(key_a);
+    tap_key(key_stop);
+    key_shift.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_LSFT));
+        EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+        EXPECT_REPORT(driver, (KC_LSFT));
+        EXPECT_EMPTY_REPORT(driver);
+    }
+    tap_key(key_play);
+    idle_for(10);
+    EXPECT_FALSE(dynamic_macro_is_playing());
+    VERIFY_AND_CLEAR(driver);
+}
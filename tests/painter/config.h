@@ -0,0 +1,14 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN 0
+#define QUANTUM_PAINTER_DISPLAY_TIMEOUT 0
+#define QUANTUM_PAINTER_NUM_FONTS 2
+#define QUANTUM_PAINTER_GLYPH_CACHE_SIZE 16
+#define QUANTUM_PAINTER_SUPPORTS_256_PALETTE 1
+#define QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS 1
+#define SURFACE_NUM_DEVICES 2
@@ -0,0 +1,56 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "flash_spi.h"
+#include "flash_mock.h"
+
+static uint8_t  mock_flash[MOCK_FLASH_SIZE];
+static bool     initialised = false;
+static uint32_t bytes_read  = 0;
+static uint32_t read_count  = 0;
+
+void flash_init(void) {
+    initialised = true;
+}
+
+flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len) {
+    // A real chip can't be read before the SPI bus is set up
+    if (!initialised) {
+        return FLASH_STATUS_ERROR;
+    }
+    if (addr + len > MOCK_FLASH_SIZE) {
+        return FLASH_STATUS_BAD_ADDRESS;
+    }
+    memcpy(buf, &mock_flash[addr], len);
+    bytes_read += len;
+    read_count++;
+    return FLASH_STATUS_SUCCESS;
+}
+
+void mock_flash_write(uint32_t addr, const void *buf, size_t len) {
+    memcpy(&mock_flash[addr], buf, len);
+}
+
+uint32_t mock_flash_bytes_read(void) {
+    return bytes_read;
+}
+
+uint32_t mock_flash_read_count(void) {
+    return read_count;
+}
+
+bool mock_flash_is_initialised(void) {
+    return initialised;
+}
+
+void mock_flash_power_cycle(void) {
+    initialised = false;
+}
+
+void mock_flash_reset_counters(void) {
+    bytes_read = 0;
+    read_count = 0;
+}
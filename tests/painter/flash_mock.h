@@ -0,0 +1,35 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCK_FLASH_SIZE 4096
+
+// Copies data into the emulated flash chip
+void mock_flash_write(uint32_t addr, const void *buf, size_t len);
+
+// Total number of bytes read through flash_read_block() since the last reset
+uint32_t mock_flash_bytes_read(void);
+
+// Total number of flash_read_block() transactions since the last reset
+uint32_t mock_flash_read_count(void);
+
+void mock_flash_reset_counters(void);
+
+// Whether flash_init() has been called since the last power cycle
+bool mock_flash_is_initialised(void);
+
+// Returns the emulated chip to its uninitialised state, reads fail until flash_init() is called
+void mock_flash_power_cycle(void);
+
+#ifdef __cplusplus
+}
+#endif
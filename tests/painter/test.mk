@@ -0,0 +1,13 @@
+# Copyright 2023 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+QUANTUM_PAINTER_ENABLE = yes
+QUANTUM_PAINTER_DRIVERS = surface
+QUANTUM_PAINTER_FLASH_STREAM_ENABLE = yes
+FLASH_DRIVER = custom
+
+SRC += flash_mock.c thintel15.qff.c lock-caps-ON.qgf.c
@@ -0,0 +1,141 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "qp.h"
+#include "qp_draw.h"
+#include "qp_stream.h"
+#include "qp_surface.h"
+}
+
+#define CODEC_SURFACE_SIZE 240
+#define BENCH_FRAMES 20
+
+static uint8_t          codec_framebuffer[SURFACE_REQUIRED_BUFFER_BYTE_SIZE(CODEC_SURFACE_SIZE, CODEC_SURFACE_SIZE, 16)];
+static uint8_t          reference_framebuffer[sizeof(codec_framebuffer)];
+static painter_device_t codec_device = nullptr;
+
+class PainterCodec : public TestFixture {
+   protected:
+    void SetUp() override {
+        // Surfaces can't be released, so all tests share the one device
+        if (codec_device == nullptr) {
+            codec_device = qp_make_rgb565_surface(CODEC_SURFACE_SIZE, CODEC_SURFACE_SIZE, codec_framebuffer);
+        }
+        ASSERT_TRUE(qp_init(codec_device, QP_ROTATION_0));
+
+        for (int i = 0; i < 256; ++i) {
+            qp_internal_global_pixel_lookup_table[i].rgb565 = (uint16_t)(i * 0x0101 + 0x1234);
+        }
+    }
+
+    // Random packed pixel data, optionally wrapped in RLE non-repeating runs
+    std::vector<uint8_t> make_pixel_data(uint32_t byte_count, bool rle) {
+        std::vector<uint8_t> data;
+        uint32_t             seed = 0x1234567;
+        for (uint32_t i = 0; i < byte_count; ++i) {
+            if (rle && i % 128 == 0) {
+                uint32_t run = (byte_count - i) < 128 ? (byte_count - i) : 128;
+                data.push_back((uint8_t)(127 + run));
+            }
+            seed = seed * 1103515245 + 12345;
+            data.push_back((uint8_t)(seed >> 16));
+        }
+        return data;
+    }
+
+    // Draws the pixel data via the original one-pixel-at-a-time decode path
+    bool draw_per_pixel(uint16_t w, uint16_t h, uint8_t bpp, std::vector<uint8_t> &data, painter_compression_t compression) {
+        painter_driver_t *driver = (painter_driver_t *)codec_device;
+        driver->driver_vtable->viewport(codec_device, 0, 0, w - 1, h - 1);
+
+        qp_memory_stream_t               stream       = qp_make_memory_stream(data.data(), data.size());
+        qp_internal_byte_input_state_t   input_state  = {.device = codec_device, .src_stream = (qp_stream_t *)&stream};
+        qp_internal_byte_input_callback  callback     = qp_internal_prepare_input_state(&input_state, compression);
+        qp_internal_pixel_output_state_t output_state = {.device = codec_device, .pixel_write_pos = 0, .max_pixels = qp_internal_num_pixels_in_buffer(codec_device)};
+
+        bool ret = qp_internal_decode_palette(codec_device, (uint32_t)w * h, bpp, callback, &input_state, qp_internal_global_pixel_lookup_table, qp_internal_pixel_appender, &output_state);
+        if (ret && output_state.pixel_write_pos > 0) {
+            ret = driver->driver_vtable->pixdata(codec_device, qp_internal_global_pixdata_buffer, output_state.pixel_write_pos);
+        }
+        return ret;
+    }
+
+    // Draws the pixel data via the shared image/font appender
+    bool draw_appender(uint16_t w, uint16_t h, uint8_t bpp, std::vector<uint8_t> &data, painter_compression_t compression) {
+        painter_driver_t *driver = (painter_driver_t *)codec_device;
+        driver->driver_vtable->viewport(codec_device, 0, 0, w - 1, h - 1);
+
+        qp_memory_stream_t              stream      = qp_make_memory_stream(data.data(), data.size());
+        qp_internal_byte_input_state_t  input_state = {.device = codec_device, .src_stream = (qp_stream_t *)&stream};
+        qp_internal_byte_input_callback callback    = qp_internal_prepare_input_state(&input_state, compression);
+
+        return qp_internal_appender(codec_device, bpp, (uint32_t)w * h, callback, &input_state);
+    }
+
+    void expect_same_output(uint16_t w, uint16_t h, uint8_t bpp, painter_compression_t compression) {
+        uint32_t             byte_count = ((uint32_t)w * h * bpp + 7) / 8;
+        std::vector<uint8_t> data       = make_pixel_data(byte_count, compression == IMAGE_COMPRESSED_RLE);
+
+        memset(codec_framebuffer, 0, sizeof(codec_framebuffer));
+        ASSERT_TRUE(draw_per_pixel(w, h, bpp, data, compression));
+        memcpy(reference_framebuffer, codec_framebuffer, sizeof(codec_framebuffer));
+
+        memset(codec_framebuffer, 0, sizeof(codec_framebuffer));
+        ASSERT_TRUE(draw_appender(w, h, bpp, data, compression));
+        EXPECT_EQ(memcmp(reference_framebuffer, codec_framebuffer, sizeof(codec_framebuffer)), 0) << "bpp=" << (int)bpp << " size=" << w << "x" << h;
+    }
+};
+
+TEST_F(PainterCodec, block_decode_matches_per_pixel_decode) {
+    for (uint8_t bpp : {1, 2, 4, 8}) {
+        expect_same_output(CODEC_SURFACE_SIZE, CODEC_SURFACE_SIZE, bpp, IMAGE_UNCOMPRESSED);
+        expect_same_output(CODEC_SURFACE_SIZE, CODEC_SURFACE_SIZE, bpp, IMAGE_COMPRESSED_RLE);
+
+        // Pixel counts which don't fill the final byte, nor the pixdata buffer
+        expect_same_output(7, 5, bpp, IMAGE_UNCOMPRESSED);
+        expect_same_output(13, 11, bpp, IMAGE_COMPRESSED_RLE);
+    }
+}
+
+TEST_F(PainterCodec, native_pixels_read_straight_into_buffer) {
+    uint32_t             byte_count = (uint32_t)CODEC_SURFACE_SIZE * 100 * 2;
+    std::vector<uint8_t> data       = make_pixel_data(byte_count, false);
+
+    memset(codec_framebuffer, 0, sizeof(codec_framebuffer));
+    ASSERT_TRUE(draw_appender(CODEC_SURFACE_SIZE, 100, 16, data, IMAGE_UNCOMPRESSED));
+    EXPECT_EQ(memcmp(codec_framebuffer, data.data(), byte_count), 0);
+
+    // Running out of data fails the draw
+    data.resize(byte_count - 1);
+    EXPECT_FALSE(draw_appender(CODEC_SURFACE_SIZE, 100, 16, data, IMAGE_UNCOMPRESSED));
+}
+
+TEST_F(PainterCodec, benchmark_palette_decode) {
+    const uint32_t pixels = (uint32_t)CODEC_SURFACE_SIZE * CODEC_SURFACE_SIZE;
+    for (uint8_t bpp : {1, 2, 4, 8}) {
+        std::vector<uint8_t> data = make_pixel_data((pixels * bpp + 7) / 8, false);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_FRAMES; ++i) {
+            ASSERT_TRUE(draw_per_pixel(CODEC_SURFACE_SIZE, CODEC_SURFACE_SIZE, bpp, data, IMAGE_UNCOMPRESSED));
+        }
+        std::chrono::duration<double> before = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_FRAMES; ++i) {
+            ASSERT_TRUE(draw_appender(CODEC_SURFACE_SIZE, CODEC_SURFACE_SIZE, bpp, data, IMAGE_UNCOMPRESSED));
+        }
+        std::chrono::duration<double> after = std::chrono::steady_clock::now() - start;
+
+        double mpix = (double)pixels * BENCH_FRAMES / 1e6;
+        std::cout << "[ BENCH    ] " << (int)bpp << "bpp palette -> rgb565: per-pixel " << mpix / before.count() << " MPix/s, block " << mpix / after.count() << " MPix/s" << std::endl;
+    }
+}
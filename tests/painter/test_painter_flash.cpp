@@ -0,0 +1,149 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <iostream>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "qp.h"
+#include "qp_surface.h"
+#include "flash_mock.h"
+#include "thintel15.qff.h"
+#include "lock-caps-ON.qgf.h"
+}
+
+#define SURFACE_WIDTH 128
+#define SURFACE_HEIGHT 32
+#define FONT_ADDRESS 0x0000
+#define IMAGE_ADDRESS 0x0800
+
+static uint8_t          framebuffer[SURFACE_REQUIRED_BUFFER_BYTE_SIZE(SURFACE_WIDTH, SURFACE_HEIGHT, 16)];
+static painter_device_t device = nullptr;
+
+class PainterFlash : public TestFixture {
+   protected:
+    void SetUp() override {
+        // Surfaces can't be released, so all tests share the one device
+        if (device == nullptr) {
+            device = qp_make_rgb565_surface(SURFACE_WIDTH, SURFACE_HEIGHT, framebuffer);
+        }
+        mock_flash_write(FONT_ADDRESS, font_thintel15, font_thintel15_length);
+        mock_flash_write(IMAGE_ADDRESS, gfx_lock_caps_ON, gfx_lock_caps_ON_length);
+        mock_flash_reset_counters();
+        mock_flash_power_cycle();
+
+        ASSERT_TRUE(qp_init(device, QP_ROTATION_0));
+    }
+
+    void draw_status_screen(painter_image_handle_t image, painter_font_handle_t font) {
+        EXPECT_TRUE(qp_drawimage(device, 0, 0, image));
+        EXPECT_NE(qp_drawtext(device, 40, 0, font, "Layer: BASE"), 0);
+        EXPECT_NE(qp_drawtext(device, 40, 16, font, "WPM: 42"), 0);
+    }
+};
+
+TEST_F(PainterFlash, loads_assets_from_flash) {
+    painter_font_handle_t  mem_font   = qp_load_font_mem(font_thintel15);
+    painter_font_handle_t  flash_font = qp_load_font_flash(FONT_ADDRESS);
+    painter_image_handle_t image      = qp_load_image_flash(IMAGE_ADDRESS);
+
+    ASSERT_NE(flash_font, nullptr);
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(flash_font->line_height, mem_font->line_height);
+    EXPECT_EQ(qp_textwidth(flash_font, "Layer: BASE"), qp_textwidth(mem_font, "Layer: BASE"));
+    EXPECT_GT(mock_flash_bytes_read(), 0u);
+
+    // Nothing is mapped at the end of the flash chip
+    EXPECT_EQ(qp_load_font_flash(MOCK_FLASH_SIZE - 4), nullptr);
+
+    EXPECT_TRUE(qp_close_image(image));
+    EXPECT_TRUE(qp_close_font(flash_font));
+    EXPECT_TRUE(qp_close_font(mem_font));
+}
+
+TEST_F(PainterFlash, loading_initialises_flash) {
+    painter_image_handle_t image = qp_load_image_flash(IMAGE_ADDRESS);
+    ASSERT_NE(image, nullptr);
+    EXPECT_TRUE(mock_flash_is_initialised());
+    EXPECT_TRUE(qp_close_image(image));
+
+    mock_flash_power_cycle();
+    painter_font_handle_t font = qp_load_font_flash(FONT_ADDRESS);
+    ASSERT_NE(font, nullptr);
+    EXPECT_TRUE(mock_flash_is_initialised());
+    EXPECT_TRUE(qp_close_font(font));
+}
+
+TEST_F(PainterFlash, renders_identically_to_memory) {
+    static uint8_t expected[sizeof(framebuffer)];
+
+    painter_font_handle_t  font  = qp_load_font_mem(font_thintel15);
+    painter_image_handle_t image = qp_load_image_mem(gfx_lock_caps_ON);
+    draw_status_screen(image, font);
+    memcpy(expected, framebuffer, sizeof(framebuffer));
+    qp_close_image(image);
+    qp_close_font(font);
+
+    memset(framebuffer, 0, sizeof(framebuffer));
+    font  = qp_load_font_flash(FONT_ADDRESS);
+    image = qp_load_image_flash(IMAGE_ADDRESS);
+
+    // Once uncached, once with glyphs replayed from the cache
+    draw_status_screen(image, font);
+    EXPECT_EQ(memcmp(expected, framebuffer, sizeof(framebuffer)), 0);
+    memset(framebuffer, 0, sizeof(framebuffer));
+    draw_status_screen(image, font);
+    EXPECT_EQ(memcmp(expected, framebuffer, sizeof(framebuffer)), 0);
+
+    qp_close_image(image);
+    qp_close_font(font);
+}
+
+TEST_F(PainterFlash, glyph_cache_reduces_bytes_read_per_frame) {
+    painter_font_handle_t  font  = qp_load_font_flash(FONT_ADDRESS);
+    painter_image_handle_t image = qp_load_image_flash(IMAGE_ADDRESS);
+
+    mock_flash_reset_counters();
+    draw_status_screen(image, font);
+    uint32_t first_frame_bytes = mock_flash_bytes_read();
+    uint32_t first_frame_reads = mock_flash_read_count();
+
+    // Only the image should need to be streamed again, text comes from the glyph cache
+    mock_flash_reset_counters();
+    for (int i = 0; i < 10; ++i) {
+        draw_status_screen(image, font);
+    }
+    uint32_t frame_bytes = mock_flash_bytes_read() / 10;
+    uint32_t frame_reads = mock_flash_read_count() / 10;
+
+    mock_flash_reset_counters();
+    EXPECT_TRUE(qp_drawimage(device, 0, 0, image));
+    EXPECT_EQ(frame_bytes, mock_flash_bytes_read());
+    EXPECT_LT(frame_bytes, first_frame_bytes);
+
+    std::cout << "[ BENCH    ] status screen: first frame " << first_frame_bytes << " bytes in " << first_frame_reads << " reads, then " << frame_bytes << " bytes in " << frame_reads << " reads per frame" << std::endl;
+
+    qp_close_image(image);
+    qp_close_font(font);
+}
+
+TEST_F(PainterFlash, closing_font_drops_cached_glyphs) {
+    painter_font_handle_t font = qp_load_font_flash(FONT_ADDRESS);
+    EXPECT_NE(qp_drawtext(device, 0, 0, font, "A"), 0);
+    qp_close_font(font);
+
+    // Reload into the same slot from a different address -- glyphs must be fetched again
+    mock_flash_write(0x0400, font_thintel15, font_thintel15_length);
+    font = qp_load_font_flash(0x0400);
+    mock_flash_reset_counters();
+    EXPECT_NE(qp_drawtext(device, 0, 0, font, "A"), 0);
+    EXPECT_GT(mock_flash_bytes_read(), 0u);
+
+    mock_flash_reset_counters();
+    EXPECT_NE(qp_drawtext(device, 0, 0, font, "A"), 0);
+    EXPECT_EQ(mock_flash_bytes_read(), 0u);
+
+    qp_close_font(font);
+}
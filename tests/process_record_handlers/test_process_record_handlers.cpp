@@ -0,0 +1,85 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+static const process_record_handler_stats_t *stats(const char *name) {
+    for (uint8_t i = 0; i < process_record_handler_count(); ++i) {
+        if (strcmp(process_record_handler_name(i), name) == 0) {
+            return process_record_handler_get_stats(i);
+        }
+    }
+    return nullptr;
+}
+
+class ProcessRecordHandlers : public TestFixture {
+   public:
+    void SetUp() override {
+        process_record_handler_reset_stats();
+    }
+};
+
+TEST_F(ProcessRecordHandlers, BasicKeycodesSkipRangeHandlers) {
+    TestDriver driver;
+    InSequence s;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    ASSERT_NE(stats("process_record_kb"), nullptr);
+    EXPECT_EQ(stats("process_record_kb")->invocations, 2);
+    EXPECT_EQ(stats("process_space_cadet")->invocations, 2);
+    EXPECT_EQ(stats("process_grave_esc")->invocations, 0);
+    EXPECT_EQ(stats("process_grave_esc")->skipped, 2);
+    EXPECT_EQ(stats("process_magic")->skipped, 2);
+    EXPECT_EQ(stats("process_tri_layer")->skipped, 2);
+}
+
+TEST_F(ProcessRecordHandlers, HandlersSeeTheirKeycodes) {
+    TestDriver driver;
+    InSequence s;
+    auto       gesc  = KeymapKey(0, 0, 0, QK_GRAVE_ESCAPE);
+    auto       lower = KeymapKey(0, 1, 0, QK_TRI_LAYER_LOWER);
+
+    set_keymap({gesc, lower});
+
+    EXPECT_REPORT(driver, (KC_ESC));
+    gesc.press();
+    run_one_scan_loop();
+    EXPECT_EMPTY_REPORT(driver);
+    gesc.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(stats("process_grave_esc")->invocations, 2);
+    // Grave Escape handles the keycode, so the handlers behind it are not reached
+    EXPECT_EQ(stats("process_tri_layer")->invocations, 0);
+    EXPECT_EQ(stats("process_tri_layer")->skipped, 0);
+
+    EXPECT_NO_REPORT(driver);
+    lower.press();
+    run_one_scan_loop();
+    EXPECT_TRUE(layer_state_is(get_tri_layer_lower_layer()));
+    lower.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(stats("process_tri_layer")->invocations, 2);
+    EXPECT_EQ(stats("process_grave_esc")->skipped, 2);
+}
@@ -0,0 +1,66 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "task_scheduler.h"
+
+using testing::_;
+using testing::InSequence;
+
+static uint32_t user_task_calls = 0;
+
+static bool user_task(void) {
+    user_task_calls++;
+    return false;
+}
+
+class TaskSchedulerTest : public TestFixture {
+   public:
+    void SetUp() override {
+        if (task_scheduler_find("user") == INVALID_TASK_ID) {
+            task_scheduler_task_t task = {"user", user_task, 10, 0, TASK_PRIORITY_LOW};
+            task_scheduler_register(&task);
+        }
+        user_task_calls = 0;
+    }
+};
+
+TEST_F(TaskSchedulerTest, CoreTasksAreRegistered) {
+    TestDriver driver;
+    task_scheduler_id_t led = task_scheduler_find("led");
+    ASSERT_NE(led, INVALID_TASK_ID);
+
+    idle_for(10);
+    EXPECT_GE(task_scheduler_get_profile(led)->calls, 10);
+    // Without a microsecond timer nothing is deferred
+    EXPECT_EQ(task_scheduler_get_profile(led)->deferrals, 0);
+}
+
+TEST_F(TaskSchedulerTest, UserTaskRunsAtItsPeriod) {
+    TestDriver driver;
+    idle_for(100);
+    EXPECT_GE(user_task_calls, 9);
+    EXPECT_LE(user_task_calls, 11);
+}
+
+TEST_F(TaskSchedulerTest, KeysAreProcessed) {
+    TestDriver driver;
+    InSequence s;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
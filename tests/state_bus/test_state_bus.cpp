@@ -0,0 +1,172 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "state_bus.h"
+#include "caps_word.h"
+
+using testing::_;
+using testing::AnyNumber;
+
+struct Notification {
+    state_domain_mask_t changed;
+    state_bus_state_t   state;
+};
+
+static std::vector<Notification> layer_events;
+static std::vector<Notification> mods_events;
+
+static void on_layers(state_domain_mask_t changed, const state_bus_state_t *state) {
+    layer_events.push_back({changed, *state});
+}
+
+static void on_mods(state_domain_mask_t changed, const state_bus_state_t *state) {
+    mods_events.push_back({changed, *state});
+}
+
+class StateBus : public TestFixture {
+   public:
+    void SetUp() override {
+        layers_subscriber = state_bus_subscribe(STATE_DOMAIN_LAYERS, on_layers);
+        mods_subscriber   = state_bus_subscribe(STATE_DOMAIN_MODS | STATE_DOMAIN_LED | STATE_DOMAIN_CAPS_WORD, on_mods);
+        layer_events.clear();
+        mods_events.clear();
+    }
+
+    void TearDown() override {
+        state_bus_unsubscribe(layers_subscriber);
+        state_bus_unsubscribe(mods_subscriber);
+    }
+
+    state_bus_subscriber_t layers_subscriber;
+    state_bus_subscriber_t mods_subscriber;
+};
+
+TEST_F(StateBus, SubscribersGetTheInitialStateOnce) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    idle_for(10);
+    ASSERT_EQ(layer_events.size(), 1);
+    EXPECT_EQ(layer_events[0].changed, STATE_DOMAIN_LAYERS);
+    ASSERT_EQ(mods_events.size(), 1);
+    EXPECT_EQ(mods_events[0].changed, STATE_DOMAIN_MODS | STATE_DOMAIN_LED | STATE_DOMAIN_CAPS_WORD);
+
+    EXPECT_EQ(state_bus_get_subscriber_stats(layers_subscriber)->skipped, 9);
+    EXPECT_EQ(state_bus_get_subscriber_stats(mods_subscriber)->skipped, 9);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(StateBus, LayerChangesOnlyNotifyLayerSubscribers) {
+    TestDriver driver;
+    auto       layer_key = KeymapKey(0, 0, 0, MO(1));
+    auto       key_b     = KeymapKey(1, 1, 0, KC_B);
+
+    set_keymap({layer_key, key_b});
+    run_one_scan_loop();
+    layer_events.clear();
+    mods_events.clear();
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.press();
+    run_one_scan_loop();
+    layer_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    ASSERT_EQ(layer_events.size(), 2);
+    EXPECT_EQ(layer_events[0].state.layer_state, 1 << 1);
+    EXPECT_EQ(layer_events[1].state.layer_state, 0);
+    EXPECT_TRUE(mods_events.empty());
+}
+
+TEST_F(StateBus, ChangesWithinAScanAreCoalesced) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+    run_one_scan_loop();
+    layer_events.clear();
+
+    layer_on(1);
+    layer_on(2);
+    run_one_scan_loop();
+    ASSERT_EQ(layer_events.size(), 1);
+    EXPECT_EQ(layer_events[0].state.layer_state, (1 << 1) | (1 << 2));
+
+    // A change that is reverted before the next scan is not seen at all
+    layer_on(3);
+    layer_off(3);
+    run_one_scan_loop();
+    EXPECT_EQ(layer_events.size(), 1);
+
+    layer_clear();
+    run_one_scan_loop();
+    EXPECT_EQ(layer_events.size(), 2);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(StateBus, ModsLedAndCapsWordChangesAreReported) {
+    TestDriver driver;
+    auto       shift_key = KeymapKey(0, 0, 0, KC_LSFT);
+
+    set_keymap({shift_key});
+    run_one_scan_loop();
+    layer_events.clear();
+    mods_events.clear();
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    shift_key.press();
+    run_one_scan_loop();
+    ASSERT_EQ(mods_events.size(), 1);
+    EXPECT_EQ(mods_events[0].changed, STATE_DOMAIN_MODS);
+    EXPECT_EQ(mods_events[0].state.mods, MOD_BIT(KC_LSFT));
+
+    EXPECT_EMPTY_REPORT(driver);
+    shift_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(mods_events.size(), 2);
+
+    led_t leds     = {};
+    leds.caps_lock = true;
+    driver.set_leds(leds.raw);
+    run_one_scan_loop();
+    ASSERT_EQ(mods_events.size(), 3);
+    EXPECT_EQ(mods_events[2].changed, STATE_DOMAIN_LED);
+    EXPECT_TRUE(mods_events[2].state.led_state.caps_lock);
+
+    EXPECT_REPORT(driver, (KC_LSFT)).Times(AnyNumber());
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    caps_word_on();
+    run_one_scan_loop();
+    caps_word_off();
+    run_one_scan_loop();
+    ASSERT_EQ(mods_events.size(), 5);
+    EXPECT_EQ(mods_events[3].changed & STATE_DOMAIN_CAPS_WORD, STATE_DOMAIN_CAPS_WORD);
+    EXPECT_TRUE(mods_events[3].state.caps_word);
+    EXPECT_FALSE(mods_events[4].state.caps_word);
+    EXPECT_TRUE(layer_events.empty());
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(StateBus, UnchangedScansAreCounted) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+    run_one_scan_loop();
+    state_bus_reset_stats();
+
+    idle_for(100);
+    layer_on(1);
+    run_one_scan_loop();
+
+    EXPECT_EQ(state_bus_get_stats()->scans, 101);
+    EXPECT_EQ(state_bus_get_stats()->changes, 1);
+    EXPECT_EQ(state_bus_get_subscriber_stats(layers_subscriber)->notifications, 1);
+    EXPECT_EQ(state_bus_get_subscriber_stats(layers_subscriber)->skipped, 100);
+    EXPECT_EQ(state_bus_get_subscriber_stats(mods_subscriber)->skipped, 101);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,9 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define STENO_DICTIONARY_ADDR 256
+#define EXTERNAL_FLASH_SPI_SLAVE_SELECT_PIN 0
@@ -0,0 +1,17 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+// steno_dictionary.json converted with `qmk generate-steno-dictionary --buckets 8`
+static const uint8_t steno_dictionary_image[] = {
+    0x53, 0x54, 0x4E, 0x44, 0x01, 0x00, 0x08, 0x00, 0x28, 0x00, 0x00, 0x00, 0x31, 0x00, 0x00, 0x00,
+    0x39, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x00, 0x62, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x02, 0x69,
+    0x66, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x01, 0x61, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02,
+    0x6F, 0x66, 0x00, 0x00, 0x00, 0x01, 0x00, 0x02, 0x19, 0x74, 0x68, 0x65, 0x20, 0x71, 0x75, 0x69,
+    0x63, 0x6B, 0x20, 0x62, 0x72, 0x6F, 0x77, 0x6E, 0x20, 0x66, 0x6F, 0x78, 0x20, 0x6A, 0x75, 0x6D,
+    0x70, 0x73, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x32,
+};
@@ -0,0 +1,62 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stdint.h>
+#include <string.h>
+#include "flash_spi.h"
+#include "virtser.h"
+#include "steno_mock.h"
+
+static uint8_t  mock_flash[MOCK_FLASH_SIZE];
+static bool     flash_initialised = false;
+static bool     flash_failing     = false;
+static uint32_t read_count        = 0;
+static uint8_t  sent[64];
+static size_t   sent_count = 0;
+
+void flash_init(void) {
+    flash_initialised = true;
+}
+
+flash_status_t flash_read_block(uint32_t addr, void *buf, size_t len) {
+    if (!flash_initialised || flash_failing) {
+        return FLASH_STATUS_ERROR;
+    }
+    if (addr + len > MOCK_FLASH_SIZE) {
+        return FLASH_STATUS_BAD_ADDRESS;
+    }
+    memcpy(buf, &mock_flash[addr], len);
+    read_count++;
+    return FLASH_STATUS_SUCCESS;
+}
+
+void mock_flash_write(uint32_t addr, const void *buf, size_t len) {
+    memcpy(&mock_flash[addr], buf, len);
+}
+
+void mock_flash_fail(bool fail) {
+    flash_failing = fail;
+}
+
+uint32_t mock_flash_read_count(void) {
+    return read_count;
+}
+
+void virtser_init(void) {}
+
+void virtser_send(const uint8_t byte) {
+    if (sent_count < sizeof(sent)) {
+        sent[sent_count] = byte;
+    }
+    sent_count++;
+}
+
+size_t mock_virtser_sent(uint8_t *buf, size_t len) {
+    memcpy(buf, sent, sent_count < len ? sent_count : len);
+    return sent_count;
+}
+
+void mock_steno_reset(void) {
+    read_count = 0;
+    sent_count = 0;
+}
@@ -0,0 +1,32 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOCK_FLASH_SIZE 4096
+
+// Copies data into the emulated flash chip
+void mock_flash_write(uint32_t addr, const void *buf, size_t len);
+
+// Makes flash_read_block() fail, as if the chip did not respond
+void mock_flash_fail(bool fail);
+
+// Number of flash_read_block() transactions since the last reset
+uint32_t mock_flash_read_count(void);
+
+// Bytes sent through virtser_send() since the last reset
+size_t mock_virtser_sent(uint8_t *buf, size_t len);
+
+void mock_steno_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
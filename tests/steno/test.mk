@@ -0,0 +1,13 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# --------------------------------------------------------------------------------
+# Keep this file, even if it is empty, as a marker that this folder contains tests
+# --------------------------------------------------------------------------------
+
+STENO_ENABLE = yes
+STENO_DICTIONARY_ENABLE = yes
+VIRTSER_ENABLE = yes
+FLASH_DRIVER = custom
+
+SRC += steno_mock.c
@@ -0,0 +1,182 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+#include "steno_mock.h"
+#include "steno_dictionary_image.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class Steno : public TestFixture {
+   public:
+    KeymapKey key_s  = KeymapKey(0, 0, 0, STN_S1);
+    KeymapKey key_t  = KeymapKey(0, 1, 0, STN_TL);
+    KeymapKey key_p  = KeymapKey(0, 2, 0, STN_PL);
+    KeymapKey key_a  = KeymapKey(0, 3, 0, STN_A);
+    KeymapKey key_o  = KeymapKey(0, 4, 0, STN_O);
+    KeymapKey key_e  = KeymapKey(0, 5, 0, STN_E);
+    KeymapKey key_zr = KeymapKey(0, 6, 0, STN_ZR);
+
+    KeymapKey key_num = KeymapKey(0, 7, 0, STN_N1);
+
+    void SetUp() override {
+        // Generated with few buckets, so that lookups have to probe past colliding entries
+        mock_flash_write(STENO_DICTIONARY_ADDR, steno_dictionary_image, sizeof(steno_dictionary_image));
+        set_keymap({key_s, key_t, key_p, key_a, key_o, key_e, key_zr, key_num});
+        mock_steno_reset();
+    }
+
+    void stroke(const std::vector<KeymapKey> &keys) {
+        for (auto key : keys) {
+            key.press();
+        }
+        run_one_scan_loop();
+        for (auto key : keys) {
+            key.release();
+            run_one_scan_loop();
+        }
+    }
+
+    std::vector<uint8_t> sent_packets() {
+        uint8_t buf[64];
+        size_t  count = mock_virtser_sent(buf, sizeof(buf));
+        return std::vector<uint8_t>(buf, buf + count);
+    }
+};
+
+TEST_F(Steno, sends_gemini_packet_for_untranslated_stroke) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    stroke({key_s, key_t, key_a});
+    VERIFY_AND_CLEAR(driver);
+
+    // S- is key 7 and T- key 9, both in the second group; A is key 15, in the third
+    EXPECT_EQ(sent_packets(), (std::vector<uint8_t>{0x80, 0x40 | 0x10, 0x20, 0x00, 0x00, 0x00}));
+}
+
+TEST_F(Steno, queues_packets_without_sending) {
+    keyrecord_t record = {};
+
+    record.event.type    = KEY_EVENT;
+    record.event.pressed = true;
+    process_steno(STN_NUM, &record);
+    record.event.pressed = false;
+    process_steno(STN_NUM, &record);
+    EXPECT_TRUE(sent_packets().empty());
+
+    steno_task();
+    EXPECT_EQ(sent_packets(), (std::vector<uint8_t>{0x80 | 0x20, 0x00, 0x00, 0x00, 0x00, 0x00}));
+}
+
+TEST_F(Steno, sends_bolt_packet) {
+    TestDriver driver;
+
+    steno_set_mode(STENO_MODE_BOLT);
+
+    EXPECT_NO_REPORT(driver);
+    stroke({key_s, key_t});
+    VERIFY_AND_CLEAR(driver);
+
+    steno_set_mode(STENO_MODE_GEMINI);
+
+    EXPECT_EQ(sent_packets(), (std::vector<uint8_t>{TXB_S_L | TXB_T_L, 0x00}));
+}
+
+TEST_F(Steno, translates_stroke) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_I));
+        EXPECT_REPORT(driver, (KC_F));
+    }
+    stroke({key_t, key_p});
+    idle_for(10);
+    EXPECT_FALSE(steno_output_pending());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_TRUE(sent_packets().empty());
+}
+
+TEST_F(Steno, translates_stroke_sequence) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_A));
+        EXPECT_REPORT(driver, (KC_O));
+        EXPECT_REPORT(driver, (KC_F));
+        for (char c : std::string("the quick brown fox jumps")) {
+            if (c == ' ') {
+                EXPECT_REPORT(driver, (KC_SPACE));
+            } else {
+                EXPECT_REPORT(driver, (KC_A + c - 'a'));
+            }
+        }
+    }
+    stroke({key_a});
+    stroke({key_o});
+    stroke({key_e, key_zr});
+    idle_for(100);
+    EXPECT_FALSE(steno_output_pending());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_TRUE(sent_packets().empty());
+}
+
+TEST_F(Steno, hash_matches_dictionary_generator) {
+    // Same values as lib/python/qmk/tests/test_steno_dictionary.py
+    EXPECT_EQ(steno_dictionary_hash(0xA00), 0x2AC0);
+    EXPECT_EQ(steno_dictionary_hash(0x20001000000), 0x7E98);
+    EXPECT_EQ(steno_dictionary_hash(0x207FF03FE80), 0x56B5);
+}
+
+TEST_F(Steno, translates_number_stroke) {
+    TestDriver driver;
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    EXPECT_REPORT(driver, (KC_2));
+    stroke({key_num, key_t});
+    idle_for(10);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_TRUE(sent_packets().empty());
+}
+
+TEST_F(Steno, retries_dictionary_after_failed_read) {
+    TestDriver driver;
+
+    steno_init();
+
+    // The chip does not respond yet, so the stroke goes to the host
+    mock_flash_fail(true);
+    EXPECT_NO_REPORT(driver);
+    stroke({key_t, key_p});
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_FALSE(sent_packets().empty());
+    mock_flash_fail(false);
+    mock_steno_reset();
+
+    EXPECT_EMPTY_REPORT(driver).Times(AnyNumber());
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_I));
+        EXPECT_REPORT(driver, (KC_F));
+    }
+    stroke({key_t, key_p});
+    idle_for(10);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_TRUE(sent_packets().empty());
+}
@@ -0,0 +1,14 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+// Enough keys for more dances than a signed 8 bit slot index can address
+#undef MATRIX_ROWS
+#define MATRIX_ROWS 16
+
+#define TAP_DANCE_MAX_SIMULTANEOUS 150
+
+#define TAPPING_TERM 1000
@@ -0,0 +1,14 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+uint8_t finished_taps[TAP_DANCE_MAX_SIMULTANEOUS];
+
+static void count_finished(tap_dance_state_t *state, void *user_data) {
+    finished_taps[(tap_dance_action_t *)state - tap_dance_actions] += state->count;
+}
+
+tap_dance_action_t tap_dance_actions[] = {
+    [0 ... TAP_DANCE_MAX_SIMULTANEOUS - 1] = ACTION_TAP_DANCE_FN(count_finished),
+};
@@ -0,0 +1,38 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+extern uint8_t finished_taps[TAP_DANCE_MAX_SIMULTANEOUS];
+}
+
+using testing::_;
+
+class TapDanceMany : public TestFixture {};
+
+TEST_F(TapDanceMany, MoreThan127DancesInProgress) {
+    TestDriver driver;
+    const int  dances = 140;
+
+    for (int i = 0; i < dances; i++) {
+        add_key(KeymapKey{0, (uint8_t)(i % MATRIX_COLS), (uint8_t)(i / MATRIX_COLS), (uint16_t)TD(i)});
+    }
+    memset(finished_taps, 0, sizeof(finished_taps));
+
+    EXPECT_NO_REPORT(driver);
+    for (int i = 0; i < dances; i++) {
+        tap_key(KeymapKey{0, (uint8_t)(i % MATRIX_COLS), (uint8_t)(i / MATRIX_COLS), (uint16_t)TD(i)});
+    }
+    // A second tap on one of the dances beyond slot 127 finds its slot again
+    tap_key(KeymapKey{0, (uint8_t)((dances - 1) % MATRIX_COLS), (uint8_t)((dances - 1) / MATRIX_COLS), (uint16_t)TD(dances - 1)});
+    idle_for(TAPPING_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+
+    for (int i = 0; i < dances - 1; i++) {
+        EXPECT_EQ(finished_taps[i], 1) << "dance " << i;
+    }
+    EXPECT_EQ(finished_taps[dances - 1], 2);
+}
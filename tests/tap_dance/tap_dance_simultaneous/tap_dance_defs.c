@@ -0,0 +1,23 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+#include "tap_dance_defs.h"
+
+uint32_t get_tapping_term_calls = 0;
+
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    get_tapping_term_calls++;
+    switch (keycode) {
+        case TD(TD_C_D):
+            return SLOW_TAPPING_TERM;
+        default:
+            return TAPPING_TERM;
+    }
+}
+
+tap_dance_action_t tap_dance_actions[] = {
+    [TD_A_B] = ACTION_TAP_DANCE_DOUBLE(KC_A, KC_B),
+    [TD_C_D] = ACTION_TAP_DANCE_DOUBLE(KC_C, KC_D),
+    [TD_E_F] = ACTION_TAP_DANCE_DOUBLE(KC_E, KC_F),
+};
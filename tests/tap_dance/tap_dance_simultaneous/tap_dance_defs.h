@@ -0,0 +1,25 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    TD_A_B,
+    TD_C_D,
+    TD_E_F,
+};
+
+// Dances on TD_C_D take twice as long to time out
+#define SLOW_TAPPING_TERM (TAPPING_TERM * 2)
+
+extern uint32_t get_tapping_term_calls;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,156 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_keymap_key.hpp"
+#include "tap_dance_defs.h"
+
+extern "C" {
+uint32_t current_access_counter(void);
+void     reset_access_counter(void);
+}
+
+using testing::_;
+using testing::InSequence;
+
+class TapDanceSimultaneous : public TestFixture {};
+
+TEST_F(TapDanceSimultaneous, IdleScansDoNoWork) {
+    TestDriver driver;
+    auto       key_ab = KeymapKey{0, 1, 0, TD(TD_A_B)};
+
+    set_keymap({key_ab});
+
+    /* Nothing in progress: the task does not even read the timer */
+    get_tapping_term_calls = 0;
+    reset_access_counter();
+    tap_dance_task();
+    EXPECT_EQ(current_access_counter(), 0);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(TAPPING_TERM * 2);
+    EXPECT_EQ(get_tapping_term_calls, 0);
+    VERIFY_AND_CLEAR(driver);
+
+    /* While a dance is pending, the tapping term is looked up once per tap rather than every scan */
+    tap_key(key_ab);
+    EXPECT_EQ(get_tapping_term_calls, 1);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    EXPECT_EQ(get_tapping_term_calls, 1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapDanceSimultaneous, InterleavedDancesResolveIndependently) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab = KeymapKey{0, 1, 0, TD(TD_A_B)};
+    auto       key_cd = KeymapKey{0, 2, 0, TD(TD_C_D)};
+
+    set_keymap({key_ab, key_cd});
+
+    /* A tap on each key: neither interrupts the other */
+    EXPECT_NO_REPORT(driver);
+    tap_key(key_ab);
+    tap_key(key_cd);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Second tap on the first key completes its double tap */
+    EXPECT_REPORT(driver, (KC_B));
+    key_ab.press();
+    run_one_scan_loop();
+    EXPECT_EMPTY_REPORT(driver);
+    key_ab.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* The second dance times out on its own, longer tapping term */
+    EXPECT_NO_REPORT(driver);
+    idle_for(SLOW_TAPPING_TERM - 3);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapDanceSimultaneous, DeadlinesFireInTimeOrder) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab = KeymapKey{0, 1, 0, TD(TD_A_B)};
+    auto       key_cd = KeymapKey{0, 2, 0, TD(TD_C_D)};
+
+    set_keymap({key_ab, key_cd});
+
+    /* The slower dance starts first but finishes last */
+    tap_key(key_cd);
+    tap_key(key_ab);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(SLOW_TAPPING_TERM - TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapDanceSimultaneous, ThirdDanceInterruptsOldest) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab = KeymapKey{0, 1, 0, TD(TD_A_B)};
+    auto       key_cd = KeymapKey{0, 2, 0, TD(TD_C_D)};
+    auto       key_ef = KeymapKey{0, 3, 0, TD(TD_E_F)};
+
+    set_keymap({key_ab, key_cd, key_ef});
+
+    tap_key(key_ab);
+    tap_key(key_cd);
+
+    /* No room for a third dance, so the oldest one finishes */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_ef);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_E));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(SLOW_TAPPING_TERM);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapDanceSimultaneous, RegularKeyInterruptsAllDances) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_ab      = KeymapKey{0, 1, 0, TD(TD_A_B)};
+    auto       key_cd      = KeymapKey{0, 2, 0, TD(TD_C_D)};
+    auto       regular_key = KeymapKey{0, 3, 0, KC_X};
+
+    set_keymap({key_ab, key_cd, regular_key});
+
+    tap_key(key_ab);
+    tap_key(key_cd);
+
+    /* Both dances finish, oldest first, before the interrupting key */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_X));
+    regular_key.press();
+    run_one_scan_loop();
+    EXPECT_EMPTY_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
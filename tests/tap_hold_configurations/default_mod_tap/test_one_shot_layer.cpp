@@ -35,6 +35,7 @@ TEST_F(OneShotLayerModTap, tap_mod_tap_hold_key) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     expect_layer_state(0);
     testing::Mock::VerifyAndClearExpectations(&driver);
 }
@@ -143,6 +144,7 @@ TEST_F(OneShotLayerModTap, tap_a_mod_tap_key_while_another_mod_tap_key_is_held_t
     EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
     second_mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     expect_layer_state(0);
     testing::Mock::VerifyAndClearExpectations(&driver);
 
@@ -150,6 +152,7 @@ TEST_F(OneShotLayerModTap, tap_a_mod_tap_key_while_another_mod_tap_key_is_held_t
     EXPECT_EMPTY_REPORT(driver);
     first_mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     testing::Mock::VerifyAndClearExpectations(&driver);
 }
 
@@ -196,6 +199,7 @@ TEST_F(OneShotLayerModTap, tap_regular_key_while_mod_tap_key_is_held) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     expect_layer_state(0);
     testing::Mock::VerifyAndClearExpectations(&driver);
 }
@@ -243,6 +247,7 @@ TEST_F(OneShotLayerModTap, tap_a_mod_tap_key_while_another_mod_tap_key_is_held)
     EXPECT_EMPTY_REPORT(driver);
     first_mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     expect_layer_state(0);
     testing::Mock::VerifyAndClearExpectations(&driver);
 }
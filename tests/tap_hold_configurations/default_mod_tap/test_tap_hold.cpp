@@ -59,6 +59,7 @@ TEST_F(DefaultTapHold, tap_regular_key_while_mod_tap_key_is_held) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Idle for tapping term of mod tap hold key. */
@@ -99,6 +100,8 @@ TEST_F(DefaultTapHold, tap_a_mod_tap_key_while_another_mod_tap_key_is_held) {
     EXPECT_EMPTY_REPORT(driver);
     first_mod_tap_hold_key.release();
     run_one_scan_loop();
+    /* Both taps are held for TAP_CODE_DELAY, one after the other. */
+    idle_for(TAP_CODE_DELAY * 2);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -136,6 +139,7 @@ TEST_F(DefaultTapHold, tap_regular_key_while_layer_tap_key_is_held) {
     EXPECT_EMPTY_REPORT(driver);
     layer_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -157,6 +161,7 @@ TEST_F(DefaultTapHold, tap_mod_tap_hold_key_two_times) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Press mod-tap-hold key again. */
@@ -169,6 +174,7 @@ TEST_F(DefaultTapHold, tap_mod_tap_hold_key_two_times) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -190,6 +196,7 @@ TEST_F(DefaultTapHold, tap_mod_tap_hold_key_twice_and_hold_on_second_time) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Press mod-tap-hold key again. */
@@ -202,6 +209,7 @@ TEST_F(DefaultTapHold, tap_mod_tap_hold_key_twice_and_hold_on_second_time) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -0,0 +1,5 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Run the hold_on_other_key_press tests again with taps held for TAP_CODE_DELAY
+SRC += $(wildcard tests/tap_hold_configurations/hold_on_other_key_press/*.cpp)
@@ -45,6 +45,7 @@ TEST_F(HoldOnOtherKeyPress, short_distinct_taps_of_mod_tap_key_and_regular_key)
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Press regular key. */
@@ -118,6 +119,7 @@ TEST_F(HoldOnOtherKeyPress, short_distinct_taps_of_layer_tap_key_and_regular_key
     EXPECT_EMPTY_REPORT(driver);
     layer_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Press regular key. */
@@ -235,6 +237,7 @@ TEST_F(HoldOnOtherKeyPress, tap_a_mod_tap_key_while_another_mod_tap_key_is_held)
     EXPECT_REPORT(driver, (KC_LSFT));
     second_mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Release first mod-tap-hold key */
@@ -344,6 +347,7 @@ TEST_F(HoldOnOtherKeyPress, nested_tap_of_layer_tap_keys) {
     EXPECT_EMPTY_REPORT(driver);
     second_key_layer_0.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Release first layer-tap key */
@@ -86,6 +86,7 @@ TEST_F(PermissiveHold, tap_a_mod_tap_key_while_another_mod_tap_key_is_held) {
     EXPECT_REPORT(driver, (KC_LEFT_SHIFT));
     second_mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Release first mod-tap-hold key */
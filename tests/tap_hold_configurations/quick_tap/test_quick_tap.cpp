@@ -61,6 +61,7 @@ TEST_F(QuickTap, tap_regular_key_while_layer_tap_key_is_held) {
     EXPECT_EMPTY_REPORT(driver);
     layer_tap_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -95,6 +96,7 @@ TEST_F(QuickTap, tap_key_and_tap_again_before_quick_tap_term) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -133,6 +135,7 @@ TEST_F(QuickTap, tap_key_and_hold_again_before_quick_tap_term) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -168,6 +171,7 @@ TEST_F(QuickTap, tap_key_and_tap_again_after_quick_tap_term) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -48,6 +48,7 @@ TEST_F(RetroTapNeutralization, neutralize_retro_tapped_left_gui_mod_tap) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -72,6 +73,7 @@ TEST_F(RetroTapNeutralization, do_not_neutralize_retro_tapped_left_shift_mod_tap
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -96,6 +98,7 @@ TEST_F(RetroTapNeutralization, do_not_neutralize_retro_tapped_right_gui_mod_tap)
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -120,6 +123,7 @@ TEST_F(RetroTapNeutralization, do_not_neutralize_retro_tapped_left_gui_shift_mod
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -156,6 +160,7 @@ TEST_F(RetroTapNeutralization, do_not_neutralize_roll_of_regular_and_mod_tap_key
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Idle for tapping term of mod tap hold key. */
@@ -46,6 +46,7 @@ TEST_F(Tapping, HoldA_SHFT_T_KeyReportsShift) {
     EXPECT_EMPTY_REPORT(driver);
     mod_tap_hold_key.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
 
@@ -67,6 +68,7 @@ TEST_F(Tapping, ANewTapWithinTappingTermIsBuggy) {
     EXPECT_EMPTY_REPORT(driver);
     key_shift_hold_p_tap.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 
     /* Press mod_tap_hold key again */
@@ -108,5 +110,6 @@ TEST_F(Tapping, ANewTapWithinTappingTermIsBuggy) {
     EXPECT_EMPTY_REPORT(driver);
     key_shift_hold_p_tap.release();
     run_one_scan_loop();
+    idle_for(TAP_CODE_DELAY);
     VERIFY_AND_CLEAR(driver);
 }
@@ -0,0 +1,141 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+#include "timer.h"
+
+using testing::_;
+using testing::InSequence;
+
+static int pre_processed_during_delay = 0;
+
+extern "C" bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (is_unregister_delayed()) {
+        pre_processed_during_delay++;
+    }
+    return true;
+}
+
+class TapCodeDelay : public TestFixture {
+   public:
+    void SetUp() override {
+        pre_processed_during_delay = 0;
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(pre_processed_during_delay, 0);
+    }
+};
+
+TEST_F(TapCodeDelay, tap_mod_tap_key_does_not_block) {
+    TestDriver driver;
+    InSequence s;
+    auto       mod_tap_key = KeymapKey(0, 1, 0, SFT_T(KC_P));
+
+    set_keymap({mod_tap_key});
+
+    /* Press mod-tap key. */
+    EXPECT_NO_REPORT(driver);
+    mod_tap_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release mod-tap key, the scan doesn't wait for TAP_CODE_DELAY. */
+    EXPECT_REPORT(driver, (KC_P));
+    uint16_t start = timer_read();
+    mod_tap_key.release();
+    run_one_scan_loop();
+    EXPECT_EQ(timer_elapsed(start), 1);
+    VERIFY_AND_CLEAR(driver);
+
+    /* The tap is released once TAP_CODE_DELAY has passed. */
+    EXPECT_NO_REPORT(driver);
+    idle_for(TAP_CODE_DELAY - 1);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapCodeDelay, key_pressed_during_delay_is_processed_after_release) {
+    TestDriver driver;
+    InSequence s;
+    auto       layer_tap_key = KeymapKey(0, 1, 0, LT(1, KC_P));
+    auto       regular_key   = KeymapKey(0, 2, 0, KC_A);
+
+    set_keymap({layer_tap_key, regular_key});
+
+    /* Tap layer-tap key. */
+    EXPECT_REPORT(driver, (KC_P));
+    tap_key(layer_tap_key);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Press regular key while the tap is still held. */
+    EXPECT_NO_REPORT(driver);
+    regular_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Release regular key, still before the tap is released. */
+    EXPECT_NO_REPORT(driver);
+    regular_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Both events follow the release of the tap, in order. */
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAP_CODE_DELAY);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapCodeDelay, tap_caps_lock_layer_tap_key_uses_hold_caps_delay) {
+    TestDriver driver;
+    InSequence s;
+    auto       layer_tap_key = KeymapKey(0, 1, 0, LT(1, KC_CAPS_LOCK));
+
+    set_keymap({layer_tap_key});
+
+    EXPECT_REPORT(driver, (KC_CAPS_LOCK));
+    tap_key(layer_tap_key);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(TAP_HOLD_CAPS_DELAY - 2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(2);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(TapCodeDelay, consecutive_tap_codes_keep_their_order) {
+    TestDriver driver;
+    InSequence s;
+
+    /* A single tap returns right away. */
+    EXPECT_REPORT(driver, (KC_A));
+    uint16_t start = timer_read();
+    tap_code(KC_A);
+    EXPECT_EQ(timer_elapsed(start), 0);
+    VERIFY_AND_CLEAR(driver);
+
+    /* The next tap waits for the first one to be released. */
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    tap_code(KC_B);
+    EXPECT_EQ(timer_elapsed(start), TAP_CODE_DELAY);
+    VERIFY_AND_CLEAR(driver);
+
+    /* The last tap is released by the first scan after its delay. */
+    EXPECT_EMPTY_REPORT(driver);
+    idle_for(TAP_CODE_DELAY + 1);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,12 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define UNICODE_SELECTED_MODES UNICODE_MODE_LINUX
+#define UNICODE_TYPE_DELAY 10
+#define UNICODE_ASYNC_OUTPUT
+#define UNICODE_ASYNC_QUEUE_SIZE 4
+#define UNICODE_OUTPUT_STATS
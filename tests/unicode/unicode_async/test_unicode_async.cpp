@@ -0,0 +1,170 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+
+class UnicodeAsync : public TestFixture {};
+
+TEST_F(UnicodeAsync, compiles_sequence_per_input_mode) {
+    unicode_sequence_t sequence;
+
+    EXPECT_TRUE(unicode_compile_sequence(0x1F9D9, UNICODE_MODE_LINUX, &sequence));
+    EXPECT_EQ(sequence.length, 5);
+    EXPECT_EQ(sequence.digits[0], 0x1);
+    EXPECT_EQ(sequence.digits[4], 0x9);
+
+    // Surrogate pair D83E DDD9
+    EXPECT_TRUE(unicode_compile_sequence(0x1F9D9, UNICODE_MODE_MACOS, &sequence));
+    EXPECT_EQ(sequence.length, 8);
+    EXPECT_EQ(sequence.digits[0], 0xD);
+    EXPECT_EQ(sequence.digits[4], 0xD);
+
+    // Leading zero before a hex letter
+    EXPECT_TRUE(unicode_compile_sequence(0xFF31, UNICODE_MODE_WINCOMPOSE, &sequence));
+    EXPECT_EQ(sequence.length, 5);
+    EXPECT_EQ(sequence.digits[0], 0x0);
+
+    EXPECT_FALSE(unicode_compile_sequence(0x1F9D9, UNICODE_MODE_WINDOWS, &sequence));
+    EXPECT_FALSE(unicode_compile_sequence(0x110000, UNICODE_MODE_LINUX, &sequence));
+}
+
+TEST_F(UnicodeAsync, register_unicode_does_not_block) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    EXPECT_NO_REPORT(driver);
+    register_unicode(0x03A8); // Ψ
+    EXPECT_TRUE(unicode_output_pending());
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_UNICODE(driver, 0x03A8);
+    idle_for(UNICODE_TYPE_DELAY + UNICODE_SEQUENCE_MAX_DIGITS);
+    EXPECT_FALSE(unicode_output_pending());
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeAsync, sends_queued_string_in_order) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    {
+        testing::InSequence s;
+
+        EXPECT_UNICODE(driver, 0xFF31);
+        EXPECT_UNICODE(driver, 0xFF2D);
+        EXPECT_UNICODE(driver, 0xFF2B);
+        EXPECT_UNICODE(driver, 0xFF01);
+        EXPECT_UNICODE(driver, 0x1F9D9);
+    }
+
+    // Longer than the queue, so the first character is drained synchronously
+    send_unicode_string("ＱＭＫ！🧙");
+    while (unicode_output_pending()) {
+        run_one_scan_loop();
+    }
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeAsync, records_output_time_per_input_mode) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+    unicode_clear_output_stats();
+
+    EXPECT_UNICODE(driver, 0x2318);
+    register_unicode(0x2318); // ⌘
+    while (unicode_output_pending()) {
+        run_one_scan_loop();
+    }
+
+    const unicode_output_stats_t *stats = unicode_get_output_stats(UNICODE_MODE_LINUX);
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->count, 1);
+    EXPECT_GE(stats->last_time, UNICODE_TYPE_DELAY);
+    EXPECT_EQ(stats->max_time, stats->last_time);
+    EXPECT_EQ(unicode_get_output_stats(UNICODE_MODE_MACOS)->count, 0);
+    EXPECT_EQ(unicode_get_output_stats(UNICODE_MODE_COUNT), nullptr);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeAsync, keys_follow_queued_output) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    {
+        testing::InSequence s;
+
+        EXPECT_UNICODE(driver, 0x03A8);
+        EXPECT_UNICODE(driver, 0x2318);
+        EXPECT_REPORT(driver, (KC_A));
+        EXPECT_EMPTY_REPORT(driver);
+    }
+
+    register_unicode(0x03A8); // Ψ
+    register_unicode(0x2318); // ⌘
+    // The first input sequence is open when the key goes down
+    run_one_scan_loop();
+    EXPECT_TRUE(unicode_output_pending());
+    tap_key(key_a);
+    EXPECT_FALSE(unicode_output_pending());
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeAsync, modifier_released_during_output_stays_released) {
+    TestDriver driver;
+    auto       key_shift = KeymapKey(0, 0, 0, KC_LEFT_SHIFT);
+
+    set_keymap({key_shift});
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    EXPECT_ANY_REPORT(driver).Times(testing::AnyNumber());
+    key_shift.press();
+    run_one_scan_loop();
+
+    register_unicode(0x03A8); // Ψ
+    run_one_scan_loop();
+    EXPECT_TRUE(unicode_output_pending());
+
+    // The input sequence saved and cleared shift, it must not come back after the release
+    key_shift.release();
+    run_one_scan_loop();
+    idle_for(UNICODE_TYPE_DELAY + UNICODE_SEQUENCE_MAX_DIGITS);
+    EXPECT_FALSE(unicode_output_pending());
+    EXPECT_EQ(get_mods(), 0);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(UnicodeAsync, sequence_finishes_in_the_mode_it_started_in) {
+    TestDriver driver;
+
+    set_unicode_input_mode(UNICODE_MODE_LINUX);
+
+    EXPECT_UNICODE(driver, 0x03A8);
+    register_unicode(0x03A8); // Ψ
+    run_one_scan_loop();
+    EXPECT_TRUE(unicode_output_pending());
+
+    // Switching modes from code halfway through the sequence still ends it the Linux way
+    set_unicode_input_mode(UNICODE_MODE_MACOS);
+    while (unicode_output_pending()) {
+        run_one_scan_loop();
+    }
+    EXPECT_EQ(get_unicode_input_mode(), UNICODE_MODE_MACOS);
+
+    VERIFY_AND_CLEAR(driver);
+}
@@ -74,6 +74,47 @@ static void obnotify(io_buffers_queue_t *bqp) {
     }
 }
 
+/**
+ * @brief   Number of reports in the output buffers queue, including the one
+ *          that may currently be in transmission.
+ */
+static inline size_t usb_endpoint_in_queued_reports(usb_endpoint_in_t *endpoint) {
+    return bqSizeX(&endpoint->obqueue) - bqSpaceI(&endpoint->obqueue);
+}
+
+/**
+ * @brief   Discards all queued reports, accounting for them as dropped.
+ */
+static void usb_endpoint_in_discard_queue(usb_endpoint_in_t *endpoint) {
+    endpoint->stats.dropped += usb_endpoint_in_queued_reports(endpoint);
+    obqResetI(&endpoint->obqueue);
+}
+
+/**
+ * @brief   Tries to merge a report into the most recently queued report, so
+ *          that frequently updated reports don't pile up in the queue ahead of
+ *          other reports sharing the endpoint.
+ *
+ * @return  true if the report was merged and must not be queued
+ */
+static bool usb_endpoint_in_merge_report(usb_endpoint_in_t *endpoint, const uint8_t *data, size_t size) {
+    output_buffers_queue_t *obqp = &endpoint->obqueue;
+
+    /* The oldest queued report may already be in transmission, so only the
+       newest one can be modified -- and only if it isn't the oldest as well,
+       and no buffered report is partially filled.*/
+    if (endpoint->merge_report_cb == NULL || obqp->ptr != NULL || usb_endpoint_in_queued_reports(endpoint) < 2U) {
+        return false;
+    }
+
+    uint8_t *newest = ((obqp->bwrptr == obqp->buffers) ? obqp->btop : obqp->bwrptr) - obqp->bsize;
+    if (*((size_t *)newest) != size) {
+        return false;
+    }
+
+    return endpoint->merge_report_cb(newest + sizeof(size_t), data, size);
+}
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -123,7 +164,7 @@ void usb_endpoint_in_stop(usb_endpoint_in_t *endpoint) {
     endpoint->config.usbp->in_params[endpoint->config.ep - 1U] = NULL;
 
     bqSuspendI(&endpoint->obqueue);
-    obqResetI(&endpoint->obqueue);
+    usb_endpoint_in_discard_queue(endpoint);
     if (endpoint->report_storage != NULL) {
         endpoint->report_storage->reset_report(endpoint->report_storage->reports);
     }
@@ -145,7 +186,7 @@ void usb_endpoint_out_stop(usb_endpoint_out_t *endpoint) {
 
 void usb_endpoint_in_suspend_cb(usb_endpoint_in_t *endpoint) {
     bqSuspendI(&endpoint->obqueue);
-    obqResetI(&endpoint->obqueue);
+    usb_endpoint_in_discard_queue(endpoint);
 
     if (endpoint->report_storage != NULL) {
         endpoint->report_storage->reset_report(endpoint->report_storage->reports);
@@ -267,6 +308,14 @@ bool usb_endpoint_in_send(usb_endpoint_in_t *endpoint, const uint8_t *data, size
     if (endpoint->timed_out && timeout != TIME_INFINITE) {
         timeout = TIME_IMMEDIATE;
     }
+
+    /* Merging never blocks, so a burst of e.g. mouse reports can neither
+     * delay the main loop nor reports queued behind it on a shared endpoint. */
+    if (!buffered && usb_endpoint_in_merge_report(endpoint, data, size)) {
+        endpoint->stats.merged++;
+        osalSysUnlock();
+        return true;
+    }
     osalSysUnlock();
 
     while (true) {
@@ -276,7 +325,7 @@ bool usb_endpoint_in_send(usb_endpoint_in_t *endpoint, const uint8_t *data, size
             osalSysLock();
             endpoint->timed_out |= sent == 0;
             bqSuspendI(&endpoint->obqueue);
-            obqResetI(&endpoint->obqueue);
+            usb_endpoint_in_discard_queue(endpoint);
             bqResumeX(&endpoint->obqueue);
             osalOsRescheduleS();
             osalSysUnlock();
@@ -287,6 +336,10 @@ bool usb_endpoint_in_send(usb_endpoint_in_t *endpoint, const uint8_t *data, size
             obqFlush(&endpoint->obqueue);
         }
 
+        osalSysLock();
+        endpoint->stats.max_depth = MAX(endpoint->stats.max_depth, usb_endpoint_in_queued_reports(endpoint));
+        osalSysUnlock();
+
         return true;
     }
 }
@@ -320,6 +373,15 @@ bool usb_endpoint_in_is_inactive(usb_endpoint_in_t *endpoint) {
     return inactive;
 }
 
+void usb_endpoint_in_get_stats(usb_endpoint_in_t *endpoint, usb_endpoint_in_stats_t *stats) {
+    osalDbgCheck((endpoint != NULL) && (stats != NULL));
+
+    osalSysLock();
+    *stats       = endpoint->stats;
+    stats->depth = usb_endpoint_in_queued_reports(endpoint);
+    osalSysUnlock();
+}
+
 bool usb_endpoint_out_receive(usb_endpoint_out_t *endpoint, uint8_t *data, size_t size, sysinterval_t timeout) {
     osalDbgCheck((endpoint != NULL) && (data != NULL) && (size > 0U));
 
@@ -33,28 +33,28 @@
  *   Given `USBv1/hal_usb_lld.h` marks the field as "not currently used" this code file
  *   makes the assumption this is safe to avoid littering with preprocessor directives.
  */
-#define QMK_USB_ENDPOINT_IN(mode, ep_size, ep_num, _buffer_capacity, _usb_requests_cb, _report_storage) \
-    {                                                                                                   \
-        .usb_requests_cb = _usb_requests_cb, .report_storage = _report_storage,                         \
-        .ep_config =                                                                                    \
-            {                                                                                           \
-                mode,                           /* EP Mode */                                           \
-                NULL,                           /* SETUP packet notification callback */                \
-                usb_endpoint_in_tx_complete_cb, /* IN notification callback */                          \
-                NULL,                           /* OUT notification callback */                         \
-                ep_size,                        /* IN maximum packet size */                            \
-                0,                              /* OUT maximum packet size */                           \
-                NULL,                           /* IN Endpoint state */                                 \
-                NULL,                           /* OUT endpoint state */                                \
-                usb_lld_endpoint_fields         /* USB driver specific endpoint fields */               \
-            },                                                                                          \
-        .config = {                                                                                     \
-            .usbp            = &USB_DRIVER,                                                             \
-            .ep              = ep_num,                                                                  \
-            .buffer_capacity = _buffer_capacity,                                                        \
-            .buffer_size     = ep_size,                                                                 \
-            .buffer          = (_Alignas(4) uint8_t[BQ_BUFFER_SIZE(_buffer_capacity, ep_size)]){0},     \
-        }                                                                                               \
+#define QMK_USB_ENDPOINT_IN(mode, ep_size, ep_num, _buffer_capacity, _usb_requests_cb, _report_storage, _merge_report_cb) \
+    {                                                                                                                     \
+        .usb_requests_cb = _usb_requests_cb, .report_storage = _report_storage, .merge_report_cb = _merge_report_cb,      \
+        .ep_config =                                                                                                      \
+            {                                                                                                             \
+                mode,                           /* EP Mode */                                                             \
+                NULL,                           /* SETUP packet notification callback */                                  \
+                usb_endpoint_in_tx_complete_cb, /* IN notification callback */                                            \
+                NULL,                           /* OUT notification callback */                                           \
+                ep_size,                        /* IN maximum packet size */                                              \
+                0,                              /* OUT maximum packet size */                                             \
+                NULL,                           /* IN Endpoint state */                                                   \
+                NULL,                           /* OUT endpoint state */                                                  \
+                usb_lld_endpoint_fields         /* USB driver specific endpoint fields */                                 \
+            },                                                                                                            \
+        .config = {                                                                                                       \
+            .usbp            = &USB_DRIVER,                                                                               \
+            .ep              = ep_num,                                                                                    \
+            .buffer_capacity = _buffer_capacity,                                                                          \
+            .buffer_size     = ep_size,                                                                                   \
+            .buffer          = (_Alignas(4) uint8_t[BQ_BUFFER_SIZE(_buffer_capacity, ep_size)]){0},                       \
+        }                                                                                                                 \
     }
 
 #if !defined(USB_ENDPOINTS_ARE_REORDERABLE)
@@ -84,28 +84,28 @@
 
 #else
 
-#    define QMK_USB_ENDPOINT_IN_SHARED(mode, ep_size, ep_num, _buffer_capacity, _usb_requests_cb, _report_storage) \
-        {                                                                                                          \
-            .usb_requests_cb = _usb_requests_cb, .is_shared = true, .report_storage = _report_storage,             \
-            .ep_config =                                                                                           \
-                {                                                                                                  \
-                    mode,                            /* EP Mode */                                                 \
-                    NULL,                            /* SETUP packet notification callback */                      \
-                    usb_endpoint_in_tx_complete_cb,  /* IN notification callback */                                \
-                    usb_endpoint_out_rx_complete_cb, /* OUT notification callback */                               \
-                    ep_size,                         /* IN maximum packet size */                                  \
-                    ep_size,                         /* OUT maximum packet size */                                 \
-                    NULL,                            /* IN Endpoint state */                                       \
-                    NULL,                            /* OUT endpoint state */                                      \
-                    usb_lld_endpoint_fields          /* USB driver specific endpoint fields */                     \
-                },                                                                                                 \
-            .config = {                                                                                            \
-                .usbp            = &USB_DRIVER,                                                                    \
-                .ep              = ep_num,                                                                         \
-                .buffer_capacity = _buffer_capacity,                                                               \
-                .buffer_size     = ep_size,                                                                        \
-                .buffer          = (_Alignas(4) uint8_t[BQ_BUFFER_SIZE(_buffer_capacity, ep_size)]){0},            \
-            }                                                                                                      \
+#    define QMK_USB_ENDPOINT_IN_SHARED(mode, ep_size, ep_num, _buffer_capacity, _usb_requests_cb, _report_storage, _merge_report_cb)        \
+        {                                                                                                                                   \
+            .usb_requests_cb = _usb_requests_cb, .is_shared = true, .report_storage = _report_storage, .merge_report_cb = _merge_report_cb, \
+            .ep_config =                                                                                                                    \
+                {                                                                                                                           \
+                    mode,                            /* EP Mode */                                                                          \
+                    NULL,                            /* SETUP packet notification callback */                                               \
+                    usb_endpoint_in_tx_complete_cb,  /* IN notification callback */                                                         \
+                    usb_endpoint_out_rx_complete_cb, /* OUT notification callback */                                                        \
+                    ep_size,                         /* IN maximum packet size */                                                           \
+                    ep_size,                         /* OUT maximum packet size */                                                          \
+                    NULL,                            /* IN Endpoint state */                                                                \
+                    NULL,                            /* OUT endpoint state */                                                               \
+                    usb_lld_endpoint_fields          /* USB driver specific endpoint fields */                                              \
+                },                                                                                                                          \
+            .config = {                                                                                                                     \
+                .usbp            = &USB_DRIVER,                                                                                             \
+                .ep              = ep_num,                                                                                                  \
+                .buffer_capacity = _buffer_capacity,                                                                                        \
+                .buffer_size     = ep_size,                                                                                                 \
+                .buffer          = (_Alignas(4) uint8_t[BQ_BUFFER_SIZE(_buffer_capacity, ep_size)]){0},                                     \
+            }                                                                                                                               \
         }
 
 /* The current assumption is that there are no standalone OUT endpoints, so the
@@ -154,6 +154,36 @@ typedef struct {
     uint8_t *buffer;
 } usb_endpoint_config_t;
 
+/**
+ * @brief Merges a report into a queued report of the same size that has not
+ * been transmitted yet, e.g. by accumulating mouse movement.
+ *
+ * @return true if the report was merged and must not be queued
+ */
+typedef bool (*usb_report_merge_cb_t)(uint8_t *queued_report, const uint8_t *report, size_t size);
+
+typedef struct {
+    /**
+     * @brief Reports currently queued, including the one being transmitted
+     */
+    size_t depth;
+
+    /**
+     * @brief Highest number of reports queued at once
+     */
+    size_t max_depth;
+
+    /**
+     * @brief Reports merged into a queued report instead of being queued
+     */
+    uint32_t merged;
+
+    /**
+     * @brief Queued reports discarded due to a timeout, suspend or reset
+     */
+    uint32_t dropped;
+} usb_endpoint_in_stats_t;
+
 typedef struct {
     output_buffers_queue_t obqueue;
     USBEndpointConfig      ep_config;
@@ -162,10 +192,12 @@ typedef struct {
     USBOutEndpointState ep_out_state;
     bool                is_shared;
 #endif
-    usb_endpoint_config_t config;
-    usbreqhandler_t       usb_requests_cb;
-    bool                  timed_out;
-    usb_report_storage_t *report_storage;
+    usb_endpoint_config_t   config;
+    usbreqhandler_t         usb_requests_cb;
+    bool                    timed_out;
+    usb_report_storage_t   *report_storage;
+    usb_report_merge_cb_t   merge_report_cb;
+    usb_endpoint_in_stats_t stats;
 } usb_endpoint_in_t;
 
 typedef struct {
@@ -187,6 +219,7 @@ void usb_endpoint_in_stop(usb_endpoint_in_t *endpoint);
 bool usb_endpoint_in_send(usb_endpoint_in_t *endpoint, const uint8_t *data, size_t size, sysinterval_t timeout, bool buffered);
 void usb_endpoint_in_flush(usb_endpoint_in_t *endpoint, bool padded);
 bool usb_endpoint_in_is_inactive(usb_endpoint_in_t *endpoint);
+void usb_endpoint_in_get_stats(usb_endpoint_in_t *endpoint, usb_endpoint_in_stats_t *stats);
 
 void usb_endpoint_in_suspend_cb(usb_endpoint_in_t *endpoint);
 void usb_endpoint_in_wakeup_cb(usb_endpoint_in_t *endpoint);
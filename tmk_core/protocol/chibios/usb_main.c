@@ -415,6 +415,18 @@ bool send_report(usb_endpoint_in_lut_t endpoint, void *report, size_t size) {
     return usb_endpoint_in_send(&usb_endpoints_in[endpoint], (uint8_t *)report, size, TIME_MS2I(100), false);
 }
 
+/**
+ * @brief Retrieve the queue statistics of an IN endpoint. Reports that can be
+ * merged, such as mouse movement, are accumulated into the most recently
+ * queued report instead of waiting for space in the queue.
+ *
+ * @param endpoint USB IN endpoint to retrieve the statistics of
+ * @param stats pointer to the statistics to fill in
+ */
+void usb_get_endpoint_in_stats(usb_endpoint_in_lut_t endpoint, usb_endpoint_in_stats_t *stats) {
+    usb_endpoint_in_get_stats(&usb_endpoints_in[endpoint], stats);
+}
+
 /**
  * @brief Send a report to the host, but delay the sending until the size of
  * endpoint report is reached or the incompletely filled buffer is flushed with
@@ -554,7 +566,12 @@ void raw_hid_task(void) {
 #ifdef MIDI_ENABLE
 
 void send_midi_packet(MIDI_EventPacket_t *event) {
-    send_report(USB_ENDPOINT_IN_MIDI, (uint8_t *)event, sizeof(MIDI_EventPacket_t));
+    // Packed into full endpoint transfers, sent once full or on flush_midi_packets()
+    send_report_buffered(USB_ENDPOINT_IN_MIDI, (uint8_t *)event, sizeof(MIDI_EventPacket_t));
+}
+
+void flush_midi_packets(void) {
+    flush_report_buffered(USB_ENDPOINT_IN_MIDI, false);
 }
 
 bool recv_midi_packet(MIDI_EventPacket_t *const event) {
@@ -34,6 +34,9 @@ void restart_usb_driver(USBDriver *usbp);
 
 bool send_report(usb_endpoint_in_lut_t endpoint, void *report, size_t size);
 
+/* Queue depth and merge/drop counters of an IN endpoint */
+void usb_get_endpoint_in_stats(usb_endpoint_in_lut_t endpoint, usb_endpoint_in_stats_t *stats);
+
 /* ---------------
  * USB Event queue
  * ---------------
@@ -294,3 +294,61 @@ bool usb_set_idle_cb(USBDriver *driver) {
 
     return true;
 }
+
+#if defined(MOUSE_ENABLE)
+#    if defined(MOUSE_EXTENDED_REPORT)
+#        define USB_MOUSE_XY_MIN INT16_MIN
+#        define USB_MOUSE_XY_MAX INT16_MAX
+#    else
+#        define USB_MOUSE_XY_MIN INT8_MIN
+#        define USB_MOUSE_XY_MAX INT8_MAX
+#    endif
+
+static inline bool usb_mouse_sum_in_range(int32_t sum, int32_t min, int32_t max) {
+    return sum >= min && sum <= max;
+}
+#endif
+
+bool usb_mouse_merge_report(uint8_t *queued_report, const uint8_t *report, size_t size) {
+#if defined(MOUSE_ENABLE)
+    report_mouse_t       *queued = (report_mouse_t *)queued_report;
+    const report_mouse_t *next   = (const report_mouse_t *)report;
+
+    if (size != sizeof(report_mouse_t)) {
+        return false;
+    }
+#    if defined(MOUSE_SHARED_EP)
+    if (queued->report_id != REPORT_ID_MOUSE || next->report_id != REPORT_ID_MOUSE) {
+        return false;
+    }
+#    endif
+    /* Button changes must reach the host in order, so only movement is merged. */
+    if (queued->buttons != next->buttons) {
+        return false;
+    }
+
+    int32_t x = (int32_t)queued->x + next->x;
+    int32_t y = (int32_t)queued->y + next->y;
+    int32_t v = (int32_t)queued->v + next->v;
+    int32_t h = (int32_t)queued->h + next->h;
+    /* Clamping would lose movement, queue the report instead. */
+    if (!usb_mouse_sum_in_range(x, USB_MOUSE_XY_MIN, USB_MOUSE_XY_MAX) || !usb_mouse_sum_in_range(y, USB_MOUSE_XY_MIN, USB_MOUSE_XY_MAX) || !usb_mouse_sum_in_range(v, INT8_MIN, INT8_MAX) || !usb_mouse_sum_in_range(h, INT8_MIN, INT8_MAX)) {
+        return false;
+    }
+
+    queued->x = x;
+    queued->y = y;
+    queued->v = v;
+    queued->h = h;
+#    if defined(MOUSE_EXTENDED_REPORT)
+    queued->boot_x = (x > 127) ? 127 : ((x < -127) ? -127 : x);
+    queued->boot_y = (y > 127) ? 127 : ((y < -127) ? -127 : y);
+#    endif
+    return true;
+#else
+    (void)queued_report;
+    (void)report;
+    (void)size;
+    return false;
+#endif
+}
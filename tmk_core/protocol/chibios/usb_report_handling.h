@@ -75,3 +75,6 @@ bool usb_shared_idle_timer_elapsed(usb_fs_report_t **timers, uint8_t report_id);
 
 bool usb_get_idle_cb(USBDriver *driver);
 bool usb_set_idle_cb(USBDriver *driver);
+
+// Merging of queued reports
+bool usb_mouse_merge_report(uint8_t *queued_report, const uint8_t *report, size_t size);
@@ -689,6 +689,10 @@ void send_midi_packet(MIDI_EventPacket_t *event) {
     MIDI_Device_SendEventPacket(&USB_MIDI_Interface, event);
 }
 
+void flush_midi_packets(void) {
+    MIDI_Device_Flush(&USB_MIDI_Interface);
+}
+
 bool recv_midi_packet(MIDI_EventPacket_t *const event) {
     return MIDI_Device_ReceiveEventPacket(&USB_MIDI_Interface, event);
 }